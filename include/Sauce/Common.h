@@ -5,9 +5,14 @@
 #pragma once
 
 #include <Sauce/Common/Engine.h>
+#include <Sauce/Common/Profiler.h>
 #include <Sauce/Common/Exception.h>
 #include <Sauce/Common/SauceObject.h>
 #include <Sauce/Common/SceneObject.h>
+#include <Sauce/Common/Entity.h>
+#include <Sauce/Common/Transform.h>
+#include <Sauce/Common/SpatialGroup.h>
 #include <Sauce/Common/Event.h>
+#include <Sauce/Common/EventQueue.h>
 #include <Sauce/Common/ResourceManager.h>
 #include <Sauce/Common/tinyxml2.h>
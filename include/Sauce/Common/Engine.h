@@ -7,6 +7,7 @@
 #include <Sauce/Config.h>
 #include <Sauce/Math.h>
 #include <Sauce/Input.h>
+#include <atomic>
 
 BEGIN_SAUCE_NAMESPACE
 
@@ -25,50 +26,65 @@ extern int _vscprintf (const char * format, va_list pargs);
 #endif
 
 /**
- * \class	FileReader
- *
- * \brief	A file reader.
+ * \brief	Severities below this are compiled out of LOG_* call sites
+ *			(0 = Debug, 1 = Info, 2 = Warning, 3 = Error).
  */
+#ifndef SAUCE_LOG_MIN_LEVEL
+	#ifdef SAUCE_DEBUG
+		#define SAUCE_LOG_MIN_LEVEL 0
+	#else
+		#define SAUCE_LOG_MIN_LEVEL 1
+	#endif
+#endif
 
+/**
+ * \class	Console
+ *
+ * \brief	Asynchronous engine log.
+ *
+ * LOG call sites format their message straight into a slot of a
+ * bounded lock-free queue. A background thread owned by the console
+ * drains the queue, adds timestamps and writes batches to stdout, the
+ * log file and the in-game console buffers, which are bounded rings.
+ * Messages logged while no console exists are written synchronously.
+ */
 class SAUCE_API Console
 {
-	friend class Game;
 public:
+	/** \brief	Maximum number of lines kept for getLog(). */
+	static const uint32 MaxLogLines = 1024;
+
+	/** \brief	Maximum number of unread bytes kept for readBuffer(). */
+	static const uint32 MaxBufferSize = 64 * 1024;
 
 	/**
 	 * \fn	Console::Console();
 	 *
-	 * \brief	Default constructor.
+	 * \brief	Starts the log thread.
 	 */
 
 	Console();
-	~Console();
 
 	/**
-	 * \fn	void Console::log(const string &msg);
-	 *
-	 * \brief	Ouputs \p msg to the console
+	 * \fn	Console::~Console();
 	 *
-	 * \param	msg	The message.
+	 * \brief	Writes out all pending messages and stops the log thread.
 	 */
 
-	//void log(const string &msg);
+	~Console();
 
 	/**
-	 * \fn	void Console::logf(const char *msg, ...);
-	 *
-	 * \brief	Logfs.
+	 * \fn	bool Console::openLogFile(const string &filePath);
 	 *
-	 * \param	msg	The message.
-	 * \param	...	Variable arguments providing additional information.
+	 * \brief	Starts appending all messages to the file at \p filePath.
 	 */
 
-	void logf(const char *msg, ...);
+	bool openLogFile(const string &filePath);
 
 	/**
 	 * \fn	string Console::getLog() const;
 	 *
-	 * \brief	Gets the log.
+	 * \brief	Gets the last MaxLogLines lines of the log.
 	 *
 	 * \return	The log.
 	 */
@@ -86,7 +102,7 @@ public:
 	/**
 	 * \fn	string Console::readBuffer();
 	 *
-	 * \brief	Reads the buffer.
+	 * \brief	Reads the text logged since the last call to readBuffer().
 	 *
 	 * \return	The buffer.
 	 */
@@ -95,47 +111,76 @@ public:
 	bool hasBuffer() const;
 	void clearBuffer();
 
-	static void Log(const char *function, const char *file, const int line, const char *msg, ...);
+	static void Log(const LogLevel level, const LogCategory category, const char *function, const char *file, const int line, const char *msg, ...);
 
-private:
+	/**
+	 * \fn	static void Console::Flush();
+	 *
+	 * \brief	Blocks until every message logged before the call has been written.
+	 */
 
-	 /**
-	  * \fn	* fn void Console::call_log(const char *msg, va_list args);
-	  *
-	  * \brief	Call log.
-	  *
-	  * \param	msg 	The message.
-	  * \param	args	The arguments.
-	  */
-	void call_log(const char *msg, va_list args);
+	static void Flush();
 
-	/** \brief	The log. */
-	string m_log;
+	static void SetMinLevel(const LogLevel level) { s_minLevel.store((uint32)level, memory_order_relaxed); }
+	static LogLevel GetMinLevel() { return (LogLevel)s_minLevel.load(memory_order_relaxed); }
+	static void SetCategoryEnabled(const LogCategory category, const bool enabled);
+	static bool IsEnabled(const LogLevel level, const LogCategory category)
+	{
+		return (uint32)level >= s_minLevel.load(memory_order_relaxed) &&
+			(s_categoryMask.load(memory_order_relaxed) & (1u << (uint32)category)) != 0;
+	}
+
+	/**
+	 * \fn	static uint64 Console::GetDroppedCount();
+	 *
+	 * \brief	Number of Debug and Info messages dropped because the queue was full.
+	 */
+
+	static uint64 GetDroppedCount();
+
+private:
+	void run();
+	void write(const string &text);
+
+	/** \brief	Ring of the last MaxLogLines lines. */
+	vector<string> m_log;
+	uint32 m_logStart;
 
-	/** \brief	The buffer. */
+	/** \brief	Text logged since the last readBuffer(). */
 	string m_buffer;
-	
-	/** \brief	The engine. */
-	Game *m_engine;
-	
-	/** \brief	The output. */
-	ofstream *m_output;
 
-	static Console *s_this;
-///< .
+	mutable mutex m_logMutex;
+
+	/** \brief	The log file. */
+	ofstream m_output;
+
+	thread m_thread;
+	atomic<bool> m_running;
+
+	static atomic<Console*> s_this;
+	static atomic<uint32> s_minLevel;
+	static atomic<uint32> s_categoryMask;
 };
 
 /**
- * \brief	A macro for logging formatted messages
- *
- * \todo TODO: Add timestap to all console messages
+ * \brief	Macros for logging formatted messages. Arguments are only
+ *			evaluated if the message passes the compile and run time filters.
  *
  * \param	str	The message to log
  * \param	...	Variable argument list to format \p message with
  */
 
-#define LOG(str, ...)                   Console::Log(__FUNCTION__, __FILE__, __LINE__, str, __VA_ARGS__)
-#define LOG_IF(cond, str, ...) if(cond) Console::Log(__FUNCTION__, __FILE__, __LINE__, str, __VA_ARGS__)
+#define LOG_EX(level, category, str, ...)                                                          \
+	do {                                                                                           \
+		if((uint32)(level) >= SAUCE_LOG_MIN_LEVEL && Console::IsEnabled(level, category))          \
+			Console::Log(level, category, __FUNCTION__, __FILE__, __LINE__, str, __VA_ARGS__);     \
+	} while(0)
+
+#define LOG(str, ...)                   LOG_EX(LogLevel::Info, LogCategory::General, str, __VA_ARGS__)
+#define LOG_IF(cond, str, ...) if(cond) LOG_EX(LogLevel::Info, LogCategory::General, str, __VA_ARGS__)
+#define LOG_DEBUG(str, ...)             LOG_EX(LogLevel::Debug, LogCategory::General, str, __VA_ARGS__)
+#define LOG_WARNING(str, ...)           LOG_EX(LogLevel::Warning, LogCategory::General, str, __VA_ARGS__)
+#define LOG_ERROR(str, ...)             LOG_EX(LogLevel::Error, LogCategory::General, str, __VA_ARGS__)
 
 /**
  * \brief	A macro for throwing an exception with a formatted string
@@ -152,6 +197,7 @@ END_SAUCE_NAMESPACE
 #include <Sauce/Common/ResourceManager.h>
 #include <Sauce/Common/SceneObject.h>
 #include <Sauce/Common/Event.h>
+#include <Sauce/Common/EventQueue.h>
 #include <Sauce/Common/Callstack.h>
 
 BEGIN_SAUCE_NAMESPACE
@@ -181,7 +227,36 @@ typedef union _LARGE_INTEGER {
 } LARGE_INTEGER, *PLARGE_INTEGER;
 #endif
 
-#ifdef SAUCE_COMPILE_WINDOWS
+/**
+ * \class	Clock
+ *
+ * \brief	Monotonic high-resolution clock. Time is measured in integer
+ *			ticks of one nanosecond so that it can be accumulated without drift.
+ */
+class SAUCE_API Clock
+{
+public:
+	static const uint64 TicksPerSecond = 1000000000ULL;
+
+	/**
+	 * \fn	static uint64 Clock::GetTicks();
+	 *
+	 * \brief	Returns the current time in nanoseconds from an arbitrary, fixed origin.
+	 */
+	static uint64 GetTicks();
+
+	/**
+	 * \fn	static void Clock::SleepUntil(const uint64 ticks);
+	 *
+	 * \brief	Blocks until GetTicks() >= \p ticks. Sleeps for as long as the
+	 *			OS scheduler can be trusted and spins for the remainder.
+	 */
+	static void SleepUntil(const uint64 ticks);
+
+	static double TicksToSeconds(const uint64 ticks) { return ticks / double(TicksPerSecond); }
+	static uint64 SecondsToTicks(const double seconds) { return seconds > 0.0 ? uint64(seconds * TicksPerSecond + 0.5) : 0; }
+};
+
 class SAUCE_API Timer
 {
 public:
@@ -204,69 +279,88 @@ public:
 	 */
 
 	void  stop();
+
+	/**
+	 * \fn	double Timer::getElapsedTime() const;
+	 *
+	 * \brief	Gets the elapsed time in seconds.
+	 */
+
 	double getElapsedTime() const;
+	uint64 getElapsedTicks() const;
 
 private:
 
-	/** \brief	The frequency. */
-	LARGE_INTEGER m_frequency;
-
 	/** \brief	The start. */
-	LARGE_INTEGER m_start;
+	uint64 m_start;
 
 	/** \brief	The end. */
-	LARGE_INTEGER m_end;
+	uint64 m_end;
 
 	/** \brief	true to running. */
 	bool m_running;
 };
 
-#else
-
-class SAUCE_API Timer {
+class SAUCE_API SimpleTimer
+{
 public:
-    Timer() :
-		m_start(clock_::now()),
-		m_end(clock_::now())
-	{
-    }
-    
-	void start()
-	{
-        m_start = clock_::now();
-    }
+	SimpleTimer();
 
-	void stop()
-	{
-		m_end = clock_::now();
-	}
+	void start();
+	float stop();
 
-    double getElapsedTime() const
-	{
-        return std::chrono::duration_cast<std::chrono::milliseconds>(m_end - m_start).count();
-    }
+	float getElapsedTime() const;
 
 private:
-    typedef std::chrono::high_resolution_clock clock_;
-    typedef std::chrono::duration<double, std::ratio<1> > second_;
-    std::chrono::time_point<clock_> m_start, m_end;
+	uint64 m_startTick;
+	bool m_running;
 };
 
-#endif // SAUCE_COMPILE_WINDOWS
-
-class SAUCE_API SimpleTimer
+/**
+ * \class	FrameTimeStats
+ *
+ * \brief	Keeps the durations of the most recent frames for frame pacing
+ *			analysis (percentiles, worst frame and histograms).
+ */
+class SAUCE_API FrameTimeStats
 {
 public:
-	SimpleTimer();
+	FrameTimeStats(const uint32 maxSampleCount = 512);
 
-	void start();
-	float stop();
+	void addSample(const uint64 frameTicks);
+	void reset();
 
-	float getElapsedTime() const;
+	uint32 getSampleCount() const { return (uint32)m_samples.size(); }
+
+	/**
+	 * \fn	uint64 FrameTimeStats::getPercentile(const double percentile) const;
+	 *
+	 * \brief	Gets the frame time in ticks that \p percentile (0-100) of the sampled frames were at or below.
+	 */
+	uint64 getPercentile(const double percentile) const;
+	uint64 getMax() const;
+	double getAverageFramesPerSecond() const;
+
+	/**
+	 * \fn	void FrameTimeStats::getHistogram(const uint64 bucketTicks, vector<uint32>& outBuckets) const;
+	 *
+	 * \brief	Counts the sampled frames into outBuckets.size() buckets that are
+	 *			\p bucketTicks wide. The last bucket also counts all longer frames.
+	 */
+	void getHistogram(const uint64 bucketTicks, vector<uint32>& outBuckets) const;
+
+	/**
+	 * \fn	void FrameTimeStats::getSamples(vector<uint64>& outSamples) const;
+	 *
+	 * \brief	Gets the sampled frame times from oldest to newest.
+	 */
+	void getSamples(vector<uint64>& outSamples) const;
 
 private:
-	clock_t m_startTick;
-	bool m_running;
+	vector<uint64> m_samples;
+	uint32 m_maxSampleCount;
+	uint32 m_nextSample;
+	uint64 m_totalTicks;
 };
 
 /*********************************************************************
@@ -578,6 +672,8 @@ class Pixmap;
 
 class SAUCE_API Window
 {
+	friend class ThreadedGraphicsContext;
+	friend class RecordingGraphicsContext;
 public:
 
 	/**
@@ -811,6 +907,51 @@ private:
 	SceneObject *m_root;
 };
 
+/**
+ * \class	StateHasher
+ *
+ * \brief	Builds a 64-bit FNV-1a hash of game state. Used to check that two
+ *			runs of a deterministic simulation ended in the same state.
+ */
+class SAUCE_API StateHasher
+{
+public:
+	StateHasher() :
+		m_hash(0xcbf29ce484222325ULL)
+	{
+	}
+
+	void add(const void* data, const uint64 size)
+	{
+		const uint8* bytes = (const uint8*)data;
+		for(uint64 i = 0; i < size; ++i)
+		{
+			m_hash ^= bytes[i];
+			m_hash *= 0x100000001b3ULL;
+		}
+	}
+
+	template<typename T>
+	StateHasher& operator<<(const T& value)
+	{
+		static_assert(is_trivially_copyable<T>::value, "StateHasher only hashes trivially copyable types");
+		add(&value, sizeof(T));
+		return *this;
+	}
+
+	StateHasher& operator<<(const string& value)
+	{
+		*this << (uint64)value.size();
+		add(value.data(), value.size());
+		return *this;
+	}
+
+	uint64 getHash() const { return m_hash; }
+
+private:
+	uint64 m_hash;
+};
+
 struct SAUCE_API GameDesc
 {
 	string          name             = "DefaultGame";
@@ -819,6 +960,15 @@ struct SAUCE_API GameDesc
 	uint32          flags            = 0;
 	GraphicsBackend graphicsBackend  = GraphicsBackend::OpenGL3;
 	double          deltaTime        = 1.0 / 30.0;
+	double          maxFramesPerSecond = 0.0; ///< Frame rate limit (0 = unlimited). Frames are paced with a hybrid sleep/spin wait.
+	vector<string>  packFiles;       ///< Pack files to mount at startup. Packs listed last take precedence.
+	string          graphicsCaptureFile; ///< If set, every graphics command is recorded to this file (see GraphicsCaptureReplayer).
+	uint64          frameCount       = 0; ///< Number of frames to run before the game ends (0 = until end() is called).
+	uint64          tickCount        = 0; ///< Number of fixed timestep ticks to run before the game ends (0 = until end() is called).
+	uint32          drawInterval     = 1; ///< Headless runs only: draw every N ticks (0 = never draw).
+	InputScript*    inputScript      = nullptr; ///< If set, these input events are injected on their ticks. Not owned by the game.
+	string          inputRecordingFile; ///< If set, every input event is recorded to this file (see InputManager::startRecording()).
+	string          inputReplayFile;    ///< If set, input is played back from a recording instead of inputScript.
 };
 
 class ResourceManager;
@@ -873,11 +1023,68 @@ public:
 		return m_framesPerSecond;
 	}
 
+	/**
+	 * \fn	const FrameTimeStats& Game::getFrameTimeStats() const
+	 *
+	 * \brief	Gets the frame times of the most recent frames.
+	 */
+
+	const FrameTimeStats& getFrameTimeStats() const
+	{
+		return m_frameTimeStats;
+	}
+
+	/**
+	 * \fn	uint64 Game::getTickCount() const
+	 *
+	 * \brief	Gets the number of fixed timestep ticks simulated so far.
+	 */
+
+	uint64 getTickCount() const
+	{
+		return m_tickCount;
+	}
+
+	/**
+	 * \fn	uint64 Game::getStateChecksum() const
+	 *
+	 * \brief	Gets the hash of the game state computed by hashState() when the game loop ended.
+	 */
+
+	uint64 getStateChecksum() const
+	{
+		return m_stateChecksum;
+	}
+
+	/**
+	 * \fn	virtual void Game::hashState(StateHasher &hasher) const
+	 *
+	 * \brief	Adds the state that a deterministic simulation must reproduce to \p hasher.
+	 *			Called once when the game loop ends.
+	 */
+
+	virtual void hashState(StateHasher &hasher) const
+	{
+	}
+
 	InputManager *getInputManager()
 	{
 		return m_inputManager;
 	}
 
+	/**
+	 * \fn	EventQueue *Game::getEventQueue()
+	 *
+	 * \brief	Gets the queue of input events. The queue is dispatched to the game
+	 *			once per frame, after SDL events have been polled and before the
+	 *			game is ticked. Events pushed to it are dispatched at that point.
+	 */
+
+	EventQueue *getEventQueue()
+	{
+		return &m_eventQueue;
+	}
+
 	ResourceManager *getResourceManager()
 	{
 		return m_resourceManager;
@@ -908,10 +1115,25 @@ private:
 
 	/** \brief	Fps. */
 	double m_framesPerSecond;
+
+	/** \brief	Frame time samples. */
+	FrameTimeStats m_frameTimeStats;
+
+	/** \brief	Ticks simulated so far. */
+	uint64 m_tickCount;
+
+	/** \brief	State hash taken when the game loop ended. */
+	uint64 m_stateChecksum;
 	
 	/** \brief	Game windows. */
 	list<Window*> m_windows;
 
+	/** \brief	Graphics context of a headless run. Otherwise the main window owns the context. */
+	GraphicsContext *m_headlessGraphicsContext;
+
+	/** \brief	Input loaded from GameDesc::inputReplayFile. */
+	InputScript *m_inputReplay;
+
 	/** \brief	The file system. */
 	FileSystem		*m_fileSystem;
 	
@@ -921,6 +1143,9 @@ private:
 	
 	InputManager *m_inputManager;
 
+	/** \brief	Input events of the current frame. */
+	EventQueue m_eventQueue;
+
 	Scene *m_scene;
 	
 	/** \brief	The timer. */
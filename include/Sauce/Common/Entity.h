@@ -0,0 +1,402 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Config.h>
+#include <Sauce/Common/SceneObject.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * \brief	Handle of an entity in an EntityWorld. The low 32 bits are the slot
+ *			of the entity and the high 32 bits count how often the slot has been
+ *			reused, so that handles of destroyed entities stay invalid.
+ */
+typedef uint64 Entity;
+
+const Entity InvalidEntity = 0xFFFFFFFFFFFFFFFF;
+
+inline uint32 GetEntitySlot(const Entity entity) { return (uint32)entity; }
+inline uint32 GetEntityGeneration(const Entity entity) { return (uint32)(entity >> 32); }
+
+/**
+ * \class	ComponentPoolBase
+ *
+ * \brief	Sparse set of the entities that have a component. Maps entity slots
+ *			to indices into a dense array that the component pool stores its
+ *			components in, in the same order.
+ */
+class SAUCE_API ComponentPoolBase
+{
+	friend class EntityWorld;
+public:
+	static const uint32 InvalidIndex = 0xFFFFFFFF;
+
+	virtual ~ComponentPoolBase() { }
+
+	bool contains(const Entity entity) const
+	{
+		return indexOf(entity) != InvalidIndex;
+	}
+
+	uint32 indexOf(const Entity entity) const
+	{
+		const uint32 slot = GetEntitySlot(entity);
+		if(slot >= m_sparse.size()) return InvalidIndex;
+		const uint32 index = m_sparse[slot];
+		return index < m_entities.size() && m_entities[index] == entity ? index : InvalidIndex;
+	}
+
+	uint32 size() const { return (uint32)m_entities.size(); }
+	const Entity *getEntities() const { return m_entities.data(); }
+
+	virtual void remove(const Entity entity) = 0;
+
+protected:
+	// Adds an entity to the end of the dense array and returns its index
+	uint32 insert(const Entity entity)
+	{
+		const uint32 slot = GetEntitySlot(entity);
+		if(slot >= m_sparse.size())
+		{
+			m_sparse.resize(slot + 1, InvalidIndex);
+		}
+		m_sparse[slot] = (uint32)m_entities.size();
+		m_entities.push_back(entity);
+		return m_sparse[slot];
+	}
+
+	// Moves the last entity into the place of the entity at index
+	void erase(const uint32 index)
+	{
+		const Entity last = m_entities.back();
+		m_entities[index] = last;
+		m_sparse[GetEntitySlot(last)] = index;
+		m_entities.pop_back();
+	}
+
+	vector<uint32> m_sparse;
+	vector<Entity> m_entities;
+};
+
+/**
+ * \class	ComponentPool
+ *
+ * \brief	Stores every component of type T contiguously. Each component type
+ *			has its own pool, so splitting hot and cold data into separate
+ *			component types gives structure-of-arrays storage.
+ *
+ *			Removing a component moves the last component into its place.
+ *			References to components are invalidated by adding or removing a
+ *			component of the same type.
+ */
+template<typename T>
+class ComponentPool : public ComponentPoolBase
+{
+public:
+	template<typename... Args>
+	T &add(const Entity entity, Args&&... args)
+	{
+		const uint32 index = indexOf(entity);
+		if(index != InvalidIndex)
+		{
+			m_components[index] = T(forward<Args>(args)...);
+			return m_components[index];
+		}
+		insert(entity);
+		m_components.emplace_back(forward<Args>(args)...);
+		return m_components.back();
+	}
+
+	void remove(const Entity entity)
+	{
+		const uint32 index = indexOf(entity);
+		if(index == InvalidIndex) return;
+		if(index + 1 < m_components.size())
+		{
+			m_components[index] = move(m_components.back());
+		}
+		m_components.pop_back();
+		erase(index);
+	}
+
+	T *get(const Entity entity)
+	{
+		const uint32 index = indexOf(entity);
+		return index != InvalidIndex ? &m_components[index] : 0;
+	}
+
+	T &at(const uint32 index) { return m_components[index]; }
+	T *getComponents() { return m_components.data(); }
+
+private:
+	vector<T> m_components;
+};
+
+class EntityWorld;
+
+/**
+ * \class	EntitySystem
+ *
+ * \brief	Game logic that runs over the components of an EntityWorld every
+ *			tick and draw, typically with EntityWorld::each().
+ */
+class SAUCE_API EntitySystem
+{
+public:
+	virtual ~EntitySystem() { }
+	virtual void onTick(EntityWorld *world, TickEvent *e) { }
+	virtual void onDraw(EntityWorld *world, DrawEvent *e) { }
+};
+
+/**
+ * \class	EntityWorld
+ *
+ * \brief	Entities with components stored in ComponentPools. Add the world to
+ *			the scene to run its systems when it receives tick and draw events.
+ *
+ *			Entities destroyed and components removed while each() is running
+ *			are destroyed and removed once it returns, so systems can destroy
+ *			entities while they iterate over them. Creating entities and adding
+ *			components is allowed during each(), but not during eachParallel().
+ */
+class SAUCE_API EntityWorld : public SceneObject
+{
+public:
+	EntityWorld();
+	~EntityWorld();
+
+	Entity createEntity();
+	void destroyEntity(const Entity entity);
+	bool isAlive(const Entity entity) const;
+	uint32 getEntityCount() const { return m_entityCount; }
+
+	template<typename T, typename... Args>
+	T &addComponent(const Entity entity, Args&&... args)
+	{
+		// A stale handle shares its slot with a live entity and would corrupt the pool
+		THROW_IF(!isAlive(entity), "Cannot add a component to destroyed entity (slot %u)", GetEntitySlot(entity));
+		ComponentPool<T> &pool = getPool<T>();
+		if(!m_pendingRemovals.empty())
+		{
+			// The component is added again after being removed during each()
+			cancelPendingRemoval(&pool, entity);
+		}
+		return pool.add(entity, forward<Args>(args)...);
+	}
+
+	template<typename T>
+	void removeComponent(const Entity entity)
+	{
+		ComponentPool<T> &pool = getPool<T>();
+		if(m_iterationDepth > 0)
+		{
+			m_pendingRemovals.push_back(make_pair(static_cast<ComponentPoolBase*>(&pool), entity));
+			return;
+		}
+		pool.remove(entity);
+	}
+
+	template<typename T>
+	T *getComponent(const Entity entity)
+	{
+		return getPool<T>().get(entity);
+	}
+
+	template<typename T>
+	bool hasComponent(const Entity entity)
+	{
+		return getPool<T>().contains(entity);
+	}
+
+	template<typename T>
+	ComponentPool<T> &getPool()
+	{
+		const uint32 typeID = GetComponentTypeID<T>();
+		if(typeID >= m_pools.size())
+		{
+			m_pools.resize(typeID + 1);
+		}
+		if(!m_pools[typeID])
+		{
+			m_pools[typeID].reset(new ComponentPool<T>());
+		}
+		return *static_cast<ComponentPool<T>*>(m_pools[typeID].get());
+	}
+
+	/**
+	 * \fn	template<typename T, typename... Rest, typename F> void EntityWorld::each(F func);
+	 *
+	 * \brief	Calls func(entity, T&, Rest&...) for every entity that has all of
+	 *			the given components. Walks the pool of T linearly, so T should be
+	 *			the rarest of the component types.
+	 */
+	template<typename T, typename... Rest, typename F>
+	void each(F func)
+	{
+		ComponentPool<T> &pool = getPool<T>();
+		beginIteration();
+		for(uint32 i = 0; i < pool.size(); ++i)
+		{
+			const Entity entity = pool.getEntities()[i];
+			if(hasComponents<Rest...>(entity))
+			{
+				func(entity, pool.at(i), *getPool<Rest>().get(entity)...);
+			}
+		}
+		endIteration();
+	}
+
+	/**
+	 * \fn	template<typename T, typename... Rest, typename F> void EntityWorld::eachParallel(F func, const uint32 minBatchSize = 4096);
+	 *
+	 * \brief	Like each(), but splits the pool of T into batches of at least
+	 *			\p minBatchSize components that are processed on worker threads.
+	 *			func may only modify the components it is given.
+	 */
+	template<typename T, typename... Rest, typename F>
+	void eachParallel(F func, const uint32 minBatchSize = 4096)
+	{
+		ComponentPool<T> &pool = getPool<T>();
+		const bool poolsCreated[] = { true, (getPool<Rest>(), true)... };
+		(void)poolsCreated;
+
+		const uint32 count = pool.size();
+		const uint32 threadCount = min(max(thread::hardware_concurrency(), 1u), max(count / max(minBatchSize, 1u), 1u));
+		beginIteration();
+		if(threadCount <= 1)
+		{
+			for(uint32 i = 0; i < count; ++i)
+			{
+				const Entity entity = pool.getEntities()[i];
+				if(hasComponents<Rest...>(entity))
+				{
+					func(entity, pool.at(i), *getPool<Rest>().get(entity)...);
+				}
+			}
+		}
+		else
+		{
+			const uint32 batchSize = (count + threadCount - 1) / threadCount;
+			auto processBatch = [&](const uint32 begin, const uint32 end)
+			{
+				for(uint32 i = begin; i < end; ++i)
+				{
+					const Entity entity = pool.getEntities()[i];
+					if(hasComponents<Rest...>(entity))
+					{
+						func(entity, pool.at(i), *getPool<Rest>().get(entity)...);
+					}
+				}
+			};
+
+			// The calling thread processes the last batch
+			vector<thread> workers;
+			workers.reserve(threadCount - 1);
+			for(uint32 i = 0; i < threadCount - 1; ++i)
+			{
+				workers.emplace_back(processBatch, i * batchSize, (i + 1) * batchSize);
+			}
+			processBatch((threadCount - 1) * batchSize, count);
+			for(thread &worker : workers)
+			{
+				worker.join();
+			}
+		}
+		endIteration();
+	}
+
+	/**
+	 * \fn	void EntityWorld::addSystem(EntitySystem *system);
+	 *
+	 * \brief	Adds a system. Systems run in the order they were added and are
+	 *			not owned by the world.
+	 */
+	void addSystem(EntitySystem *system);
+	void removeSystem(EntitySystem *system);
+
+	void onTick(TickEvent *e);
+	void onDraw(DrawEvent *e);
+
+private:
+	template<typename... Ts>
+	bool hasComponents(const Entity entity)
+	{
+		const bool contained[] = { true, getPool<Ts>().contains(entity)... };
+		return all_of(begin(contained), end(contained), [](const bool c) { return c; });
+	}
+
+	static uint32 NextComponentTypeID();
+
+	template<typename T>
+	static uint32 GetComponentTypeID()
+	{
+		static const uint32 typeID = NextComponentTypeID();
+		return typeID;
+	}
+
+	void beginIteration() { m_iterationDepth++; }
+	void endIteration();
+	void cancelPendingRemoval(ComponentPoolBase *pool, const Entity entity);
+
+	// Component pools indexed by component type ID
+	vector<unique_ptr<ComponentPoolBase>> m_pools;
+
+	// Generation of every entity slot, and the slots that are free for reuse.
+	// Slots are reused oldest first, so a handle only comes back once every
+	// other free slot has been reused as often.
+	vector<uint32> m_generations;
+	deque<uint32> m_freeSlots;
+	uint32 m_entityCount;
+
+	// Destruction and removal is deferred while iterating
+	uint32 m_iterationDepth;
+	vector<Entity> m_pendingDestroys;
+	vector<pair<ComponentPoolBase*, Entity>> m_pendingRemovals;
+
+	vector<EntitySystem*> m_systems;
+};
+
+/**
+ * \class	EntityObject
+ *
+ * \brief	A scene object that owns an entity. The entity is created with the
+ *			object and destroyed with it, so the world must outlive the object.
+ */
+class SAUCE_API EntityObject : public SceneObject
+{
+public:
+	EntityObject(EntityWorld *world) :
+		m_world(world),
+		m_entity(world->createEntity())
+	{
+	}
+
+	~EntityObject()
+	{
+		m_world->destroyEntity(m_entity);
+	}
+
+	template<typename T, typename... Args>
+	T &addComponent(Args&&... args)
+	{
+		return m_world->addComponent<T>(m_entity, forward<Args>(args)...);
+	}
+
+	template<typename T>
+	T *getComponent() const
+	{
+		return m_world->getComponent<T>(m_entity);
+	}
+
+	Entity getEntity() const { return m_entity; }
+	EntityWorld *getWorld() const { return m_world; }
+
+private:
+	EntityWorld *m_world;
+	const Entity m_entity;
+};
+
+END_SAUCE_NAMESPACE
@@ -0,0 +1,128 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Config.h>
+#include <Sauce/Common/Event.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * \class	EventQueue
+ *
+ * \brief	Events that are dispatched together at a defined point in the frame.
+ *
+ *			Events are constructed in place in memory blocks that are kept
+ *			when the queue is cleared, so queueing events does not allocate
+ *			once the queue has grown to the size of a typical frame. Queued
+ *			event types must be trivially destructible, like all engine events.
+ *
+ *			An event pushed with a coalescing key replaces the queued event with
+ *			the same key, as long as only coalescable events were queued after
+ *			it. Many mouse motion or axis events in a frame are dispatched as
+ *			one that way, while their order relative to other events is kept.
+ *			A coalescing key must always be used with the same event type.
+ */
+class SAUCE_API EventQueue
+{
+public:
+	static const uint32 NoCoalescing = 0;
+	static const uint32 BlockSize = 4096;
+
+	EventQueue();
+
+	template<typename T, typename... Args>
+	T *push(Args&&... args)
+	{
+		return pushCoalesced<T>(NoCoalescing, forward<Args>(args)...);
+	}
+
+	template<typename T, typename... Args>
+	T *pushCoalesced(const uint32 coalesceKey, Args&&... args)
+	{
+		static_assert(is_base_of<Event, T>::value, "Queued events must derive from Event");
+		static_assert(is_trivially_destructible<T>::value, "Queued events must be trivially destructible");
+		static_assert(sizeof(T) <= BlockSize, "Event type is too large for the event queue");
+
+		if(coalesceKey != NoCoalescing)
+		{
+			for(uint32 i = (uint32)m_events.size(); i > m_coalesceBegin; --i)
+			{
+				QueuedEvent &queued = m_events[i - 1];
+				if(queued.coalesceKey == coalesceKey)
+				{
+					T *event = new (queued.event) T(forward<Args>(args)...);
+					queued.event = event;
+					m_coalescedCount++;
+					return event;
+				}
+			}
+		}
+
+		T *event = new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+		QueuedEvent queued = { event, coalesceKey };
+		m_events.push_back(queued);
+		if(coalesceKey == NoCoalescing)
+		{
+			m_coalesceBegin = (uint32)m_events.size();
+		}
+		return event;
+	}
+
+	/**
+	 * \fn	template<typename F> void EventQueue::dispatch(F func);
+	 *
+	 * \brief	Calls func(Event*) for every queued event in order, then clears the
+	 *			queue. Events pushed by func are dispatched in the same call.
+	 */
+	template<typename F>
+	void dispatch(F func)
+	{
+		for(uint32 i = 0; i < m_events.size(); ++i)
+		{
+			// Dispatched events must not be replaced by coalescing
+			m_coalesceBegin = max(m_coalesceBegin, i + 1);
+			Event *event = m_events[i].event;
+			func(event);
+		}
+		clear();
+	}
+
+	void clear();
+
+	uint32 getSize() const { return (uint32)m_events.size(); }
+	bool isEmpty() const { return m_events.empty(); }
+
+	/**
+	 * \fn	uint64 EventQueue::getCoalescedCount() const
+	 *
+	 * \brief	Gets the number of events that replaced a queued event since the
+	 *			queue was created.
+	 */
+	uint64 getCoalescedCount() const { return m_coalescedCount; }
+
+private:
+	void *allocate(const size_t size, const size_t alignment);
+
+	struct QueuedEvent
+	{
+		Event *event;
+		uint32 coalesceKey;
+	};
+
+	vector<QueuedEvent> m_events;
+
+	// Queued events before this index are never replaced by coalescing
+	uint32 m_coalesceBegin;
+
+	// Event storage. Blocks are reused from the first one after clear().
+	vector<unique_ptr<uint8[]>> m_blocks;
+	uint32 m_currentBlock;
+	size_t m_blockOffset;
+
+	uint64 m_coalescedCount;
+};
+
+END_SAUCE_NAMESPACE
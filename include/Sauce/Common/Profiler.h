@@ -0,0 +1,170 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Config.h>
+#include <atomic>
+
+BEGIN_SAUCE_NAMESPACE
+
+class GraphicsContext;
+
+/**
+ * \struct	ProfilerEvent
+ *
+ * \brief	A completed profiling scope. Times are in Clock ticks (nanoseconds).
+ *			Scope names must be string literals or otherwise outlive the profiler.
+ */
+struct SAUCE_API ProfilerEvent
+{
+	const char* name;
+	uint64      startTicks;
+	uint64      endTicks;
+	uint32      depth;
+};
+
+/**
+ * \class	ProfilerTrack
+ *
+ * \brief	Ring buffer of profiler events for one thread (or the GPU).
+ *			Only the owning thread writes to the track. Readers take
+ *			lock-free snapshots and discard entries that were overwritten
+ *			while they were being copied.
+ */
+class SAUCE_API ProfilerTrack
+{
+	friend class Profiler;
+	friend class ProfileScope;
+public:
+	static const uint32 Capacity = 1 << 14;
+
+	ProfilerTrack(const uint32 trackId, const string& name);
+
+	void push(const ProfilerEvent& profilerEvent)
+	{
+		const uint64 writeIndex = m_writeIndex.load(memory_order_relaxed);
+		m_events[writeIndex % Capacity] = profilerEvent;
+		m_writeIndex.store(writeIndex + 1, memory_order_release);
+	}
+
+	/**
+	 * \fn	void ProfilerTrack::snapshot(vector<ProfilerEvent>& outEvents, const uint64 fromIndex = 0) const;
+	 *
+	 * \brief	Appends the events with an index >= \p fromIndex that are still in the buffer to \p outEvents.
+	 */
+	void snapshot(vector<ProfilerEvent>& outEvents, const uint64 fromIndex = 0) const;
+
+	uint64 getWriteIndex() const { return m_writeIndex.load(memory_order_acquire); }
+	uint32 getTrackId() const { return m_trackId; }
+	const string& getName() const { return m_name; }
+
+private:
+	unique_ptr<ProfilerEvent[]> m_events;
+	atomic<uint64> m_writeIndex;
+	uint32 m_depth;
+	const uint32 m_trackId;
+	string m_name;
+};
+
+/**
+ * \class	Profiler
+ *
+ * \brief	Collects CPU scopes from every thread and GPU scopes reported by
+ *			the graphics context. Can draw an ImGui overlay of the last frame
+ *			and export everything still in the buffers as a Chrome trace
+ *			(chrome://tracing or ui.perfetto.dev).
+ */
+class SAUCE_API Profiler
+{
+public:
+	static void SetEnabled(const bool enabled) { s_enabled.store(enabled, memory_order_relaxed); }
+	static bool IsEnabled() { return s_enabled.load(memory_order_relaxed); }
+
+	/**
+	 * \fn	static void Profiler::SetThreadName(const string& name);
+	 *
+	 * \brief	Names the calling thread's track in the overlay and in exported traces.
+	 */
+	static void SetThreadName(const string& name);
+
+	/**
+	 * \fn	static ProfilerTrack* Profiler::GetThreadTrack();
+	 *
+	 * \brief	Gets the calling thread's track, registering it on first use.
+	 */
+	static ProfilerTrack* GetThreadTrack();
+
+	/**
+	 * \fn	static void Profiler::SubmitGPUEvents(const vector<ProfilerEvent>& events);
+	 *
+	 * \brief	Called by graphics backends with the resolved GPU scopes of one frame,
+	 *			converted to the CPU clock. Backends on a render thread call it
+	 *			from that thread.
+	 */
+	static void SubmitGPUEvents(const vector<ProfilerEvent>& events);
+
+	/**
+	 * \fn	static void Profiler::NewFrame();
+	 *
+	 * \brief	Marks the start of a frame on the calling (main) thread.
+	 */
+	static void NewFrame();
+
+	/**
+	 * \fn	static void Profiler::DrawOverlay();
+	 *
+	 * \brief	Draws the profiler window. Must be called between ImGui's NewFrame() and Render().
+	 */
+	static void DrawOverlay();
+
+	/**
+	 * \fn	static bool Profiler::ExportChromeTrace(const string& filePath);
+	 *
+	 * \brief	Writes all buffered events as Chrome trace_event JSON.
+	 */
+	static bool ExportChromeTrace(const string& filePath);
+
+private:
+	static atomic<bool> s_enabled;
+};
+
+/**
+ * \class	ProfileScope
+ *
+ * \brief	Records a CPU profiling scope for as long as it is alive.
+ */
+class SAUCE_API ProfileScope
+{
+public:
+	ProfileScope(const char* name);
+	~ProfileScope();
+
+private:
+	ProfilerTrack* m_track;
+	ProfilerEvent m_event;
+};
+
+/**
+ * \class	GPUProfileScope
+ *
+ * \brief	Records a GPU profiling scope around the commands submitted to
+ *			\p graphicsContext while it is alive.
+ */
+class SAUCE_API GPUProfileScope
+{
+public:
+	GPUProfileScope(GraphicsContext* graphicsContext, const char* name);
+	~GPUProfileScope();
+
+private:
+	GraphicsContext* m_graphicsContext;
+};
+
+#define SAUCE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SAUCE_PROFILE_CONCAT(a, b) SAUCE_PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) ProfileScope SAUCE_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(context, name) GPUProfileScope SAUCE_PROFILE_CONCAT(gpuProfileScope_, __LINE__)(context, name)
+
+END_SAUCE_NAMESPACE
@@ -9,22 +9,76 @@
 
 BEGIN_SAUCE_NAMESPACE
 
-#define PROPAGATE_EVENT for(SceneObject *child : list<SceneObject*>(m_children)) child->onEvent(e)
+#define PROPAGATE_EVENT propagateEvent(e)
 
 /**
 * \class	SceneObject
 *
 * \brief	An game object.
+*
+* Events are passed to the children in place. Children added or removed while
+* an event is being passed down are only added or removed once it has reached
+* every child, so an event is always delivered to the children the object had
+* when the event arrived.
+*
+* Objects can limit the events they handle with setEventMask(). Children that
+* don't handle an event are skipped, and whole subtrees are skipped when no
+* object in them handles it.
 */
 class SAUCE_API SceneObject
 {
 public:
 	SceneObject() :
 		m_parent(0),
-		m_userData(0)
+		m_userData(0),
+		m_eventMask(~0ULL),
+		m_subtreeEventMask(~0ULL),
+		m_dispatchDepth(0)
 	{
 	}
 
+	/**
+	* \fn	virtual SceneObject::~SceneObject()
+	*
+	* \brief	Detaches the object from its parent and children. An object may
+	* 			be deleted while its parent passes an event down, e.g. by the
+	* 			object's own handler.
+	*/
+
+	virtual ~SceneObject()
+	{
+		for(SceneObject *child : m_children)
+		{
+			if(child && child->m_parent == this) child->m_parent = 0;
+		}
+		for(const pair<ChildChange, SceneObject*> &change : m_pendingChanges)
+		{
+			if(change.second && change.second->m_parent == this) change.second->m_parent = 0;
+		}
+		if(m_parent)
+		{
+			m_parent->forgetChild(this);
+		}
+	}
+
+	/**
+	* \fn	static uint64 SceneObject::EventBit(const int32 eventType)
+	*
+	* \brief	Gets the event mask bit of an event type. Event types past the
+	* 			first 63 share the last bit.
+	*/
+
+	static uint64 EventBit(const int32 eventType)
+	{
+		return eventType >= 0 && eventType < 63 ? 1ULL << eventType : 1ULL << 63;
+	}
+
+	template<typename T>
+	static uint64 EventBit(const T eventType)
+	{
+		return EventBit((int32)eventType);
+	}
+
 	/**
 	* \fn	virtual void Game::onStart(GameEvent*)
 	*
@@ -324,6 +378,48 @@ public:
 		}
 	}
 
+	/**
+	* \fn	void SceneObject::propagateEvent(Event *e)
+	*
+	* \brief	Passes an event on to the children that handle it.
+	*
+	* \param [in,out]	e	The event.
+	*/
+
+	void propagateEvent(Event *e)
+	{
+		const uint64 eventBit = EventBit(e->getType());
+		if(!(m_subtreeEventMask & eventBit)) return;
+
+		beginPropagation();
+		for(SceneObject *child : m_children)
+		{
+			// Children deleted during the event leave a null until it is over
+			if(child) PassEvent(child, e, eventBit);
+		}
+		endPropagation();
+	}
+
+	/**
+	* \fn	void SceneObject::setEventMask(const uint64 eventMask)
+	*
+	* \brief	Sets the events this object handles, as a combination of EventBit()s.
+	* 			All events are handled by default.
+	*
+	* \param	eventMask	The event mask.
+	*/
+
+	void setEventMask(const uint64 eventMask)
+	{
+		m_eventMask = eventMask;
+		updateSubtreeEventMask();
+	}
+
+	uint64 getEventMask() const
+	{
+		return m_eventMask;
+	}
+
 	/**
 	* \fn	void SceneObject::addChildFirst(SceneObject *child)
 	*
@@ -335,8 +431,8 @@ public:
 	void addChildFirst(SceneObject *child)
 	{
 		if(!child) return;
-		m_children.push_front(child);
 		child->m_parent = this;
+		changeChildren(ChildChange::AddFirst, child);
 	}
 
 	/**
@@ -350,8 +446,8 @@ public:
 	void addChildLast(SceneObject *child)
 	{
 		if(!child) return;
-		m_children.push_back(child);
 		child->m_parent = this;
+		changeChildren(ChildChange::AddLast, child);
 	}
 
 	/**
@@ -365,7 +461,7 @@ public:
 	void removeChild(SceneObject *child)
 	{
 		if(!child) return;
-		m_children.remove(child);
+		changeChildren(ChildChange::Remove, child);
 	}
 
 	/**
@@ -376,8 +472,7 @@ public:
 
 	void removeChildFront()
 	{
-		if(m_children.empty()) return;
-		m_children.pop_front();
+		changeChildren(ChildChange::RemoveFirst, 0);
 	}
 
 	/**
@@ -388,19 +483,20 @@ public:
 
 	void removeChildLast()
 	{
-		if(m_children.empty()) return;
-		m_children.pop_back();
+		changeChildren(ChildChange::RemoveLast, 0);
 	}
 
 	/**
-	* \fn	list<SceneObject*> getChildren() const
+	* \fn	const vector<SceneObject*> &getChildren() const
 	*
-	* \brief	Gets the children of this item.
+	* \brief	Gets the children of this item. While an event is being passed
+	* 			down, this does not include changes made during the event, and
+	* 			children deleted during the event are null.
 	*
-	* \return	null if it fails, else the children.
+	* \return	The children.
 	*/
 
-	list<SceneObject*> getChildren() const
+	const vector<SceneObject*> &getChildren() const
 	{
 		return m_children;
 	}
@@ -444,11 +540,190 @@ public:
 		return m_userData;
 	}
 
+protected:
+	/**
+	* \fn	virtual void SceneObject::onParentChanged()
+	*
+	* \brief	Called after this object was added to or removed from a parent.
+	*/
+
+	virtual void onParentChanged()
+	{
+	}
+
+	/**
+	* \fn	virtual void SceneObject::onChildRemoved(SceneObject *child)
+	*
+	* \brief	Called after a child was removed from this object, before the
+	* 			child's onParentChanged(). Also called when a child is deleted,
+	* 			in which case \p child must not be dereferenced.
+	*
+	* \param [in,out]	child	The removed child.
+	*/
+
+	virtual void onChildRemoved(SceneObject *child)
+	{
+	}
+
+	/**
+	* \fn	void SceneObject::beginPropagation()
+	*
+	* \brief	For objects that pass events on to a subset of their children.
+	* 			Child changes are deferred until the matching endPropagation().
+	*/
+
+	void beginPropagation()
+	{
+		m_dispatchDepth++;
+	}
+
+	void endPropagation()
+	{
+		if(--m_dispatchDepth == 0 && !m_pendingChanges.empty())
+		{
+			applyPendingChanges();
+		}
+	}
+
+	static void PassEvent(SceneObject *child, Event *e, const uint64 eventBit)
+	{
+		if(child->m_eventMask & eventBit)
+		{
+			child->onEvent(e);
+		}
+		else if(child->m_subtreeEventMask & eventBit)
+		{
+			// Skip the child's own handlers, but not its children
+			child->propagateEvent(e);
+		}
+	}
+
 private:
+	enum class ChildChange
+	{
+		AddFirst,
+		AddLast,
+		Remove,
+		RemoveFirst,
+		RemoveLast,
+		Compact
+	};
+
+	void changeChildren(const ChildChange change, SceneObject *child)
+	{
+		if(m_dispatchDepth > 0)
+		{
+			m_pendingChanges.push_back(make_pair(change, child));
+			return;
+		}
+
+		switch(change)
+		{
+			case ChildChange::AddFirst: m_children.insert(m_children.begin(), child); break;
+			case ChildChange::AddLast: m_children.push_back(child); break;
+			case ChildChange::Remove:
+			{
+				vector<SceneObject*>::iterator itr = remove(m_children.begin(), m_children.end(), child);
+				if(itr == m_children.end()) return;
+				m_children.erase(itr, m_children.end());
+			}
+			break;
+			case ChildChange::RemoveFirst:
+			{
+				if(m_children.empty()) return;
+				child = m_children.front();
+				m_children.erase(m_children.begin());
+			}
+			break;
+			case ChildChange::RemoveLast:
+			{
+				if(m_children.empty()) return;
+				child = m_children.back();
+				m_children.pop_back();
+			}
+			break;
+		}
+
+		const bool removed = change != ChildChange::AddFirst && change != ChildChange::AddLast;
+		if(removed)
+		{
+			if(child->m_parent == this) child->m_parent = 0;
+		}
+		updateSubtreeEventMask();
+		if(removed)
+		{
+			onChildRemoved(child);
+		}
+		child->onParentChanged();
+	}
+
+	void applyPendingChanges()
+	{
+		// Close the holes left by children deleted during the event first
+		m_children.erase(remove(m_children.begin(), m_children.end(), (SceneObject*)0), m_children.end());
+		for(const pair<ChildChange, SceneObject*> &change : m_pendingChanges)
+		{
+			if(change.first == ChildChange::Compact)
+			{
+				updateSubtreeEventMask();
+				continue;
+			}
+			changeChildren(change.first, change.second);
+		}
+		m_pendingChanges.clear();
+	}
+
+	// Called by a child that is being deleted, so the child is never dereferenced afterwards
+	void forgetChild(SceneObject *child)
+	{
+		m_pendingChanges.erase(remove_if(m_pendingChanges.begin(), m_pendingChanges.end(),
+			[child](const pair<ChildChange, SceneObject*> &change) { return change.second == child; }),
+			m_pendingChanges.end());
+
+		vector<SceneObject*>::iterator itr = find(m_children.begin(), m_children.end(), child);
+		if(itr != m_children.end())
+		{
+			if(m_dispatchDepth > 0)
+			{
+				// The children are being iterated, so leave a hole
+				*itr = 0;
+				m_pendingChanges.push_back(make_pair(ChildChange::Compact, (SceneObject*)0));
+			}
+			else
+			{
+				m_children.erase(itr);
+				updateSubtreeEventMask();
+			}
+		}
+		onChildRemoved(child);
+	}
+
+	void updateSubtreeEventMask()
+	{
+		for(SceneObject *object = this; object; object = object->m_parent)
+		{
+			uint64 subtreeEventMask = object->m_eventMask;
+			for(SceneObject *child : object->m_children)
+			{
+				if(child) subtreeEventMask |= child->m_subtreeEventMask;
+			}
+			if(subtreeEventMask == object->m_subtreeEventMask && object != this) break;
+			object->m_subtreeEventMask = subtreeEventMask;
+		}
+	}
+
 	// TODO: Consider using shared_ptr for SceneObject*
-	list<SceneObject*> m_children;
+	vector<SceneObject*> m_children;
 	SceneObject *m_parent;
 	void *m_userData;
+
+	// Events handled by this object and by any object in its subtree
+	uint64 m_eventMask;
+	uint64 m_subtreeEventMask;
+
+	// Child changes made while an event is passed down are applied afterwards
+	uint32 m_dispatchDepth;
+	vector<pair<ChildChange, SceneObject*>> m_pendingChanges;
 };
 
 END_SAUCE_NAMESPACE
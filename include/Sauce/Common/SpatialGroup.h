@@ -0,0 +1,89 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Config.h>
+#include <Sauce/Math.h>
+#include <Sauce/Common/SceneObject.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * \class	SpatialGroup
+ *
+ * \brief	A scene object that keeps the bounds of its children in a spatial
+ *			index. While a view rectangle is set, draw events are only passed
+ *			on to the children whose bounds overlap it, so drawing costs time
+ *			proportional to what is visible. Other events reach all children.
+ *
+ *			Children without bounds are not drawn while a view rectangle is
+ *			set. Visible children are drawn in the order their bounds were
+ *			first set, and pick() returns the child drawn last.
+ */
+class SAUCE_API SpatialGroup : public SceneObject
+{
+public:
+	SpatialGroup(const float margin = 8.0f);
+
+	/**
+	 * \fn	void SpatialGroup::setChildBounds(SceneObject *child, const Rect<float> &bounds);
+	 *
+	 * \brief	Sets or updates the bounds of a child. Moving bounds only
+	 *			touches the index when they leave the margin around them.
+	 *			The bounds are dropped when the child is removed from the group.
+	 */
+	void setChildBounds(SceneObject *child, const Rect<float> &bounds);
+	void removeChildBounds(SceneObject *child);
+
+	void setViewRect(const Rect<float> &viewRect);
+	void clearViewRect();
+
+	/**
+	 * \fn	void SpatialGroup::queryRect(const Rect<float> &rect, vector<SceneObject*> &outChildren) const;
+	 *
+	 * \brief	Gets the children whose bounds overlap \p rect, in draw order.
+	 */
+	void queryRect(const Rect<float> &rect, vector<SceneObject*> &outChildren) const;
+
+	/**
+	 * \fn	SceneObject *SpatialGroup::pick(const Vector2F &point) const;
+	 *
+	 * \brief	Gets the topmost child whose bounds contain \p point, or null.
+	 */
+	SceneObject *pick(const Vector2F &point) const;
+
+	const SpatialIndex2D &getIndex() const
+	{
+		return m_index;
+	}
+
+	void onDraw(DrawEvent *e);
+
+protected:
+	void onChildRemoved(SceneObject *child);
+
+private:
+	struct Entry
+	{
+		uint32 proxy;
+		uint32 order;
+		Rect<float> bounds;
+	};
+
+	// Appends the children overlapping box, with their draw order
+	void collect(const BoundingBox2D &box, vector<pair<uint32, SceneObject*>> &outChildren) const;
+
+	SpatialIndex2D m_index;
+	unordered_map<SceneObject*, Entry> m_entries;
+	uint32 m_nextOrder;
+
+	bool m_hasViewRect;
+	Rect<float> m_viewRect;
+
+	// Scratch list of visible children, kept to avoid allocating every draw
+	vector<pair<uint32, SceneObject*>> m_visible;
+};
+
+END_SAUCE_NAMESPACE
@@ -0,0 +1,131 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Config.h>
+#include <Sauce/Math.h>
+#include <Sauce/Common/SceneObject.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+typedef uint32 TransformID;
+
+const TransformID InvalidTransform = 0xFFFFFFFF;
+
+/**
+ * \class	TransformHierarchy
+ *
+ * \brief	A tree of transforms with cached world matrices. A world matrix is
+ *			the world matrix of the parent times the local matrix, the same way
+ *			GraphicsContext::pushMatrix() composes matrices.
+ *
+ *			Transforms are stored in breadth-first order, so update() computes
+ *			the world matrices in one linear pass where every parent comes
+ *			before its children. Only transforms whose local matrix or parent
+ *			changed since the last update, and the subtrees below them, are
+ *			recomputed.
+ */
+class SAUCE_API TransformHierarchy
+{
+public:
+	TransformHierarchy();
+
+	TransformID create(const TransformID parent = InvalidTransform);
+
+	/**
+	 * \fn	void TransformHierarchy::destroy(const TransformID transform);
+	 *
+	 * \brief	Destroys a transform. Its children become roots.
+	 */
+	void destroy(const TransformID transform);
+	bool isValid(const TransformID transform) const;
+
+	/**
+	 * \fn	bool TransformHierarchy::setParent(const TransformID transform, const TransformID parent);
+	 *
+	 * \brief	Moves a transform below another transform, or makes it a root when
+	 *			\p parent is InvalidTransform. Fails if it would create a cycle.
+	 */
+	bool setParent(const TransformID transform, const TransformID parent);
+	TransformID getParent(const TransformID transform) const;
+
+	void setLocalMatrix(const TransformID transform, const Matrix4 &localMatrix);
+	const Matrix4 &getLocalMatrix(const TransformID transform) const;
+
+	/**
+	 * \fn	const Matrix4 &TransformHierarchy::getWorldMatrix(const TransformID transform);
+	 *
+	 * \brief	Gets the world matrix of a transform, updating the hierarchy first
+	 *			if anything changed since the last update.
+	 */
+	const Matrix4 &getWorldMatrix(const TransformID transform);
+
+	/**
+	 * \fn	void TransformHierarchy::update();
+	 *
+	 * \brief	Recomputes the world matrices of the transforms that moved.
+	 */
+	void update();
+
+	uint32 getSize() const { return (uint32)(m_ids.size() - m_destroyedIDs.size()); }
+
+private:
+	static const uint32 InvalidIndex = 0xFFFFFFFF;
+
+	// Restores breadth-first order and removes destroyed transforms
+	void sort();
+
+	// Per transform, in breadth-first order after sort()
+	vector<TransformID> m_ids;
+	vector<uint32> m_parentIndices;
+	vector<Matrix4> m_localMatrices;
+	vector<Matrix4> m_worldMatrices;
+	vector<uint8> m_dirty;
+
+	// Per transform ID
+	vector<uint32> m_indices;
+	vector<TransformID> m_parents;
+	vector<TransformID> m_freeIDs;
+
+	// Destroyed transforms are removed, and their IDs freed, by the next sort
+	vector<TransformID> m_destroyedIDs;
+
+	bool m_orderChanged;
+	bool m_matricesChanged;
+};
+
+/**
+ * \class	TransformObject
+ *
+ * \brief	A scene object with a transform. The transform is parented to the
+ *			transform of the scene parent when the scene parent is a
+ *			TransformObject in the same hierarchy, and is a root otherwise.
+ *
+ *			To draw with the cached transform, push getWorldMatrix() and pop
+ *			it again before passing the draw event on to the children, as
+ *			they have world matrices of their own.
+ */
+class SAUCE_API TransformObject : public SceneObject
+{
+public:
+	TransformObject(TransformHierarchy *hierarchy);
+	~TransformObject();
+
+	void setLocalMatrix(const Matrix4 &localMatrix) { m_hierarchy->setLocalMatrix(m_transform, localMatrix); }
+	const Matrix4 &getLocalMatrix() const { return m_hierarchy->getLocalMatrix(m_transform); }
+	const Matrix4 &getWorldMatrix() const { return m_hierarchy->getWorldMatrix(m_transform); }
+
+	TransformID getTransform() const { return m_transform; }
+	TransformHierarchy *getHierarchy() const { return m_hierarchy; }
+
+protected:
+	void onParentChanged();
+
+private:
+	TransformHierarchy *m_hierarchy;
+	const TransformID m_transform;
+};
+
+END_SAUCE_NAMESPACE
@@ -186,7 +186,10 @@ enum class EngineFlag : uint32
 	RunInBackground            = 1 << 1, ///< This will allow the program to run while not focused.
 	CaptureInputWhenOutOfFocus = 1 << 2, ///< If SAUCE_RUN_IN_BACKGROUND is set, this will block input while program is out of focus. 
 	Verbose                    = 1 << 4, ///< This will make the engine produce more verbose messages from engine calls.
-	ResizableWindow            = 1 << 5
+	ResizableWindow            = 1 << 5,
+	ShowProfiler               = 1 << 6, ///< Show the built-in profiler overlay.
+	RenderThread               = 1 << 7, ///< Submit rendering commands to the GPU from a dedicated thread.
+	Headless                   = 1 << 8  ///< Run without a window or GPU. Rendering goes to a NullGraphicsContext and every frame advances exactly one tick.
 };
 ENUM_CLASS_ADD_BITWISE_OPERATORS(EngineFlag);
 
@@ -200,6 +203,28 @@ enum MessageType
 	Error
 };
 
+/*********************************************************************
+**	Log severities and categories									**
+**********************************************************************/
+enum class LogLevel : uint32
+{
+	Debug,
+	Info,
+	Warning,
+	Error
+};
+
+enum class LogCategory : uint32
+{
+	General,
+	Graphics,
+	Audio,
+	Input,
+	Resources,
+	Scripting,
+	Count
+};
+
 /*********************************************************************
 **	List of supported graphics backends								**
 **********************************************************************/
@@ -208,7 +233,8 @@ enum class GraphicsBackend : uint32
 	OpenGL3,
 	OpenGL4,
 	DirectX12,
-	Vulkan_VERSION
+	Vulkan_VERSION,
+	Null            ///< No rendering. Device objects only exist on the CPU.
 };
 
 /*********************************************************************
@@ -7,6 +7,10 @@
 #include <Sauce/Math.h>
 #include <Sauce/Graphics/GraphicsContext.h>
 #include <Sauce/Graphics/OpenGL/OpenGLContext.h>
+#include <Sauce/Graphics/Null/NullGraphicsContext.h>
+#include <Sauce/Graphics/GraphicsCommandBuffer.h>
+#include <Sauce/Graphics/ThreadedGraphicsContext.h>
+#include <Sauce/Graphics/RecordingGraphicsContext.h>
 #include <Sauce/Graphics/BlendState.h>
 #include <Sauce/Graphics/Animation.h>
 #include <Sauce/Graphics/SpriteBatch.h>
@@ -36,6 +36,7 @@ class SAUCE_API BlendState
 {
 	friend class GraphicsContext;
 	friend class OpenGLContext;
+	friend class GraphicsCommandBuffer;
 public:
 
 	BlendState(const BlendPreset preset);
@@ -17,6 +17,8 @@
 
 BEGIN_SAUCE_NAMESPACE
 
+class Pixmap;
+
 /**
  * Text alignment enum
  */
@@ -36,10 +38,7 @@ struct SAUCE_API FontRendererDesc : public SauceObjectDesc
 	uint32 fontSize     = 128;
 
 	/** Key that is used to look for cached font data files */
-	string getKey() const
-	{
-		return util::FileMD5(fontFilePath) + "_" + to_string(fontSize);
-	}
+	string getKey() const;
 };
 
 /** 
@@ -87,6 +86,13 @@ class SAUCE_API FontRenderingSystem
 public:
 	static bool Initialize(GraphicsContext* context);
 	static void Free();
+
+	/**
+	 * Generates a single channel signed distance field from a binary glyph mask.
+	 * Each output pixel covers \p subdivisions x \p subdivisions mask pixels
+	 * and edges are searched for up to \p radius mask pixels away.
+	 */
+	static void GenerateSDF(const uint8* mask, const uint32 width, const uint32 height, const int32 radius, const int32 subdivisions, Pixmap& outPixmap);
 };
 
 END_SAUCE_NAMESPACE
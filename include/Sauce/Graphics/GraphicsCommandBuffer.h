@@ -0,0 +1,294 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Graphics/GraphicsContext.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * Graphics command types.
+ * Identifies the commands stored in a GraphicsCommandBuffer.
+ */
+enum class GraphicsCommandType : uint32
+{
+	SetState,
+	Enable,
+	Disable,
+	EnableScissor,
+	DisableScissor,
+	SetPointSize,
+	SetLineWidth,
+	SetViewportSize,
+	SetSwapInterval,
+	SwapBuffers,
+	Clear,
+	SaveScreenshot,
+	DrawPrimitives,
+	DrawIndexedPrimitives,
+	DrawVertexBuffer,
+	DrawIndexedVertexBuffer,
+	DrawIndexedVertexBufferRange,
+	BeginProfileScope,
+	EndProfileScope,
+	DefineVertexFormat,
+	Texture2DCreate,
+	Texture2DDestroy,
+	Texture2DCopyToGPU,
+	Texture2DUpdateSubregion,
+	Texture2DUpdateFiltering,
+	Texture2DUpdateWrapping,
+	Texture2DClear,
+	ShaderCreate,
+	ShaderDestroy,
+	ShaderCompile,
+	ShaderSetUniform,
+	ShaderSetSampler2D,
+	RenderTarget2DCreate,
+	RenderTarget2DDestroy,
+	RenderTarget2DInitialize,
+	RenderTarget2DBind,
+	VertexBufferCreate,
+	VertexBufferDestroy,
+	VertexBufferInitialize,
+	VertexBufferModify,
+	IndexBufferCreate,
+	IndexBufferDestroy,
+	IndexBufferInitialize,
+	IndexBufferModify,
+	Invoke,
+	Count
+};
+
+/**
+ * \struct	GraphicsCommandStatistics
+ *
+ * \brief	Counts gathered while executing a command buffer.
+ */
+struct SAUCE_API GraphicsCommandStatistics
+{
+	uint32 commandCount      = 0;
+	uint32 drawCalls         = 0;
+	uint32 stateChanges      = 0; ///< Render state, capabilities, viewport, scissor, render target and uniform changes
+	uint64 bytesUploaded     = 0; ///< Vertex, index, texture and uniform data sent to the backend
+	uint32 objectsCreated    = 0;
+	uint32 objectsDestroyed  = 0;
+
+	GraphicsCommandStatistics& operator+=(const GraphicsCommandStatistics& other);
+};
+
+/**
+ * \class	GraphicsCommandBuffer
+ *
+ * \brief	A list of GraphicsContext calls with deep copies of their arguments.
+ *
+ * Commands are packed into a single byte array that keeps its capacity
+ * between frames, so recording a frame does not allocate once the buffer
+ * has grown to its working size. Resources used by the commands are kept
+ * alive until the buffer is reset. Draw commands are preceded by a
+ * SetState command whenever the texture, shader, blend state, viewport or
+ * matrices changed since the previous draw.
+ *
+ * A serializable buffer refers to device objects and resources by ids
+ * instead of pointers, and keeps its vertex formats and ids across
+ * reset(), so that the bytes of consecutive frames form a self-contained
+ * stream that can be stored and executed in another process. Creation of
+ * device objects must then be recorded as well, and invoke() is not
+ * available. Executing such a stream creates the objects on the target
+ * context as their creation commands are reached.
+ */
+class SAUCE_API GraphicsCommandBuffer
+{
+public:
+	GraphicsCommandBuffer(const bool serializable = false);
+
+	GraphicsCommandBuffer(const GraphicsCommandBuffer&) = delete;
+	GraphicsCommandBuffer& operator=(const GraphicsCommandBuffer&) = delete;
+
+	/**
+	 * Removes all commands and releases the resources they referenced.
+	 */
+	void reset();
+
+	/**
+	 * Replays all commands on \p context in the order they were recorded.
+	 * \p context may be null to only gather \p outStatistics.
+	 */
+	void execute(GraphicsContext* context, GraphicsCommandStatistics* outStatistics = nullptr);
+
+	/**
+	 * Replaces the commands with \p size bytes of a serialized stream.
+	 */
+	void setData(const uint8* data, const uint64 size, const uint32 commandCount);
+
+	bool isSerializable() const { return m_serializable; }
+	bool isEmpty() const { return m_commandCount == 0; }
+	uint32 getCommandCount() const { return m_commandCount; }
+	uint64 getSize() const { return m_data.size(); }
+	const uint8* getData() const { return m_data.data(); }
+
+	/************************************************
+	 *  Recording                                   *
+	 ************************************************/
+
+	void setState(const GraphicsContext::State& state);
+
+	void enable(const Capability cap);
+	void disable(const Capability cap);
+	void enableScissor(const int x, const int y, const int w, const int h);
+	void disableScissor();
+	void setPointSize(const float pointSize);
+	void setLineWidth(const float lineWidth);
+	void setViewportSize(const uint w, const uint h);
+	void setSwapInterval(const int interval);
+	void swapBuffers();
+	void clear(const uint32 clearMask, const Color& clearColor, const double clearDepth, const int32 clearStencil);
+	void saveScreenshot(const string& path);
+
+	void drawPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount);
+	void drawIndexedPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount);
+	void drawPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer);
+	void drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer);
+	void drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex);
+
+	void beginProfileScope(const char* name);
+	void endProfileScope();
+
+	/**
+	 * Creation commands are only recorded by serializable buffers.
+	 */
+	void texture2D_createDeviceObject(Texture2DDeviceObject* textureDeviceObject, const string& deviceObjectName);
+	void shader_createDeviceObject(ShaderDeviceObject* shaderDeviceObject, const string& deviceObjectName);
+	void shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource);
+	void renderTarget2D_createDeviceObject(RenderTarget2DDeviceObject* renderTargetDeviceObject, const string& deviceObjectName);
+	void vertexBuffer_createDeviceObject(VertexBufferDeviceObject* vertexBufferDeviceObject, const string& deviceObjectName);
+	void indexBuffer_createDeviceObject(IndexBufferDeviceObject* indexBufferDeviceObject, const string& deviceObjectName);
+
+	void texture2D_destroyDeviceObject(Texture2DDeviceObject* textureDeviceObject);
+	void texture2D_copyToGPU(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, const uint8* textureData);
+	void texture2D_updateSubregion(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, const uint32 pixelSizeInBytes, const uint8* textureData);
+	void texture2D_updateFiltering(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering);
+	void texture2D_updateWrapping(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping);
+	void texture2D_clearTexture(Texture2DDeviceObject* textureDeviceObject);
+
+	void shader_destroyDeviceObject(ShaderDeviceObject* shaderDeviceObject);
+	void shader_setUniform(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data, const uint32 dataSize);
+	void shader_setSampler2D(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture);
+
+	void renderTarget2D_destroyDeviceObject(RenderTarget2DDeviceObject* renderTargetDeviceObject);
+	void renderTarget2D_initializeRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject, const Texture2DRef* targetTextures, const uint32 targetCount);
+	void renderTarget2D_bindRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject);
+
+	void vertexBuffer_destroyDeviceObject(VertexBufferDeviceObject* vertexBufferDeviceObject);
+	void vertexBuffer_initializeVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const BufferUsage bufferUsage, const VertexArray& vertices, const uint32 vertexCount);
+	void vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const uint32 startIndex, const VertexArray& vertices, const uint32 vertexCount);
+
+	void indexBuffer_destroyDeviceObject(IndexBufferDeviceObject* indexBufferDeviceObject);
+	void indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const BufferUsage bufferUsage, const uint32* indices, const uint32 indexCount);
+	void indexBuffer_modifyIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const uint32 startIndex, const uint32* indices, const uint32 indexCount);
+
+	/**
+	 * Records an arbitrary call to make on the executing context.
+	 */
+	void invoke(function<void(GraphicsContext*)> func);
+
+private:
+	void beginCommand(const GraphicsCommandType type);
+	uint32 addReference(shared_ptr<void> object);
+	uint32 addVertexFormat(const VertexFormat& vertexFormat);
+	void writeVertices(const uint32 vertexFormatIndex, const VertexArray& vertices, const uint32 vertexCount);
+	VertexArray& readVertices(const uint8*& cursor);
+
+	void writeNewDeviceObject(const void* deviceObject);
+	void writeReleasedDeviceObject(const void* deviceObject);
+	void writeDeviceObject(const void* deviceObject);
+	template<typename ResourceType> void writeResource(const shared_ptr<ResourceType>& resource);
+	uint32 getObjectId(const void* deviceObject) const;
+	template<typename ResourceType> uint64 getResourceKey(const shared_ptr<ResourceType>& resource) const;
+
+	template<typename ResourceType, typename DeviceObjectType> DeviceObjectType* readDeviceObject(const uint8*& cursor);
+	template<typename ResourceType> shared_ptr<ResourceType> readResource(const uint8*& cursor);
+	template<typename ResourceType, typename DeviceObjectType> void executeCreate(const uint8*& cursor, GraphicsContext* context, void (GraphicsContext::*createDeviceObject)(DeviceObjectType*&, const string&));
+	template<typename ResourceType, typename DeviceObjectType> void executeDestroy(const uint8*& cursor, GraphicsContext* context, void (GraphicsContext::*destroyDeviceObject)(DeviceObjectType*&));
+
+	template<typename T>
+	void write(const T& value)
+	{
+		static_assert(is_trivially_copyable<T>::value, "Only trivially copyable values can be written to a command buffer");
+		writeBytes(&value, sizeof(T));
+	}
+
+	void writeBytes(const void* data, const uint64 size)
+	{
+		const size_t offset = m_data.size();
+		m_data.resize(offset + (size_t)size);
+		if(size > 0)
+		{
+			memcpy(m_data.data() + offset, data, (size_t)size);
+		}
+	}
+
+	void writeString(const string& str)
+	{
+		write<uint32>((uint32)str.size());
+		writeBytes(str.data(), str.size());
+	}
+
+	template<typename T>
+	static T read(const uint8*& cursor)
+	{
+		T value;
+		memcpy(&value, cursor, sizeof(T));
+		cursor += sizeof(T);
+		return value;
+	}
+
+	static string readString(const uint8*& cursor)
+	{
+		const uint32 size = read<uint32>(cursor);
+		string str((const char*)cursor, size);
+		cursor += size;
+		return str;
+	}
+
+	/** Packed commands and their arguments */
+	vector<uint8> m_data;
+	uint32 m_commandCount;
+	const bool m_serializable;
+
+	/** Ids of live device objects when recording a serializable buffer */
+	unordered_map<const void*, uint32> m_objectIds;
+	uint32 m_nextObjectId;
+
+	/** Resources created while executing a serializable buffer, by id */
+	unordered_map<uint32, shared_ptr<void>> m_replayObjects;
+
+	/** Objects referenced by the commands, kept alive until reset() */
+	vector<shared_ptr<void>> m_references;
+	vector<VertexFormat> m_vertexFormats;
+	vector<function<void(GraphicsContext*)>> m_functions;
+	vector<shared_ptr<void>> m_releasedReferences;
+	vector<function<void(GraphicsContext*)>> m_releasedFunctions;
+
+	/** Last state written by setState(), resources by getResourceKey() */
+	struct RecordedState
+	{
+		uint64 texture;
+		uint64 shader;
+		BlendFactor blendFactors[4];
+		uint width;
+		uint height;
+		float projectionMatrix[16];
+		float modelViewMatrix[16];
+	};
+	RecordedState m_recordedState;
+	bool m_hasRecordedState;
+
+	/** Vertex storage reused when replaying draws */
+	VertexArray m_replayVertices;
+	vector<uint32> m_replayIndices;
+};
+
+END_SAUCE_NAMESPACE
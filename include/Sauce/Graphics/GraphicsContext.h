@@ -72,9 +72,19 @@ class SAUCE_API GraphicsContext
 {
 	friend class Game;
 	friend class Window;
+	friend class GraphicsCommandBuffer;
+	friend class ThreadedGraphicsContext;
+	friend class RecordingGraphicsContext;
 
 protected:
 	GraphicsContext();
+
+	/**
+	 * Constructs a context that forwards to \p wrappedContext. The new
+	 * context takes over as the singleton and starts out with a copy of
+	 * the wrapped context's state.
+	 */
+	GraphicsContext(GraphicsContext* wrappedContext);
 	virtual ~GraphicsContext();
 
 	virtual Window* createWindow(const string& title, const int x, const int y, const int w, const int h, const Uint32 flags) = 0;
@@ -314,26 +324,51 @@ public:
 	}
 
 	/**
-	 * Fast way to draw with a temporary vertex array
+	 * Fast way to draw with a temporary vertex array. Same as
+	 * allocateScratchVertices() with the default vertex format.
 	 */
 	VertexArray& getTempVertexArray(const uint32 vertexCount);
 
+	/**
+	 * Draws the primitives batched by the draw*() helpers above. Batches are
+	 * flushed automatically when the state of the context changes, before
+	 * every command below and before textures and shader uniforms are
+	 * modified. Flush explicitly before changing anything the context does
+	 * not see, such as a render state set directly through the backend API.
+	 */
+	void flushBatch();
+
+	/**
+	 * Gets a vertex array of \p vertexCount vertices that stays valid until
+	 * the end of the frame. The storage is reused in later frames, so the
+	 * contents of the vertices are undefined.
+	 * \param vertexCount Number of vertices.
+	 * \param vertexFormat Vertex format of the vertices.
+	 */
+	VertexArray& allocateScratchVertices(const uint32 vertexCount, const VertexFormat& vertexFormat = VertexFormat::s_vtc);
+
+	/**
+	 * Releases all scratch vertex arrays. Called by the engine at the end of
+	 * every frame.
+	 */
+	void resetScratchVertices();
+
 public:
 	/************************************************
-	 *  Pure virtual backend dependent functions    *
+	 *  Backend dependent functions                 *
 	 ************************************************/
 
 	/**
 	 * Enables the capability \p cap.
 	 * \param cap Capability to enable.
 	 */
-	virtual void enable(const Capability cap) = 0;
+	void enable(const Capability cap);
 
 	/**
 	 * Disables the capability \p cap.
 	 * \param cap Capability to disable.
 	 */
-	virtual void disable(const Capability cap) = 0;
+	void disable(const Capability cap);
 
 	/**
 	 * Returns true if capability \p cap is enabled
@@ -343,40 +378,40 @@ public:
 	/**
 	 * Enable scissor testing
 	 */
-	virtual void enableScissor(const int x, const int y, const int w, const int h) = 0;
+	void enableScissor(const int x, const int y, const int w, const int h);
 	
 	/**
 	 * Disable scissor testing
 	 */
-	virtual void disableScissor() = 0;
+	void disableScissor();
 
 	/**
 	 * Set rendering point size
 	 */
-	virtual void setPointSize(const float pointSize) = 0;
+	void setPointSize(const float pointSize);
 	
 	/**
 	 * Set rendering line width
 	 */
-	virtual void setLineWidth(const float lineWidth) = 0;
+	void setLineWidth(const float lineWidth);
 	
 	/**
 	 * Set the size of the viewport
 	 */
-	virtual void setViewportSize(const uint w, const uint h) = 0;
+	void setViewportSize(const uint w, const uint h);
 
 	/**
 	 * Clears the back buffer using \p mask.
 	 * \param mask Decides what channels in the back buffer to clear.
 	 * \param fillColor Decides what value to clear to.
 	 */
-	virtual void clear(const uint32 clearMask, const Color& clearColor = Color(0, 0, 0, 0), const double clearDepth = 1.0, const int32 clearStencil = 0) = 0;
+	void clear(const uint32 clearMask, const Color& clearColor = Color(0, 0, 0, 0), const double clearDepth = 1.0, const int32 clearStencil = 0);
 
 	/**
 	 * Saves a screen shot of the back buffer to \p path as a PNG file.
 	 * \param path Screen shot destination path
 	 */
-	virtual void saveScreenshot(string path) = 0;
+	void saveScreenshot(string path);
 	
 	/**
 	 * Create matricies
@@ -393,7 +428,7 @@ public:
 	 * \param indices Array of indices.
 	 * \param indexCount Number of indices.
 	 */
-	virtual void drawIndexedPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount) = 0;
+	void drawIndexedPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount);
 
 	/**
 	 * Renders an indexed primitive to the screen using vertex and index buffers.
@@ -401,7 +436,19 @@ public:
 	 * \param vbo Vertex buffer object.
 	 * \param ibo Index buffer object.
 	 */
-	virtual void drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer) = 0;
+	void drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer);
+
+	/**
+	 * Renders a range of an index buffer. Lets many draws share one pair of
+	 * buffers that is uploaded once.
+	 * \param type Types of primitives to render.
+	 * \param vbo Vertex buffer object.
+	 * \param ibo Index buffer object.
+	 * \param firstIndex Position of the first index to render in the index buffer.
+	 * \param indexCount Number of indices to render.
+	 * \param baseVertex Value added to every index before vertices are fetched.
+	 */
+	void drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex);
 
 	/**
 	 * Renders primitives to the screen.
@@ -409,16 +456,68 @@ public:
 	 * \param vertices Array of vertices to render.
 	 * \param vertexCount Number of vertices to render.
 	 */
-	virtual void drawPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount) = 0;
+	void drawPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount);
 
 	/**
 	 * Renders primitives to the screen.
 	 * \param type Types of primitives to render.
 	 * \param vbo Vertex buffer object.
 	 */
-	virtual void drawPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer) = 0;
+	void drawPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer);
+
+	/**
+	 * GPU profiling. Scopes can be nested. Backends that support timer queries
+	 * report the scopes to the Profiler once their results are available,
+	 * which is a few frames after they were recorded.
+	 * Use GPUProfileScope/PROFILE_GPU_SCOPE rather than calling these directly.
+	 */
+	virtual void beginProfileScope(const char* name) { }
+	virtual void endProfileScope() { }
+
+	/**
+	 * Called once per frame after presenting to collect finished GPU scopes.
+	 */
+	virtual void resolveProfileScopes() { }
+
+	/**
+	 * Presents the back buffer.
+	 */
+	void swapBuffers();
+
+	/**
+	 * Sets the number of vertical blanks to wait between buffer swaps.
+	 * 0 disables vsync, 1 enables it and -1 requests adaptive vsync.
+	 */
+	virtual void setSwapInterval(const int interval) = 0;
+
+	/**
+	 * Binds/unbinds the context to the calling thread. A context can only be
+	 * current on one thread at a time.
+	 */
+	virtual void makeCurrent() { }
+	virtual void doneCurrent() { }
 
 protected:
+	/**
+	 * Backend implementations of the commands above. The commands flush the
+	 * primitive batch before calling these.
+	 */
+	virtual void enableImpl(const Capability cap) = 0;
+	virtual void disableImpl(const Capability cap) = 0;
+	virtual void enableScissorImpl(const int x, const int y, const int w, const int h) = 0;
+	virtual void disableScissorImpl() = 0;
+	virtual void setPointSizeImpl(const float pointSize) = 0;
+	virtual void setLineWidthImpl(const float lineWidth) = 0;
+	virtual void setViewportSizeImpl(const uint w, const uint h) = 0;
+	virtual void clearImpl(const uint32 clearMask, const Color& clearColor, const double clearDepth, const int32 clearStencil) = 0;
+	virtual void saveScreenshotImpl(string path) = 0;
+	virtual void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount) = 0;
+	virtual void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer) = 0;
+	virtual void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex) = 0;
+	virtual void drawPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount) = 0;
+	virtual void drawPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer) = 0;
+	virtual void swapBuffersImpl() = 0;
+
 	/**
 	 * Texture2D internal API
 	 */
@@ -426,12 +525,18 @@ protected:
 	void texture2D_getDeviceObject(Texture2DRef texture, Texture2DDeviceObject*& outShaderDeviceObject);
 	virtual void texture2D_createDeviceObject(Texture2DDeviceObject*& textureDeviceObject, const string& deviceObjectName) = 0;
 	virtual void texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject) = 0;
-	virtual void texture2D_copyToGPU(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData) = 0;
-	virtual void texture2D_copyToCPUReadable(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData) = 0;
-	virtual void texture2D_updateSubregion(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData) = 0;
-	virtual void texture2D_updateFiltering(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering) = 0;
-	virtual void texture2D_updateWrapping(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping) = 0;
-	virtual void texture2D_clearTexture(Texture2DDeviceObject* textureDeviceObject) = 0;
+	void texture2D_copyToGPU(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData);
+	virtual void texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData) = 0;
+	void texture2D_copyToCPUReadable(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData);
+	virtual void texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData) = 0;
+	void texture2D_updateSubregion(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData);
+	virtual void texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData) = 0;
+	void texture2D_updateFiltering(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering);
+	virtual void texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering) = 0;
+	void texture2D_updateWrapping(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping);
+	virtual void texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping) = 0;
+	void texture2D_clearTexture(Texture2DDeviceObject* textureDeviceObject);
+	virtual void texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObject) = 0;
 	
 	/**
 	 * Shader internal API
@@ -441,8 +546,11 @@ protected:
 	virtual void shader_createDeviceObject(ShaderDeviceObject*& shaderDeviceObject, const string& deviceObjectName) = 0;
 	virtual void shader_destroyDeviceObject(ShaderDeviceObject*& shaderDeviceObject) = 0;
 	virtual void shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource) = 0;
-	virtual void shader_setUniform(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data) = 0;
-	virtual void shader_setSampler2D(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture) = 0;
+	void shader_setUniform(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data);
+	virtual void shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data) = 0;
+	void shader_setSampler2D(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture);
+	virtual void shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture) = 0;
+	virtual uint32 shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObject, const string& uniformName) = 0;
 
 	/**
 	 * RenderTarget2D internal API
@@ -483,8 +591,27 @@ protected:
 	stack<State> m_stateStack;
 	State* m_currentState;
 
-	/** We keep a list of vertices for when we might need it */
-	VertexArray m_tempVertices;
+	/**
+	 * Reserves \p vertexCount vertices of \p type in the primitive batch,
+	 * flushing the batch first if it holds a different primitive type.
+	 */
+	VertexPosColorUV* appendToBatch(const PrimitiveType type, const uint32 vertexCount);
+
+	/** Gets the points of a circle of radius 1 divided into \p segments segments, segments + 1 in total */
+	const Vector2F* getUnitCircle(const uint segments);
+
+	/** Primitive batch for the draw*() helpers */
+	static const uint32 MaxBatchVertexCount = 65536;
+	VertexArrayT<VertexPosColorUV> m_batchVertices;
+	PrimitiveType m_batchPrimitiveType;
+	uint32 m_batchVertexCount;
+
+	/** Unit circle points by segment count */
+	unordered_map<uint, vector<Vector2F>> m_unitCircles;
+
+	/** Per frame scratch vertex arrays, see allocateScratchVertices() */
+	vector<unique_ptr<VertexArray>> m_scratchVertices;
+	uint32 m_scratchVertexArrayCount;
 
 	static ShaderRef s_defaultShader;
 	static Texture2DRef s_defaultTexture;
@@ -0,0 +1,124 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Common.h>
+#include <Sauce/Graphics/GraphicsContext.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * \class	NullGraphicsContext
+ *
+ * \brief	A graphics backend that does not talk to a GPU.
+ *
+ * Device objects only keep their CPU-side bookkeeping (sizes, formats and
+ * texture pixels, so that readbacks still work) and draw calls are counted
+ * and dropped. Used for headless runs, servers and CPU benchmarks.
+ */
+class SAUCE_API NullGraphicsContext final : public GraphicsContext
+{
+	friend class Game;
+private:
+	/**
+	 * Creates a context with a \p width x \p height back buffer. Creating
+	 * a window is optional.
+	 */
+	NullGraphicsContext(const uint width, const uint height);
+	~NullGraphicsContext();
+
+public:
+	bool isEnabled(const Capability cap) override;
+
+	Matrix4 createOrtographicMatrix(const float left, const float right, const float top, const float bottom, const float n = -1.0f, const float f = 1.0f) const override;
+	Matrix4 createPerspectiveMatrix(const float fov, const float aspectRatio, const float zNear, const float zFar) const override;
+	Matrix4 createLookAtMatrix(const Vector3F &position, const Vector3F &fwd) const override;
+
+	void setSwapInterval(const int interval) override;
+
+	/**
+	 * Counters since the context was created
+	 */
+	uint64 getFrameCount() const { return m_frameCount; }
+	uint64 getDrawCallCount() const { return m_drawCallCount; }
+	uint64 getVertexCount() const { return m_vertexCount; }
+	uint32 getDeviceObjectCount() const { return m_deviceObjectCount; }
+
+protected:
+	void enableImpl(const Capability cap) override;
+	void disableImpl(const Capability cap) override;
+	void enableScissorImpl(const int x, const int y, const int w, const int h) override;
+	void disableScissorImpl() override;
+	void setPointSizeImpl(const float pointSize) override;
+	void setLineWidthImpl(const float lineWidth) override;
+	void setViewportSizeImpl(const uint w, const uint h) override;
+	void clearImpl(const uint32 clearMask, const Color &clearColor, const double clearDepth, const int32 clearStencil) override;
+	void saveScreenshotImpl(string filePath) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex) override;
+	void drawPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount) override;
+	void drawPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer) override;
+	void swapBuffersImpl() override;
+
+	/**
+	 * Texture2D internal API
+	 */
+	void texture2D_createDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject, const string& deviceObjectName) override;
+	void texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject) override;
+	void texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData) override;
+	void texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData) override;
+	void texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData) override;
+	void texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering) override;
+	void texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping) override;
+	void texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObject) override;
+
+	/**
+	 * Shader internal API
+	 */
+	void shader_createDeviceObject(ShaderDeviceObject*& outShaderDeviceObject, const string& deviceObjectName) override;
+	void shader_destroyDeviceObject(ShaderDeviceObject*& outShaderDeviceObject) override;
+	void shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource) override;
+	void shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data) override;
+	void shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture) override;
+	uint32 shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObject, const string& uniformName) override;
+
+	/**
+	 * RenderTarget2D internal API
+	 */
+	void renderTarget2D_createDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject, const string& deviceObjectName) override;
+	void renderTarget2D_destroyDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject) override;
+	void renderTarget2D_initializeRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject, const Texture2DRef* targetTextures, const uint32 targetCount) override;
+	void renderTarget2D_bindRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject) override;
+
+	/**
+	 * VertexBuffer internal API
+	 */
+	void vertexBuffer_createDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject, const string& deviceObjectName) override;
+	void vertexBuffer_destroyDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject) override;
+	void vertexBuffer_initializeVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const BufferUsage bufferUsage, const VertexArray& vertices, const uint32 vertexCount) override;
+	void vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const uint32 startIndex, const VertexArray& vertices, const uint32 vertexCount) override;
+	void vertexBuffer_bindVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject) override;
+
+	/**
+	 * IndexBuffer internal API
+	 */
+	void indexBuffer_createDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject, const string& deviceObjectName) override;
+	void indexBuffer_destroyDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject) override;
+	void indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const BufferUsage bufferUsage, const uint32* indices, const uint32 indexCount) override;
+	void indexBuffer_modifyIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const uint32 startIndex, const uint32* indices, const uint32 indexCount) override;
+	void indexBuffer_bindIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject) override;
+
+private:
+	Window *createWindow(const string &title, const int x, const int y, const int w, const int h, const Uint32 flags) override;
+
+	uint32 m_enabledCapabilities;
+	uint64 m_frameCount;
+	uint64 m_drawCallCount;
+	uint64 m_vertexCount;
+	uint32 m_deviceObjectCount;
+};
+
+END_SAUCE_NAMESPACE
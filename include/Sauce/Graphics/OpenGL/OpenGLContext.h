@@ -29,43 +29,50 @@ private:
 	void setupVertexAttributePointers(const VertexFormat& fmt);
 
 public:
-	void enable(const Capability cap) override;
-	void disable(const Capability cap) override;
 	bool isEnabled(const Capability cap) override;
 
-	void enableScissor(const int x, const int y, const int w, const int h) override;
-	void disableScissor() override;
-
-	void setPointSize(const float pointSize) override;
-	void setLineWidth(const float lineWidth) override;
-	void setViewportSize(const uint w, const uint h) override;
-	void clear(const uint32 clearMask, const Color &clearColor, const double clearDepth, const int32 clearStencil) override;
-
-	void saveScreenshot(string filePath) override;
-
 	Matrix4 createOrtographicMatrix(const float left, const float right, const float top, const float bottom, const float n = -1.0f, const float f = 1.0f) const override;
 	Matrix4 createPerspectiveMatrix(const float fov, const float aspectRatio, const float zNear, const float zFar) const override;
 	Matrix4 createLookAtMatrix(const Vector3F &position, const Vector3F &fwd) const override;
 
-	void drawIndexedPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount) override;
-	void drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer) override;
-	void drawPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount) override;
-	void drawPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer) override;
+	void beginProfileScope(const char* name) override;
+	void endProfileScope() override;
+	void resolveProfileScopes() override;
+
+	void setSwapInterval(const int interval) override;
+	void makeCurrent() override;
+	void doneCurrent() override;
 
 	string getGLSLVersion() const;
 
 protected:
+	void enableImpl(const Capability cap) override;
+	void disableImpl(const Capability cap) override;
+	void enableScissorImpl(const int x, const int y, const int w, const int h) override;
+	void disableScissorImpl() override;
+	void setPointSizeImpl(const float pointSize) override;
+	void setLineWidthImpl(const float lineWidth) override;
+	void setViewportSizeImpl(const uint w, const uint h) override;
+	void clearImpl(const uint32 clearMask, const Color &clearColor, const double clearDepth, const int32 clearStencil) override;
+	void saveScreenshotImpl(string filePath) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex) override;
+	void drawPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount) override;
+	void drawPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer) override;
+	void swapBuffersImpl() override;
+
 	/**
 	 * Texture2D internal API
 	 */
 	void texture2D_createDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject, const string& deviceObjectName) override;
 	void texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject) override;
-	void texture2D_copyToGPU(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData) override;
-	void texture2D_copyToCPUReadable(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData) override;
-	void texture2D_updateSubregion(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData) override;
-	void texture2D_updateFiltering(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering) override;
-	void texture2D_updateWrapping(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping) override;
-	void texture2D_clearTexture(Texture2DDeviceObject* textureDeviceObject) override;
+	void texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData) override;
+	void texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData) override;
+	void texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData) override;
+	void texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering) override;
+	void texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping) override;
+	void texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObject) override;
 
 	/**
 	 * Shader internal API
@@ -73,8 +80,9 @@ protected:
 	void shader_createDeviceObject(ShaderDeviceObject*& outShaderDeviceObject, const string& deviceObjectName) override;
 	void shader_destroyDeviceObject(ShaderDeviceObject*& outShaderDeviceObject) override;
 	void shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource) override;
-	void shader_setUniform(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data) override;
-	void shader_setSampler2D(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture) override;
+	void shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data) override;
+	void shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture) override;
+	uint32 shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObject, const string& uniformName) override;
 
 	/**
 	 * RenderTarget2D internal API
@@ -104,8 +112,36 @@ protected:
 
 private:
 	Window *createWindow(const string &title, const int x, const int y, const int w, const int h, const Uint32 flags);
+	void beginProfileFrame();
 
 	const int m_majorVersion, m_minorVersion;
+
+	/**
+	 * GPU profiling using GL_TIMESTAMP queries. Frames are kept in a ring
+	 * so results are read back ProfileFrameCount - 1 frames later without
+	 * stalling the pipeline.
+	 */
+	struct ProfileQuery
+	{
+		const char* name;
+		uint32 beginQuery;
+		uint32 endQuery;
+		uint32 depth;
+	};
+
+	struct ProfileFrame
+	{
+		vector<ProfileQuery> queries;
+		vector<uint32> queryPool;
+		uint32 usedQueryCount = 0;
+		int64 gpuToCpuTicks = 0;
+	};
+
+	static const uint32 ProfileFrameCount = 3;
+	ProfileFrame m_profileFrames[ProfileFrameCount];
+	uint32 m_profileFrameIndex;
+	vector<uint32> m_openProfileScopes;
+	bool m_timerQueriesSupported;
 };
 
 END_SAUCE_NAMESPACE
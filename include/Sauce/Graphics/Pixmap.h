@@ -64,7 +64,8 @@ public:
 	Pixmap(Pixmap&& other) noexcept;
 	~Pixmap();
 
-	Pixmap &operator=(Pixmap &other);
+	Pixmap &operator=(const Pixmap &other);
+	Pixmap &operator=(Pixmap &&other) noexcept;
 
 	uint getWidth() const;
 	uint getHeight() const;
@@ -73,6 +74,7 @@ public:
 
 	void getPixel(const uint x, const uint y, void *data) const;
 	void setPixel(const uint x, const uint y, const void *data);
+	void setPixels(const uint x, const uint y, const Pixmap &pixmap);
 
 	void flipY();
 
@@ -86,6 +88,12 @@ public:
 	void saveToFile(string path) const;
 	static Pixmap loadFromFile(const string& imageFile);
 
+	/**
+	 * Reads a serialized pixmap without copying its pixels. outPixels points
+	 * into the stream's memory and is only valid while the stream is open.
+	 */
+	static bool readView(ByteStreamIn& in, uint& outWidth, uint& outHeight, PixelFormat& outFormat, util::FileSpan& outPixels);
+
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const Pixmap& pixmap);
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, Pixmap& pixmap);
 
@@ -0,0 +1,205 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Graphics/GraphicsContext.h>
+#include <Sauce/Graphics/GraphicsCommandBuffer.h>
+#include <Sauce/Utils/FileSystemUtils.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * \brief	Graphics capture file layout
+ *
+ * [GraphicsCaptureHeader][GraphicsCaptureFrame][frame commands]...
+ *
+ * Each frame holds the commands recorded between two swapBuffers() calls
+ * as written by a serializable GraphicsCommandBuffer. Frames depend on the
+ * objects and vertex formats defined by the frames before them, so a
+ * capture must be replayed from the start.
+ */
+struct GraphicsCaptureHeader
+{
+	uint32 magic;
+	uint32 version;
+};
+
+struct GraphicsCaptureFrame
+{
+	uint32 commandCount;
+	uint32 reserved;
+	uint64 size;
+};
+
+/**
+ * \class	RecordingGraphicsContext
+ *
+ * \brief	Forwards every call to a graphics backend and writes them to a capture file.
+ *
+ * State changes, resource creation, uploads (with their data) and draws
+ * are recorded. Only resources created after the recording context was
+ * installed can be referred to by the capture.
+ */
+class SAUCE_API RecordingGraphicsContext final : public GraphicsContext
+{
+	friend class Game;
+private:
+	/**
+	 * Takes ownership of \p backend, which must already have created its window.
+	 */
+	RecordingGraphicsContext(GraphicsContext* backend, const string& captureFilePath);
+	~RecordingGraphicsContext();
+
+public:
+	static const uint32 Magic = 0x50434753; // "SGCP"
+	static const uint32 Version = 2;
+
+	bool isRecording() const { return m_fileStream.is_open(); }
+	uint32 getFrameCount() const { return m_frameCount; }
+
+	GraphicsContext* getBackend() const { return m_backend; }
+
+	bool isEnabled(const Capability cap) override;
+
+	Matrix4 createOrtographicMatrix(const float left, const float right, const float top, const float bottom, const float n = -1.0f, const float f = 1.0f) const override;
+	Matrix4 createPerspectiveMatrix(const float fov, const float aspectRatio, const float zNear, const float zFar) const override;
+	Matrix4 createLookAtMatrix(const Vector3F &position, const Vector3F &fwd) const override;
+
+	void beginProfileScope(const char* name) override;
+	void endProfileScope() override;
+	void resolveProfileScopes() override;
+
+	void setSwapInterval(const int interval) override;
+	void makeCurrent() override;
+	void doneCurrent() override;
+
+protected:
+	void enableImpl(const Capability cap) override;
+	void disableImpl(const Capability cap) override;
+	void enableScissorImpl(const int x, const int y, const int w, const int h) override;
+	void disableScissorImpl() override;
+	void setPointSizeImpl(const float pointSize) override;
+	void setLineWidthImpl(const float lineWidth) override;
+	void setViewportSizeImpl(const uint w, const uint h) override;
+	void clearImpl(const uint32 clearMask, const Color &clearColor, const double clearDepth, const int32 clearStencil) override;
+	void saveScreenshotImpl(string filePath) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex) override;
+	void drawPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount) override;
+	void drawPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer) override;
+	void swapBuffersImpl() override;
+
+	/**
+	 * Texture2D internal API
+	 */
+	void texture2D_createDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject, const string& deviceObjectName) override;
+	void texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject) override;
+	void texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData) override;
+	void texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData) override;
+	void texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData) override;
+	void texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering) override;
+	void texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping) override;
+	void texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObject) override;
+
+	/**
+	 * Shader internal API
+	 */
+	void shader_createDeviceObject(ShaderDeviceObject*& outShaderDeviceObject, const string& deviceObjectName) override;
+	void shader_destroyDeviceObject(ShaderDeviceObject*& outShaderDeviceObject) override;
+	void shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource) override;
+	void shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data) override;
+	void shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture) override;
+	uint32 shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObject, const string& uniformName) override;
+
+	/**
+	 * RenderTarget2D internal API
+	 */
+	void renderTarget2D_createDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject, const string& deviceObjectName) override;
+	void renderTarget2D_destroyDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject) override;
+	void renderTarget2D_initializeRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject, const Texture2DRef* targetTextures, const uint32 targetCount) override;
+	void renderTarget2D_bindRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject) override;
+
+	/**
+	 * VertexBuffer internal API
+	 */
+	void vertexBuffer_createDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject, const string& deviceObjectName) override;
+	void vertexBuffer_destroyDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject) override;
+	void vertexBuffer_initializeVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const BufferUsage bufferUsage, const VertexArray& vertices, const uint32 vertexCount) override;
+	void vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const uint32 startIndex, const VertexArray& vertices, const uint32 vertexCount) override;
+	void vertexBuffer_bindVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject) override;
+
+	/**
+	 * IndexBuffer internal API
+	 */
+	void indexBuffer_createDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject, const string& deviceObjectName) override;
+	void indexBuffer_destroyDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject) override;
+	void indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const BufferUsage bufferUsage, const uint32* indices, const uint32 indexCount) override;
+	void indexBuffer_modifyIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const uint32 startIndex, const uint32* indices, const uint32 indexCount) override;
+	void indexBuffer_bindIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject) override;
+
+private:
+	Window *createWindow(const string &title, const int x, const int y, const int w, const int h, const Uint32 flags) override;
+
+	/**
+	 * Appends the commands recorded since the last call as one frame.
+	 */
+	void writeFrame();
+
+	GraphicsContext* m_backend;
+	GraphicsCommandBuffer m_commandBuffer;
+	ofstream m_fileStream;
+	uint32 m_frameCount;
+};
+
+/**
+ * \class	GraphicsCaptureReplayer
+ *
+ * \brief	Replays a capture written by RecordingGraphicsContext on any graphics context.
+ *
+ * Passing a null context executes nothing and only gathers statistics,
+ * which makes it possible to check the draw traffic of a capture without
+ * a GPU.
+ */
+class SAUCE_API GraphicsCaptureReplayer
+{
+public:
+	GraphicsCaptureReplayer();
+	~GraphicsCaptureReplayer();
+
+	GraphicsCaptureReplayer(const GraphicsCaptureReplayer&) = delete;
+	GraphicsCaptureReplayer& operator=(const GraphicsCaptureReplayer&) = delete;
+
+	bool open(const string& filePath);
+	void close();
+	bool isOpen() const { return m_mappedFile.isOpen(); }
+
+	/**
+	 * \fn	bool GraphicsCaptureReplayer::replayFrame(GraphicsContext* context, GraphicsCommandStatistics* outStatistics = nullptr);
+	 *
+	 * \brief	Executes the next frame of the capture on \p context.
+	 *
+	 * \return	False if there are no frames left or the capture is truncated.
+	 */
+	bool replayFrame(GraphicsContext* context, GraphicsCommandStatistics* outStatistics = nullptr);
+
+	/**
+	 * \fn	bool GraphicsCaptureReplayer::replay(GraphicsContext* context, vector<GraphicsCommandStatistics>* outFrameStatistics = nullptr);
+	 *
+	 * \brief	Executes every remaining frame of the capture, optionally collecting statistics per frame.
+	 */
+	bool replay(GraphicsContext* context, vector<GraphicsCommandStatistics>* outFrameStatistics = nullptr);
+
+	uint32 getFrameIndex() const { return m_frameIndex; }
+	bool isAtEnd() const { return m_readOffset >= m_mappedFile.getSize(); }
+
+private:
+	util::MappedFile m_mappedFile;
+	unique_ptr<GraphicsCommandBuffer> m_commandBuffer;
+	uint64 m_readOffset;
+	uint32 m_frameIndex;
+};
+
+END_SAUCE_NAMESPACE
@@ -31,6 +31,7 @@ struct SAUCE_API RenderTarget2DDesc : public GraphicsDeviceObjectDesc
 class SAUCE_API RenderTarget2D final : public SauceObject
 {
 	friend class GraphicsContext;
+	friend class GraphicsCommandBuffer;
 public:
 	SAUCE_REF_TYPE(RenderTarget2D);
 
@@ -28,6 +28,7 @@ struct SAUCE_API ShaderDesc : public GraphicsDeviceObjectDesc
 class SAUCE_API Shader final : public SauceObject
 {
 	friend class GraphicsContext;
+	friend class GraphicsCommandBuffer;
 	friend class ResourceManager;
 public:
 	SAUCE_REF_TYPE(Shader);
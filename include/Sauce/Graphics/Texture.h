@@ -44,12 +44,18 @@ struct SAUCE_API Texture2DDesc : public GraphicsDeviceObjectDesc
 	TextureFiltering filtering = TextureFiltering::Nearest;
 	TextureWrapping  wrapping  = TextureWrapping::ClampToEdge;
 	bool             mipmaps   = false;
+
+	/** Keep a CPU copy of the pixels so that getPixmap() and serialization
+	    do not have to read the texture back from the GPU. The copy does not
+	    see changes made by rendering to the texture. */
+	bool             retainPixmap = false;
 };
 
 class SAUCE_API Texture2D final : public SauceObject
 {
 	friend class RenderTarget2D;
 	friend class GraphicsContext;
+	friend class GraphicsCommandBuffer;
 	friend class Shader;
 public:
 	SAUCE_REF_TYPE(Texture2D);
@@ -85,8 +91,12 @@ public:
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, Texture2DRef& texture);
 
 private:
+	void uploadPixels(const PixelFormat& format, const uint32 width, const uint32 height, const uint8* data);
+
 	GraphicsContext* m_graphicsContext;
 	Texture2DDeviceObject* m_deviceObject;
+	bool m_retainPixmap;
+	Pixmap m_retainedPixmap;
 };
 SAUCE_REF_TYPE_TYPEDEFS(Texture2D);
 
@@ -0,0 +1,166 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Graphics/GraphicsContext.h>
+#include <Sauce/Graphics/GraphicsCommandBuffer.h>
+#include <condition_variable>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * \class	ThreadedGraphicsContext
+ *
+ * \brief	Runs a graphics backend on a dedicated render thread.
+ *
+ * Calls made on the game thread are recorded into one of two command
+ * buffers. swapBuffers() hands the recorded frame to the render thread and
+ * continues recording the next frame into the other buffer, so the game
+ * thread is never more than one frame ahead of the GPU submission.
+ *
+ * Creating device objects, compiling shaders and reading textures back to
+ * the CPU need results from the backend; these calls flush the recorded
+ * commands and wait for the render thread to execute them.
+ */
+class SAUCE_API ThreadedGraphicsContext final : public GraphicsContext
+{
+	friend class Game;
+private:
+	/**
+	 * Takes ownership of \p backend, which must already have created its
+	 * window. The backend is released from the calling thread and made
+	 * current on the render thread.
+	 */
+	ThreadedGraphicsContext(GraphicsContext* backend);
+	~ThreadedGraphicsContext();
+
+public:
+	/**
+	 * Blocks until the render thread has executed every command recorded so far.
+	 */
+	void synchronize();
+
+	GraphicsContext* getBackend() const { return m_backend; }
+
+	bool isEnabled(const Capability cap) override;
+
+	Matrix4 createOrtographicMatrix(const float left, const float right, const float top, const float bottom, const float n = -1.0f, const float f = 1.0f) const override;
+	Matrix4 createPerspectiveMatrix(const float fov, const float aspectRatio, const float zNear, const float zFar) const override;
+	Matrix4 createLookAtMatrix(const Vector3F &position, const Vector3F &fwd) const override;
+
+	void beginProfileScope(const char* name) override;
+	void endProfileScope() override;
+	void resolveProfileScopes() override;
+
+	void setSwapInterval(const int interval) override;
+
+protected:
+	void enableImpl(const Capability cap) override;
+	void disableImpl(const Capability cap) override;
+	void enableScissorImpl(const int x, const int y, const int w, const int h) override;
+	void disableScissorImpl() override;
+	void setPointSizeImpl(const float pointSize) override;
+	void setLineWidthImpl(const float lineWidth) override;
+	void setViewportSizeImpl(const uint w, const uint h) override;
+	void clearImpl(const uint32 clearMask, const Color &clearColor, const double clearDepth, const int32 clearStencil) override;
+	void saveScreenshotImpl(string filePath) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer) override;
+	void drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex) override;
+	void drawPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount) override;
+	void drawPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer) override;
+	void swapBuffersImpl() override;
+
+	/**
+	 * Texture2D internal API
+	 */
+	void texture2D_createDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject, const string& deviceObjectName) override;
+	void texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject) override;
+	void texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData) override;
+	void texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData) override;
+	void texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData) override;
+	void texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering) override;
+	void texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping) override;
+	void texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObject) override;
+
+	/**
+	 * Shader internal API
+	 */
+	void shader_createDeviceObject(ShaderDeviceObject*& outShaderDeviceObject, const string& deviceObjectName) override;
+	void shader_destroyDeviceObject(ShaderDeviceObject*& outShaderDeviceObject) override;
+	void shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource) override;
+	void shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data) override;
+	void shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture) override;
+	uint32 shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObject, const string& uniformName) override;
+
+	/**
+	 * RenderTarget2D internal API
+	 */
+	void renderTarget2D_createDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject, const string& deviceObjectName) override;
+	void renderTarget2D_destroyDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject) override;
+	void renderTarget2D_initializeRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject, const Texture2DRef* targetTextures, const uint32 targetCount) override;
+	void renderTarget2D_bindRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject) override;
+
+	/**
+	 * VertexBuffer internal API
+	 */
+	void vertexBuffer_createDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject, const string& deviceObjectName) override;
+	void vertexBuffer_destroyDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject) override;
+	void vertexBuffer_initializeVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const BufferUsage bufferUsage, const VertexArray& vertices, const uint32 vertexCount) override;
+	void vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const uint32 startIndex, const VertexArray& vertices, const uint32 vertexCount) override;
+	void vertexBuffer_bindVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject) override;
+
+	/**
+	 * IndexBuffer internal API
+	 */
+	void indexBuffer_createDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject, const string& deviceObjectName) override;
+	void indexBuffer_destroyDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject) override;
+	void indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const BufferUsage bufferUsage, const uint32* indices, const uint32 indexCount) override;
+	void indexBuffer_modifyIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const uint32 startIndex, const uint32* indices, const uint32 indexCount) override;
+	void indexBuffer_bindIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject) override;
+
+private:
+	Window *createWindow(const string &title, const int x, const int y, const int w, const int h, const Uint32 flags) override;
+
+	/**
+	 * Returns true if the caller should call the backend directly instead of
+	 * recording. This is the case on the render thread itself (e.g. when a
+	 * resource is released during replay) and when the thread is not running.
+	 */
+	bool isImmediate() const;
+
+	/**
+	 * Hands the recording buffer to the render thread once it has finished
+	 * the previous one, and starts recording into the other buffer.
+	 */
+	void submit(const bool present);
+
+	/**
+	 * Records \p func and blocks until the render thread has executed it.
+	 */
+	void invokeAndWait(function<void(GraphicsContext*)> func);
+
+	void run();
+
+	GraphicsContext* m_backend;
+
+	/** Capabilities enabled through this context */
+	uint32 m_enabledCapabilities;
+
+	GraphicsCommandBuffer m_commandBuffers[2];
+	uint32 m_recordIndex;
+
+	thread m_thread;
+	bool m_running;
+
+	/** Guarded by m_mutex */
+	mutex m_mutex;
+	condition_variable m_condition;
+	GraphicsCommandBuffer* m_submittedBuffer;
+	bool m_submittedPresent;
+	bool m_quit;
+};
+
+END_SAUCE_NAMESPACE
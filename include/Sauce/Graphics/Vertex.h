@@ -20,6 +20,47 @@ enum class VertexAttribute : uint32
 	Max
 };
 
+/*********************************************************************
+**	Vertex elements													**
+**********************************************************************/
+
+/**
+ * \brief	Maps the type of a vertex struct member to the element count and
+ *			datatype of a vertex attribute.
+ */
+template<typename T> struct VertexElementTraits;
+
+template<> struct VertexElementTraits<float>  { static const int ElementCount = 1; static const Datatype Type = Datatype::Float; };
+template<> struct VertexElementTraits<uint32> { static const int ElementCount = 1; static const Datatype Type = Datatype::Uint32; };
+template<> struct VertexElementTraits<int32>  { static const int ElementCount = 1; static const Datatype Type = Datatype::Int32; };
+template<> struct VertexElementTraits<uint16> { static const int ElementCount = 1; static const Datatype Type = Datatype::Uint16; };
+template<> struct VertexElementTraits<int16>  { static const int ElementCount = 1; static const Datatype Type = Datatype::Int16; };
+template<> struct VertexElementTraits<uint8>  { static const int ElementCount = 1; static const Datatype Type = Datatype::Uint8; };
+template<> struct VertexElementTraits<int8>   { static const int ElementCount = 1; static const Datatype Type = Datatype::Int8; };
+
+template<typename T> struct VertexElementTraits<Vector2<T>> { static const int ElementCount = 2; static const Datatype Type = VertexElementTraits<T>::Type; };
+template<typename T> struct VertexElementTraits<Vector3<T>> { static const int ElementCount = 3; static const Datatype Type = VertexElementTraits<T>::Type; };
+template<typename T> struct VertexElementTraits<Vector4<T>> { static const int ElementCount = 4; static const Datatype Type = VertexElementTraits<T>::Type; };
+template<> struct VertexElementTraits<Color> { static const int ElementCount = 4; static const Datatype Type = Datatype::Uint8; };
+template<typename T, size_t N> struct VertexElementTraits<T[N]> { static const int ElementCount = (int)N; static const Datatype Type = VertexElementTraits<T>::Type; };
+
+/**
+ * \brief	Describes the member of a vertex struct that holds a vertex attribute.
+ */
+struct VertexElement
+{
+	VertexAttribute attribute;
+	int elementCount;
+	Datatype datatype;
+	uint offset;
+};
+
+#define SAUCE_VERTEX_ELEMENT(VertexType, member, vertexAttribute) \
+	sauce::VertexElement { vertexAttribute, \
+		sauce::VertexElementTraits<decltype(VertexType::member)>::ElementCount, \
+		sauce::VertexElementTraits<decltype(VertexType::member)>::Type, \
+		(uint)offsetof(VertexType, member) }
+
 /*********************************************************************
 **	Vertex format													**
 **********************************************************************/
@@ -44,11 +85,33 @@ public:
 	uint getAttributeOffset(const VertexAttribute attrib) const;
 	
 	VertexArray createVertices(const uint32 count) const;
+
+	/**
+	 * \fn	template<typename T> static VertexFormat VertexFormat::FromElements(initializer_list<VertexElement> elements);
+	 *
+	 * \brief	Creates the vertex format of the vertex struct T from a description
+	 *			of its members, see SAUCE_VERTEX_ELEMENT. Attributes are packed in
+	 *			VertexAttribute order, so the members of T must be declared in that
+	 *			order without padding. Throws if the layout does not match.
+	 */
+	template<typename T>
+	static VertexFormat FromElements(initializer_list<VertexElement> elements)
+	{
+		VertexFormat vertexFormat;
+		for(const VertexElement &element : elements)
+		{
+			vertexFormat.set(element.attribute, element.elementCount, element.datatype);
+		}
+		vertexFormat.validateElements(elements, sizeof(T));
+		return vertexFormat;
+	}
 	
 	VertexFormat &operator=(const VertexFormat &other);
 	bool operator==(const VertexFormat &other);
 
 private:
+	void validateElements(initializer_list<VertexElement> elements, const uint vertexSize) const;
+
 	// Default vertex format: position, color, texture coord
 	static VertexFormat s_vtc;
 
@@ -84,6 +147,7 @@ class SAUCE_API Vertex
 
 private:
 	Vertex();
+	Vertex(uint8 *vertexData, const VertexFormat *vertexFormat);
 
 public:
 
@@ -123,7 +187,7 @@ public:
 
 private:
 	uint8* m_vertexData;
-	VertexFormat m_vertexFormat;
+	const VertexFormat* m_vertexFormat;
 };
 
 /*********************************************************************
@@ -141,14 +205,37 @@ public:
 
 	VertexArray& operator=(VertexArray&) = delete;
 	VertexArray& operator=(VertexArray&& other) noexcept;
-	Vertex& operator[](const uint32 index);
+	Vertex operator[](const uint32 index);
 
 	uint32 getVertexCount() const;
+	uint32 getVertexCapacity() const;
 	VertexFormat getVertexFormat() const;
 	uint8* getVertexData() const; // TODO: Should probably be "lockVertexData" when multithreading if multithreading is introduced
 	uint32 getVertexDataSize() const;
 
+	/**
+	 * \fn	void VertexArray::resize(const uint32 newVertexCount);
+	 *
+	 * \brief	Sets the vertex count. Storage grows geometrically and is never
+	 *			shrunk. Vertices in newly allocated storage are zeroed, vertices
+	 *			that were in use before keep their data.
+	 */
 	void resize(const uint32 newVertexCount);
+	void reserve(const uint32 vertexCapacity);
+
+	/**
+	 * \fn	void VertexArray::clear();
+	 *
+	 * \brief	Sets the vertex count to zero, keeping the storage for reuse.
+	 */
+	void clear();
+
+	/**
+	 * \fn	void VertexArray::setVertexFormat(const VertexFormat& vertexFormat);
+	 *
+	 * \brief	Changes the vertex format of a cleared array, keeping its storage.
+	 */
+	void setVertexFormat(const VertexFormat& vertexFormat);
 	VertexArray makeCopy() const;
 
 	string toString() const;
@@ -158,7 +245,121 @@ private:
 	uint32       m_vertexCapacity;
 	VertexFormat m_vertexFormat;
 	uint8*       m_vertexArrayData;
-	Vertex*      m_vertexHandlesCache;
 };
 
+/*********************************************************************
+**	VertexArrayT													**
+**********************************************************************/
+
+/**
+ * \class	VertexArrayT
+ *
+ * \brief	A vertex array of the vertex struct T. T::GetVertexFormat() returns
+ *			its vertex format, usually with VertexFormat::FromElements().
+ *
+ *			Vertices are written as T directly into the storage of the
+ *			underlying VertexArray, which is what gets passed on to draw calls
+ *			and vertex buffers.
+ */
+template<typename T>
+class VertexArrayT final
+{
+	static_assert(is_standard_layout<T>::value, "Vertex types must have standard layout");
+public:
+	VertexArrayT() :
+		m_vertices(0, GetVertexFormat())
+	{
+	}
+
+	explicit VertexArrayT(const uint32 vertexCount) :
+		m_vertices(vertexCount, GetVertexFormat())
+	{
+	}
+
+	T &operator[](const uint32 index) { return getVertices()[index]; }
+	const T &operator[](const uint32 index) const { return getVertices()[index]; }
+
+	T *getVertices() const { return reinterpret_cast<T*>(m_vertices.getVertexData()); }
+	uint32 getVertexCount() const { return m_vertices.getVertexCount(); }
+	uint32 getVertexCapacity() const { return m_vertices.getVertexCapacity(); }
+
+	void resize(const uint32 newVertexCount) { m_vertices.resize(newVertexCount); }
+	void reserve(const uint32 vertexCapacity) { m_vertices.reserve(vertexCapacity); }
+	void clear() { m_vertices.clear(); }
+
+	/**
+	 * \fn	void VertexArrayT::setVertices(const uint32 startIndex, const T *vertices, const uint32 vertexCount)
+	 *
+	 * \brief	Copies vertices into the array, growing it if needed.
+	 */
+	void setVertices(const uint32 startIndex, const T *vertices, const uint32 vertexCount)
+	{
+		if(startIndex + vertexCount > getVertexCount())
+		{
+			resize(startIndex + vertexCount);
+		}
+		memcpy(getVertices() + startIndex, vertices, vertexCount * sizeof(T));
+	}
+
+	const VertexArray &getVertexArray() const { return m_vertices; }
+	operator const VertexArray&() const { return m_vertices; }
+
+	static const VertexFormat &GetVertexFormat()
+	{
+		static const VertexFormat vertexFormat = T::GetVertexFormat();
+		return vertexFormat;
+	}
+
+private:
+	VertexArray m_vertices;
+};
+
+/**
+ * \brief	Vertex with the default vertex format: position, color, texture coord.
+ */
+struct VertexPosColorUV
+{
+	Vector3F position;
+	Color color;
+	Vector2F uv;
+
+	static VertexFormat GetVertexFormat()
+	{
+		return VertexFormat::FromElements<VertexPosColorUV>({
+			SAUCE_VERTEX_ELEMENT(VertexPosColorUV, position, VertexAttribute::Position),
+			SAUCE_VERTEX_ELEMENT(VertexPosColorUV, color, VertexAttribute::Color),
+			SAUCE_VERTEX_ELEMENT(VertexPosColorUV, uv, VertexAttribute::TexCoord)
+		});
+	}
+};
+
+static_assert(offsetof(VertexPosColorUV, color) == sizeof(Vector3F) &&
+	offsetof(VertexPosColorUV, uv) == sizeof(Vector3F) + sizeof(Color) &&
+	sizeof(VertexPosColorUV) == sizeof(Vector3F) + sizeof(Color) + sizeof(Vector2F),
+	"VertexPosColorUV must be packed like its vertex format");
+
+/**
+ * \brief	Vertex with a 2D position, color and texture coord.
+ */
+struct VertexPos2DColorUV
+{
+	Vector2F position;
+	Color color;
+	Vector2F uv;
+
+	static VertexFormat GetVertexFormat()
+	{
+		return VertexFormat::FromElements<VertexPos2DColorUV>({
+			SAUCE_VERTEX_ELEMENT(VertexPos2DColorUV, position, VertexAttribute::Position),
+			SAUCE_VERTEX_ELEMENT(VertexPos2DColorUV, color, VertexAttribute::Color),
+			SAUCE_VERTEX_ELEMENT(VertexPos2DColorUV, uv, VertexAttribute::TexCoord)
+		});
+	}
+};
+
+static_assert(offsetof(VertexPos2DColorUV, color) == sizeof(Vector2F) &&
+	offsetof(VertexPos2DColorUV, uv) == sizeof(Vector2F) + sizeof(Color) &&
+	sizeof(VertexPos2DColorUV) == sizeof(Vector2F) + sizeof(Color) + sizeof(Vector2F),
+	"VertexPos2DColorUV must be packed like its vertex format");
+
 END_SAUCE_NAMESPACE
@@ -41,6 +41,7 @@ struct SAUCE_API VertexBufferDesc : public GraphicsDeviceObjectDesc
 class SAUCE_API VertexBuffer : public SauceObject
 {
 	friend class GraphicsContext;
+	friend class GraphicsCommandBuffer;
 public:
 	SAUCE_REF_TYPE(VertexBuffer);
 
@@ -82,6 +83,7 @@ struct SAUCE_API IndexBufferDesc : public GraphicsDeviceObjectDesc
 class SAUCE_API IndexBuffer : public SauceObject
 {
 	friend class GraphicsContext;
+	friend class GraphicsCommandBuffer;
 public:
 	SAUCE_REF_TYPE(IndexBuffer);
 
@@ -90,6 +92,8 @@ public:
 
 	bool initialize(IndexBufferDesc indexBufferDesc);
 
+	void modifyData(const uint32 startIndex, const uint32* indices, const uint32 indexCount);
+
 	uint32 getIndexCount() const;
 
 private:
@@ -80,6 +80,11 @@
 // Read about ImGuiBackendFlags_RendererHasVtxOffset for details.
 //#define ImDrawIdx unsigned int
 
+//---- Sauce: 32-bit indices and a vertex layout matching a Position/Color/TexCoord VertexFormat,
+// so that ImGuiSystem::render() can upload the draw lists as they are.
+#define ImDrawIdx unsigned int
+#define IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT struct ImDrawVert { ImVec2 pos; ImU32 col; ImVec2 uv; }
+
 //---- Override ImDrawCallback signature (will need to modify renderer back-ends accordingly)
 //struct ImDrawList;
 //struct ImDrawCmd;
@@ -9,5 +9,6 @@
 
 #include <Sauce/Input/InputManager.h>
 #include <Sauce/Input/InputContext.h>
+#include <Sauce/Input/InputScript.h>
 #include <Sauce/Input/Keycodes.h>
 #include <Sauce/Input/Scancodes.h>
@@ -33,14 +33,10 @@ public:
 
 	void addKeybind(const string &name, Keybind* keybind);
 
-	Keybind *getKeybind(const string &name)
+	Keybind *getKeybind(const string &name);
+	Keybind *getKeybind(const uint actionID) const
 	{
-		map<string, Keybind*>::iterator itr;
-		if((itr = m_keybinds.find(name)) != m_keybinds.end())
-		{
-			return itr->second;
-		}
-		return 0;
+		return actionID < m_keybinds.size() ? m_keybinds[actionID] : 0;
 	}
 
 	/**
@@ -56,22 +52,12 @@ public:
 	void removeKeybind(Keybind *keybind);
 	void removeKeybind(const string &name);
 
-	bool getKeyState(string name) const;
+	bool getKeyState(const string &name) const;
+	bool getKeyState(const uint actionID) const;
 
 private:
-
-	/**
-	 * \fn	void InputContext::updateKeybinds(KeyEvent *e);
-	 *
-	 * \brief	Updates the keybinds with event e.
-	 *
-	 * \param [in,out]	e	If non-null, the KeyEvent to process.
-	 */
-
-	void updateKeybinds(InputEvent *e);
-
-	// Key binds
-	map<string, Keybind*> m_keybinds;
+	// Key binds indexed by action ID (see InputManager::getActionID)
+	vector<Keybind*> m_keybinds;
 
 	// Input manager
 	InputManager *m_inputManager;
@@ -7,11 +7,13 @@
 #include <Sauce/Config.h>
 
 #include <Sauce/Input/InputButton.h>
+#include <Sauce/Input/InputScript.h>
 
 BEGIN_SAUCE_NAMESPACE
 
 class InputEvent;
 class InputContext;
+class InputManager;
 
 /**
 * \class	Keybind
@@ -21,6 +23,8 @@ class InputContext;
 
 class SAUCE_API Keybind
 {
+	friend class InputManager;
+	friend class InputContext;
 public:
 	Keybind();
 	Keybind(InputButton button, function<void(InputEvent*)> func = function<void(InputEvent*)>(), const uint flags = TRIGGER_WHEN_PRESSED);
@@ -48,14 +52,21 @@ public:
 		return m_inputButton;
 	}
 
-	void setInputButton(const InputButton inputButton)
-	{
-		m_inputButton = inputButton;
-	}
+	/**
+	* \fn	void Keybind::setInputButton(const InputButton inputButton);
+	*
+	* \brief	Rebinds the keybind. The input manager it was added to picks up
+	* 			the new button before it dispatches the next input event.
+	*/
+
+	void setInputButton(const InputButton inputButton);
 
 private:
 	InputButton m_inputButton;
 	function<void(InputEvent*)> m_function;
+
+	// Input manager whose keybind table contains this keybind
+	InputManager *m_inputManager;
 };
 
 typedef void ControllerDevice;
@@ -73,6 +84,8 @@ typedef void ControllerDevice;
 class SAUCE_API InputManager
 {
 	friend class Game;
+	friend class InputContext;
+	friend class Keybind;
 public:
 	InputManager(string contextFile);
 	~InputManager();
@@ -108,6 +121,25 @@ public:
 	// Virtual key to string
 	InputButton toInputButton(string name) const;
 
+	/**
+	* \fn	uint InputManager::getActionID(const string &name);
+	*
+	* \brief	Interns an action name. Every name maps to the same small integer
+	* 			for the lifetime of the input manager, so games can resolve their
+	* 			action names once and look up keybinds and key states by ID.
+	*/
+
+	uint getActionID(const string &name);
+
+	/**
+	* \fn	bool InputManager::findActionID(const string &name, uint &actionID) const;
+	*
+	* \brief	Looks up the ID of an action name without interning it.
+	* 			Returns false if the name was never interned.
+	*/
+
+	bool findActionID(const string &name, uint &actionID) const;
+
 	/**
 	* \fn	KeybindPtr InputManager::addKeybind(KeybindPtr keybind);
 	*
@@ -134,10 +166,45 @@ public:
 	void removeController(const uint id);
 	void setAxisThreshold(const float threshold) { m_triggerThreshold = threshold; }
 
+	/**
+	* \fn	void InputManager::startRecording(const string &filePath);
+	*
+	* \brief	Records every input event the game processes from now on, stamped
+	* 			with the current tick. The recording is written to \p filePath when
+	* 			recording stops and can be played back with GameDesc::inputReplayFile.
+	*/
+
+	void startRecording(const string &filePath);
+	void stopRecording();
+	bool isRecording() const { return m_recording != nullptr; }
+
 private:
 	// Update bindings
 	void updateKeybinds(InputEvent *e);
 
+	// Keybind table
+	void invalidateKeybinds() { m_keybindTableDirty = true; }
+	void rebuildKeybindTable();
+	static int getKeybindSlot(const InputButton inputButton);
+
+	// Track button states and record an input event the game is about to process
+	void processEvent(const uint64 tick, const SDL_Event &event);
+
+	// Controller events only count towards the tracked states if they come from the default controller
+	void setDefaultControllerID(const SDL_JoystickID joyId);
+	bool isDefaultControllerEvent(const SDL_JoystickID joyId);
+
+	// Button states as seen through processed events, so that
+	// scripted input and live input look the same when polled
+	bool m_keyStates[SDL_NUM_SCANCODES];
+	Uint32 m_mouseButtonStates;
+	bool m_controllerButtonStates[SDL_CONTROLLER_BUTTON_MAX];
+	Sint16 m_controllerAxisValues[SDL_CONTROLLER_AXIS_MAX];
+
+	// Input recording
+	InputScript *m_recording;
+	string m_recordingFilePath;
+
 	// Cursor position
 	Sint32 m_x, m_y;
 
@@ -146,14 +213,27 @@ private:
 	map<string, InputContext*> m_contextMap;
 
 	// String to key map
-	map<string, InputButton> m_strToKey;
+	unordered_map<string, InputButton> m_strToKey;
+
+	// Interned action names
+	unordered_map<string, uint> m_actionIDs;
 
 	// Key binds
 	list<Keybind*> m_keybinds;
 	list<Keybind*> m_contextKeybinds;
 
-	// Default controller
+	// Keybinds of the manager and the current context grouped by input button.
+	// The keybinds of slot i are m_keybindTable[m_keybindTableOffsets[i]] up to
+	// m_keybindTable[m_keybindTableOffsets[i + 1]]. Rebuilt before the next
+	// dispatch whenever a keybind or the context changes.
+	vector<Keybind*> m_keybindTable;
+	vector<uint> m_keybindTableOffsets;
+	bool m_keybindTableDirty;
+
+	// Default controller and the instance id of the pad whose events
+	// drive the tracked controller button and axis states
 	ControllerDevice *m_defaultController;
+	SDL_JoystickID m_defaultControllerID;
 
 	// Controllers
 	map<uint, ControllerDevice*> m_controllers;
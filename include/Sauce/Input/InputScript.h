@@ -0,0 +1,90 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Config.h>
+
+#include <Sauce/Input/InputButton.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * \class	InputScript
+ *
+ * \brief	A stream of SDL input events stamped with the tick they occur on.
+ *
+ * Game::run() pushes the events of a tick to the SDL event queue before it
+ * polls for events, so scripted input goes through exactly the same path
+ * as live input. In a headless run every frame simulates one tick, which
+ * makes the input of every tick reproducible.
+ *
+ * Scripts can be saved to and loaded from a compact binary file. Every
+ * event is stored as a variable-length tick delta, a type code and only
+ * the fields the engine reads for that type.
+ */
+class SAUCE_API InputScript
+{
+public:
+	static const uint32 FileVersion = 1;
+
+	InputScript();
+
+	/**
+	 * \fn	static bool InputScript::IsInputEvent(const Uint32 eventType);
+	 *
+	 * \brief	True for the SDL event types that can be scripted and recorded.
+	 */
+	static bool IsInputEvent(const Uint32 eventType);
+
+	/**
+	 * \fn	void InputScript::addEvent(const uint64 tick, const SDL_Event& event);
+	 *
+	 * \brief	Adds an event that is delivered before \p tick is simulated.
+	 *			Events on the same tick are delivered in the order they were added.
+	 *			Events that are not input events are ignored.
+	 */
+	void addEvent(const uint64 tick, const SDL_Event& event);
+
+	void addKey(const uint64 tick, const Scancode scancode, const bool pressed);
+	void addMouseButton(const uint64 tick, const MouseButton button, const bool pressed, const int32 x, const int32 y);
+	void addMouseMove(const uint64 tick, const int32 x, const int32 y);
+	void addMouseWheel(const uint64 tick, const int32 dx, const int32 dy);
+	void addText(const uint64 tick, const char character);
+
+	/**
+	 * \fn	void InputScript::pushEvents(const uint64 tick);
+	 *
+	 * \brief	Pushes every event stamped with \p tick or earlier that has not
+	 *			been delivered yet to the SDL event queue.
+	 */
+	void pushEvents(const uint64 tick);
+
+	/**
+	 * \fn	void InputScript::rewind();
+	 *
+	 * \brief	Starts delivering events from the beginning again.
+	 */
+	void rewind() { m_nextEvent = 0; }
+	void clear();
+
+	bool save(const string& filePath) const;
+	bool load(const string& filePath);
+
+	bool isFinished() const { return m_nextEvent >= m_events.size(); }
+	uint64 getEventCount() const { return m_events.size(); }
+	uint64 getLastTick() const { return m_events.empty() ? 0 : m_events.back().tick; }
+
+private:
+	struct ScriptedEvent
+	{
+		uint64 tick;
+		SDL_Event event;
+	};
+
+	vector<ScriptedEvent> m_events;
+	size_t m_nextEvent;
+};
+
+END_SAUCE_NAMESPACE
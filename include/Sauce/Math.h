@@ -9,6 +9,7 @@
 #include <Sauce/Math/Rectangle.h>
 #include <Sauce/Math/RectanglePacker.h>
 #include <Sauce/Math/Random.h>
+#include <Sauce/Math/SpatialIndex.h>
 
 #define PI 3.14159265359f
 
@@ -0,0 +1,543 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Config.h>
+#include <Sauce/Math/Vector.h>
+#include <Sauce/Math/Rectangle.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * \struct	BoundingBox
+ *
+ * \brief	An axis-aligned bounding box in N dimensions.
+ */
+template<uint32 N>
+struct BoundingBox
+{
+	float min[N];
+	float max[N];
+
+	bool overlaps(const BoundingBox &other) const
+	{
+		for(uint32 i = 0; i < N; ++i)
+		{
+			if(max[i] < other.min[i] || min[i] > other.max[i]) return false;
+		}
+		return true;
+	}
+
+	bool contains(const BoundingBox &other) const
+	{
+		for(uint32 i = 0; i < N; ++i)
+		{
+			if(other.min[i] < min[i] || other.max[i] > max[i]) return false;
+		}
+		return true;
+	}
+
+	bool containsPoint(const float point[N]) const
+	{
+		for(uint32 i = 0; i < N; ++i)
+		{
+			if(point[i] < min[i] || point[i] > max[i]) return false;
+		}
+		return true;
+	}
+
+	BoundingBox merged(const BoundingBox &other) const
+	{
+		BoundingBox result;
+		for(uint32 i = 0; i < N; ++i)
+		{
+			result.min[i] = std::min(min[i], other.min[i]);
+			result.max[i] = std::max(max[i], other.max[i]);
+		}
+		return result;
+	}
+
+	BoundingBox expanded(const float margin) const
+	{
+		BoundingBox result;
+		for(uint32 i = 0; i < N; ++i)
+		{
+			result.min[i] = min[i] - margin;
+			result.max[i] = max[i] + margin;
+		}
+		return result;
+	}
+
+	// Perimeter in 2D and surface area in 3D, used to pick where boxes are inserted
+	float getCost() const
+	{
+		float cost = 0.0f;
+		if(N <= 2)
+		{
+			for(uint32 i = 0; i < N; ++i) cost += max[i] - min[i];
+		}
+		else
+		{
+			for(uint32 i = 0; i < N; ++i)
+			{
+				for(uint32 j = i + 1; j < N; ++j) cost += (max[i] - min[i]) * (max[j] - min[j]);
+			}
+		}
+		return cost;
+	}
+
+	/**
+	 * \fn	bool BoundingBox::intersectRay(const float origin[N], const float direction[N], const float maxDistance, float &outDistance) const
+	 *
+	 * \brief	Tests the ray origin + direction * t for 0 <= t <= maxDistance
+	 *			against the box. \p outDistance is the t at which the ray enters.
+	 */
+	bool intersectRay(const float origin[N], const float direction[N], const float maxDistance, float &outDistance) const
+	{
+		float tMin = 0.0f, tMax = maxDistance;
+		for(uint32 i = 0; i < N; ++i)
+		{
+			if(fabs(direction[i]) < 1.0e-9f)
+			{
+				if(origin[i] < min[i] || origin[i] > max[i]) return false;
+				continue;
+			}
+
+			const float invDirection = 1.0f / direction[i];
+			float t0 = (min[i] - origin[i]) * invDirection;
+			float t1 = (max[i] - origin[i]) * invDirection;
+			if(t0 > t1) swap(t0, t1);
+			tMin = std::max(tMin, t0);
+			tMax = std::min(tMax, t1);
+			if(tMin > tMax) return false;
+		}
+		outDistance = tMin;
+		return true;
+	}
+
+	/**
+	 * \fn	bool BoundingBox::isOutsidePlane(const float plane[N + 1]) const
+	 *
+	 * \brief	True if the whole box is on the negative side of the plane
+	 *			n . x + d = 0, where plane holds n followed by d.
+	 */
+	bool isOutsidePlane(const float plane[N + 1]) const
+	{
+		float distance = plane[N];
+		for(uint32 i = 0; i < N; ++i)
+		{
+			distance += plane[i] * (plane[i] >= 0.0f ? max[i] : min[i]);
+		}
+		return distance < 0.0f;
+	}
+};
+
+typedef BoundingBox<2> BoundingBox2D;
+typedef BoundingBox<3> BoundingBox3D;
+
+inline BoundingBox2D ToBoundingBox(const Rect<float> &rect)
+{
+	BoundingBox2D box;
+	box.min[0] = rect.getLeft(); box.min[1] = rect.getTop();
+	box.max[0] = rect.getRight(); box.max[1] = rect.getBottom();
+	return box;
+}
+
+inline BoundingBox3D ToBoundingBox(const Vector3F &min, const Vector3F &max)
+{
+	BoundingBox3D box;
+	box.min[0] = min.x; box.min[1] = min.y; box.min[2] = min.z;
+	box.max[0] = max.x; box.max[1] = max.y; box.max[2] = max.z;
+	return box;
+}
+
+/**
+ * \class	SpatialIndex
+ *
+ * \brief	A dynamic AABB tree. Every proxy is a leaf holding a box that is
+ *			enlarged by a margin, so objects that move a little don't have to
+ *			be reinserted. Internal nodes bound their children and the tree
+ *			is kept balanced, so queries visit O(log n + k) nodes for k results.
+ *
+ *			Queries report the enlarged boxes. Callers that need exact results
+ *			test their own bounds in the callback.
+ */
+template<uint32 N>
+class SpatialIndex
+{
+public:
+	typedef BoundingBox<N> Box;
+	static const uint32 NullProxy = 0xFFFFFFFF;
+
+	SpatialIndex(const float margin = 1.0f) :
+		m_root(NullProxy),
+		m_freeList(NullProxy),
+		m_proxyCount(0),
+		m_margin(margin)
+	{
+	}
+
+	uint32 insert(const Box &box, void *userData)
+	{
+		const uint32 proxy = allocateNode();
+		m_nodes[proxy].box = box.expanded(m_margin);
+		m_nodes[proxy].userData = userData;
+		m_nodes[proxy].height = 0;
+		insertLeaf(proxy);
+		m_proxyCount++;
+		return proxy;
+	}
+
+	void remove(const uint32 proxy)
+	{
+		removeLeaf(proxy);
+		freeNode(proxy);
+		m_proxyCount--;
+	}
+
+	/**
+	 * \fn	bool SpatialIndex::move(const uint32 proxy, const Box &box)
+	 *
+	 * \brief	Updates the box of a proxy. Returns true if the proxy had to be
+	 *			reinserted because the new box left its enlarged box.
+	 */
+	bool move(const uint32 proxy, const Box &box)
+	{
+		if(m_nodes[proxy].box.contains(box))
+		{
+			return false;
+		}
+
+		removeLeaf(proxy);
+		m_nodes[proxy].box = box.expanded(m_margin);
+		insertLeaf(proxy);
+		return true;
+	}
+
+	void *getUserData(const uint32 proxy) const { return m_nodes[proxy].userData; }
+	const Box &getFatBox(const uint32 proxy) const { return m_nodes[proxy].box; }
+	uint32 getProxyCount() const { return m_proxyCount; }
+	uint32 getHeight() const { return m_root == NullProxy ? 0 : (uint32)m_nodes[m_root].height; }
+
+	void clear()
+	{
+		m_nodes.clear();
+		m_root = m_freeList = NullProxy;
+		m_proxyCount = 0;
+	}
+
+	/**
+	 * \fn	template<typename F> void SpatialIndex::query(const Box &box, F callback) const
+	 *
+	 * \brief	Calls callback(proxy) for every proxy overlapping \p box until it returns false.
+	 */
+	template<typename F>
+	void query(const Box &box, F callback) const
+	{
+		traverse([&box](const Box &nodeBox) { return nodeBox.overlaps(box); }, callback);
+	}
+
+	template<typename F>
+	void queryPoint(const float point[N], F callback) const
+	{
+		traverse([point](const Box &nodeBox) { return nodeBox.containsPoint(point); }, callback);
+	}
+
+	/**
+	 * \fn	template<typename F> void SpatialIndex::queryPlanes(const float planes[][N + 1], const uint32 planeCount, F callback) const
+	 *
+	 * \brief	Calls callback(proxy) for every proxy not entirely outside one of
+	 *			the planes, e.g. the six planes of a view frustum pointing inwards.
+	 */
+	template<typename F>
+	void queryPlanes(const float planes[][N + 1], const uint32 planeCount, F callback) const
+	{
+		traverse([planes, planeCount](const Box &nodeBox)
+		{
+			for(uint32 i = 0; i < planeCount; ++i)
+			{
+				if(nodeBox.isOutsidePlane(planes[i])) return false;
+			}
+			return true;
+		}, callback);
+	}
+
+	/**
+	 * \fn	template<typename F> void SpatialIndex::rayCast(const float origin[N], const float direction[N], float maxDistance, F callback) const
+	 *
+	 * \brief	Calls callback(proxy, distance) for proxies hit by the ray, where
+	 *			distance is where the ray enters the enlarged box. The callback
+	 *			returns the new maximum distance: 0 stops the cast, the distance
+	 *			of an exact hit finds the closest hit, and maxDistance keeps going.
+	 */
+	template<typename F>
+	void rayCast(const float origin[N], const float direction[N], float maxDistance, F callback) const
+	{
+		if(m_root == NullProxy) return;
+
+		uint32 stack[StackSize];
+		uint32 stackSize = 0;
+		stack[stackSize++] = m_root;
+		while(stackSize > 0)
+		{
+			const uint32 index = stack[--stackSize];
+			const Node &node = m_nodes[index];
+			float distance;
+			if(!node.box.intersectRay(origin, direction, maxDistance, distance)) continue;
+
+			if(node.isLeaf())
+			{
+				const float newMaxDistance = callback(index, distance);
+				if(newMaxDistance <= 0.0f) return;
+				maxDistance = std::min(maxDistance, newMaxDistance);
+			}
+			else
+			{
+				stack[stackSize++] = node.child1;
+				stack[stackSize++] = node.child2;
+			}
+		}
+	}
+
+private:
+	// Enough for any balanced tree that fits in memory
+	static const uint32 StackSize = 256;
+
+	struct Node
+	{
+		Box box;
+		void *userData;
+		uint32 parent; // Next free node while on the free list
+		uint32 child1, child2;
+		int32 height; // Leaves are 0, free nodes -1
+
+		bool isLeaf() const { return child1 == NullProxy; }
+	};
+
+	template<typename Test, typename F>
+	void traverse(Test test, F callback) const
+	{
+		if(m_root == NullProxy) return;
+
+		uint32 stack[StackSize];
+		uint32 stackSize = 0;
+		stack[stackSize++] = m_root;
+		while(stackSize > 0)
+		{
+			const uint32 index = stack[--stackSize];
+			const Node &node = m_nodes[index];
+			if(!test(node.box)) continue;
+
+			if(node.isLeaf())
+			{
+				if(!callback(index)) return;
+			}
+			else
+			{
+				stack[stackSize++] = node.child1;
+				stack[stackSize++] = node.child2;
+			}
+		}
+	}
+
+	uint32 allocateNode()
+	{
+		if(m_freeList == NullProxy)
+		{
+			m_nodes.push_back(Node());
+			m_freeList = (uint32)m_nodes.size() - 1;
+			m_nodes[m_freeList].parent = NullProxy;
+		}
+
+		const uint32 index = m_freeList;
+		m_freeList = m_nodes[index].parent;
+		Node &node = m_nodes[index];
+		node.parent = node.child1 = node.child2 = NullProxy;
+		node.userData = 0;
+		node.height = 0;
+		return index;
+	}
+
+	void freeNode(const uint32 index)
+	{
+		m_nodes[index].parent = m_freeList;
+		m_nodes[index].height = -1;
+		m_freeList = index;
+	}
+
+	void insertLeaf(const uint32 leaf)
+	{
+		if(m_root == NullProxy)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = NullProxy;
+			return;
+		}
+
+		// Walk down to the sibling that grows the tree the least
+		const Box leafBox = m_nodes[leaf].box;
+		uint32 index = m_root;
+		while(!m_nodes[index].isLeaf())
+		{
+			const Node &node = m_nodes[index];
+			const float combinedCost = node.box.merged(leafBox).getCost();
+			const float cost = 2.0f * combinedCost;
+			const float inheritanceCost = 2.0f * (combinedCost - node.box.getCost());
+			const float cost1 = descendCost(node.child1, leafBox) + inheritanceCost;
+			const float cost2 = descendCost(node.child2, leafBox) + inheritanceCost;
+			if(cost < cost1 && cost < cost2) break;
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		// Replace the sibling with a new parent of the sibling and the leaf
+		const uint32 sibling = index;
+		const uint32 oldParent = m_nodes[sibling].parent;
+		const uint32 newParent = allocateNode();
+		m_nodes[newParent].parent = oldParent;
+		m_nodes[newParent].box = leafBox.merged(m_nodes[sibling].box);
+		m_nodes[newParent].height = m_nodes[sibling].height + 1;
+		m_nodes[newParent].child1 = sibling;
+		m_nodes[newParent].child2 = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+		if(oldParent != NullProxy)
+		{
+			if(m_nodes[oldParent].child1 == sibling) m_nodes[oldParent].child1 = newParent;
+			else m_nodes[oldParent].child2 = newParent;
+		}
+		else
+		{
+			m_root = newParent;
+		}
+
+		refit(m_nodes[leaf].parent);
+	}
+
+	float descendCost(const uint32 child, const Box &leafBox) const
+	{
+		const Box &childBox = m_nodes[child].box;
+		const float mergedCost = leafBox.merged(childBox).getCost();
+		return m_nodes[child].isLeaf() ? mergedCost : mergedCost - childBox.getCost();
+	}
+
+	void removeLeaf(const uint32 leaf)
+	{
+		if(leaf == m_root)
+		{
+			m_root = NullProxy;
+			return;
+		}
+
+		const uint32 parent = m_nodes[leaf].parent;
+		const uint32 grandParent = m_nodes[parent].parent;
+		const uint32 sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+		freeNode(parent);
+		if(grandParent != NullProxy)
+		{
+			if(m_nodes[grandParent].child1 == parent) m_nodes[grandParent].child1 = sibling;
+			else m_nodes[grandParent].child2 = sibling;
+			m_nodes[sibling].parent = grandParent;
+			refit(grandParent);
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = NullProxy;
+		}
+	}
+
+	// Rebalances and recomputes the boxes from index up to the root
+	void refit(uint32 index)
+	{
+		while(index != NullProxy)
+		{
+			index = balance(index);
+			Node &node = m_nodes[index];
+			const Node &child1 = m_nodes[node.child1];
+			const Node &child2 = m_nodes[node.child2];
+			node.height = 1 + std::max(child1.height, child2.height);
+			node.box = child1.box.merged(child2.box);
+			index = node.parent;
+		}
+	}
+
+	// Rotates the taller child of iA up if the children differ in height by more than one
+	uint32 balance(const uint32 iA)
+	{
+		Node &A = m_nodes[iA];
+		if(A.isLeaf() || A.height < 2)
+		{
+			return iA;
+		}
+
+		const uint32 iB = A.child1, iC = A.child2;
+		Node &B = m_nodes[iB];
+		Node &C = m_nodes[iC];
+		const int32 heightDifference = C.height - B.height;
+		if(heightDifference > 1)
+		{
+			rotateUp(iA, iC, iB, false);
+			return iC;
+		}
+		if(heightDifference < -1)
+		{
+			rotateUp(iA, iB, iC, true);
+			return iB;
+		}
+		return iA;
+	}
+
+	// Makes iUp (a child of iA) the parent of iA. iOther is the other child of iA.
+	void rotateUp(const uint32 iA, const uint32 iUp, const uint32 iOther, const bool upIsChild1)
+	{
+		Node &A = m_nodes[iA];
+		Node &up = m_nodes[iUp];
+		Node &other = m_nodes[iOther];
+		const uint32 iF = up.child1, iG = up.child2;
+		Node &F = m_nodes[iF];
+		Node &G = m_nodes[iG];
+
+		up.child1 = iA;
+		up.parent = A.parent;
+		A.parent = iUp;
+		if(up.parent != NullProxy)
+		{
+			if(m_nodes[up.parent].child1 == iA) m_nodes[up.parent].child1 = iUp;
+			else m_nodes[up.parent].child2 = iUp;
+		}
+		else
+		{
+			m_root = iUp;
+		}
+
+		// The taller grandchild stays with iUp, the other one moves to iA
+		const bool keepF = F.height > G.height;
+		const uint32 iKeep = keepF ? iF : iG, iMove = keepF ? iG : iF;
+		Node &keep = m_nodes[iKeep];
+		Node &moved = m_nodes[iMove];
+		up.child2 = iKeep;
+		if(upIsChild1) A.child1 = iMove;
+		else A.child2 = iMove;
+		moved.parent = iA;
+		A.box = other.box.merged(moved.box);
+		up.box = A.box.merged(keep.box);
+		A.height = 1 + std::max(other.height, moved.height);
+		up.height = 1 + std::max(A.height, keep.height);
+	}
+
+	vector<Node> m_nodes;
+	uint32 m_root;
+	uint32 m_freeList;
+	uint32 m_proxyCount;
+	const float m_margin;
+};
+
+template<uint32 N>
+const uint32 SpatialIndex<N>::NullProxy;
+
+typedef SpatialIndex<2> SpatialIndex2D;
+typedef SpatialIndex<3> SpatialIndex3D;
+
+END_SAUCE_NAMESPACE
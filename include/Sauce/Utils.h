@@ -6,3 +6,4 @@
 
 #include <Sauce/Utils/MiscUtils.h>
 #include <Sauce/Utils/FileSystemUtils.h>
+#include <Sauce/Utils/PackFile.h>
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <Sauce/Config.h>
+#include <cstring>
 
 #ifdef SAUCE_COMPILE_WINDOWS
 #include <Windows.h>
@@ -23,11 +24,138 @@ namespace util
 	SAUCE_API void toDirectoryPath(string& path);
 	SAUCE_API string getWorkingDirectory();
 
+	//--------------------------------------------------------------
+	// File reading
+	//--------------------------------------------------------------
+	SAUCE_API bool readFile(const string& assetPath, string& outContent);
+
+	/**
+	 * \struct	FileSpan
+	 *
+	 * \brief	Read-only view into a range of bytes. When returned from a
+	 *			PackFile, the span points directly into the mapped archive
+	 *			and stays valid for as long as the pack file is open.
+	 */
+	struct SAUCE_API FileSpan
+	{
+		const uint8* data = nullptr;
+		uint64       size = 0;
+
+		bool isValid() const { return data != nullptr; }
+	};
+
+	/**
+	 * \class	MappedFile
+	 *
+	 * \brief	Maps a whole file read-only into memory
+	 */
+	class SAUCE_API MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * \brief	Maps \p filePath into memory. Empty files cannot be mapped and will fail to open.
+		 */
+		bool open(const string& filePath);
+		void close();
+		bool isOpen() const { return m_data != nullptr; }
+
+		const uint8* getData() const { return m_data; }
+		uint64 getSize() const { return m_size; }
+		FileSpan getSpan() const { FileSpan span; span.data = m_data; span.size = m_size; return span; }
+
+	private:
+		const uint8* m_data;
+		uint64 m_size;
+
+#ifdef SAUCE_COMPILE_WINDOWS
+		HANDLE m_fileHandle;
+		HANDLE m_mappingHandle;
+#endif
+	};
+
+	//--------------------------------------------------------------
+	// Byte order
+	//--------------------------------------------------------------
+	template<typename T>
+	inline T toLittleEndian(T v)
+	{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		uint8* bytes = (uint8*)&v;
+		reverse(bytes, bytes + sizeof(T));
+#endif
+		return v;
+	}
+
 	//--------------------------------------------------------------
 	// File hashing
 	//--------------------------------------------------------------
 	SAUCE_API std::string FileMD5(const std::string& fileName);
 
+	/**
+	 * \struct	FileMetadata
+	 *
+	 * \brief	File system metadata used to detect that a file has changed
+	 */
+	struct SAUCE_API FileMetadata
+	{
+		uint64 size = 0;
+		int64  modifiedTime = 0; ///< Nanoseconds since the Unix epoch
+		uint64 fileId = 0;       ///< Inode number, or the NTFS file index on Windows
+
+		bool operator==(const FileMetadata& other) const
+		{
+			return size == other.size && modifiedTime == other.modifiedTime && fileId == other.fileId;
+		}
+		bool operator!=(const FileMetadata& other) const { return !this->operator==(other); }
+	};
+
+	SAUCE_API bool getFileMetadata(const string& filePath, FileMetadata& outMetadata);
+
+	/**
+	 * \class	FileHashCache
+	 *
+	 * \brief	Caches XXH64 content hashes of files keyed on their path and
+	 *			metadata. A file is only read and hashed again when its size,
+	 *			modification time or inode changes.
+	 */
+	class SAUCE_API FileHashCache
+	{
+	public:
+		static const uint32 Version = 1;
+
+		FileHashCache();
+
+		/**
+		 * \brief	Replaces the cache with the index stored in \p indexFilePath.
+		 */
+		bool load(const string& indexFilePath);
+		bool save(const string& indexFilePath);
+
+		/**
+		 * \brief	Returns the content hash of \p filePath, hashing the file
+		 *			only if it is not in the cache or its metadata changed.
+		 */
+		bool getContentHash(const string& filePath, uint64& outHash);
+
+		bool isDirty() const { return m_dirty; }
+
+	private:
+		struct Entry
+		{
+			FileMetadata metadata;
+			uint64 contentHash;
+		};
+
+		unordered_map<string, Entry> m_entries;
+		bool m_dirty;
+	};
+
 	/**
 	 * \enum	FileSystemIteratorFlag
 	 *
@@ -36,10 +164,17 @@ namespace util
 	enum class FileSystemIteratorFlag : uint32
 	{
 		IncludeDirectories = 1 << 1, ///< Include directories if set
-		IncludeFiles       = 1 << 2  ///< Include files if set
+		IncludeFiles       = 1 << 2, ///< Include files if set
+		Recursive          = 1 << 3  ///< Descend into subdirectories if set
 	};
 	ENUM_CLASS_ADD_BITWISE_OPERATORS(FileSystemIteratorFlag);
 
+	/**
+	 * \brief	Returns true if \p name matches the wildcard \p mask ('*' and '?').
+	 *			Matching is case-insensitive on Windows, as with FindFirstFile.
+	 */
+	SAUCE_API bool matchFileMask(const char* mask, const char* name);
+
 	//--------------------------------------------------------------
 	// File system iterator
 	//--------------------------------------------------------------
@@ -66,13 +201,28 @@ namespace util
 		iterator end() { return TO >= FROM ? TO + 1 : TO - 1; }
 	};
 
+	/**
+	 * \struct	DirectoryOrFile
+	 *
+	 * \brief	An entry returned by FileSystemIterator. The metadata is
+	 *			filled in while enumerating the directory.
+	 */
 	struct SAUCE_API DirectoryOrFile
 	{
-		DirectoryOrFile(const string& baseName, const string& directoryName, const bool& isDirectory)
+		DirectoryOrFile()
+			: size(0)
+			, modifiedTime(0)
+			, isDirectory(false)
+		{
+		}
+
+		DirectoryOrFile(const string& baseName, const string& directoryName, const bool isDirectory, const uint64 size = 0, const int64 modifiedTime = 0)
 			: baseName(baseName)
 			, directoryName(directoryName)
 			, fullPath(directoryName + "/" + baseName)
-			, isDirectory(false)
+			, size(size)
+			, modifiedTime(modifiedTime)
+			, isDirectory(isDirectory)
 		{
 		}
 
@@ -81,12 +231,21 @@ namespace util
 			return fullPath == other.fullPath && isDirectory == other.isDirectory;
 		}
 
-		const string baseName;
-		const string directoryName;
-		const string fullPath;
-		const bool isDirectory;
+		string baseName;
+		string directoryName;
+		string fullPath;
+		uint64 size;         ///< File size in bytes (0 for directories)
+		int64 modifiedTime;  ///< Last modification time in nanoseconds since the Unix epoch
+		bool isDirectory;
 	};
 
+	/**
+	 * \class	FileSystemIterator
+	 *
+	 * \brief	Enumerates the entries of a directory, optionally recursing
+	 *			into subdirectories (pre-order). The mask is matched against
+	 *			entry names only; recursion always visits every subdirectory.
+	 */
 	class SAUCE_API FileSystemIterator
 	{
 	public:
@@ -95,55 +254,36 @@ namespace util
 			friend class FileSystemIterator;
 
 			FileSystemIterator& m_fsitr;
-			DirectoryOrFile* m_directoryOrFile;
+			DirectoryOrFile m_directoryOrFile;
 			bool m_isEnd;
 
 			iterator(FileSystemIterator& fsitr, bool isEnd)
 				: m_fsitr(fsitr)
-				, m_directoryOrFile(nullptr)
 				, m_isEnd(isEnd)
 			{
 			}
 
-			iterator(const iterator& other)
-				: m_fsitr(other.m_fsitr)
-				, m_directoryOrFile(nullptr)
-				, m_isEnd(other.m_isEnd)
-			{
-				if (other.m_directoryOrFile)
-				{
-					m_directoryOrFile = new DirectoryOrFile(*other.m_directoryOrFile);
-				}
-			}
-
 		public:
-			~iterator()
-			{
-				delete m_directoryOrFile;
-			}
-
 			iterator& operator++();
 			iterator operator++(int);
 			bool operator==(const iterator& other) const
 			{
-				if (m_directoryOrFile == nullptr || other.m_directoryOrFile == nullptr)
+				if (m_isEnd || other.m_isEnd)
 				{
-					return m_isEnd == other.m_isEnd && m_directoryOrFile == other.m_directoryOrFile;
-				}
-				else
-				{
-					return m_isEnd == other.m_isEnd && *m_directoryOrFile == *other.m_directoryOrFile;
+					return m_isEnd == other.m_isEnd;
 				}
+				return m_directoryOrFile == other.m_directoryOrFile;
 			}
 			bool operator!=(const iterator& other) const { return !this->operator==(other); }
-			DirectoryOrFile operator*() const;
+			const DirectoryOrFile& operator*() const { return m_directoryOrFile; }
+			const DirectoryOrFile* operator->() const { return &m_directoryOrFile; }
 
 			// iterator traits
-			using difference_type = DirectoryOrFile;
+			using difference_type = ptrdiff_t;
 			using value_type = DirectoryOrFile;
 			using pointer = const DirectoryOrFile*;
 			using reference = const DirectoryOrFile&;
-			using iterator_category = std::forward_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
 		};
 
 		iterator begin();
@@ -152,57 +292,132 @@ namespace util
 		FileSystemIterator(const string& searchPath, const string& mask, const uint32 flags);
 		~FileSystemIterator();
 
+		FileSystemIterator(const FileSystemIterator&) = delete;
+		FileSystemIterator& operator=(const FileSystemIterator&) = delete;
+
 	private:
+		/**
+		 * \brief	An open directory on the traversal stack
+		 */
+		struct OpenDirectory
+		{
+			string path; ///< Path as reported in DirectoryOrFile::directoryName
+#ifdef SAUCE_COMPILE_WINDOWS
+			string absolutePath;
+			HANDLE findHandle;
+			WIN32_FIND_DATA findData;
+			bool hasPendingEntry; ///< FindFirstFile has already filled findData
+#else
+			void* dirHandle; ///< DIR*
+#endif
+		};
+
+		bool pushDirectory(const string& name);
+		void popDirectory();
+		bool next(DirectoryOrFile& outDirectoryOrFile);
+
 		const string m_searchPath;
 		const string m_searchMask;
 		const uint32 m_searchFlags;
 
-		WIN32_FIND_DATA m_fdata;
-		HANDLE m_hFind;
+		vector<OpenDirectory> m_directoryStack;
 	};
 }
 
-class SAUCE_API ByteStreamOut
+/**
+ * \struct	ByteStreamHeader
+ *
+ * \brief	Header written at the start of every byte stream file.
+ *			All values following the header are stored little-endian and
+ *			lengths are stored as uint64 regardless of platform.
+ */
+struct ByteStreamHeader
 {
-	ofstream fileStream;
+	uint32 magic;         ///< Always ByteStreamHeader::Magic
+	uint32 byteOrderMark; ///< ByteOrderMark as stored by the writer; used to reject streams from mismatched hosts
+	uint32 formatVersion; ///< Version of the byte stream container itself
+	uint32 userVersion;   ///< Version of the serialized data, chosen by the writer
+	uint64 payloadSize;   ///< Number of bytes following the header
+	uint32 checksum;      ///< CRC32 of the payload
+	uint32 reserved;
+
+	static const uint32 Magic = 0x54534253; // "SBST"
+	static const uint32 ByteOrderMark = 0x01020304;
+	static const uint32 FormatVersion = 1;
+};
 
+/**
+ * \class	ByteStreamOut
+ *
+ * \brief	Buffered binary writer. Writes are combined in memory and
+ *			flushed to the file in large blocks. The header is finalized
+ *			with the payload size and checksum when the stream is closed.
+ */
+class SAUCE_API ByteStreamOut
+{
 public:
-	ByteStreamOut(const string& filePath)
-		: fileStream(filePath, ofstream::binary)
-	{
-	}
+	ByteStreamOut(const string& filePath, const uint32 version = 0);
+	~ByteStreamOut();
 
 	ByteStreamOut(const ByteStreamOut&) = delete;
 
-	operator bool() const { return (bool)fileStream; }
-	void close() { fileStream.close(); }
+	operator bool() const { return (bool)m_fileStream; }
+	void close();
+
+	/**
+	 * \brief	Writes \p size raw bytes to the stream.
+	 */
+	void write(const void* data, const uint64 size)
+	{
+		if (m_bufferSize + size <= BufferCapacity)
+		{
+			memcpy(m_buffer + m_bufferSize, data, (size_t)size);
+			m_bufferSize += (uint32)size;
+		}
+		else
+		{
+			writeUnbuffered(data, size);
+		}
+	}
+
+	/**
+	 * \brief	Writes \p count values of a trivially copyable type in one call.
+	 *			Arithmetic types are stored little-endian; other types are stored as laid out in memory.
+	 */
+	template<typename T>
+	void write(const T* data, const uint64 count)
+	{
+		static_assert(is_trivially_copyable<T>::value, "ByteStreamOut::write() requires a trivially copyable type");
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		if (is_arithmetic<T>::value && sizeof(T) > 1)
+		{
+			for (uint64 i = 0; i < count; ++i) writeLittleEndian(data[i]);
+			return;
+		}
+#endif
+		write((const void*)data, count * sizeof(T));
+	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const string& v)
 	{
-		const size_t strSize = v.size();
-		out.fileStream.write((const char*)&strSize, sizeof(size_t));
-		out.fileStream.write((const char*)v.c_str(), strSize);
+		out << (uint64)v.size();
+		out.write(v.data(), v.size());
 		return out;
 	}
 
 	template<typename T>
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const vector<T>& v)
 	{
-		const size_t arraySize = v.size();
-		out.fileStream.write((const char*)&arraySize, sizeof(size_t));
-		for (int32 i = 0; i < arraySize; ++i)
-		{
-			out << v[i];
-		}
+		out << (uint64)v.size();
+		out.writeElements(v.data(), v.size(), typename is_arithmetic<T>::type());
 		return out;
 	}
 
 	template<typename K, typename V>
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const unordered_map<K, V>& v)
 	{
-		const size_t mapSize = v.size();
-		out.fileStream.write((const char*)&mapSize, sizeof(size_t));
-		for (const pair<K, V>& entry : v)
+		out << (uint64)v.size();
+		for (const pair<const K, V>& entry : v)
 		{
 			out << entry.first;
 			out << entry.second;
@@ -212,114 +427,224 @@ public:
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const bool& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(bool));
+		out.writeLittleEndian((uint8)v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const float& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(float));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const double& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(double));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const int8& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(int8));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const uint8& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(uint8));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const int16& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(int16));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const uint16& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(uint16));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const int32& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(int32));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const uint32& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(uint32));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const int64& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(int64));
+		out.writeLittleEndian(v);
 		return out;
 	}
 
 	friend ByteStreamOut& operator<<(ByteStreamOut& out, const uint64& v)
 	{
-		out.fileStream.write((const char*)&v, sizeof(uint64));
+		out.writeLittleEndian(v);
 		return out;
 	}
+
+private:
+	static const uint32 BufferCapacity = 64 * 1024;
+
+	template<typename T>
+	void writeLittleEndian(const T& v)
+	{
+		const T value = util::toLittleEndian(v);
+		write((const void*)&value, sizeof(T));
+	}
+
+	template<typename T>
+	void writeElements(const T* data, const uint64 count, true_type)
+	{
+		write(data, count);
+	}
+
+	template<typename T>
+	void writeElements(const T* data, const uint64 count, false_type)
+	{
+		for (uint64 i = 0; i < count; ++i)
+		{
+			*this << data[i];
+		}
+	}
+
+	void writeUnbuffered(const void* data, const uint64 size);
+	void flush();
+
+	ofstream m_fileStream;
+	uint8* m_buffer;
+	uint32 m_bufferSize;
+	ByteStreamHeader m_header;
 };
 
+/**
+ * \class	ByteStreamIn
+ *
+ * \brief	Binary reader over a memory range. Files are memory-mapped (or
+ *			resolved into a mounted pack file) and the header and checksum
+ *			are validated up front. Reading past the end of the payload
+ *			puts the stream into a failed state.
+ */
 class SAUCE_API ByteStreamIn
 {
-	ifstream fileStream;
-
 public:
-	ByteStreamIn(const string& filePath)
-		: fileStream(filePath, ifstream::binary)
+	ByteStreamIn(const string& filePath, const uint32 version = 0);
+	ByteStreamIn(const util::FileSpan& span, const uint32 version = 0);
+
+	ByteStreamIn(const ByteStreamIn&) = delete;
+
+	operator bool() const { return m_data != nullptr; }
+	void close();
+
+	/**
+	 * \brief	Reads \p size raw bytes from the stream.
+	 */
+	bool read(void* data, const uint64 size)
 	{
+		if (m_data && m_offset + size <= m_size)
+		{
+			memcpy(data, m_data + m_offset, (size_t)size);
+			m_offset += size;
+			return true;
+		}
+		memset(data, 0, (size_t)size);
+		close();
+		return false;
 	}
 
-	ByteStreamIn(const ByteStreamIn&) = delete;
+	/**
+	 * \brief	Reads \p count values of a trivially copyable type in one call.
+	 */
+	template<typename T>
+	bool read(T* data, const uint64 count)
+	{
+		static_assert(is_trivially_copyable<T>::value, "ByteStreamIn::read() requires a trivially copyable type");
+		if (!read((void*)data, count * sizeof(T)))
+		{
+			return false;
+		}
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		if (is_arithmetic<T>::value && sizeof(T) > 1)
+		{
+			for (uint64 i = 0; i < count; ++i) data[i] = util::toLittleEndian(data[i]);
+		}
+#endif
+		return true;
+	}
 
-	operator bool() const { return (bool)fileStream; }
-	void close() { fileStream.close(); }
+	/**
+	 * \brief	Returns a view of the next \p size bytes without copying them and advances past them.
+	 *			The view is valid for as long as the stream is open.
+	 */
+	util::FileSpan readSpan(const uint64 size)
+	{
+		util::FileSpan span;
+		if (m_data && m_offset + size <= m_size)
+		{
+			span.data = m_data + m_offset;
+			span.size = size;
+			m_offset += size;
+		}
+		else
+		{
+			close();
+		}
+		return span;
+	}
+
+	uint64 getRemainingSize() const { return m_size - m_offset; }
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, string& v)
 	{
-		size_t strSize;
-		in.fileStream.read((char*)&strSize, sizeof(size_t));
-		v.resize(strSize);
-		in.fileStream.read((char*)v.c_str(), strSize);
+		uint64 strSize = 0;
+		in >> strSize;
+		if (strSize > in.getRemainingSize())
+		{
+			in.close();
+			v.clear();
+			return in;
+		}
+		v.resize((size_t)strSize);
+		in.read(&v[0], strSize);
 		return in;
 	}
 
 	template<typename T>
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, vector<T>& v)
 	{
-		size_t arraySize = 0;
-		in.fileStream.read((char*)&arraySize, sizeof(size_t));
-		v.resize(arraySize);
-		for (int32 i = 0; i < arraySize; ++i)
+		uint64 arraySize = 0;
+		in >> arraySize;
+		if (arraySize > in.getRemainingSize())
 		{
-			in >> v[i];
+			in.close();
+			v.clear();
+			return in;
 		}
+		v.resize((size_t)arraySize);
+		in.readElements(v.data(), arraySize, typename is_arithmetic<T>::type());
 		return in;
 	}
 
 	template<typename K, typename V>
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, unordered_map<K, V>& v)
 	{
-		size_t mapSize = 0;
-		in.fileStream.read((char*)&mapSize, sizeof(size_t));
-		for (uint32 i = 0; i < mapSize; ++i)
+		uint64 mapSize = 0;
+		in >> mapSize;
+		if (mapSize > in.getRemainingSize())
+		{
+			in.close();
+			return in;
+		}
+		v.reserve((size_t)mapSize);
+		for (uint64 i = 0; i < mapSize && in; ++i)
 		{
 			pair<K, V> entry;
 			in >> entry.first;
@@ -331,69 +656,101 @@ public:
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, bool& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(bool));
+		uint8 value = 0;
+		in.readLittleEndian(value);
+		v = value != 0;
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, float& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(float));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, double& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(double));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, int8& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(int8));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, uint8& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(uint8));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, int16& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(int16));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, uint16& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(uint16));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, int32& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(int32));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, uint32& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(uint32));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, int64& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(int64));
+		in.readLittleEndian(v);
 		return in;
 	}
 
 	friend ByteStreamIn& operator>>(ByteStreamIn& in, uint64& v)
 	{
-		in.fileStream.read((char*)&v, sizeof(uint64));
+		in.readLittleEndian(v);
 		return in;
 	}
+
+private:
+	template<typename T>
+	void readLittleEndian(T& v)
+	{
+		read((void*)&v, sizeof(T));
+		v = util::toLittleEndian(v);
+	}
+
+	template<typename T>
+	void readElements(T* data, const uint64 count, true_type)
+	{
+		read(data, count);
+	}
+
+	template<typename T>
+	void readElements(T* data, const uint64 count, false_type)
+	{
+		for (uint64 i = 0; i < count && *this; ++i)
+		{
+			*this >> data[i];
+		}
+	}
+
+	bool validate(const util::FileSpan& span, const uint32 version);
+
+	util::MappedFile m_mappedFile;
+	const uint8* m_data;
+	uint64 m_size;
+	uint64 m_offset;
 };
 
 END_SAUCE_NAMESPACE
@@ -55,6 +55,14 @@ namespace util
 
 	SAUCE_API std::string ByteArrayMD5(const std::string& str);
 
+	// Computes the CRC32 of a byte array. Pass the previous result as
+	// \p crc to continue a checksum over multiple calls.
+	SAUCE_API uint32 CRC32(const void* data, const uint64 size, const uint32 crc = 0);
+
+	// Computes the 64-bit xxHash (XXH64) of a byte array. Much faster than
+	// MD5 for content hashing, but not suitable for cryptographic use.
+	SAUCE_API uint64 XXH64(const void* data, const uint64 size, const uint64 seed = 0);
+
 	SAUCE_API uint32 GetDatatypeSize(const Datatype datatype);
 }
 
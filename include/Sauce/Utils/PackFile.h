@@ -0,0 +1,136 @@
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#pragma once
+
+#include <Sauce/Config.h>
+#include <Sauce/Utils/FileSystemUtils.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+namespace util
+{
+	/**
+	 * \enum	PackCompression
+	 *
+	 * \brief	How the bytes of a pack entry are stored
+	 */
+	enum class PackCompression : uint32
+	{
+		None = 0 ///< Stored as-is; the entry can be handed out as a zero-copy span
+	};
+
+	/**
+	 * \brief	Pack file layout
+	 *
+	 * [PackFileHeader][entry data, each aligned to header.alignment][PackFileEntry * entryCount][string table]
+	 *
+	 * The table of contents is sorted by pathHash so lookups are a binary
+	 * search over the mapped memory. All values are stored little-endian.
+	 */
+	struct PackFileHeader
+	{
+		uint32 magic;
+		uint32 version;
+		uint32 entryCount;
+		uint32 alignment;
+		uint64 tocOffset;
+		uint64 stringTableOffset;
+		uint64 stringTableSize;
+	};
+
+	struct PackFileEntry
+	{
+		uint64 pathHash;
+		uint64 dataOffset;
+		uint64 dataSize;
+		uint64 storedSize;
+		uint32 pathOffset;
+		uint32 pathLength;
+		uint32 compression;
+		uint32 reserved;
+	};
+
+	/**
+	 * \class	PackFile
+	 *
+	 * \brief	Memory-mapped, read-only asset archive
+	 */
+	class SAUCE_API PackFile
+	{
+	public:
+		static const uint32 Magic = 0x4B415053; // "SPAK"
+		static const uint32 Version = 1;
+
+		PackFile();
+		~PackFile();
+
+		PackFile(const PackFile&) = delete;
+		PackFile& operator=(const PackFile&) = delete;
+
+		bool open(const string& filePath);
+		void close();
+		bool isOpen() const { return m_mappedFile.isOpen(); }
+
+		/**
+		 * \brief	Returns true if the archive has an entry for \p assetPath.
+		 */
+		bool contains(const string& assetPath) const;
+
+		/**
+		 * \brief	Looks up \p assetPath and returns a view of its bytes in \p outSpan.
+		 */
+		bool find(const string& assetPath, FileSpan& outSpan) const;
+
+		uint32 getEntryCount() const { return m_header ? m_header->entryCount : 0; }
+		const string& getFilePath() const { return m_filePath; }
+
+		/**
+		 * \brief	Strips the ":/" prefix and unifies path separators so
+		 *			that asset paths hash the same in the packer and at runtime.
+		 *			Returns an empty string for paths that cannot live in a pack.
+		 */
+		static string NormalizePath(const string& assetPath);
+		static uint64 HashPath(const string& normalizedPath);
+
+	private:
+		const PackFileEntry* findEntry(const string& normalizedPath) const;
+
+		string m_filePath;
+		MappedFile m_mappedFile;
+		const PackFileHeader* m_header;
+		const PackFileEntry* m_entries;
+		const char* m_stringTable;
+	};
+
+	/**
+	 * \class	PackFileWriter
+	 *
+	 * \brief	Builds a pack file from loose files or memory
+	 */
+	class SAUCE_API PackFileWriter
+	{
+	public:
+		PackFileWriter(const uint32 alignment = 16);
+
+		bool addFile(const string& assetPath, const string& diskFilePath);
+		bool addData(const string& assetPath, const uint8* data, const uint64 size);
+		bool write(const string& packFilePath) const;
+
+		uint32 getEntryCount() const { return (uint32)m_entries.size(); }
+
+	private:
+		uint32 m_alignment;
+		map<string, vector<uint8>> m_entries;
+	};
+
+	//--------------------------------------------------------------
+	// Mounted pack files
+	//--------------------------------------------------------------
+	SAUCE_API bool mountPackFile(const string& packFilePath);
+	SAUCE_API void unmountPackFiles();
+	SAUCE_API bool findInPackFiles(const string& assetPath, FileSpan& outSpan);
+}
+
+END_SAUCE_NAMESPACE
@@ -43,7 +43,7 @@ public:
 			prevNode = node;
 
 			// Add tree edges
-			list<SceneObject*> children = node->getChildren();
+			const vector<SceneObject*> &children = node->getChildren();
 			for(SceneObject *child : children)
 			{
 				sgedges += "\t" + string((char*) node->getUserData()) + "->" + string((char*) child->getUserData()) + "\n";
@@ -121,7 +121,7 @@ void drawCube(GraphicsContext* graphicsContext, const float x, const float y, co
 	format.set(VertexAttribute::Color, 4, Datatype::Uint8);
 	format.set(VertexAttribute::TexCoord, 2, Datatype::Float);
 	
-	VertexArray vertices = format.createVertices(36);
+	VertexArray& vertices = graphicsContext->allocateScratchVertices(36, format);
 
 	Matrix4 mat;
 	mat.translate(x, y, z);
@@ -12,126 +12,437 @@
 
 #include <Sauce/Common.h>
 
+#include <condition_variable>
+
 BEGIN_SAUCE_NAMESPACE
 
-Console *Console::s_this = nullptr;
+//--------------------------------------------------------------------
+// Log queue
+//--------------------------------------------------------------------
+
+namespace
+{
+	// A formatted message waiting to be written. Messages that do not fit
+	// in the inline buffer are stored on the heap.
+	struct LogRecord
+	{
+		static const uint32 InlineSize = 384;
+
+		uint64 ticks;
+		LogLevel level;
+		LogCategory category;
+		const char *function;
+		const char *file;
+		int line;
+		char *longMessage;
+		char message[InlineSize];
+
+		const char *getMessage() const { return longMessage ? longMessage : message; }
+	};
+
+	// Bounded multi-producer queue after Dmitry Vyukov's design. Each cell
+	// carries a sequence number that tells producers and the consumer whose
+	// turn it is, so claiming a slot is a single compare-exchange.
+	struct LogQueue
+	{
+		static const uint64 Capacity = 2048;
+
+		struct Cell
+		{
+			atomic<uint64> sequence;
+			LogRecord record;
+		};
+
+		LogQueue()
+			: cells(new Cell[Capacity])
+			, enqueuePosition(0)
+			, dequeuePosition(0)
+			, writtenPosition(0)
+			, droppedCount(0)
+		{
+			for(uint64 i = 0; i < Capacity; i++)
+			{
+				cells[i].sequence.store(i, memory_order_relaxed);
+			}
+		}
+
+		// Claims the next free cell. Returns nullptr if the queue is full.
+		Cell *beginPush(uint64 &position)
+		{
+			position = enqueuePosition.load(memory_order_relaxed);
+			while(true)
+			{
+				Cell *cell = &cells[position % Capacity];
+				const int64 difference = (int64)cell->sequence.load(memory_order_acquire) - (int64)position;
+				if(difference == 0)
+				{
+					if(enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+					{
+						return cell;
+					}
+				}
+				else if(difference < 0)
+				{
+					return nullptr;
+				}
+				else
+				{
+					position = enqueuePosition.load(memory_order_relaxed);
+				}
+			}
+		}
+
+		void endPush(Cell *cell, const uint64 position)
+		{
+			cell->sequence.store(position + 1, memory_order_release);
+		}
+
+		// Only called from the log thread
+		LogRecord *front()
+		{
+			Cell *cell = &cells[dequeuePosition % Capacity];
+			return cell->sequence.load(memory_order_acquire) == dequeuePosition + 1 ? &cell->record : nullptr;
+		}
+
+		void pop()
+		{
+			Cell *cell = &cells[dequeuePosition % Capacity];
+			delete[] cell->record.longMessage;
+			cell->record.longMessage = nullptr;
+			cell->sequence.store(dequeuePosition + Capacity, memory_order_release);
+			dequeuePosition++;
+		}
+
+		unique_ptr<Cell[]> cells;
+		atomic<uint64> enqueuePosition;
+		uint64 dequeuePosition;
+		atomic<uint64> writtenPosition;
+		atomic<uint64> droppedCount;
+	};
+
+	LogQueue g_logQueue;
+	mutex g_logWakeMutex;
+	condition_variable g_logWakeCondition;
+
+	const char *g_logLevelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+	const char *g_logCategoryNames[] = { "General", "Graphics", "Audio", "Input", "Resources", "Scripting" };
+
+	// Formats \p msg into \p record, spilling to the heap if it does not fit inline
+	void formatRecord(LogRecord &record, const char *msg, va_list args)
+	{
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+		const int size = vsnprintf(record.message, LogRecord::InlineSize, msg, argsCopy);
+		va_end(argsCopy);
+
+		record.longMessage = nullptr;
+		if(size < 0)
+		{
+			record.message[0] = '\0';
+		}
+		else if((uint32)size >= LogRecord::InlineSize)
+		{
+			record.longMessage = new char[size + 1];
+			vsnprintf(record.longMessage, size + 1, msg, args);
+		}
+	}
+
+	// Appends one formatted message to \p out. The local time is only
+	// recomputed when the second changes.
+	void appendRecord(string &out, const LogRecord &record, const uint64 baseTicks, const int64 baseUnixMilliseconds)
+	{
+		thread_local int64 cachedSecond = -1;
+		thread_local char cachedTime[9] = "00:00:00";
+
+		const int64 unixMilliseconds = baseUnixMilliseconds + (int64)(record.ticks - baseTicks) / 1000000;
+		const int64 second = unixMilliseconds / 1000;
+		if(second != cachedSecond)
+		{
+			const time_t rawtime = (time_t)second;
+			tm timeinfo;
+#ifdef SAUCE_COMPILE_WINDOWS
+			localtime_s(&timeinfo, &rawtime);
+#else
+			localtime_r(&rawtime, &timeinfo);
+#endif
+			strftime(cachedTime, sizeof(cachedTime), "%H:%M:%S", &timeinfo);
+			cachedSecond = second;
+		}
+
+		char header[512];
+		snprintf(header, sizeof(header), "[%s.%03i] [%s] [%s] [%s:%i in function %s]\n",
+			cachedTime, (int)(unixMilliseconds % 1000),
+			g_logLevelNames[(uint32)record.level], g_logCategoryNames[(uint32)record.category],
+			record.file, record.line, record.function);
+		out += header;
+		out += record.getMessage();
+		out += '\n';
+	}
+}
+
+atomic<Console*> Console::s_this(nullptr);
+atomic<uint32> Console::s_minLevel((uint32)LogLevel::Debug);
+atomic<uint32> Console::s_categoryMask(0xFFFFFFFF);
 
 Console::Console() :
-	m_engine(0), // Set by the engine
-	m_output(0)
+	m_logStart(0),
+	m_running(true)
 {
 	// Check singleton
 	if(s_this)
 	{
 		THROW("Console already initialized!");
 	}
-	s_this = this;
+	m_log.reserve(MaxLogLines);
+	m_thread = thread(&Console::run, this);
+
+	// Published after the log thread exists, since Flush() reads m_thread
+	s_this.store(this, memory_order_release);
 }
 
 Console::~Console()
 {
-	delete m_output;
-	s_this = 0;
+	// Messages logged from now on are written synchronously
+	s_this.store(nullptr, memory_order_release);
+	{
+		lock_guard<mutex> lock(g_logWakeMutex);
+		m_running = false;
+	}
+	g_logWakeCondition.notify_one();
+	m_thread.join();
 }
 
-void Console::call_log(const char *msg, va_list args)
+bool Console::openLogFile(const string &filePath)
 {
-#ifdef SAUCE_COMPILE_WINDOWS
-	// Get string length
-	const size_t size = _vscprintf(msg, args);
-
-	// Create out string
-	string out;
-	out.resize(size);
-	
-	// Parse varargs
-#ifdef USE_CTR_SECURE
-	vsprintf_s(&out[0], size + 1, msg, args);
-#else
-	vsprintf(&out[0], msg, args);
-#endif
+	lock_guard<mutex> lock(m_logMutex);
+	m_output.open(filePath);
+	return m_output.is_open();
+}
+
+void Console::run()
+{
+	const uint64 baseTicks = Clock::GetTicks();
+	const int64 baseUnixMilliseconds = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+
+	string batch;
+	uint64 reportedDroppedCount = 0;
+	while(true)
+	{
+		// Drain everything that is ready into one batch
+		batch.clear();
+		while(LogRecord *record = g_logQueue.front())
+		{
+			appendRecord(batch, *record, baseTicks, baseUnixMilliseconds);
+			g_logQueue.pop();
+		}
+
+		const uint64 droppedCount = g_logQueue.droppedCount.load(memory_order_relaxed);
+		if(droppedCount != reportedDroppedCount)
+		{
+			batch += "[Console] " + to_string(droppedCount - reportedDroppedCount) + " messages were dropped because the log queue was full\n";
+			reportedDroppedCount = droppedCount;
+		}
+
+		if(!batch.empty())
+		{
+			write(batch);
+		}
+		g_logQueue.writtenPosition.store(g_logQueue.dequeuePosition, memory_order_release);
+
+		// Sleep until woken by an important message, a flush, shutdown or the next poll
+		unique_lock<mutex> lock(g_logWakeMutex);
+		if(!m_running && !g_logQueue.front())
+		{
+			break;
+		}
+		if(!g_logQueue.front())
+		{
+			g_logWakeCondition.wait_for(lock, chrono::milliseconds(10));
+		}
+	}
+}
 
+void Console::write(const string &text)
+{
 	// System log
+	fwrite(text.data(), 1, text.size(), stdout);
+	fflush(stdout);
 #ifdef SAUCE_COMPILE_WINDOWS
-	OutputDebugString(out.c_str());
-	OutputDebugString("\n");
+	OutputDebugString(text.c_str());
 #endif
-	
-	// Append message to log file
-	if(m_engine->isEnabled(EngineFlag::ExportLog))
+
+	lock_guard<mutex> lock(m_logMutex);
+
+	// Append to log file
+	if(m_output.is_open())
 	{
-		*m_output << out << endl;
-		m_output->flush();
+		m_output.write(text.data(), text.size());
+		m_output.flush();
 	}
 
-	// Append to console buffer
-	m_log.append(out);
-	m_buffer.append(out);
-#endif
-}
+	// Append to the console buffer, keeping only the newest text
+	m_buffer.append(text);
+	if(m_buffer.size() > MaxBufferSize)
+	{
+		m_buffer.erase(0, m_buffer.size() - MaxBufferSize);
+	}
 
-#ifdef SAUCE_COMPILE_WINDOWS
-#ifndef USE_CTR_SECURE
-#define CALL_LOG(format, ...)						\
-	int size = _scprintf(format, __VA_ARGS__) + 1;	\
-	char *newMsg = new char[size];					\
-	sprintf(newMsg, format, __VA_ARGS__);			\
-	s_this->call_log(newMsg, args);					\
-	delete[] newMsg;
-#else
-#define CALL_LOG(format, ...)						\
-	int size = _scprintf(format, __VA_ARGS__) + 1;	\
-	char *newMsg = new char[size];					\
-	sprintf_s(newMsg, size, format, __VA_ARGS__);	\
-	s_this->call_log(newMsg, args);					\
-	delete[] newMsg;
-#endif
-#endif
+	// Append lines to the log ring
+	size_t lineStart = 0;
+	while(lineStart < text.size())
+	{
+		size_t lineEnd = text.find('\n', lineStart);
+		if(lineEnd == string::npos)
+		{
+			lineEnd = text.size();
+		}
+
+		if(m_log.size() < MaxLogLines)
+		{
+			m_log.emplace_back(text, lineStart, lineEnd - lineStart);
+		}
+		else
+		{
+			m_log[m_logStart].assign(text, lineStart, lineEnd - lineStart);
+			m_logStart = (m_logStart + 1) % MaxLogLines;
+		}
+		lineStart = lineEnd + 1;
+	}
+}
 
-void Console::Log(const char *function, const char *file, const int line, const char *msg, ...)
+void Console::Log(const LogLevel level, const LogCategory category, const char *function, const char *file, const int line, const char *msg, ...)
 {
-	// Get argument lists
 	va_list args;
 	va_start(args, msg);
 
-	// Get timestamp
-	time_t rawtime;
-	time(&rawtime);
-	tm *timeinfo = localtime(&rawtime);
-	char timestamp[9];
-	strftime(timestamp, sizeof(timestamp), "%H:%M:%S", timeinfo);
+	if(!s_this.load(memory_order_acquire))
+	{
+		// No log thread yet, write synchronously
+		LogRecord record;
+		record.ticks = Clock::GetTicks();
+		record.level = level;
+		record.category = category;
+		record.function = function;
+		record.file = file;
+		record.line = line;
+		formatRecord(record, msg, args);
 
+		string text;
+		appendRecord(text, record, record.ticks, chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count());
+		fwrite(text.data(), 1, text.size(), stdout);
 #ifdef SAUCE_COMPILE_WINDOWS
-	CALL_LOG("[%s] [INFO] [%s:%i in function %s]\n%s", timestamp, file, line, function, msg);
+		OutputDebugString(text.c_str());
 #endif
+		delete[] record.longMessage;
+		va_end(args);
+		return;
+	}
+
+	// Claim a slot. Debug and Info messages are dropped if the log thread
+	// falls behind, more severe messages wait for space.
+	uint64 position;
+	LogQueue::Cell *cell;
+	while(!(cell = g_logQueue.beginPush(position)))
+	{
+		if(level < LogLevel::Warning)
+		{
+			g_logQueue.droppedCount.fetch_add(1, memory_order_relaxed);
+			va_end(args);
+			return;
+		}
+		g_logWakeCondition.notify_one();
+		this_thread::yield();
+	}
+
+	LogRecord &record = cell->record;
+	record.ticks = Clock::GetTicks();
+	record.level = level;
+	record.category = category;
+	record.function = function;
+	record.file = file;
+	record.line = line;
+	formatRecord(record, msg, args);
+	g_logQueue.endPush(cell, position);
 
 	va_end(args);
+
+	// Wake the log thread early for important messages and bursts
+	if(level >= LogLevel::Warning || position % (LogQueue::Capacity / 4) == 0)
+	{
+		g_logWakeCondition.notify_one();
+	}
+}
+
+void Console::Flush()
+{
+	Console *console = s_this.load(memory_order_acquire);
+	if(!console || console->m_thread.get_id() == this_thread::get_id())
+	{
+		fflush(stdout);
+		return;
+	}
+
+	const uint64 target = g_logQueue.enqueuePosition.load(memory_order_acquire);
+	while(g_logQueue.writtenPosition.load(memory_order_acquire) < target)
+	{
+		g_logWakeCondition.notify_one();
+		this_thread::sleep_for(chrono::microseconds(100));
+	}
+}
+
+void Console::SetCategoryEnabled(const LogCategory category, const bool enabled)
+{
+	if(enabled)
+	{
+		s_categoryMask.fetch_or(1u << (uint32)category, memory_order_relaxed);
+	}
+	else
+	{
+		s_categoryMask.fetch_and(~(1u << (uint32)category), memory_order_relaxed);
+	}
+}
+
+uint64 Console::GetDroppedCount()
+{
+	return g_logQueue.droppedCount.load(memory_order_relaxed);
 }
 
 string Console::getLog() const
 {
-	return m_log;
+	lock_guard<mutex> lock(m_logMutex);
+	string log;
+	for(uint32 i = 0; i < m_log.size(); i++)
+	{
+		log += m_log[(m_logStart + i) % m_log.size()];
+		log += '\n';
+	}
+	return log;
 }
 
 void Console::clear()
 {
+	lock_guard<mutex> lock(m_logMutex);
 	m_log.clear();
+	m_logStart = 0;
 }
 
 string Console::readBuffer()
 {
-	string buffer = m_buffer;
-	m_buffer.clear();
+	lock_guard<mutex> lock(m_logMutex);
+	string buffer;
+	buffer.swap(m_buffer);
 	return buffer;
 }
 
 bool Console::hasBuffer() const
 {
+	lock_guard<mutex> lock(m_logMutex);
 	return m_buffer.size() > 0;
 }
 
 void Console::clearBuffer()
 {
+	lock_guard<mutex> lock(m_logMutex);
 	m_buffer.clear();
 }
 
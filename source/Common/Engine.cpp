@@ -48,6 +48,19 @@ void FreeImageErrorHandler(FREE_IMAGE_FORMAT fif, const char *message)
 
 Game *Game::s_this = 0;
 
+// Coalescing keys of the events queued by the game loop. Each controller
+// axis has its own key.
+static const uint32 MouseMoveCoalesceKey = 1;
+static const uint32 ControllerAxisCoalesceKey = 0x100;
+
+// True for the queued events that trigger keybinds
+static bool IsKeybindEvent(const int32 type)
+{
+	return (type > (int32)KeyEventType::_StartEventID && type < (int32)KeyEventType::_MaxEventID) ||
+		(type > (int32)ControllerButtonEventType::_StartEventID && type < (int32)ControllerButtonEventType::_MaxEventID) ||
+		type == (int32)CoreEventType::ControllerAxis;
+}
+
 Game::Game()
 	: m_initialized(false)
 	, m_paused(false)
@@ -55,6 +68,10 @@ Game::Game()
 	, m_console(nullptr)
 	, m_fileSystem(nullptr)
 	, m_framesPerSecond(0.0)
+	, m_tickCount(0)
+	, m_stateChecksum(0)
+	, m_headlessGraphicsContext(nullptr)
+	, m_inputReplay(nullptr)
 	, m_inputManager(nullptr)
 	, m_resourceManager(nullptr)
 	, m_scene(nullptr)
@@ -67,10 +84,14 @@ Game::Game()
 Game::~Game()
 {
 	// Release managers
+	delete m_inputReplay;
 	delete m_fileSystem;
 	delete m_timer;
 	delete m_console;
 	delete m_resourceManager;
+
+	// Resources release their device objects through the context, so it goes last
+	delete m_headlessGraphicsContext;
 	s_this = 0;
 }
 
@@ -120,20 +141,24 @@ int Game::run(const GameDesc &desc)
 		//m_fileSystem = new FileSystem();
 		if(isEnabled(EngineFlag::ExportLog))
 		{
-			m_console->m_output = new ofstream();
-			m_console->m_output->open("console.log");
+			m_console->openLogFile("console.log");
 		}
 
 		m_timer = new Timer();
 		//m_audio = new AudioManager();
 
-		m_console->m_engine = this;
-
 		LOG("** Initializing Engine **");
 		LOG("** Current working dir: %s **", util::getWorkingDirectory().c_str());
 
-		// Initialize SDL
-		THROW_IF(SDL_Init(SDL_INIT_EVERYTHING) < 0, "Unable to initialize SDL");
+		// Mount asset pack files
+		for(const string &packFile : desc.packFiles)
+		{
+			util::mountPackFile(packFile);
+		}
+
+		// Initialize SDL. Headless runs have no display or audio device.
+		const bool headless = isEnabled(EngineFlag::Headless);
+		THROW_IF(SDL_Init(headless ? SDL_INIT_EVENTS | SDL_INIT_TIMER : SDL_INIT_EVERYTHING) < 0, "Unable to initialize SDL");
 
 		SDL_version sdlver;
 		SDL_GetVersion(&sdlver);
@@ -153,12 +178,34 @@ int Game::run(const GameDesc &desc)
 
 		// Initialize graphics context and window
 		GraphicsContext *graphicsContext = 0;
-		switch(desc.graphicsBackend)
+		Window *mainWindow = 0;
+		if(headless)
+		{
+			graphicsContext = new NullGraphicsContext(1280, 720);
+		}
+		else
+		{
+			switch(desc.graphicsBackend)
+			{
+				case GraphicsBackend::Null: graphicsContext = new NullGraphicsContext(1280, 720); break;
+				default: graphicsContext = new OpenGLContext(4, 2); break;
+			}
+			mainWindow = graphicsContext->createWindow(desc.name.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720, windowFlags);
+			m_windows.push_back(mainWindow);
+		}
+
+		// Record the draw traffic of the whole session
+		if(!desc.graphicsCaptureFile.empty())
+		{
+			graphicsContext = new RecordingGraphicsContext(graphicsContext, desc.graphicsCaptureFile);
+		}
+
+		// Move GPU submission to a render thread. Everything created from
+		// here on goes through the threaded context.
+		if(isEnabled(EngineFlag::RenderThread))
 		{
-			default: graphicsContext = new OpenGLContext(4, 2); break;
+			graphicsContext = new ThreadedGraphicsContext(graphicsContext);
 		}
-		Window *mainWindow = graphicsContext->createWindow(desc.name.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720, windowFlags);
-		m_windows.push_back(mainWindow);
 
 		// Initialize font rendering system
 		FontRenderingSystem::Initialize(graphicsContext);
@@ -166,12 +213,35 @@ int Game::run(const GameDesc &desc)
 		// Initialize input handler
 		m_inputManager = new InputManager("InputConfig.xml");
 
+		// Set up input recording and playback
+		InputScript *inputScript = desc.inputScript;
+		if(!desc.inputReplayFile.empty())
+		{
+			m_inputReplay = new InputScript();
+			THROW_IF(!m_inputReplay->load(desc.inputReplayFile), "Unable to load input replay \"%s\"", desc.inputReplayFile.c_str());
+			inputScript = m_inputReplay;
+		}
+		if(!desc.inputRecordingFile.empty())
+		{
+			m_inputManager->startRecording(desc.inputRecordingFile);
+		}
+
 		m_scene = new Scene(this);
 		
 		// Start listening for SDL text input
-		SDL_StartTextInput();
+		if(!headless)
+		{
+			SDL_StartTextInput();
+		}
+
+		// Without a window the context is ours to release
+		if(headless)
+		{
+			m_headlessGraphicsContext = graphicsContext;
+		}
 
 		// Initialize ImGui
+		if(!headless)
 		{
 			SDL_SysWMinfo info;
 			SDL_VERSION(&info.version);
@@ -190,17 +260,20 @@ int Game::run(const GameDesc &desc)
 			onEvent(&e);
 		}
 		
-		// Fps sampling
-		const uint numFpsSamples = 8;
-		double fpsSamples[numFpsSamples];
-		for(uint i = 0; i < numFpsSamples; ++i) fpsSamples[i] = 0.0;
-		uint currFpsSample = 0;
-
-		// Setup game loop
+		// Setup game loop. Time is accumulated in integer clock ticks so that
+		// the fixed timestep does not drift over long sessions.
 		m_timer->start();
 		const double dt = desc.deltaTime;
-		double accumulator = 0.0;
-		double prevTime = m_timer->getElapsedTime();
+		const uint64 tickDuration = max<uint64>(Clock::SecondsToTicks(dt), 1);
+		const uint64 maxFrameTicks = Clock::SecondsToTicks(0.25);
+		const uint64 frameLimitTicks = desc.maxFramesPerSecond > 0.0 ? Clock::SecondsToTicks(1.0 / desc.maxFramesPerSecond) : 0;
+		uint64 accumulator = 0;
+		uint64 frameCount = 0;
+		uint64 simulationTicks = 0;
+		m_tickCount = 0;
+		uint64 prevTicks = m_timer->getElapsedTicks();
+		uint64 nextFrameTicks = prevTicks;
+		m_frameTimeStats.reset();
 
 		// Make sure update is called once before draw
 		{
@@ -209,13 +282,31 @@ int Game::run(const GameDesc &desc)
 		}
 
 		// Game loop
+		Profiler::SetThreadName("Main");
 		while(m_running)
 		{
+			Profiler::NewFrame();
+			PROFILE_SCOPE("Frame");
+
+			// Inject scripted input. Live input is discarded until the script
+			// has ended, as it would make the run diverge from the script.
+			if(inputScript && !inputScript->isFinished())
+			{
+				SDL_PumpEvents();
+				SDL_FlushEvents(SDL_KEYDOWN, SDL_MOUSEWHEEL);
+				SDL_FlushEvents(SDL_CONTROLLERAXISMOTION, SDL_CONTROLLERBUTTONUP);
+				inputScript->pushEvents(m_tickCount);
+			}
+
 			// Event handling
 			SDL_Event event;
-			char textInputChar = '\0';
 			while(SDL_PollEvent(&event))
 			{
+				m_inputManager->processEvent(m_tickCount, event);
+				if(!headless)
+				{
+					ImGuiSystem::processEvent(event);
+				}
 				switch(event.type)
 				{
 					case SDL_WINDOWEVENT:
@@ -245,16 +336,14 @@ int Game::run(const GameDesc &desc)
 
 					case SDL_KEYUP: case SDL_KEYDOWN:
 					{
-						// Send key input event
-						KeyEvent e(
+						// Queue key input event
+						m_eventQueue.push<KeyEvent>(
 							event.type == SDL_KEYDOWN ?
 							(event.key.repeat == 0 ? KeyEventType::Down : KeyEventType::Repeat) :
 							KeyEventType::Up,
 							m_inputManager,
 							(Scancode)event.key.keysym.scancode,
 							event.key.keysym.mod);
-						onEvent(&e);
-						m_inputManager->updateKeybinds(&e);
 					}
 					break;
 
@@ -263,11 +352,9 @@ int Game::run(const GameDesc &desc)
 						// If no modifiers are pressed
 						if((SDL_GetModState() & (KMOD_CTRL | KMOD_ALT)) == 0)
 						{
-							// Send text input event
-							TextEvent e(event.text.text[0]);
-							onEvent(&e);
+							// Queue text input event
+							m_eventQueue.push<TextEvent>(event.text.text[0]);
 						}
-						textInputChar = event.text.text[0];
 					}
 					break;
 
@@ -277,43 +364,36 @@ int Game::run(const GameDesc &desc)
 						m_inputManager->m_x = event.motion.x;
 						m_inputManager->m_y = event.motion.y;
 
-						// Send mouse move event
-						MouseEvent e(MouseEventType::Move, m_inputManager, event.motion.x, event.motion.y, SAUCE_MOUSE_BUTTON_NONE, 0, 0);
-						onEvent(&e);
+						// Queue mouse move event. Only the last move before a
+						// button or key event is dispatched.
+						m_eventQueue.pushCoalesced<MouseEvent>(MouseMoveCoalesceKey, MouseEventType::Move, m_inputManager, event.motion.x, event.motion.y, SAUCE_MOUSE_BUTTON_NONE, 0, 0);
 					}
 					break;
 
 					case SDL_MOUSEBUTTONDOWN:
 					{
 						// MouseEvent
-						MouseEvent mouseEvent(MouseEventType::Down, m_inputManager, m_inputManager->m_x, m_inputManager->m_y, (const MouseButton) event.button.button, 0, 0);
-						onEvent(&mouseEvent);
+						m_eventQueue.push<MouseEvent>(MouseEventType::Down, m_inputManager, m_inputManager->m_x, m_inputManager->m_y, (const MouseButton) event.button.button, 0, 0);
 
 						// KeyEvent
-						KeyEvent keyEvent(KeyEventType::Down, m_inputManager, (const MouseButton) event.button.button, event.key.keysym.mod);
-						onEvent(&keyEvent);
-						m_inputManager->updateKeybinds(&keyEvent);
+						m_eventQueue.push<KeyEvent>(KeyEventType::Down, m_inputManager, (const MouseButton) event.button.button, event.key.keysym.mod);
 					}
 					break;
 
 					case SDL_MOUSEBUTTONUP:
 					{
 						// MouseEvent
-						MouseEvent mouseEvent(MouseEventType::Up, m_inputManager, m_inputManager->m_x, m_inputManager->m_y, (const MouseButton) event.button.button, 0, 0);
-						onEvent(&mouseEvent);
+						m_eventQueue.push<MouseEvent>(MouseEventType::Up, m_inputManager, m_inputManager->m_x, m_inputManager->m_y, (const MouseButton) event.button.button, 0, 0);
 
 						// KeyEvent
-						KeyEvent keyEvent(KeyEventType::Up, m_inputManager, (const MouseButton) event.button.button, event.key.keysym.mod);
-						onEvent(&keyEvent);
-						m_inputManager->updateKeybinds(&keyEvent);
+						m_eventQueue.push<KeyEvent>(KeyEventType::Up, m_inputManager, (const MouseButton) event.button.button, event.key.keysym.mod);
 					}
 					break;
 
 					case SDL_MOUSEWHEEL:
 					{
 						// Scroll event
-						MouseEvent mouseEvent(MouseEventType::Wheel, m_inputManager, m_inputManager->m_x, m_inputManager->m_y, SAUCE_MOUSE_BUTTON_NONE, event.wheel.x, event.wheel.y);
-						onEvent(&mouseEvent);
+						m_eventQueue.push<MouseEvent>(MouseEventType::Wheel, m_inputManager, m_inputManager->m_x, m_inputManager->m_y, SAUCE_MOUSE_BUTTON_NONE, event.wheel.x, event.wheel.y);
 					}
 					break;
 
@@ -335,19 +415,15 @@ int Game::run(const GameDesc &desc)
 
 					case SDL_CONTROLLERBUTTONDOWN:
 					{
-						// Send controller button event
-						ControllerButtonEvent e(ControllerButtonEventType::Down, m_inputManager, (const ControllerButton)event.cbutton.button);// , event.cbutton.which);
-						onEvent(&e);
-						m_inputManager->updateKeybinds(&e);
+						// Queue controller button event
+						m_eventQueue.push<ControllerButtonEvent>(ControllerButtonEventType::Down, m_inputManager, (const ControllerButton)event.cbutton.button);// , event.cbutton.which);
 					}
 					break;
 
 					case SDL_CONTROLLERBUTTONUP:
 					{
-						// Send controller button event
-						ControllerButtonEvent e(ControllerButtonEventType::Up, m_inputManager, (const ControllerButton) event.cbutton.button);// , event.cbutton.which);
-						onEvent(&e);
-						m_inputManager->updateKeybinds(&e);
+						// Queue controller button event
+						m_eventQueue.push<ControllerButtonEvent>(ControllerButtonEventType::Up, m_inputManager, (const ControllerButton) event.cbutton.button);// , event.cbutton.which);
 					}
 					break;
   
@@ -361,11 +437,9 @@ int Game::run(const GameDesc &desc)
 								// And the axis exceedes the threshold value
 								if(AXIS_VALUE_TO_FLOAT(event.caxis.value) >= m_inputManager->m_triggerThreshold)
 								{
-									// Flag trigger as pressed and send controller button event
+									// Flag trigger as pressed and queue controller button event
 									m_inputManager->m_rightTrigger = true;
-									ControllerButtonEvent e(ControllerButtonEventType::Down, m_inputManager, SAUCE_CONTROLLER_BUTTON_RIGHT_TRIGGER);// , event.cbutton.which);
-									onEvent(&e);
-									m_inputManager->updateKeybinds(&e);
+									m_eventQueue.push<ControllerButtonEvent>(ControllerButtonEventType::Down, m_inputManager, SAUCE_CONTROLLER_BUTTON_RIGHT_TRIGGER);// , event.cbutton.which);
 								}
 							}
 							else
@@ -373,9 +447,7 @@ int Game::run(const GameDesc &desc)
 								if(AXIS_VALUE_TO_FLOAT(event.caxis.value) < m_inputManager->m_triggerThreshold)
 								{
 									m_inputManager->m_rightTrigger = false;
-									ControllerButtonEvent e(ControllerButtonEventType::Up, m_inputManager, SAUCE_CONTROLLER_BUTTON_RIGHT_TRIGGER);// , event.cbutton.which);
-									onEvent(&e);
-									m_inputManager->updateKeybinds(&e);
+									m_eventQueue.push<ControllerButtonEvent>(ControllerButtonEventType::Up, m_inputManager, SAUCE_CONTROLLER_BUTTON_RIGHT_TRIGGER);// , event.cbutton.which);
 								}
 							}
 						}
@@ -386,9 +458,7 @@ int Game::run(const GameDesc &desc)
 								if(event.caxis.value >= m_inputManager->m_triggerThreshold)
 								{
 									m_inputManager->m_leftTrigger = true;
-									ControllerButtonEvent e(ControllerButtonEventType::Down, m_inputManager, SAUCE_CONTROLLER_BUTTON_LEFT_TRIGGER);// , event.cbutton.which);
-									onEvent(&e);
-									m_inputManager->updateKeybinds(&e);
+									m_eventQueue.push<ControllerButtonEvent>(ControllerButtonEventType::Down, m_inputManager, SAUCE_CONTROLLER_BUTTON_LEFT_TRIGGER);// , event.cbutton.which);
 								}
 							}
 							else
@@ -396,41 +466,55 @@ int Game::run(const GameDesc &desc)
 								if(event.caxis.value < m_inputManager->m_triggerThreshold)
 								{
 									m_inputManager->m_leftTrigger = false;
-									ControllerButtonEvent e(ControllerButtonEventType::Up, m_inputManager, SAUCE_CONTROLLER_BUTTON_LEFT_TRIGGER);// , event.cbutton.which);
-									onEvent(&e);
-									m_inputManager->updateKeybinds(&e);
+									m_eventQueue.push<ControllerButtonEvent>(ControllerButtonEventType::Up, m_inputManager, SAUCE_CONTROLLER_BUTTON_LEFT_TRIGGER);// , event.cbutton.which);
 								}
 							}
 						}
 
-						// Send controller axis event
-						ControllerAxisEvent e(m_inputManager, (const ControllerAxis) event.caxis.axis, event.caxis.value);// , event.cbutton.which);
-						onEvent(&e);
-						m_inputManager->updateKeybinds(&e);
+						// Queue controller axis event. Only the last value of each
+						// axis before a button or key event is dispatched.
+						m_eventQueue.pushCoalesced<ControllerAxisEvent>(ControllerAxisCoalesceKey + event.caxis.axis, m_inputManager, (const ControllerAxis) event.caxis.axis, event.caxis.value);// , event.cbutton.which);
 					}
 					break;
 				}
 			}
 
+			// Dispatch the input events of this frame
+			{
+				PROFILE_SCOPE("Input Events");
+				m_eventQueue.dispatch([this](Event *e)
+				{
+					onEvent(e);
+					if(IsKeybindEvent(e->getType()))
+					{
+						m_inputManager->updateKeybinds(static_cast<InputEvent*>(e));
+					}
+				});
+			}
+
 			// Check if game is paused or out of focus
-			if(m_paused || (!isEnabled(EngineFlag::RunInBackground) && !mainWindow->checkFlags(SDL_WINDOW_INPUT_FOCUS)))
+			if(m_paused || (mainWindow && !isEnabled(EngineFlag::RunInBackground) && !mainWindow->checkFlags(SDL_WINDOW_INPUT_FOCUS)))
 			{
 				continue;
 			}
 
 			// Calculate time delta
-			const double currentTime = m_timer->getElapsedTime();
-			double deltaTime = currentTime - prevTime;
-			prevTime = currentTime;
+			const uint64 currentTicks = m_timer->getElapsedTicks();
+			const uint64 frameTicks = currentTicks - prevTicks;
+			prevTicks = currentTicks;
+			m_frameTimeStats.addSample(frameTicks);
+			m_framesPerSecond = m_frameTimeStats.getAverageFramesPerSecond();
 
-			// Avoid spiral of death
-			if(deltaTime > 0.25)
-			{
-				deltaTime = 0.25;
-			}
+			// Avoid spiral of death. Headless runs do not wait for the
+			// clock and step exactly one tick per frame.
+			const uint64 deltaTicks = headless ? tickDuration : min(frameTicks, maxFrameTicks);
+			const double deltaTime = Clock::TicksToSeconds(deltaTicks);
 
 			// TODO: Make a scene object instead?
-			ImGuiSystem::processInputs(deltaTime, textInputChar);
+			if(!headless)
+			{
+				ImGuiSystem::processInputs(deltaTime);
+			}
 
 			// Step begin
 			{
@@ -439,56 +523,114 @@ int Game::run(const GameDesc &desc)
 			}
 
 			// Apply time delta to accumulator
-			accumulator += deltaTime;
-			while(accumulator >= dt)
+			accumulator += deltaTicks;
+			while(accumulator >= tickDuration && (desc.tickCount == 0 || m_tickCount < desc.tickCount))
 			{
 				// Update the game
 				{
+					PROFILE_SCOPE("Tick");
+					const uint64 tickStartTicks = Clock::GetTicks();
 					TickEvent e(dt);
 					onEvent(&e);
+					simulationTicks += Clock::GetTicks() - tickStartTicks;
 				}
-				accumulator -= dt;
+				accumulator -= tickDuration;
+				++m_tickCount;
 			}
 
 			// New ImGui frame
-			ImGuiSystem::newFrame();
+			if(!headless)
+			{
+				ImGuiSystem::newFrame();
+			}
+
+			// Headless runs only draw every drawInterval ticks
+			const bool draw = !headless || (desc.drawInterval > 0 && m_tickCount % desc.drawInterval == 0);
 
 			// Draw the game
-			const double alpha = accumulator / dt;
+			const double alpha = double(accumulator) / double(tickDuration);
+			if(draw)
 			{
+				PROFILE_SCOPE("Draw");
+				PROFILE_GPU_SCOPE(graphicsContext, "Draw");
 				DrawEvent e(alpha, dt, graphicsContext);
 				onEvent(&e);
 			}
 
 			// Draw ImGui last
-			ImGuiSystem::render();
-
-			SDL_GL_SwapWindow(mainWindow->getSDLHandle());
-			graphicsContext->clear(BufferMask::Color | BufferMask::Depth);
+			if(!headless)
+			{
+				PROFILE_SCOPE("ImGui");
+				PROFILE_GPU_SCOPE(graphicsContext, "ImGui");
+				if(isEnabled(EngineFlag::ShowProfiler))
+				{
+					Profiler::DrawOverlay();
+				}
+				ImGuiSystem::render();
+			}
 
-			// Add fps sample
-			if(deltaTime != 0.0f)
+			// Pace frames if a frame rate limit is set
+			if(frameLimitTicks > 0)
 			{
-				fpsSamples[currFpsSample++] = 1.0 / deltaTime;
-				if(currFpsSample >= numFpsSamples)
+				PROFILE_SCOPE("Frame Limiter");
+				nextFrameTicks += frameLimitTicks;
+				const uint64 nowTicks = m_timer->getElapsedTicks();
+				if(nextFrameTicks > nowTicks)
+				{
+					Clock::SleepUntil(Clock::GetTicks() + (nextFrameTicks - nowTicks));
+				}
+				else
 				{
-					currFpsSample = 0;
+					// We fell behind, don't try to catch up
+					nextFrameTicks = nowTicks;
 				}
 			}
 
-			// Get average fps
-			double fps = 0.0;
-			for(uint i = 0; i < numFpsSamples; i++) fps += fpsSamples[i];
-			m_framesPerSecond = fps / numFpsSamples;
+			if(draw)
+			{
+				{
+					PROFILE_SCOPE("Swap");
+					graphicsContext->swapBuffers();
+				}
+				graphicsContext->resolveProfileScopes();
+				graphicsContext->clear(BufferMask::Color | BufferMask::Depth);
+			}
 
 			// Step end
 			{
 				StepEvent e(StepEventType::End);
 				onEvent(&e);
 			}
+
+			// Scratch vertices are also handed out while ticking, so return them every step
+			graphicsContext->resetScratchVertices();
+
+			// End after a fixed number of frames or ticks if requested
+			if((desc.frameCount > 0 && ++frameCount >= desc.frameCount) ||
+				(desc.tickCount > 0 && m_tickCount >= desc.tickCount))
+			{
+				end();
+			}
 		}
 gameloopend:
 
+		// Write the input recording
+		m_inputManager->stopRecording();
+
+		// Fingerprint the final state so that runs can be compared
+		{
+			StateHasher hasher;
+			hashState(hasher);
+			m_stateChecksum = hasher.getHash();
+		}
+
+		if(headless)
+		{
+			LOG("Simulated %llu ticks in %.3f s (%.3f us/tick), state checksum %016llx",
+				(unsigned long long)m_tickCount, Clock::TicksToSeconds(simulationTicks),
+				m_tickCount > 0 ? simulationTicks / 1000.0 / m_tickCount : 0.0, (unsigned long long)m_stateChecksum);
+		}
+
 		SDL_StopTextInput();
 		
 		LOG("** Game Ending **");
@@ -504,14 +646,21 @@ gameloopend:
 		stringstream ss;
 		ss << e.message() << endl << "------------------------------------------------------------------------------------------------" << endl;
 		ss << "Callstack: " << endl << e.callstack();
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "An error occured", ss.str().c_str(), m_windows.front()->getSDLHandle());
-		LOG("An exception occured: %s", ss.str().c_str());
+		if(!isEnabled(EngineFlag::Headless))
+		{
+			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "An error occured", ss.str().c_str(), m_windows.empty() ? nullptr : m_windows.front()->getSDLHandle());
+		}
+		LOG_ERROR("An exception occured: %s", ss.str().c_str());
+		Console::Flush();
 		return (uint32)e.errorCode();
 	}
 
 	// Free font rendering system
 	FontRenderingSystem::Free();
 
+	// Release mapped pack files
+	util::unmountPackFiles();
+
 	return (uint32)RetCode::Ok;
 }
 
@@ -539,7 +688,7 @@ Window *Game::getWindow(const Sint32 id) const
 {
 	if(id < 0)
 	{
-		return m_windows.front();
+		return m_windows.empty() ? nullptr : m_windows.front();
 	}
 	for(Window *window : m_windows)
 	{
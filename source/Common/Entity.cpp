@@ -0,0 +1,148 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+const uint32 ComponentPoolBase::InvalidIndex;
+
+EntityWorld::EntityWorld() :
+	m_entityCount(0),
+	m_iterationDepth(0)
+{
+}
+
+EntityWorld::~EntityWorld()
+{
+}
+
+uint32 EntityWorld::NextComponentTypeID()
+{
+	static atomic<uint32> nextTypeID(0);
+	return nextTypeID++;
+}
+
+Entity EntityWorld::createEntity()
+{
+	uint32 slot;
+	if(!m_freeSlots.empty())
+	{
+		slot = m_freeSlots.front();
+		m_freeSlots.pop_front();
+	}
+	else
+	{
+		THROW_IF(m_generations.size() >= 0xFFFFFFFF, "Too many entities (max %u)", 0xFFFFFFFF);
+		slot = (uint32)m_generations.size();
+		m_generations.push_back(0);
+	}
+	m_entityCount++;
+	return ((Entity)m_generations[slot] << 32) | slot;
+}
+
+void EntityWorld::destroyEntity(const Entity entity)
+{
+	if(!isAlive(entity))
+	{
+		return;
+	}
+
+	if(m_iterationDepth > 0)
+	{
+		m_pendingDestroys.push_back(entity);
+		return;
+	}
+
+	for(unique_ptr<ComponentPoolBase> &pool : m_pools)
+	{
+		if(pool)
+		{
+			pool->remove(entity);
+		}
+	}
+
+	// Bump the generation so that existing handles to the slot become invalid.
+	// A slot whose generation is used up is retired instead of wrapping around.
+	const uint32 slot = GetEntitySlot(entity);
+	if(m_generations[slot] < 0xFFFFFFFF)
+	{
+		m_generations[slot]++;
+		m_freeSlots.push_back(slot);
+	}
+	m_entityCount--;
+}
+
+bool EntityWorld::isAlive(const Entity entity) const
+{
+	const uint32 slot = GetEntitySlot(entity);
+	return slot < m_generations.size() && m_generations[slot] == GetEntityGeneration(entity);
+}
+
+void EntityWorld::endIteration()
+{
+	if(--m_iterationDepth > 0)
+	{
+		return;
+	}
+
+	// Removals may refer to entities that are destroyed below, so they go first
+	for(const pair<ComponentPoolBase*, Entity> &removal : m_pendingRemovals)
+	{
+		removal.first->remove(removal.second);
+	}
+	m_pendingRemovals.clear();
+
+	for(const Entity entity : m_pendingDestroys)
+	{
+		destroyEntity(entity);
+	}
+	m_pendingDestroys.clear();
+}
+
+void EntityWorld::cancelPendingRemoval(ComponentPoolBase *pool, const Entity entity)
+{
+	m_pendingRemovals.erase(remove(m_pendingRemovals.begin(), m_pendingRemovals.end(), make_pair(pool, entity)), m_pendingRemovals.end());
+}
+
+void EntityWorld::addSystem(EntitySystem *system)
+{
+	if(system && find(m_systems.begin(), m_systems.end(), system) == m_systems.end())
+	{
+		m_systems.push_back(system);
+	}
+}
+
+void EntityWorld::removeSystem(EntitySystem *system)
+{
+	m_systems.erase(remove(m_systems.begin(), m_systems.end(), system), m_systems.end());
+}
+
+void EntityWorld::onTick(TickEvent *e)
+{
+	for(EntitySystem *system : m_systems)
+	{
+		system->onTick(this, e);
+	}
+	SceneObject::onTick(e);
+}
+
+void EntityWorld::onDraw(DrawEvent *e)
+{
+	for(EntitySystem *system : m_systems)
+	{
+		system->onDraw(this, e);
+	}
+	SceneObject::onDraw(e);
+}
+
+END_SAUCE_NAMESPACE
@@ -0,0 +1,59 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+const uint32 EventQueue::NoCoalescing;
+const uint32 EventQueue::BlockSize;
+
+EventQueue::EventQueue() :
+	m_coalesceBegin(0),
+	m_currentBlock(0),
+	m_blockOffset(0),
+	m_coalescedCount(0)
+{
+}
+
+void EventQueue::clear()
+{
+	m_events.clear();
+	m_coalesceBegin = 0;
+	m_currentBlock = 0;
+	m_blockOffset = 0;
+}
+
+void *EventQueue::allocate(const size_t size, const size_t alignment)
+{
+	m_blockOffset = (m_blockOffset + alignment - 1) & ~(alignment - 1);
+	if(m_blocks.empty() || m_blockOffset + size > BlockSize)
+	{
+		// Continue in the next block, allocating it if this is the largest
+		// the queue has been
+		if(!m_blocks.empty())
+		{
+			m_currentBlock++;
+		}
+		if(m_currentBlock == m_blocks.size())
+		{
+			m_blocks.emplace_back(new uint8[BlockSize]);
+		}
+		m_blockOffset = 0;
+	}
+
+	void *memory = m_blocks[m_currentBlock].get() + m_blockOffset;
+	m_blockOffset += size;
+	return memory;
+}
+
+END_SAUCE_NAMESPACE
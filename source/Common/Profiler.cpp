@@ -0,0 +1,328 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+#include <Sauce/Graphics.h>
+#include <Sauce/ImGui.h>
+#include <Sauce/Utils.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**
+ * Globals used by the Profiler
+ */
+atomic<bool>                      Profiler::s_enabled(true);
+mutex                             g_profilerTracksMutex;
+vector<unique_ptr<ProfilerTrack>> g_profilerTracks;
+thread_local ProfilerTrack*       g_profilerThreadTrack = nullptr;
+ProfilerTrack*                    g_profilerGPUTrack = nullptr;
+
+/** Last completed frame, kept for the overlay (main thread only) */
+uint64                            g_profilerFrameStartIndex = 0;
+uint64                            g_profilerFrameStartTicks = 0;
+uint64                            g_profilerLastFrameTicks = 0;
+vector<ProfilerEvent>             g_profilerLastFrameEvents;
+
+/** Last resolved GPU frame, submitted by the render thread (guarded by g_profilerTracksMutex) */
+vector<ProfilerEvent>             g_profilerLastGPUFrameEvents;
+
+static ProfilerTrack* createTrack(const string& name)
+{
+	lock_guard<mutex> lock(g_profilerTracksMutex);
+	g_profilerTracks.push_back(unique_ptr<ProfilerTrack>(new ProfilerTrack((uint32)g_profilerTracks.size(), name)));
+	return g_profilerTracks.back().get();
+}
+
+static void sortEventsByStart(vector<ProfilerEvent>& events)
+{
+	// Events are recorded when their scope ends, so parents come after their children
+	stable_sort(events.begin(), events.end(), [](const ProfilerEvent& a, const ProfilerEvent& b)
+	{
+		return a.startTicks < b.startTicks || (a.startTicks == b.startTicks && a.depth < b.depth);
+	});
+}
+
+//--------------------------------------------------------------
+// ProfilerTrack
+//--------------------------------------------------------------
+ProfilerTrack::ProfilerTrack(const uint32 trackId, const string& name)
+	: m_events(new ProfilerEvent[Capacity])
+	, m_writeIndex(0)
+	, m_depth(0)
+	, m_trackId(trackId)
+	, m_name(name)
+{
+}
+
+void ProfilerTrack::snapshot(vector<ProfilerEvent>& outEvents, const uint64 fromIndex) const
+{
+	const uint64 endIndex = m_writeIndex.load(memory_order_acquire);
+	const uint64 beginIndex = max(fromIndex, endIndex > Capacity ? endIndex - Capacity : 0);
+	if (beginIndex >= endIndex)
+	{
+		return;
+	}
+
+	const size_t outBegin = outEvents.size();
+	for (uint64 i = beginIndex; i < endIndex; ++i)
+	{
+		outEvents.push_back(m_events[i % Capacity]);
+	}
+
+	// The writer may have lapped us while we were copying. Drop every
+	// entry it could have overwritten, including the one it may be writing.
+	const uint64 newEndIndex = m_writeIndex.load(memory_order_acquire);
+	if (newEndIndex + 1 > beginIndex + Capacity)
+	{
+		const uint64 overwrittenCount = min(newEndIndex + 1 - Capacity - beginIndex, endIndex - beginIndex);
+		outEvents.erase(outEvents.begin() + outBegin, outEvents.begin() + outBegin + (size_t)overwrittenCount);
+	}
+}
+
+//--------------------------------------------------------------
+// Profiler
+//--------------------------------------------------------------
+void Profiler::SetThreadName(const string& name)
+{
+	ProfilerTrack* track = GetThreadTrack();
+	lock_guard<mutex> lock(g_profilerTracksMutex);
+	track->m_name = name;
+}
+
+ProfilerTrack* Profiler::GetThreadTrack()
+{
+	if (!g_profilerThreadTrack)
+	{
+		stringstream threadName;
+		threadName << "Thread " << this_thread::get_id();
+		g_profilerThreadTrack = createTrack(threadName.str());
+	}
+	return g_profilerThreadTrack;
+}
+
+void Profiler::SubmitGPUEvents(const vector<ProfilerEvent>& events)
+{
+	if (!g_profilerGPUTrack)
+	{
+		g_profilerGPUTrack = createTrack("GPU");
+	}
+
+	for (const ProfilerEvent& profilerEvent : events)
+	{
+		g_profilerGPUTrack->push(profilerEvent);
+	}
+
+	vector<ProfilerEvent> sortedEvents(events);
+	sortEventsByStart(sortedEvents);
+
+	lock_guard<mutex> lock(g_profilerTracksMutex);
+	g_profilerLastGPUFrameEvents.swap(sortedEvents);
+}
+
+void Profiler::NewFrame()
+{
+	ProfilerTrack* track = GetThreadTrack();
+	const uint64 currentTicks = Clock::GetTicks();
+
+	// Keep the events of the frame that just ended for the overlay
+	if (g_profilerFrameStartTicks != 0)
+	{
+		g_profilerLastFrameEvents.clear();
+		track->snapshot(g_profilerLastFrameEvents, g_profilerFrameStartIndex);
+		sortEventsByStart(g_profilerLastFrameEvents);
+		g_profilerLastFrameTicks = currentTicks - g_profilerFrameStartTicks;
+	}
+
+	g_profilerFrameStartIndex = track->getWriteIndex();
+	g_profilerFrameStartTicks = currentTicks;
+}
+
+void Profiler::DrawOverlay()
+{
+	if (!ImGui::Begin("Profiler"))
+	{
+		ImGui::End();
+		return;
+	}
+
+	// Frame time distribution
+	const FrameTimeStats& frameTimeStats = Game::Get()->getFrameTimeStats();
+	ImGui::Text("Frame: %.2f ms (p50: %.2f ms, p99: %.2f ms, max: %.2f ms)",
+		Clock::TicksToSeconds(g_profilerLastFrameTicks) * 1000.0,
+		Clock::TicksToSeconds(frameTimeStats.getPercentile(50.0)) * 1000.0,
+		Clock::TicksToSeconds(frameTimeStats.getPercentile(99.0)) * 1000.0,
+		Clock::TicksToSeconds(frameTimeStats.getMax()) * 1000.0);
+
+	static vector<uint64> frameTimeSamples;
+	static vector<float> frameTimesMs;
+	frameTimeStats.getSamples(frameTimeSamples);
+	frameTimesMs.resize(frameTimeSamples.size());
+	for (size_t i = 0; i < frameTimeSamples.size(); ++i)
+	{
+		frameTimesMs[i] = float(Clock::TicksToSeconds(frameTimeSamples[i]) * 1000.0);
+	}
+	ImGui::PlotLines("##FrameTimes", frameTimesMs.data(), (int)frameTimesMs.size(), 0, "Frame time (ms)", 0.0f, FLT_MAX, ImVec2(0, 60));
+
+	// Scopes of the last frame
+	const auto drawEvents = [](const char* label, const vector<ProfilerEvent>& events)
+	{
+		if (ImGui::CollapsingHeader(label, ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			for (const ProfilerEvent& profilerEvent : events)
+			{
+				ImGui::Text("%*s%s", profilerEvent.depth * 2, "", profilerEvent.name);
+				ImGui::SameLine(ImGui::GetWindowContentRegionWidth() * 0.6f);
+				ImGui::Text("%.3f ms", Clock::TicksToSeconds(profilerEvent.endTicks - profilerEvent.startTicks) * 1000.0);
+			}
+		}
+	};
+	drawEvents("CPU", g_profilerLastFrameEvents);
+
+	static vector<ProfilerEvent> gpuFrameEvents;
+	{
+		lock_guard<mutex> lock(g_profilerTracksMutex);
+		gpuFrameEvents = g_profilerLastGPUFrameEvents;
+	}
+	drawEvents("GPU", gpuFrameEvents);
+
+	bool enabled = IsEnabled();
+	if (ImGui::Checkbox("Enabled", &enabled))
+	{
+		SetEnabled(enabled);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export Chrome trace"))
+	{
+		ExportChromeTrace("prefs:/ProfilerTrace.json");
+	}
+
+	ImGui::End();
+}
+
+bool Profiler::ExportChromeTrace(const string& filePath)
+{
+	// Snapshot every track
+	vector<pair<string, uint32>> trackInfos;
+	vector<vector<ProfilerEvent>> trackEvents;
+	{
+		lock_guard<mutex> lock(g_profilerTracksMutex);
+		for (const unique_ptr<ProfilerTrack>& track : g_profilerTracks)
+		{
+			trackInfos.push_back(make_pair(track->getName(), track->getTrackId()));
+			trackEvents.push_back(vector<ProfilerEvent>());
+			track->snapshot(trackEvents.back());
+		}
+	}
+
+	// Timestamps are written in microseconds relative to the earliest event
+	uint64 originTicks = numeric_limits<uint64>::max();
+	for (const vector<ProfilerEvent>& events : trackEvents)
+	{
+		for (const ProfilerEvent& profilerEvent : events)
+		{
+			originTicks = min(originTicks, profilerEvent.startTicks);
+		}
+	}
+
+	const auto escapeJSON = [](const string& str)
+	{
+		string escaped;
+		escaped.reserve(str.size());
+		for (const char c : str)
+		{
+			if (c == '"' || c == '\\') escaped += '\\';
+			if ((uint8)c >= 0x20) escaped += c;
+		}
+		return escaped;
+	};
+
+	const string absoluteFilePath = util::getAbsoluteFilePath(filePath);
+	ofstream fileStream(absoluteFilePath);
+	if (!fileStream)
+	{
+		LOG("Could not open \"%s\" for writing the profiler trace", absoluteFilePath.c_str());
+		return false;
+	}
+
+	fileStream << "{\"traceEvents\":[\n";
+	bool firstEvent = true;
+	char eventString[512];
+	for (size_t trackIndex = 0; trackIndex < trackInfos.size(); ++trackIndex)
+	{
+		const uint32 trackId = trackInfos[trackIndex].second;
+		snprintf(eventString, sizeof(eventString), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+			firstEvent ? "" : ",\n", trackId, escapeJSON(trackInfos[trackIndex].first).c_str());
+		fileStream << eventString;
+		firstEvent = false;
+
+		for (const ProfilerEvent& profilerEvent : trackEvents[trackIndex])
+		{
+			snprintf(eventString, sizeof(eventString), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				escapeJSON(profilerEvent.name).c_str(), trackId,
+				(profilerEvent.startTicks - originTicks) / 1000.0,
+				(profilerEvent.endTicks - profilerEvent.startTicks) / 1000.0);
+			fileStream << eventString;
+		}
+	}
+	fileStream << "\n]}\n";
+
+	LOG("Profiler trace written to \"%s\"", absoluteFilePath.c_str());
+	return (bool)fileStream;
+}
+
+//--------------------------------------------------------------
+// ProfileScope
+//--------------------------------------------------------------
+ProfileScope::ProfileScope(const char* name)
+	: m_track(nullptr)
+{
+	if (Profiler::IsEnabled())
+	{
+		m_track = Profiler::GetThreadTrack();
+		m_event.name = name;
+		m_event.depth = m_track->m_depth++;
+		m_event.startTicks = Clock::GetTicks();
+	}
+}
+
+ProfileScope::~ProfileScope()
+{
+	if (m_track)
+	{
+		m_event.endTicks = Clock::GetTicks();
+		m_track->m_depth--;
+		m_track->push(m_event);
+	}
+}
+
+//--------------------------------------------------------------
+// GPUProfileScope
+//--------------------------------------------------------------
+GPUProfileScope::GPUProfileScope(GraphicsContext* graphicsContext, const char* name)
+	: m_graphicsContext(nullptr)
+{
+	if (Profiler::IsEnabled() && graphicsContext)
+	{
+		m_graphicsContext = graphicsContext;
+		m_graphicsContext->beginProfileScope(name);
+	}
+}
+
+GPUProfileScope::~GPUProfileScope()
+{
+	if (m_graphicsContext)
+	{
+		m_graphicsContext->endProfileScope();
+	}
+}
+
+END_SAUCE_NAMESPACE
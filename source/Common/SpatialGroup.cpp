@@ -0,0 +1,140 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+SpatialGroup::SpatialGroup(const float margin) :
+	m_index(margin),
+	m_nextOrder(0),
+	m_hasViewRect(false)
+{
+}
+
+void SpatialGroup::setChildBounds(SceneObject *child, const Rect<float> &bounds)
+{
+	if(!child || child->getParent() != this)
+	{
+		LOG("SpatialGroup::setChildBounds(): Object is not a child of this group");
+		return;
+	}
+
+	unordered_map<SceneObject*, Entry>::iterator itr = m_entries.find(child);
+	if(itr != m_entries.end())
+	{
+		itr->second.bounds = bounds;
+		m_index.move(itr->second.proxy, ToBoundingBox(bounds));
+		return;
+	}
+
+	Entry entry;
+	entry.proxy = m_index.insert(ToBoundingBox(bounds), child);
+	entry.order = m_nextOrder++;
+	entry.bounds = bounds;
+	m_entries[child] = entry;
+}
+
+void SpatialGroup::removeChildBounds(SceneObject *child)
+{
+	unordered_map<SceneObject*, Entry>::iterator itr = m_entries.find(child);
+	if(itr != m_entries.end())
+	{
+		m_index.remove(itr->second.proxy);
+		m_entries.erase(itr);
+	}
+}
+
+void SpatialGroup::setViewRect(const Rect<float> &viewRect)
+{
+	m_viewRect = viewRect;
+	m_hasViewRect = true;
+}
+
+void SpatialGroup::clearViewRect()
+{
+	m_hasViewRect = false;
+}
+
+void SpatialGroup::collect(const BoundingBox2D &box, vector<pair<uint32, SceneObject*>> &outChildren) const
+{
+	const size_t begin = outChildren.size();
+	m_index.query(box, [&](const uint32 proxy)
+	{
+		// The index holds enlarged boxes, so test the exact bounds
+		SceneObject *child = static_cast<SceneObject*>(m_index.getUserData(proxy));
+		unordered_map<SceneObject*, Entry>::const_iterator itr = m_entries.find(child);
+		if(itr != m_entries.end() && ToBoundingBox(itr->second.bounds).overlaps(box))
+		{
+			outChildren.push_back(make_pair(itr->second.order, child));
+		}
+		return true;
+	});
+	sort(outChildren.begin() + begin, outChildren.end());
+}
+
+void SpatialGroup::queryRect(const Rect<float> &rect, vector<SceneObject*> &outChildren) const
+{
+	vector<pair<uint32, SceneObject*>> children;
+	collect(ToBoundingBox(rect), children);
+	for(const pair<uint32, SceneObject*> &child : children)
+	{
+		outChildren.push_back(child.second);
+	}
+}
+
+SceneObject *SpatialGroup::pick(const Vector2F &point) const
+{
+	const float p[2] = { point.x, point.y };
+	SceneObject *topmost = 0;
+	uint32 topmostOrder = 0;
+	m_index.queryPoint(p, [&](const uint32 proxy)
+	{
+		SceneObject *child = static_cast<SceneObject*>(m_index.getUserData(proxy));
+		unordered_map<SceneObject*, Entry>::const_iterator itr = m_entries.find(child);
+		if(itr != m_entries.end() && itr->second.bounds.contains(point) && (!topmost || itr->second.order > topmostOrder))
+		{
+			topmost = child;
+			topmostOrder = itr->second.order;
+		}
+		return true;
+	});
+	return topmost;
+}
+
+void SpatialGroup::onChildRemoved(SceneObject *child)
+{
+	// Children may be deleted once removed, so the index must not keep them
+	removeChildBounds(child);
+}
+
+void SpatialGroup::onDraw(DrawEvent *e)
+{
+	if(!m_hasViewRect)
+	{
+		SceneObject::onDraw(e);
+		return;
+	}
+
+	m_visible.clear();
+	collect(ToBoundingBox(m_viewRect), m_visible);
+
+	beginPropagation();
+	const uint64 eventBit = EventBit(e->getType());
+	for(const pair<uint32, SceneObject*> &child : m_visible)
+	{
+		PassEvent(child.second, e, eventBit);
+	}
+	endPropagation();
+}
+
+END_SAUCE_NAMESPACE
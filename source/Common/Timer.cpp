@@ -14,41 +14,77 @@
 
 BEGIN_SAUCE_NAMESPACE
 
-#ifdef SAUCE_COMPILE_WINDOWS
+//--------------------------------------------------------------
+// Clock
+//--------------------------------------------------------------
+uint64 Clock::GetTicks()
+{
+	// steady_clock is monotonic and backed by QueryPerformanceCounter on
+	// Windows and CLOCK_MONOTONIC on Linux
+	return (uint64)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Clock::SleepUntil(const uint64 ticks)
+{
+	// Running estimate of how long a 1 ms sleep actually takes. Sleeping
+	// only while more than this remains keeps us from oversleeping. Kept per
+	// thread since SleepUntil() may be called from several threads at once.
+	thread_local uint64 sleepEstimate = 2000000;
+
+	uint64 now = GetTicks();
+	while (now + sleepEstimate < ticks)
+	{
+		this_thread::sleep_for(chrono::milliseconds(1));
+		const uint64 sleptTicks = GetTicks() - now;
+		now += sleptTicks;
+
+		// Adapt quickly to longer sleeps and slowly to shorter ones
+		sleepEstimate = sleptTicks > sleepEstimate ? sleptTicks : (sleepEstimate * 63 + sleptTicks) / 64;
+	}
+
+	// Spin for the remainder
+	while (GetTicks() < ticks)
+	{
+		this_thread::yield();
+	}
+}
+
+//--------------------------------------------------------------
+// Timer
+//--------------------------------------------------------------
 Timer::Timer() :
+	m_start(0),
+	m_end(0),
 	m_running(false)
 {
-    QueryPerformanceFrequency(&m_frequency);
-	m_start.QuadPart = m_end.QuadPart = 0;
 }
 
 void Timer::start()
 {
 	m_running = true;
-	QueryPerformanceCounter(&m_start);
+	m_start = Clock::GetTicks();
 }
 
 void Timer::stop()
 {
-	QueryPerformanceCounter(&m_end);
+	m_end = Clock::GetTicks();
 	m_running = false;
 }
 
 double Timer::getElapsedTime() const
 {
-	LARGE_INTEGER end = m_end;
-    if(m_running)
-	{
-        QueryPerformanceCounter(&end);
-	}
-
-	double startTime = m_start.QuadPart * (1.0 / m_frequency.QuadPart);
-	double endTime = end.QuadPart * (1.0 / m_frequency.QuadPart);
-    return endTime - startTime;
+	return Clock::TicksToSeconds(getElapsedTicks());
 }
 
-#endif
+uint64 Timer::getElapsedTicks() const
+{
+	const uint64 end = m_running ? Clock::GetTicks() : m_end;
+	return end - m_start;
+}
 
+//--------------------------------------------------------------
+// SimpleTimer
+//--------------------------------------------------------------
 SimpleTimer::SimpleTimer() :
 	m_startTick(0),
 	m_running(false)
@@ -58,7 +94,7 @@ SimpleTimer::SimpleTimer() :
 void SimpleTimer::start()
 {
 	m_running = true;
-	m_startTick = clock();
+	m_startTick = Clock::GetTicks();
 }
 
 float SimpleTimer::stop()
@@ -73,7 +109,92 @@ float SimpleTimer::stop()
 
 float SimpleTimer::getElapsedTime() const
 {
-	return float(clock() - m_startTick) / float(CLOCKS_PER_SEC);
+	return (float)Clock::TicksToSeconds(Clock::GetTicks() - m_startTick);
+}
+
+//--------------------------------------------------------------
+// FrameTimeStats
+//--------------------------------------------------------------
+FrameTimeStats::FrameTimeStats(const uint32 maxSampleCount) :
+	m_maxSampleCount(max(maxSampleCount, 1u)),
+	m_nextSample(0),
+	m_totalTicks(0)
+{
+	m_samples.reserve(m_maxSampleCount);
+}
+
+void FrameTimeStats::addSample(const uint64 frameTicks)
+{
+	// Ring buffer over the most recent frames
+	if(m_samples.size() < m_maxSampleCount)
+	{
+		m_samples.push_back(frameTicks);
+	}
+	else
+	{
+		m_totalTicks -= m_samples[m_nextSample];
+		m_samples[m_nextSample] = frameTicks;
+	}
+	m_totalTicks += frameTicks;
+	m_nextSample = (m_nextSample + 1) % m_maxSampleCount;
+}
+
+void FrameTimeStats::reset()
+{
+	m_samples.clear();
+	m_nextSample = 0;
+	m_totalTicks = 0;
+}
+
+uint64 FrameTimeStats::getPercentile(const double percentile) const
+{
+	if(m_samples.empty())
+	{
+		return 0;
+	}
+
+	// Nearest-rank percentile
+	vector<uint64> sortedSamples(m_samples);
+	const double rank = ceil(min(max(percentile, 0.0), 100.0) / 100.0 * sortedSamples.size());
+	const size_t index = rank > 0.0 ? (size_t)rank - 1 : 0;
+	nth_element(sortedSamples.begin(), sortedSamples.begin() + index, sortedSamples.end());
+	return sortedSamples[index];
+}
+
+uint64 FrameTimeStats::getMax() const
+{
+	return m_samples.empty() ? 0 : *max_element(m_samples.begin(), m_samples.end());
+}
+
+double FrameTimeStats::getAverageFramesPerSecond() const
+{
+	return m_totalTicks > 0 ? m_samples.size() / Clock::TicksToSeconds(m_totalTicks) : 0.0;
+}
+
+void FrameTimeStats::getHistogram(const uint64 bucketTicks, vector<uint32>& outBuckets) const
+{
+	fill(outBuckets.begin(), outBuckets.end(), 0);
+	if(outBuckets.empty() || bucketTicks == 0)
+	{
+		return;
+	}
+
+	for(const uint64 sample : m_samples)
+	{
+		outBuckets[min<uint64>(sample / bucketTicks, outBuckets.size() - 1)]++;
+	}
+}
+
+void FrameTimeStats::getSamples(vector<uint64>& outSamples) const
+{
+	// Once the buffer is full, the oldest sample is the one to be overwritten next
+	outSamples.clear();
+	outSamples.reserve(m_samples.size());
+	const uint32 oldestSample = m_samples.size() < m_maxSampleCount ? 0 : m_nextSample;
+	for(uint32 i = 0; i < m_samples.size(); ++i)
+	{
+		outSamples.push_back(m_samples[(oldestSample + i) % m_samples.size()]);
+	}
 }
 
 END_SAUCE_NAMESPACE
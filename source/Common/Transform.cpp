@@ -0,0 +1,293 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+const uint32 TransformHierarchy::InvalidIndex;
+
+TransformHierarchy::TransformHierarchy() :
+	m_orderChanged(false),
+	m_matricesChanged(false)
+{
+}
+
+TransformID TransformHierarchy::create(const TransformID parent)
+{
+	TransformID transform;
+	if(!m_freeIDs.empty())
+	{
+		transform = m_freeIDs.back();
+		m_freeIDs.pop_back();
+	}
+	else
+	{
+		transform = (TransformID)m_indices.size();
+		m_indices.push_back(InvalidIndex);
+		m_parents.push_back(InvalidTransform);
+	}
+	m_parents[transform] = InvalidTransform;
+
+	// Appending keeps parents before their children, so the order
+	// is still valid for update() until the next sort
+	m_indices[transform] = (uint32)m_ids.size();
+	m_ids.push_back(transform);
+	m_parentIndices.push_back(InvalidIndex);
+	m_localMatrices.push_back(Matrix4());
+	m_worldMatrices.push_back(Matrix4());
+	m_dirty.push_back(1);
+	m_matricesChanged = true;
+
+	if(isValid(parent))
+	{
+		m_parents[transform] = parent;
+		m_parentIndices.back() = m_indices[parent];
+		m_orderChanged = true;
+	}
+	return transform;
+}
+
+void TransformHierarchy::destroy(const TransformID transform)
+{
+	if(!isValid(transform))
+	{
+		return;
+	}
+
+	// The transform is removed by the next sort. Its ID is not reused
+	// before that, so children can still tell that their parent is gone.
+	m_ids[m_indices[transform]] = InvalidTransform;
+	m_destroyedIDs.push_back(transform);
+	m_orderChanged = true;
+}
+
+bool TransformHierarchy::isValid(const TransformID transform) const
+{
+	return transform < m_indices.size() && m_indices[transform] != InvalidIndex && m_ids[m_indices[transform]] == transform;
+}
+
+bool TransformHierarchy::setParent(const TransformID transform, const TransformID parent)
+{
+	if(!isValid(transform))
+	{
+		return false;
+	}
+
+	if(!isValid(parent))
+	{
+		if(m_parents[transform] != InvalidTransform)
+		{
+			m_parents[transform] = InvalidTransform;
+			m_parentIndices[m_indices[transform]] = InvalidIndex;
+			m_dirty[m_indices[transform]] = 1;
+			m_matricesChanged = m_orderChanged = true;
+		}
+		return true;
+	}
+
+	for(TransformID ancestor = parent; ancestor != InvalidTransform; ancestor = isValid(ancestor) ? m_parents[ancestor] : InvalidTransform)
+	{
+		if(ancestor == transform)
+		{
+			LOG("Cannot parent transform %i to its own descendant %i", transform, parent);
+			return false;
+		}
+	}
+
+	if(m_parents[transform] != parent)
+	{
+		m_parents[transform] = parent;
+		m_parentIndices[m_indices[transform]] = m_indices[parent];
+		m_dirty[m_indices[transform]] = 1;
+		m_matricesChanged = m_orderChanged = true;
+	}
+	return true;
+}
+
+TransformID TransformHierarchy::getParent(const TransformID transform) const
+{
+	return isValid(transform) && isValid(m_parents[transform]) ? m_parents[transform] : InvalidTransform;
+}
+
+void TransformHierarchy::setLocalMatrix(const TransformID transform, const Matrix4 &localMatrix)
+{
+	if(!isValid(transform))
+	{
+		return;
+	}
+
+	const uint32 index = m_indices[transform];
+	m_localMatrices[index] = localMatrix;
+	m_dirty[index] = 1;
+	m_matricesChanged = true;
+}
+
+const Matrix4 &TransformHierarchy::getLocalMatrix(const TransformID transform) const
+{
+	THROW_IF(!isValid(transform), "Invalid transform %i", transform);
+	return m_localMatrices[m_indices[transform]];
+}
+
+const Matrix4 &TransformHierarchy::getWorldMatrix(const TransformID transform)
+{
+	THROW_IF(!isValid(transform), "Invalid transform %i", transform);
+	update();
+	return m_worldMatrices[m_indices[transform]];
+}
+
+void TransformHierarchy::update()
+{
+	if(m_orderChanged)
+	{
+		sort();
+	}
+
+	if(!m_matricesChanged)
+	{
+		return;
+	}
+
+	// Parents come first, so a dirty parent has marked its children by the time we get to them
+	const uint32 count = (uint32)m_ids.size();
+	for(uint32 i = 0; i < count; ++i)
+	{
+		const uint32 parentIndex = m_parentIndices[i];
+		if(parentIndex == InvalidIndex)
+		{
+			if(m_dirty[i])
+			{
+				m_worldMatrices[i] = m_localMatrices[i];
+			}
+		}
+		else if(m_dirty[i] || m_dirty[parentIndex])
+		{
+			m_dirty[i] = 1;
+			m_worldMatrices[i] = m_worldMatrices[parentIndex] * m_localMatrices[i];
+		}
+	}
+
+	fill(m_dirty.begin(), m_dirty.end(), 0);
+	m_matricesChanged = false;
+}
+
+void TransformHierarchy::sort()
+{
+	const uint32 count = (uint32)m_ids.size();
+
+	// Count the children of every transform, with their offsets as prefix sums.
+	// Children of destroyed transforms become roots.
+	vector<uint32> childOffsets(count + 1, 0);
+	vector<uint32> order;
+	order.reserve(count - (uint32)m_destroyedIDs.size());
+	for(uint32 i = 0; i < count; ++i)
+	{
+		if(m_ids[i] == InvalidTransform) continue;
+		const uint32 parentIndex = m_parentIndices[i];
+		if(parentIndex == InvalidIndex || m_ids[parentIndex] == InvalidTransform)
+		{
+			order.push_back(i);
+		}
+		else
+		{
+			childOffsets[parentIndex + 1]++;
+		}
+	}
+
+	for(uint32 i = 0; i < count; ++i)
+	{
+		childOffsets[i + 1] += childOffsets[i];
+	}
+
+	vector<uint32> children(childOffsets[count]);
+	vector<uint32> next(childOffsets.begin(), childOffsets.end() - 1);
+	for(uint32 i = 0; i < count; ++i)
+	{
+		const uint32 parentIndex = m_parentIndices[i];
+		if(m_ids[i] != InvalidTransform && parentIndex != InvalidIndex && m_ids[parentIndex] != InvalidTransform)
+		{
+			children[next[parentIndex]++] = i;
+		}
+	}
+
+	// Breadth-first walk from the roots
+	for(uint32 i = 0; i < order.size(); ++i)
+	{
+		const uint32 index = order[i];
+		order.insert(order.end(), children.begin() + childOffsets[index], children.begin() + childOffsets[index + 1]);
+	}
+
+	// Move everything into the new order
+	vector<uint32> newIndices(count, InvalidIndex);
+	for(uint32 i = 0; i < order.size(); ++i)
+	{
+		newIndices[order[i]] = i;
+	}
+
+	vector<TransformID> ids(order.size());
+	vector<uint32> parentIndices(order.size());
+	vector<Matrix4> localMatrices(order.size());
+	vector<Matrix4> worldMatrices(order.size());
+	vector<uint8> dirty(order.size());
+	for(uint32 i = 0; i < order.size(); ++i)
+	{
+		const uint32 oldIndex = order[i];
+		const uint32 oldParentIndex = m_parentIndices[oldIndex];
+		ids[i] = m_ids[oldIndex];
+		localMatrices[i] = m_localMatrices[oldIndex];
+		worldMatrices[i] = m_worldMatrices[oldIndex];
+		dirty[i] = m_dirty[oldIndex];
+		parentIndices[i] = oldParentIndex != InvalidIndex ? newIndices[oldParentIndex] : InvalidIndex;
+		if(oldParentIndex != InvalidIndex && parentIndices[i] == InvalidIndex)
+		{
+			// Orphaned by destroy()
+			m_parents[ids[i]] = InvalidTransform;
+			dirty[i] = 1;
+			m_matricesChanged = true;
+		}
+		m_indices[ids[i]] = i;
+	}
+
+	// Release the IDs of destroyed transforms
+	for(const TransformID transform : m_destroyedIDs)
+	{
+		m_indices[transform] = InvalidIndex;
+		m_freeIDs.push_back(transform);
+	}
+	m_destroyedIDs.clear();
+
+	m_ids.swap(ids);
+	m_parentIndices.swap(parentIndices);
+	m_localMatrices.swap(localMatrices);
+	m_worldMatrices.swap(worldMatrices);
+	m_dirty.swap(dirty);
+	m_orderChanged = false;
+}
+
+TransformObject::TransformObject(TransformHierarchy *hierarchy) :
+	m_hierarchy(hierarchy),
+	m_transform(hierarchy->create())
+{
+}
+
+TransformObject::~TransformObject()
+{
+	m_hierarchy->destroy(m_transform);
+}
+
+void TransformObject::onParentChanged()
+{
+	TransformObject *parent = dynamic_cast<TransformObject*>(getParent());
+	m_hierarchy->setParent(m_transform, parent && parent->m_hierarchy == m_hierarchy ? parent->m_transform : InvalidTransform);
+}
+
+END_SAUCE_NAMESPACE
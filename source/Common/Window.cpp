@@ -197,8 +197,7 @@ SDL_Window *Window::getSDLHandle() const
 
 void Window::setVSync(const int mode)
 {
-	SDL_GL_MakeCurrent(m_window, m_graphicsContext->getSDLHandle());
-	SDL_GL_SetSwapInterval(mode);
+	m_graphicsContext->setSwapInterval(mode);
 }
 
 Uint32 Window::getID() const
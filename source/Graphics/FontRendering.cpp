@@ -253,119 +253,13 @@ private:
 		}
 
 		// Create sdf map
-		const int32 sdfMapSizeX = extents.x / m_subdivisionsPerSDFPixel;
-		const int32 sdfMapSizeY = extents.y / m_subdivisionsPerSDFPixel;
-		Pixmap sdfAtlas(sdfMapSizeX, sdfMapSizeY, PixelFormat(PixelComponents::R, PixelDatatype::Uint8));
-		{
-			for (int32 sdfMapY = 0; sdfMapY < sdfMapSizeY; ++sdfMapY)
-			{
-				for (int32 sdfMapX = 0; sdfMapX < sdfMapSizeX; ++sdfMapX)
-				{
-					// We first check if this SDF pixel contains a contour
-					{
-						bool isContour = false;
-						uint32 x = sdfMapX * m_subdivisionsPerSDFPixel;
-						uint32 y = sdfMapY * m_subdivisionsPerSDFPixel;
-						const bool isFirstPixelInside = glyphAtlasData[x + y * extents.x] != 0;
-
-						// For each pixel in the high-res image contained within this SDF pixel
-						for (int32 subPixelY = 0; subPixelY < m_subdivisionsPerSDFPixel && !isContour; ++subPixelY)
-						{
-							for (int32 subPixelX = 0; subPixelX < m_subdivisionsPerSDFPixel; ++subPixelX)
-							{
-								// Search in a radius for a pixel in an opposite state
-								x = sdfMapX * m_subdivisionsPerSDFPixel + subPixelX;
-								y = sdfMapY * m_subdivisionsPerSDFPixel + subPixelY;
-								const bool isPixelInside = glyphAtlasData[x + y * extents.x] != 0;
-								if (isFirstPixelInside != isPixelInside)
-								{
-									isContour = true;
-									break;
-								}
-							}
-						}
-
-						if (isContour)
-						{
-							// Write 0.5 if this SDF pixel contains a contour
-							const uint8 sdfPixelValue = 127;
-							sdfAtlas.setPixel(sdfMapX, sdfMapY, &sdfPixelValue);
-							continue;
-						}
-					}
-
-					// Iterate pixels at the edge of the SDF cell and find min signed distance
-					{
-						float signedDistanceSqMin = numeric_limits<float>::max();
-
-						// For each pixel in the high-res image contained within this SDF pixel
-						for (int32 subPixelY = 0; subPixelY < m_subdivisionsPerSDFPixel; ++subPixelY)
-						{
-							for (int32 subPixelX = 0; subPixelX < m_subdivisionsPerSDFPixel; ++subPixelX)
-							{
-								// Skip center pixels
-								if ((subPixelX != 0 && subPixelX != m_subdivisionsPerSDFPixel - 1) &&
-									(subPixelY != 0 && subPixelY != m_subdivisionsPerSDFPixel - 1))
-								{
-									continue;
-								}
-
-								// Search in a radius for a pixel in an opposite state
-								const uint32 x = sdfMapX * m_subdivisionsPerSDFPixel + subPixelX;
-								const uint32 y = sdfMapY * m_subdivisionsPerSDFPixel + subPixelY;
-
-								// Check if we are starting from the inside or the outside
-								const bool isSubPixelInside = glyphAtlasData[x + y * extents.x] != 0;
-								float distanceSq = m_sdfRadius * m_sdfRadius;
-
-								for (int32 offsetY = -m_sdfRadius; offsetY <= m_sdfRadius; ++offsetY)
-								{
-									for (int32 offsetX = -m_sdfRadius; offsetX <= m_sdfRadius; ++offsetX)
-									{
-										if ((x + offsetX < 0 || x + offsetX >= extents.x) ||
-											(y + offsetY < 0 || y + offsetY >= extents.y))
-										{
-											continue;
-										}
-
-										// Skip pixel if it is further away than our current min distance
-										const float currentDistanceSq = offsetX * offsetX + offsetY * offsetY;
-										if (currentDistanceSq > distanceSq)
-										{
-											continue;
-										}
-
-										// Update distance if pixel is in opposite state
-										const bool isPixelInside = glyphAtlasData[(x + offsetX) + (y + offsetY) * extents.x] != 0;
-										if (isPixelInside != isSubPixelInside)
-										{
-											distanceSq = currentDistanceSq;
-										}
-									}
-								}
-
-								// Update the smallest distance for this SDF cell if the magnitude of the
-								// squared distance for this pixel is less than the magnitude of the
-								// current min signed distance squared
-								if (distanceSq < abs(signedDistanceSqMin))
-								{
-									signedDistanceSqMin = distanceSq * (isSubPixelInside ? 1 : -1);
-								}
-							}
-						}
-
-						const float signedDistanceNorm = signedDistanceSqMin / float(m_sdfRadius * m_sdfRadius); // [-1, +1]
-						const float distanceNorm = ((signedDistanceNorm + 1.0f) / 2.0f);                   // [+0, +1]
-						const uint8 sdfPixelValue = distanceNorm * 255.5f;                                  // [+0, +255]
-						sdfAtlas.setPixel(sdfMapX, sdfMapY, &sdfPixelValue);
-					}
-				}
-			}
-		}
+		Pixmap sdfAtlas;
+		FontRenderingSystem::GenerateSDF(glyphAtlasData, extents.x, extents.y, m_sdfRadius, m_subdivisionsPerSDFPixel, sdfAtlas);
 
 		Texture2DDesc textureDesc;
 		textureDesc.pixmap = &sdfAtlas;
 		textureDesc.filtering = TextureFiltering::Linear;
+		textureDesc.retainPixmap = true; // Written to the font cache without a GPU readback
 		m_sdfTextureAtlas = CreateNew<Texture2D>(textureDesc);
 
 		delete[] glyphAtlasData;
@@ -405,9 +299,37 @@ SAUCE_REF_TYPE_TYPEDEFS(FontRendererSharedData);
 /**
  * Globals used by FontRendererImpl
  */
-VertexFormat                                     g_fontVertexFormat;
+const uint32                                     g_fontCacheVersion = 1;
+const string                                     g_fontCacheDirectory = "DataCache/Fonts/";
+const string                                     g_fontHashIndexFileName = "FontHashes.index";
 unordered_map<string, string>                    g_sharedFontDataOnDisk;
 unordered_map<string, FontRendererSharedDataRef> g_sharedFontDataLoaded;
+util::FileHashCache                              g_fontFileHashes;
+
+//--------------------------------------------------------------
+// FontRendererDesc
+//--------------------------------------------------------------
+string FontRendererDesc::getKey() const
+{
+	// Font files are only hashed when they are new or have changed on disk
+	uint64 contentHash = 0;
+	string prefix;
+	util::FileSpan fileSpan;
+	if (util::findInPackFiles(fontFilePath, fileSpan))
+	{
+		contentHash = util::XXH64(fileSpan.data, fileSpan.size);
+	}
+	else if (!g_fontFileHashes.getContentHash(fontFilePath, contentHash))
+	{
+		// Fonts that can't be read still need a key of their own
+		contentHash = util::XXH64(fontFilePath.data(), fontFilePath.size());
+		prefix = "PATH_";
+	}
+
+	char hashString[17];
+	snprintf(hashString, sizeof(hashString), "%016llx", (unsigned long long)contentHash);
+	return prefix + hashString + "_" + to_string(fontSize);
+}
 
 const string g_fontShaderVS =
 	"in vec2 in_Position;\n"
@@ -464,26 +386,153 @@ bool FontRenderingSystem::Initialize(GraphicsContext* context)
 	shaderDesc.shaderSourcePS = g_fontShaderPS;
 	g_fontShader = CreateNew<Shader>(shaderDesc);
 
-	// Set font vertex format
-	g_fontVertexFormat.set(VertexAttribute::Position, 2, Datatype::Float);
-	g_fontVertexFormat.set(VertexAttribute::TexCoord, 2, Datatype::Float);
-	g_fontVertexFormat.set(VertexAttribute::Color, 4, Datatype::Uint8);
-
 	// Register all cached fonts
-	util::FileSystemIterator cachedFontsDir("DataCache/Fonts", "*", (uint32)util::FileSystemIteratorFlag::IncludeFiles);
-	for (util::DirectoryOrFile cachedFontFile : cachedFontsDir)
+	util::FileSystemIterator cachedFontsDir(g_fontCacheDirectory, "*", (uint32)util::FileSystemIteratorFlag::IncludeFiles);
+	for (const util::DirectoryOrFile& cachedFontFile : cachedFontsDir)
 	{
-		g_sharedFontDataOnDisk[cachedFontFile.baseName] = cachedFontFile.fullPath;
+		if (cachedFontFile.baseName != g_fontHashIndexFileName)
+		{
+			g_sharedFontDataOnDisk[cachedFontFile.baseName] = cachedFontFile.fullPath;
+		}
 	}
 
+	// Load the content hashes of previously seen font files
+	g_fontFileHashes.load(g_fontCacheDirectory + g_fontHashIndexFileName);
+
 	return true;
 }
 
 void FontRenderingSystem::Free()
 {
+	// Persist font file hashes computed during this run
+	if (g_fontFileHashes.isDirty())
+	{
+		if (!filesystem::exists(g_fontCacheDirectory))
+		{
+			filesystem::create_directories(g_fontCacheDirectory);
+		}
+		g_fontFileHashes.save(g_fontCacheDirectory + g_fontHashIndexFileName);
+	}
+
 	FT_Done_FreeType(g_library);
 }
 
+//--------------------------------------------------------------
+// FontRenderingSystem::GenerateSDF()
+//--------------------------------------------------------------
+void FontRenderingSystem::GenerateSDF(const uint8* mask, const uint32 width, const uint32 height, const int32 radius, const int32 subdivisions, Pixmap& outPixmap)
+{
+	const int32 sdfMapSizeX = width / subdivisions;
+	const int32 sdfMapSizeY = height / subdivisions;
+	outPixmap = Pixmap(sdfMapSizeX, sdfMapSizeY, PixelFormat(PixelComponents::R, PixelDatatype::Uint8));
+	{
+		for (int32 sdfMapY = 0; sdfMapY < sdfMapSizeY; ++sdfMapY)
+		{
+			for (int32 sdfMapX = 0; sdfMapX < sdfMapSizeX; ++sdfMapX)
+			{
+				// We first check if this SDF pixel contains a contour
+				{
+					bool isContour = false;
+					uint32 x = sdfMapX * subdivisions;
+					uint32 y = sdfMapY * subdivisions;
+					const bool isFirstPixelInside = mask[x + y * width] != 0;
+
+					// For each pixel in the high-res image contained within this SDF pixel
+					for (int32 subPixelY = 0; subPixelY < subdivisions && !isContour; ++subPixelY)
+					{
+						for (int32 subPixelX = 0; subPixelX < subdivisions; ++subPixelX)
+						{
+							// Search in a radius for a pixel in an opposite state
+							x = sdfMapX * subdivisions + subPixelX;
+							y = sdfMapY * subdivisions + subPixelY;
+							const bool isPixelInside = mask[x + y * width] != 0;
+							if (isFirstPixelInside != isPixelInside)
+							{
+								isContour = true;
+								break;
+							}
+						}
+					}
+
+					if (isContour)
+					{
+						// Write 0.5 if this SDF pixel contains a contour
+						const uint8 sdfPixelValue = 127;
+						outPixmap.setPixel(sdfMapX, sdfMapY, &sdfPixelValue);
+						continue;
+					}
+				}
+
+				// Iterate pixels at the edge of the SDF cell and find min signed distance
+				{
+					float signedDistanceSqMin = numeric_limits<float>::max();
+
+					// For each pixel in the high-res image contained within this SDF pixel
+					for (int32 subPixelY = 0; subPixelY < subdivisions; ++subPixelY)
+					{
+						for (int32 subPixelX = 0; subPixelX < subdivisions; ++subPixelX)
+						{
+							// Skip center pixels
+							if ((subPixelX != 0 && subPixelX != subdivisions - 1) &&
+								(subPixelY != 0 && subPixelY != subdivisions - 1))
+							{
+								continue;
+							}
+
+							// Search in a radius for a pixel in an opposite state
+							const uint32 x = sdfMapX * subdivisions + subPixelX;
+							const uint32 y = sdfMapY * subdivisions + subPixelY;
+
+							// Check if we are starting from the inside or the outside
+							const bool isSubPixelInside = mask[x + y * width] != 0;
+							float distanceSq = radius * radius;
+
+							for (int32 offsetY = -radius; offsetY <= radius; ++offsetY)
+							{
+								for (int32 offsetX = -radius; offsetX <= radius; ++offsetX)
+								{
+									if ((x + offsetX < 0 || x + offsetX >= width) ||
+										(y + offsetY < 0 || y + offsetY >= height))
+									{
+										continue;
+									}
+
+									// Skip pixel if it is further away than our current min distance
+									const float currentDistanceSq = offsetX * offsetX + offsetY * offsetY;
+									if (currentDistanceSq > distanceSq)
+									{
+										continue;
+									}
+
+									// Update distance if pixel is in opposite state
+									const bool isPixelInside = mask[(x + offsetX) + (y + offsetY) * width] != 0;
+									if (isPixelInside != isSubPixelInside)
+									{
+										distanceSq = currentDistanceSq;
+									}
+								}
+							}
+
+							// Update the smallest distance for this SDF cell if the magnitude of the
+							// squared distance for this pixel is less than the magnitude of the
+							// current min signed distance squared
+							if (distanceSq < abs(signedDistanceSqMin))
+							{
+								signedDistanceSqMin = distanceSq * (isSubPixelInside ? 1 : -1);
+							}
+						}
+					}
+
+					const float signedDistanceNorm = signedDistanceSqMin / float(radius * radius); // [-1, +1]
+					const float distanceNorm = ((signedDistanceNorm + 1.0f) / 2.0f);                   // [+0, +1]
+					const uint8 sdfPixelValue = distanceNorm * 255.5f;                                  // [+0, +255]
+					outPixmap.setPixel(sdfMapX, sdfMapY, &sdfPixelValue);
+				}
+			}
+		}
+	}
+}
+
 //--------------------------------------------------------------
 // FontRenderer implementation
 //--------------------------------------------------------------
@@ -492,15 +541,9 @@ class FontRendererImpl : public FontRenderer
 public:
 	FontRendererImpl()
 		: m_sharedData(nullptr)
-		, m_indices(nullptr)
 	{
 	}
 
-	~FontRendererImpl()
-	{
-		delete[] m_indices;
-	}
-
 	bool initialize(FontRendererDesc fontDesc) override
 	{
 		if (fontDesc.fontFilePath.empty())
@@ -534,11 +577,9 @@ public:
 					g_sharedFontDataLoaded[cachedFontKey] = m_sharedData;
 					return true;
 				}
-				else
-				{
-					LOG("Failed to load font's cached shared data from file");
-					return false;
-				}
+
+				// Stale or corrupt cache files are regenerated below
+				LOG("Failed to load font's cached shared data from file, regenerating it");
 			}
 		}
 
@@ -547,11 +588,11 @@ public:
 			m_sharedData = sauce::CreateNew<FontRendererSharedData>(fontDesc);
 
 			// Write to data cache
-			if (!filesystem::exists("DataCache/Fonts/"))
+			if (!filesystem::exists(g_fontCacheDirectory))
 			{
-				filesystem::create_directories("DataCache/Fonts/");
+				filesystem::create_directories(g_fontCacheDirectory);
 			}
-			saveCached("DataCache/Fonts/" + fontDesc.getKey());
+			saveCached(g_fontCacheDirectory + cachedFontKey);
 
 			g_sharedFontDataLoaded[cachedFontKey] = m_sharedData;
 
@@ -561,19 +602,23 @@ public:
 
 	bool loadCached(const string& cachedFile)
 	{
-		ByteStreamIn fileStream(cachedFile);
+		ByteStreamIn fileStream(cachedFile, g_fontCacheVersion);
 		if (fileStream)
 		{
 			fileStream >> m_sharedData;
-			fileStream.close();
-			return true;
+			if (fileStream)
+			{
+				fileStream.close();
+				return true;
+			}
+			m_sharedData = nullptr;
 		}
 		return false;
 	}
 
 	bool saveCached(const string& cachedFile)
 	{
-		ByteStreamOut fileStream(cachedFile);
+		ByteStreamOut fileStream(cachedFile, g_fontCacheVersion);
 		if (fileStream)
 		{
 			fileStream << m_sharedData;
@@ -593,9 +638,8 @@ public:
 		{
 			m_extentsOfString = Vector2F::Zero;
 
-			delete[] m_indices;
-			m_vertices = g_fontVertexFormat.createVertices(numChars * 4);
-			m_indices = new uint32[numChars * 6];
+			m_vertices.resize(numChars * 4);
+			m_indices.resize(numChars * 6);
 
 			Vector2F currentPos = Vector2F(0.0f, 0.0f);
 
@@ -609,27 +653,21 @@ public:
 					if (!glyphDesc)
 					{
 						LOG("Tried to render glyph with charcode '%i', but no maching glyph descriptor was found", charcode);
+
+						// Vertex storage is reused, so emit an empty quad
+						fill_n(&m_vertices[i * 4], 4, VertexPos2DColorUV());
+						fill_n(&m_indices[i * 6], 6, 0);
 						continue;
 					}
 				}
 
 				const Vector2F currentTL = currentPos + glyphDesc->pixelDrawOffset;
 				const Vector2F currentBR = currentPos + glyphDesc->pixelSize + glyphDesc->pixelDrawOffset;
-				m_vertices[i * 4 + 0].set2f(VertexAttribute::Position, currentTL.x, currentTL.y);
-				m_vertices[i * 4 + 0].set2f(VertexAttribute::TexCoord, glyphDesc->uv0.x, glyphDesc->uv0.y);
-				m_vertices[i * 4 + 0].set4ub(VertexAttribute::Color, 255, 255, 255, 255);
-
-				m_vertices[i * 4 + 1].set2f(VertexAttribute::Position, currentBR.x, currentTL.y);
-				m_vertices[i * 4 + 1].set2f(VertexAttribute::TexCoord, glyphDesc->uv1.x, glyphDesc->uv0.y);
-				m_vertices[i * 4 + 1].set4ub(VertexAttribute::Color, 255, 255, 255, 255);
-
-				m_vertices[i * 4 + 2].set2f(VertexAttribute::Position, currentTL.x, currentBR.y);
-				m_vertices[i * 4 + 2].set2f(VertexAttribute::TexCoord, glyphDesc->uv0.x, glyphDesc->uv1.y);
-				m_vertices[i * 4 + 2].set4ub(VertexAttribute::Color, 255, 255, 255, 255);
-
-				m_vertices[i * 4 + 3].set2f(VertexAttribute::Position, currentBR.x, currentBR.y);
-				m_vertices[i * 4 + 3].set2f(VertexAttribute::TexCoord, glyphDesc->uv1.x, glyphDesc->uv1.y);
-				m_vertices[i * 4 + 3].set4ub(VertexAttribute::Color, 255, 255, 255, 255);
+				VertexPos2DColorUV* vertices = &m_vertices[i * 4];
+				vertices[0] = { currentTL, Color::White, glyphDesc->uv0 };
+				vertices[1] = { Vector2F(currentBR.x, currentTL.y), Color::White, Vector2F(glyphDesc->uv1.x, glyphDesc->uv0.y) };
+				vertices[2] = { Vector2F(currentTL.x, currentBR.y), Color::White, Vector2F(glyphDesc->uv0.x, glyphDesc->uv1.y) };
+				vertices[3] = { currentBR, Color::White, glyphDesc->uv1 };
 
 				m_indices[i * 6 + 0] = i * 4 + 0;
 				m_indices[i * 6 + 1] = i * 4 + 2;
@@ -679,7 +717,7 @@ public:
 
 		// Draw text
 		context->pushMatrix(drawTransform);
-		context->drawIndexedPrimitives(PrimitiveType::Triangles, m_vertices, numChars * 4, m_indices, numChars * 6);
+		context->drawIndexedPrimitives(PrimitiveType::Triangles, m_vertices, numChars * 4, m_indices.data(), numChars * 6);
 		context->popMatrix();
 
 		// Clean up
@@ -695,8 +733,8 @@ private:
 	
 	Vector2F m_extentsOfString;
 
-	VertexArray m_vertices;
-	uint32* m_indices;
+	VertexArrayT<VertexPos2DColorUV> m_vertices;
+	vector<uint32> m_indices;
 
 	static VertexFormat s_vertexFormat;
 };
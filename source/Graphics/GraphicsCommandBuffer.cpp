@@ -0,0 +1,1153 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Graphics.h>
+#include <Sauce/Graphics/GraphicsCommandBuffer.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+static const uint32 NoReference = 0xFFFFFFFF;
+
+GraphicsCommandStatistics& GraphicsCommandStatistics::operator+=(const GraphicsCommandStatistics& other)
+{
+	commandCount += other.commandCount;
+	drawCalls += other.drawCalls;
+	stateChanges += other.stateChanges;
+	bytesUploaded += other.bytesUploaded;
+	objectsCreated += other.objectsCreated;
+	objectsDestroyed += other.objectsDestroyed;
+	return *this;
+}
+
+GraphicsCommandBuffer::GraphicsCommandBuffer(const bool serializable)
+	: m_commandCount(0)
+	, m_serializable(serializable)
+	, m_nextObjectId(1)
+	, m_recordedState()
+	, m_hasRecordedState(false)
+{
+}
+
+void GraphicsCommandBuffer::reset()
+{
+	// Releasing references may destroy resources, which records new
+	// commands. Move them out of the way before letting them go.
+	m_releasedReferences.swap(m_references);
+	m_releasedFunctions.swap(m_functions);
+
+	m_data.clear();
+	m_commandCount = 0;
+	m_hasRecordedState = false;
+
+	// Serialized streams define each vertex format once
+	if(!m_serializable)
+	{
+		m_vertexFormats.clear();
+	}
+
+	m_releasedReferences.clear();
+	m_releasedFunctions.clear();
+}
+
+void GraphicsCommandBuffer::setData(const uint8* data, const uint64 size, const uint32 commandCount)
+{
+	assert(m_serializable);
+	m_data.assign(data, data + size);
+	m_commandCount = commandCount;
+	m_hasRecordedState = false;
+}
+
+void GraphicsCommandBuffer::beginCommand(const GraphicsCommandType type)
+{
+	write<uint32>((uint32)type);
+	m_commandCount++;
+}
+
+uint32 GraphicsCommandBuffer::addReference(shared_ptr<void> object)
+{
+	if(!object)
+	{
+		return NoReference;
+	}
+	m_references.push_back(move(object));
+	return (uint32)m_references.size() - 1;
+}
+
+uint32 GraphicsCommandBuffer::addVertexFormat(const VertexFormat& vertexFormat)
+{
+	// Most frames only use a handful of formats
+	for(uint32 i = (uint32)m_vertexFormats.size(); i-- > 0;)
+	{
+		if(m_vertexFormats[i] == vertexFormat)
+		{
+			return i;
+		}
+	}
+	m_vertexFormats.push_back(vertexFormat);
+
+	// Serialized streams carry their own format definitions
+	if(m_serializable)
+	{
+		beginCommand(GraphicsCommandType::DefineVertexFormat);
+		for(uint32 i = 0; i < (uint32)VertexAttribute::Max; i++)
+		{
+			write<int32>(vertexFormat.getElementCount((VertexAttribute)i));
+			write<Datatype>(vertexFormat.getDatatype((VertexAttribute)i));
+		}
+	}
+	return (uint32)m_vertexFormats.size() - 1;
+}
+
+void GraphicsCommandBuffer::writeVertices(const uint32 vertexFormatIndex, const VertexArray& vertices, const uint32 vertexCount)
+{
+	const uint32 count = min(vertexCount, vertices.getVertexCount());
+	write<uint32>(vertexFormatIndex);
+	write<uint32>(count);
+	writeBytes(vertices.getVertexData(), (uint64)count * m_vertexFormats[vertexFormatIndex].getVertexSizeInBytes());
+}
+
+VertexArray& GraphicsCommandBuffer::readVertices(const uint8*& cursor)
+{
+	VertexFormat& vertexFormat = m_vertexFormats[read<uint32>(cursor)];
+	const uint32 vertexCount = read<uint32>(cursor);
+	if(!(vertexFormat == m_replayVertices.getVertexFormat()))
+	{
+		m_replayVertices.clear();
+		m_replayVertices.setVertexFormat(vertexFormat);
+	}
+	m_replayVertices.resize(vertexCount);
+
+	const uint32 dataSize = vertexCount * vertexFormat.getVertexSizeInBytes();
+	if(dataSize > 0)
+	{
+		memcpy(m_replayVertices.getVertexData(), cursor, dataSize);
+	}
+	cursor += dataSize;
+	return m_replayVertices;
+}
+
+//--------------------------------------------------------------------
+// Device objects and resources
+//--------------------------------------------------------------------
+void GraphicsCommandBuffer::writeNewDeviceObject(const void* deviceObject)
+{
+	assert(m_serializable);
+	const uint32 objectId = m_nextObjectId++;
+	m_objectIds[deviceObject] = objectId;
+	write<uint32>(objectId);
+}
+
+void GraphicsCommandBuffer::writeReleasedDeviceObject(const void* deviceObject)
+{
+	writeDeviceObject(deviceObject);
+	if(m_serializable)
+	{
+		m_objectIds.erase(deviceObject);
+	}
+}
+
+void GraphicsCommandBuffer::writeDeviceObject(const void* deviceObject)
+{
+	if(!m_serializable)
+	{
+		write<const void*>(deviceObject);
+		return;
+	}
+
+	if(!deviceObject)
+	{
+		write<uint32>(0);
+		return;
+	}
+
+	write<uint32>(getObjectId(deviceObject));
+}
+
+uint32 GraphicsCommandBuffer::getObjectId(const void* deviceObject) const
+{
+	// Objects created before recording started (e.g. the backend's default
+	// shader and texture) are written as null
+	unordered_map<const void*, uint32>::const_iterator itr = m_objectIds.find(deviceObject);
+	return itr != m_objectIds.end() ? itr->second : 0;
+}
+
+template<typename ResourceType>
+void GraphicsCommandBuffer::writeResource(const shared_ptr<ResourceType>& resource)
+{
+	if(m_serializable)
+	{
+		writeDeviceObject(resource ? resource->m_deviceObject : nullptr);
+	}
+	else
+	{
+		write<uint32>(addReference(resource));
+	}
+}
+
+template<typename ResourceType>
+uint64 GraphicsCommandBuffer::getResourceKey(const shared_ptr<ResourceType>& resource) const
+{
+	if(m_serializable)
+	{
+		// A resource released during the frame may leave its address to a new
+		// one, but ids are never reused
+		return resource && resource->m_deviceObject ? getObjectId(resource->m_deviceObject) : 0;
+	}
+
+	// Referenced resources are kept alive until reset(), so their addresses are unique
+	return (uint64)(uintptr_t)resource.get();
+}
+
+template<typename ResourceType, typename DeviceObjectType>
+DeviceObjectType* GraphicsCommandBuffer::readDeviceObject(const uint8*& cursor)
+{
+	if(!m_serializable)
+	{
+		return read<DeviceObjectType*>(cursor);
+	}
+
+	const shared_ptr<ResourceType> resource = readResource<ResourceType>(cursor);
+	return resource ? resource->m_deviceObject : nullptr;
+}
+
+template<typename ResourceType>
+shared_ptr<ResourceType> GraphicsCommandBuffer::readResource(const uint8*& cursor)
+{
+	if(!m_serializable)
+	{
+		const uint32 index = read<uint32>(cursor);
+		return index != NoReference ? static_pointer_cast<ResourceType>(m_references[index]) : nullptr;
+	}
+
+	const uint32 objectId = read<uint32>(cursor);
+	if(objectId == 0)
+	{
+		return nullptr;
+	}
+
+	unordered_map<uint32, shared_ptr<void>>::iterator itr = m_replayObjects.find(objectId);
+	if(itr == m_replayObjects.end())
+	{
+		THROW("GraphicsCommandBuffer: Object %i is used before it was created", objectId);
+	}
+	return static_pointer_cast<ResourceType>(itr->second);
+}
+
+template<typename ResourceType, typename DeviceObjectType>
+void GraphicsCommandBuffer::executeCreate(const uint8*& cursor, GraphicsContext* context, void (GraphicsContext::*createDeviceObject)(DeviceObjectType*&, const string&))
+{
+	if(!m_serializable)
+	{
+		THROW("GraphicsCommandBuffer: Device objects can only be created by serialized streams");
+	}
+
+	// Executed streams own a resource wrapping every device object they
+	// create, so that state and draw commands can refer to it
+	const uint32 objectId = read<uint32>(cursor);
+	const string deviceObjectName = readString(cursor);
+	shared_ptr<ResourceType> resource(new ResourceType());
+	resource->m_graphicsContext = context;
+	if(context)
+	{
+		(context->*createDeviceObject)(resource->m_deviceObject, deviceObjectName);
+	}
+	m_replayObjects[objectId] = resource;
+}
+
+template<typename ResourceType, typename DeviceObjectType>
+void GraphicsCommandBuffer::executeDestroy(const uint8*& cursor, GraphicsContext* context, void (GraphicsContext::*destroyDeviceObject)(DeviceObjectType*&))
+{
+	if(!m_serializable)
+	{
+		DeviceObjectType* deviceObject = read<DeviceObjectType*>(cursor);
+		if(context)
+		{
+			(context->*destroyDeviceObject)(deviceObject);
+		}
+		return;
+	}
+
+	const uint32 objectId = read<uint32>(cursor);
+	if(objectId == 0)
+	{
+		return;
+	}
+
+	unordered_map<uint32, shared_ptr<void>>::iterator itr = m_replayObjects.find(objectId);
+	if(itr == m_replayObjects.end())
+	{
+		THROW("GraphicsCommandBuffer: Object %i is destroyed before it was created", objectId);
+	}
+
+	const shared_ptr<ResourceType> resource = static_pointer_cast<ResourceType>(itr->second);
+	m_replayObjects.erase(itr);
+	if(context && resource->m_deviceObject)
+	{
+		(context->*destroyDeviceObject)(resource->m_deviceObject);
+		resource->m_deviceObject = nullptr;
+	}
+}
+
+//--------------------------------------------------------------------
+// Recording
+//--------------------------------------------------------------------
+void GraphicsCommandBuffer::setState(const GraphicsContext::State& state)
+{
+	RecordedState recordedState;
+	memset(&recordedState, 0, sizeof(RecordedState));
+	recordedState.texture = getResourceKey(state.texture);
+	recordedState.shader = getResourceKey(state.shader);
+	recordedState.blendFactors[0] = state.blendState.m_src;
+	recordedState.blendFactors[1] = state.blendState.m_dst;
+	recordedState.blendFactors[2] = state.blendState.m_alphaSrc;
+	recordedState.blendFactors[3] = state.blendState.m_alphaDst;
+	recordedState.width = state.width;
+	recordedState.height = state.height;
+	memcpy(recordedState.projectionMatrix, state.projectionMatrix.get(), sizeof(recordedState.projectionMatrix));
+	memcpy(recordedState.modelViewMatrix, state.transformationMatrixStack.top().get(), sizeof(recordedState.modelViewMatrix));
+
+	// Skip redundant state changes
+	if(m_hasRecordedState && memcmp(&recordedState, &m_recordedState, sizeof(RecordedState)) == 0)
+	{
+		return;
+	}
+	m_recordedState = recordedState;
+	m_hasRecordedState = true;
+
+	beginCommand(GraphicsCommandType::SetState);
+	writeResource(state.texture);
+	writeResource(state.shader);
+	writeBytes(recordedState.blendFactors, sizeof(recordedState.blendFactors));
+	write<uint32>(recordedState.width);
+	write<uint32>(recordedState.height);
+	writeBytes(recordedState.projectionMatrix, sizeof(recordedState.projectionMatrix));
+	writeBytes(recordedState.modelViewMatrix, sizeof(recordedState.modelViewMatrix));
+}
+
+void GraphicsCommandBuffer::enable(const Capability cap)
+{
+	beginCommand(GraphicsCommandType::Enable);
+	write<Capability>(cap);
+}
+
+void GraphicsCommandBuffer::disable(const Capability cap)
+{
+	beginCommand(GraphicsCommandType::Disable);
+	write<Capability>(cap);
+}
+
+void GraphicsCommandBuffer::enableScissor(const int x, const int y, const int w, const int h)
+{
+	beginCommand(GraphicsCommandType::EnableScissor);
+	write<int32>(x);
+	write<int32>(y);
+	write<int32>(w);
+	write<int32>(h);
+}
+
+void GraphicsCommandBuffer::disableScissor()
+{
+	beginCommand(GraphicsCommandType::DisableScissor);
+}
+
+void GraphicsCommandBuffer::setPointSize(const float pointSize)
+{
+	beginCommand(GraphicsCommandType::SetPointSize);
+	write<float>(pointSize);
+}
+
+void GraphicsCommandBuffer::setLineWidth(const float lineWidth)
+{
+	beginCommand(GraphicsCommandType::SetLineWidth);
+	write<float>(lineWidth);
+}
+
+void GraphicsCommandBuffer::setViewportSize(const uint w, const uint h)
+{
+	beginCommand(GraphicsCommandType::SetViewportSize);
+	write<uint32>(w);
+	write<uint32>(h);
+}
+
+void GraphicsCommandBuffer::setSwapInterval(const int interval)
+{
+	beginCommand(GraphicsCommandType::SetSwapInterval);
+	write<int32>(interval);
+}
+
+void GraphicsCommandBuffer::swapBuffers()
+{
+	beginCommand(GraphicsCommandType::SwapBuffers);
+}
+
+void GraphicsCommandBuffer::clear(const uint32 clearMask, const Color& clearColor, const double clearDepth, const int32 clearStencil)
+{
+	beginCommand(GraphicsCommandType::Clear);
+	write<uint32>(clearMask);
+	write<uint8>(clearColor.getR());
+	write<uint8>(clearColor.getG());
+	write<uint8>(clearColor.getB());
+	write<uint8>(clearColor.getA());
+	write<double>(clearDepth);
+	write<int32>(clearStencil);
+}
+
+void GraphicsCommandBuffer::saveScreenshot(const string& path)
+{
+	beginCommand(GraphicsCommandType::SaveScreenshot);
+	writeString(path);
+}
+
+void GraphicsCommandBuffer::drawPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount)
+{
+	const uint32 vertexFormatIndex = addVertexFormat(vertices.getVertexFormat());
+	beginCommand(GraphicsCommandType::DrawPrimitives);
+	write<PrimitiveType>(type);
+	writeVertices(vertexFormatIndex, vertices, vertexCount);
+}
+
+void GraphicsCommandBuffer::drawIndexedPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount)
+{
+	const uint32 vertexFormatIndex = addVertexFormat(vertices.getVertexFormat());
+	beginCommand(GraphicsCommandType::DrawIndexedPrimitives);
+	write<PrimitiveType>(type);
+	writeVertices(vertexFormatIndex, vertices, vertexCount);
+	write<uint32>(indexCount);
+	writeBytes(indices, (uint64)indexCount * sizeof(uint));
+}
+
+void GraphicsCommandBuffer::drawPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer)
+{
+	beginCommand(GraphicsCommandType::DrawVertexBuffer);
+	write<PrimitiveType>(type);
+	writeResource(vertexBuffer);
+}
+
+void GraphicsCommandBuffer::drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer)
+{
+	beginCommand(GraphicsCommandType::DrawIndexedVertexBuffer);
+	write<PrimitiveType>(type);
+	writeResource(vertexBuffer);
+	writeResource(indexBuffer);
+}
+
+void GraphicsCommandBuffer::drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex)
+{
+	beginCommand(GraphicsCommandType::DrawIndexedVertexBufferRange);
+	write<PrimitiveType>(type);
+	writeResource(vertexBuffer);
+	writeResource(indexBuffer);
+	write<uint32>(firstIndex);
+	write<uint32>(indexCount);
+	write<int32>(baseVertex);
+}
+
+void GraphicsCommandBuffer::beginProfileScope(const char* name)
+{
+	// Scope names are string literals, so only in-process buffers can
+	// store the pointer
+	beginCommand(GraphicsCommandType::BeginProfileScope);
+	if(m_serializable)
+	{
+		writeString(name);
+	}
+	else
+	{
+		write<const char*>(name);
+	}
+}
+
+void GraphicsCommandBuffer::endProfileScope()
+{
+	beginCommand(GraphicsCommandType::EndProfileScope);
+}
+
+void GraphicsCommandBuffer::texture2D_createDeviceObject(Texture2DDeviceObject* textureDeviceObject, const string& deviceObjectName)
+{
+	beginCommand(GraphicsCommandType::Texture2DCreate);
+	writeNewDeviceObject(textureDeviceObject);
+	writeString(deviceObjectName);
+}
+
+void GraphicsCommandBuffer::texture2D_destroyDeviceObject(Texture2DDeviceObject* textureDeviceObject)
+{
+	beginCommand(GraphicsCommandType::Texture2DDestroy);
+	writeReleasedDeviceObject(textureDeviceObject);
+}
+
+void GraphicsCommandBuffer::texture2D_copyToGPU(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, const uint8* textureData)
+{
+	beginCommand(GraphicsCommandType::Texture2DCopyToGPU);
+	writeDeviceObject(textureDeviceObject);
+	write<PixelFormat>(pixelFormat);
+	write<uint32>(width);
+	write<uint32>(height);
+	write<uint8>(textureData ? 1 : 0);
+	if(textureData)
+	{
+		writeBytes(textureData, (uint64)width * height * pixelFormat.getPixelSizeInBytes());
+	}
+}
+
+void GraphicsCommandBuffer::texture2D_updateSubregion(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, const uint32 pixelSizeInBytes, const uint8* textureData)
+{
+	beginCommand(GraphicsCommandType::Texture2DUpdateSubregion);
+	writeDeviceObject(textureDeviceObject);
+	write<uint32>(x);
+	write<uint32>(y);
+	write<uint32>(subRegionWidth);
+	write<uint32>(subRegionHeight);
+	write<uint32>(pixelSizeInBytes);
+	writeBytes(textureData, (uint64)subRegionWidth * subRegionHeight * pixelSizeInBytes);
+}
+
+void GraphicsCommandBuffer::texture2D_updateFiltering(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering)
+{
+	beginCommand(GraphicsCommandType::Texture2DUpdateFiltering);
+	writeDeviceObject(textureDeviceObject);
+	write<TextureFiltering>(filtering);
+}
+
+void GraphicsCommandBuffer::texture2D_updateWrapping(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping)
+{
+	beginCommand(GraphicsCommandType::Texture2DUpdateWrapping);
+	writeDeviceObject(textureDeviceObject);
+	write<TextureWrapping>(wrapping);
+}
+
+void GraphicsCommandBuffer::texture2D_clearTexture(Texture2DDeviceObject* textureDeviceObject)
+{
+	beginCommand(GraphicsCommandType::Texture2DClear);
+	writeDeviceObject(textureDeviceObject);
+}
+
+void GraphicsCommandBuffer::shader_createDeviceObject(ShaderDeviceObject* shaderDeviceObject, const string& deviceObjectName)
+{
+	beginCommand(GraphicsCommandType::ShaderCreate);
+	writeNewDeviceObject(shaderDeviceObject);
+	writeString(deviceObjectName);
+}
+
+void GraphicsCommandBuffer::shader_destroyDeviceObject(ShaderDeviceObject* shaderDeviceObject)
+{
+	beginCommand(GraphicsCommandType::ShaderDestroy);
+	writeReleasedDeviceObject(shaderDeviceObject);
+}
+
+void GraphicsCommandBuffer::shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource)
+{
+	beginCommand(GraphicsCommandType::ShaderCompile);
+	writeDeviceObject(shaderDeviceObject);
+	writeString(vsSource);
+	writeString(psSource);
+	writeString(gsSource);
+}
+
+void GraphicsCommandBuffer::shader_setUniform(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data, const uint32 dataSize)
+{
+	beginCommand(GraphicsCommandType::ShaderSetUniform);
+	writeDeviceObject(shaderDeviceObject);
+	writeString(uniformName);
+	write<Datatype>(datatype);
+	write<uint32>(numComponentsPerElement);
+	write<uint32>(numElements);
+	write<uint32>(dataSize);
+	writeBytes(data, dataSize);
+}
+
+void GraphicsCommandBuffer::shader_setSampler2D(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture)
+{
+	beginCommand(GraphicsCommandType::ShaderSetSampler2D);
+	writeDeviceObject(shaderDeviceObject);
+	writeString(uniformName);
+	writeResource(texture);
+}
+
+void GraphicsCommandBuffer::renderTarget2D_createDeviceObject(RenderTarget2DDeviceObject* renderTargetDeviceObject, const string& deviceObjectName)
+{
+	beginCommand(GraphicsCommandType::RenderTarget2DCreate);
+	writeNewDeviceObject(renderTargetDeviceObject);
+	writeString(deviceObjectName);
+}
+
+void GraphicsCommandBuffer::renderTarget2D_destroyDeviceObject(RenderTarget2DDeviceObject* renderTargetDeviceObject)
+{
+	beginCommand(GraphicsCommandType::RenderTarget2DDestroy);
+	writeReleasedDeviceObject(renderTargetDeviceObject);
+}
+
+void GraphicsCommandBuffer::renderTarget2D_initializeRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject, const Texture2DRef* targetTextures, const uint32 targetCount)
+{
+	beginCommand(GraphicsCommandType::RenderTarget2DInitialize);
+	writeDeviceObject(renderTargetDeviceObject);
+	write<uint32>(targetCount);
+	for(uint32 i = 0; i < targetCount; i++)
+	{
+		writeResource(targetTextures[i]);
+	}
+}
+
+void GraphicsCommandBuffer::renderTarget2D_bindRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject)
+{
+	beginCommand(GraphicsCommandType::RenderTarget2DBind);
+	writeDeviceObject(renderTargetDeviceObject);
+}
+
+void GraphicsCommandBuffer::vertexBuffer_createDeviceObject(VertexBufferDeviceObject* vertexBufferDeviceObject, const string& deviceObjectName)
+{
+	beginCommand(GraphicsCommandType::VertexBufferCreate);
+	writeNewDeviceObject(vertexBufferDeviceObject);
+	writeString(deviceObjectName);
+}
+
+void GraphicsCommandBuffer::vertexBuffer_destroyDeviceObject(VertexBufferDeviceObject* vertexBufferDeviceObject)
+{
+	beginCommand(GraphicsCommandType::VertexBufferDestroy);
+	writeReleasedDeviceObject(vertexBufferDeviceObject);
+}
+
+void GraphicsCommandBuffer::vertexBuffer_initializeVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const BufferUsage bufferUsage, const VertexArray& vertices, const uint32 vertexCount)
+{
+	const uint32 vertexFormatIndex = addVertexFormat(vertices.getVertexFormat());
+	beginCommand(GraphicsCommandType::VertexBufferInitialize);
+	writeDeviceObject(vertexBufferDeviceObject);
+	write<BufferUsage>(bufferUsage);
+	writeVertices(vertexFormatIndex, vertices, vertexCount);
+}
+
+void GraphicsCommandBuffer::vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const uint32 startIndex, const VertexArray& vertices, const uint32 vertexCount)
+{
+	const uint32 vertexFormatIndex = addVertexFormat(vertices.getVertexFormat());
+	beginCommand(GraphicsCommandType::VertexBufferModify);
+	writeDeviceObject(vertexBufferDeviceObject);
+	write<uint32>(startIndex);
+	writeVertices(vertexFormatIndex, vertices, vertexCount);
+}
+
+void GraphicsCommandBuffer::indexBuffer_createDeviceObject(IndexBufferDeviceObject* indexBufferDeviceObject, const string& deviceObjectName)
+{
+	beginCommand(GraphicsCommandType::IndexBufferCreate);
+	writeNewDeviceObject(indexBufferDeviceObject);
+	writeString(deviceObjectName);
+}
+
+void GraphicsCommandBuffer::indexBuffer_destroyDeviceObject(IndexBufferDeviceObject* indexBufferDeviceObject)
+{
+	beginCommand(GraphicsCommandType::IndexBufferDestroy);
+	writeReleasedDeviceObject(indexBufferDeviceObject);
+}
+
+void GraphicsCommandBuffer::indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const BufferUsage bufferUsage, const uint32* indices, const uint32 indexCount)
+{
+	beginCommand(GraphicsCommandType::IndexBufferInitialize);
+	writeDeviceObject(indexBufferDeviceObject);
+	write<BufferUsage>(bufferUsage);
+	write<uint32>(indexCount);
+	writeBytes(indices, (uint64)indexCount * sizeof(uint32));
+}
+
+void GraphicsCommandBuffer::indexBuffer_modifyIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const uint32 startIndex, const uint32* indices, const uint32 indexCount)
+{
+	beginCommand(GraphicsCommandType::IndexBufferModify);
+	writeDeviceObject(indexBufferDeviceObject);
+	write<uint32>(startIndex);
+	write<uint32>(indexCount);
+	writeBytes(indices, (uint64)indexCount * sizeof(uint32));
+}
+
+void GraphicsCommandBuffer::invoke(function<void(GraphicsContext*)> func)
+{
+	assert(!m_serializable);
+	beginCommand(GraphicsCommandType::Invoke);
+	m_functions.push_back(move(func));
+	write<uint32>((uint32)m_functions.size() - 1);
+}
+
+//--------------------------------------------------------------------
+// Replay
+//--------------------------------------------------------------------
+void GraphicsCommandBuffer::execute(GraphicsContext* context, GraphicsCommandStatistics* outStatistics)
+{
+	GraphicsCommandStatistics statistics;
+	statistics.commandCount = m_commandCount;
+
+	const uint8* cursor = m_data.data();
+	const uint8* end = cursor + m_data.size();
+	while(cursor < end)
+	{
+		const GraphicsCommandType type = (GraphicsCommandType)read<uint32>(cursor);
+		switch(type)
+		{
+			case GraphicsCommandType::SetState:
+			{
+				const Texture2DRef texture = readResource<Texture2D>(cursor);
+				const ShaderRef shader = readResource<Shader>(cursor);
+				BlendFactor blendFactors[4];
+				memcpy(blendFactors, cursor, sizeof(blendFactors));
+				cursor += sizeof(blendFactors);
+				const uint32 width = read<uint32>(cursor);
+				const uint32 height = read<uint32>(cursor);
+				const float* projectionMatrix = (const float*)cursor;
+				cursor += sizeof(float) * 16;
+				const float* modelViewMatrix = (const float*)cursor;
+				cursor += sizeof(float) * 16;
+				statistics.stateChanges++;
+
+				if(context)
+				{
+					GraphicsContext::State& state = *context->m_currentState;
+					state.texture = texture;
+					state.shader = shader;
+					state.blendState = BlendState(blendFactors[0], blendFactors[1], blendFactors[2], blendFactors[3]);
+					state.width = width;
+					state.height = height;
+					state.projectionMatrix.set(projectionMatrix);
+					state.transformationMatrixStack.top().set(modelViewMatrix);
+				}
+			}
+			break;
+
+			case GraphicsCommandType::Enable:
+			{
+				const Capability cap = read<Capability>(cursor);
+				statistics.stateChanges++;
+				if(context) context->enable(cap);
+			}
+			break;
+
+			case GraphicsCommandType::Disable:
+			{
+				const Capability cap = read<Capability>(cursor);
+				statistics.stateChanges++;
+				if(context) context->disable(cap);
+			}
+			break;
+
+			case GraphicsCommandType::EnableScissor:
+			{
+				const int32 x = read<int32>(cursor);
+				const int32 y = read<int32>(cursor);
+				const int32 w = read<int32>(cursor);
+				const int32 h = read<int32>(cursor);
+				statistics.stateChanges++;
+				if(context) context->enableScissor(x, y, w, h);
+			}
+			break;
+
+			case GraphicsCommandType::DisableScissor:
+			{
+				statistics.stateChanges++;
+				if(context) context->disableScissor();
+			}
+			break;
+
+			case GraphicsCommandType::SetPointSize:
+			{
+				const float pointSize = read<float>(cursor);
+				statistics.stateChanges++;
+				if(context) context->setPointSize(pointSize);
+			}
+			break;
+
+			case GraphicsCommandType::SetLineWidth:
+			{
+				const float lineWidth = read<float>(cursor);
+				statistics.stateChanges++;
+				if(context) context->setLineWidth(lineWidth);
+			}
+			break;
+
+			case GraphicsCommandType::SetViewportSize:
+			{
+				const uint32 w = read<uint32>(cursor);
+				const uint32 h = read<uint32>(cursor);
+				statistics.stateChanges++;
+				if(context) context->setViewportSize(w, h);
+			}
+			break;
+
+			case GraphicsCommandType::SetSwapInterval:
+			{
+				const int32 interval = read<int32>(cursor);
+				statistics.stateChanges++;
+				if(context) context->setSwapInterval(interval);
+			}
+			break;
+
+			case GraphicsCommandType::SwapBuffers:
+			{
+				if(context) context->swapBuffers();
+			}
+			break;
+
+			case GraphicsCommandType::Clear:
+			{
+				const uint32 clearMask = read<uint32>(cursor);
+				const uint8 r = read<uint8>(cursor);
+				const uint8 g = read<uint8>(cursor);
+				const uint8 b = read<uint8>(cursor);
+				const uint8 a = read<uint8>(cursor);
+				const double clearDepth = read<double>(cursor);
+				const int32 clearStencil = read<int32>(cursor);
+				if(context) context->clear(clearMask, Color(r, g, b, a), clearDepth, clearStencil);
+			}
+			break;
+
+			case GraphicsCommandType::SaveScreenshot:
+			{
+				const string path = readString(cursor);
+				if(context) context->saveScreenshot(path);
+			}
+			break;
+
+			case GraphicsCommandType::DrawPrimitives:
+			{
+				const PrimitiveType primitiveType = read<PrimitiveType>(cursor);
+				VertexArray& vertices = readVertices(cursor);
+				statistics.drawCalls++;
+				statistics.bytesUploaded += vertices.getVertexDataSize();
+				if(context) context->drawPrimitives(primitiveType, vertices, vertices.getVertexCount());
+			}
+			break;
+
+			case GraphicsCommandType::DrawIndexedPrimitives:
+			{
+				const PrimitiveType primitiveType = read<PrimitiveType>(cursor);
+				VertexArray& vertices = readVertices(cursor);
+				const uint32 indexCount = read<uint32>(cursor);
+				m_replayIndices.resize(indexCount);
+				memcpy(m_replayIndices.data(), cursor, indexCount * sizeof(uint32));
+				cursor += indexCount * sizeof(uint32);
+				statistics.drawCalls++;
+				statistics.bytesUploaded += vertices.getVertexDataSize() + indexCount * sizeof(uint32);
+				if(context) context->drawIndexedPrimitives(primitiveType, vertices, vertices.getVertexCount(), m_replayIndices.data(), indexCount);
+			}
+			break;
+
+			case GraphicsCommandType::DrawVertexBuffer:
+			{
+				const PrimitiveType primitiveType = read<PrimitiveType>(cursor);
+				const VertexBufferRef vertexBuffer = readResource<VertexBuffer>(cursor);
+				statistics.drawCalls++;
+				if(context) context->drawPrimitives(primitiveType, vertexBuffer);
+			}
+			break;
+
+			case GraphicsCommandType::DrawIndexedVertexBuffer:
+			{
+				const PrimitiveType primitiveType = read<PrimitiveType>(cursor);
+				const VertexBufferRef vertexBuffer = readResource<VertexBuffer>(cursor);
+				const IndexBufferRef indexBuffer = readResource<IndexBuffer>(cursor);
+				statistics.drawCalls++;
+				if(context) context->drawIndexedPrimitives(primitiveType, vertexBuffer, indexBuffer);
+			}
+			break;
+
+			case GraphicsCommandType::DrawIndexedVertexBufferRange:
+			{
+				const PrimitiveType primitiveType = read<PrimitiveType>(cursor);
+				const VertexBufferRef vertexBuffer = readResource<VertexBuffer>(cursor);
+				const IndexBufferRef indexBuffer = readResource<IndexBuffer>(cursor);
+				const uint32 firstIndex = read<uint32>(cursor);
+				const uint32 indexCount = read<uint32>(cursor);
+				const int32 baseVertex = read<int32>(cursor);
+				statistics.drawCalls++;
+				if(context) context->drawIndexedPrimitives(primitiveType, vertexBuffer, indexBuffer, firstIndex, indexCount, baseVertex);
+			}
+			break;
+
+			case GraphicsCommandType::BeginProfileScope:
+			{
+				// Serialized scope names are dropped, they would not outlive the stream
+				if(m_serializable)
+				{
+					readString(cursor);
+				}
+				else
+				{
+					const char* name = read<const char*>(cursor);
+					if(context) context->beginProfileScope(name);
+				}
+			}
+			break;
+
+			case GraphicsCommandType::EndProfileScope:
+			{
+				if(!m_serializable && context) context->endProfileScope();
+			}
+			break;
+
+			case GraphicsCommandType::DefineVertexFormat:
+			{
+				VertexFormat vertexFormat;
+				for(uint32 i = 0; i < (uint32)VertexAttribute::Max; i++)
+				{
+					const int32 elementCount = read<int32>(cursor);
+					const Datatype datatype = read<Datatype>(cursor);
+					if(elementCount > 0)
+					{
+						vertexFormat.set((VertexAttribute)i, elementCount, datatype);
+					}
+				}
+				m_vertexFormats.push_back(vertexFormat);
+			}
+			break;
+
+			case GraphicsCommandType::Texture2DCreate:
+			{
+				executeCreate<Texture2D>(cursor, context, &GraphicsContext::texture2D_createDeviceObject);
+				statistics.objectsCreated++;
+			}
+			break;
+
+			case GraphicsCommandType::Texture2DDestroy:
+			{
+				executeDestroy<Texture2D>(cursor, context, &GraphicsContext::texture2D_destroyDeviceObject);
+				statistics.objectsDestroyed++;
+			}
+			break;
+
+			case GraphicsCommandType::Texture2DCopyToGPU:
+			{
+				Texture2DDeviceObject* textureDeviceObject = readDeviceObject<Texture2D, Texture2DDeviceObject>(cursor);
+				const PixelFormat pixelFormat = read<PixelFormat>(cursor);
+				const uint32 width = read<uint32>(cursor);
+				const uint32 height = read<uint32>(cursor);
+				uint8* textureData = nullptr;
+				if(read<uint8>(cursor))
+				{
+					const uint64 dataSize = (uint64)width * height * pixelFormat.getPixelSizeInBytes();
+					textureData = (uint8*)cursor;
+					cursor += dataSize;
+					statistics.bytesUploaded += dataSize;
+				}
+				if(context) context->texture2D_copyToGPU(textureDeviceObject, pixelFormat, width, height, textureData);
+			}
+			break;
+
+			case GraphicsCommandType::Texture2DUpdateSubregion:
+			{
+				Texture2DDeviceObject* textureDeviceObject = readDeviceObject<Texture2D, Texture2DDeviceObject>(cursor);
+				const uint32 x = read<uint32>(cursor);
+				const uint32 y = read<uint32>(cursor);
+				const uint32 subRegionWidth = read<uint32>(cursor);
+				const uint32 subRegionHeight = read<uint32>(cursor);
+				const uint32 pixelSizeInBytes = read<uint32>(cursor);
+				const uint64 dataSize = (uint64)subRegionWidth * subRegionHeight * pixelSizeInBytes;
+				uint8* textureData = (uint8*)cursor;
+				cursor += dataSize;
+				statistics.bytesUploaded += dataSize;
+				if(context) context->texture2D_updateSubregion(textureDeviceObject, x, y, subRegionWidth, subRegionHeight, textureData);
+			}
+			break;
+
+			case GraphicsCommandType::Texture2DUpdateFiltering:
+			{
+				Texture2DDeviceObject* textureDeviceObject = readDeviceObject<Texture2D, Texture2DDeviceObject>(cursor);
+				const TextureFiltering filtering = read<TextureFiltering>(cursor);
+				if(context) context->texture2D_updateFiltering(textureDeviceObject, filtering);
+			}
+			break;
+
+			case GraphicsCommandType::Texture2DUpdateWrapping:
+			{
+				Texture2DDeviceObject* textureDeviceObject = readDeviceObject<Texture2D, Texture2DDeviceObject>(cursor);
+				const TextureWrapping wrapping = read<TextureWrapping>(cursor);
+				if(context) context->texture2D_updateWrapping(textureDeviceObject, wrapping);
+			}
+			break;
+
+			case GraphicsCommandType::Texture2DClear:
+			{
+				Texture2DDeviceObject* textureDeviceObject = readDeviceObject<Texture2D, Texture2DDeviceObject>(cursor);
+				if(context) context->texture2D_clearTexture(textureDeviceObject);
+			}
+			break;
+
+			case GraphicsCommandType::ShaderCreate:
+			{
+				executeCreate<Shader>(cursor, context, &GraphicsContext::shader_createDeviceObject);
+				statistics.objectsCreated++;
+			}
+			break;
+
+			case GraphicsCommandType::ShaderDestroy:
+			{
+				executeDestroy<Shader>(cursor, context, &GraphicsContext::shader_destroyDeviceObject);
+				statistics.objectsDestroyed++;
+			}
+			break;
+
+			case GraphicsCommandType::ShaderCompile:
+			{
+				ShaderDeviceObject* shaderDeviceObject = readDeviceObject<Shader, ShaderDeviceObject>(cursor);
+				const string vsSource = readString(cursor);
+				const string psSource = readString(cursor);
+				const string gsSource = readString(cursor);
+				if(context) context->shader_compileShader(shaderDeviceObject, vsSource, psSource, gsSource);
+			}
+			break;
+
+			case GraphicsCommandType::ShaderSetUniform:
+			{
+				ShaderDeviceObject* shaderDeviceObject = readDeviceObject<Shader, ShaderDeviceObject>(cursor);
+				const string uniformName = readString(cursor);
+				const Datatype datatype = read<Datatype>(cursor);
+				const uint32 numComponentsPerElement = read<uint32>(cursor);
+				const uint32 numElements = read<uint32>(cursor);
+				const uint32 dataSize = read<uint32>(cursor);
+				const uint8* data = cursor;
+				cursor += dataSize;
+				statistics.stateChanges++;
+				statistics.bytesUploaded += dataSize;
+				if(context) context->shader_setUniform(shaderDeviceObject, uniformName, datatype, numComponentsPerElement, numElements, data);
+			}
+			break;
+
+			case GraphicsCommandType::ShaderSetSampler2D:
+			{
+				ShaderDeviceObject* shaderDeviceObject = readDeviceObject<Shader, ShaderDeviceObject>(cursor);
+				const string uniformName = readString(cursor);
+				const Texture2DRef texture = readResource<Texture2D>(cursor);
+				statistics.stateChanges++;
+				if(context) context->shader_setSampler2D(shaderDeviceObject, uniformName, texture);
+			}
+			break;
+
+			case GraphicsCommandType::RenderTarget2DCreate:
+			{
+				executeCreate<RenderTarget2D>(cursor, context, &GraphicsContext::renderTarget2D_createDeviceObject);
+				statistics.objectsCreated++;
+			}
+			break;
+
+			case GraphicsCommandType::RenderTarget2DDestroy:
+			{
+				executeDestroy<RenderTarget2D>(cursor, context, &GraphicsContext::renderTarget2D_destroyDeviceObject);
+				statistics.objectsDestroyed++;
+			}
+			break;
+
+			case GraphicsCommandType::RenderTarget2DInitialize:
+			{
+				RenderTarget2DDeviceObject* renderTargetDeviceObject = readDeviceObject<RenderTarget2D, RenderTarget2DDeviceObject>(cursor);
+				const uint32 targetCount = read<uint32>(cursor);
+				vector<Texture2DRef> targetTextures(targetCount);
+				for(uint32 i = 0; i < targetCount; i++)
+				{
+					targetTextures[i] = readResource<Texture2D>(cursor);
+				}
+				if(context) context->renderTarget2D_initializeRenderTarget(renderTargetDeviceObject, targetTextures.data(), targetCount);
+			}
+			break;
+
+			case GraphicsCommandType::RenderTarget2DBind:
+			{
+				RenderTarget2DDeviceObject* renderTargetDeviceObject = readDeviceObject<RenderTarget2D, RenderTarget2DDeviceObject>(cursor);
+				statistics.stateChanges++;
+				if(context) context->renderTarget2D_bindRenderTarget(renderTargetDeviceObject);
+			}
+			break;
+
+			case GraphicsCommandType::VertexBufferCreate:
+			{
+				executeCreate<VertexBuffer>(cursor, context, &GraphicsContext::vertexBuffer_createDeviceObject);
+				statistics.objectsCreated++;
+			}
+			break;
+
+			case GraphicsCommandType::VertexBufferDestroy:
+			{
+				executeDestroy<VertexBuffer>(cursor, context, &GraphicsContext::vertexBuffer_destroyDeviceObject);
+				statistics.objectsDestroyed++;
+			}
+			break;
+
+			case GraphicsCommandType::VertexBufferInitialize:
+			{
+				VertexBufferDeviceObject* vertexBufferDeviceObject = readDeviceObject<VertexBuffer, VertexBufferDeviceObject>(cursor);
+				const BufferUsage bufferUsage = read<BufferUsage>(cursor);
+				VertexArray& vertices = readVertices(cursor);
+				statistics.bytesUploaded += vertices.getVertexDataSize();
+				if(context) context->vertexBuffer_initializeVertexBuffer(vertexBufferDeviceObject, bufferUsage, vertices, vertices.getVertexCount());
+			}
+			break;
+
+			case GraphicsCommandType::VertexBufferModify:
+			{
+				VertexBufferDeviceObject* vertexBufferDeviceObject = readDeviceObject<VertexBuffer, VertexBufferDeviceObject>(cursor);
+				const uint32 startIndex = read<uint32>(cursor);
+				VertexArray& vertices = readVertices(cursor);
+				statistics.bytesUploaded += vertices.getVertexDataSize();
+				if(context) context->vertexBuffer_modifyVertexBuffer(vertexBufferDeviceObject, startIndex, vertices, vertices.getVertexCount());
+			}
+			break;
+
+			case GraphicsCommandType::IndexBufferCreate:
+			{
+				executeCreate<IndexBuffer>(cursor, context, &GraphicsContext::indexBuffer_createDeviceObject);
+				statistics.objectsCreated++;
+			}
+			break;
+
+			case GraphicsCommandType::IndexBufferDestroy:
+			{
+				executeDestroy<IndexBuffer>(cursor, context, &GraphicsContext::indexBuffer_destroyDeviceObject);
+				statistics.objectsDestroyed++;
+			}
+			break;
+
+			case GraphicsCommandType::IndexBufferInitialize:
+			{
+				IndexBufferDeviceObject* indexBufferDeviceObject = readDeviceObject<IndexBuffer, IndexBufferDeviceObject>(cursor);
+				const BufferUsage bufferUsage = read<BufferUsage>(cursor);
+				const uint32 indexCount = read<uint32>(cursor);
+				m_replayIndices.resize(indexCount);
+				memcpy(m_replayIndices.data(), cursor, indexCount * sizeof(uint32));
+				cursor += indexCount * sizeof(uint32);
+				statistics.bytesUploaded += indexCount * sizeof(uint32);
+				if(context) context->indexBuffer_initializeIndexBuffer(indexBufferDeviceObject, bufferUsage, m_replayIndices.data(), indexCount);
+			}
+			break;
+
+			case GraphicsCommandType::IndexBufferModify:
+			{
+				IndexBufferDeviceObject* indexBufferDeviceObject = readDeviceObject<IndexBuffer, IndexBufferDeviceObject>(cursor);
+				const uint32 startIndex = read<uint32>(cursor);
+				const uint32 indexCount = read<uint32>(cursor);
+				m_replayIndices.resize(indexCount);
+				memcpy(m_replayIndices.data(), cursor, indexCount * sizeof(uint32));
+				cursor += indexCount * sizeof(uint32);
+				statistics.bytesUploaded += indexCount * sizeof(uint32);
+				if(context) context->indexBuffer_modifyIndexBuffer(indexBufferDeviceObject, startIndex, m_replayIndices.data(), indexCount);
+			}
+			break;
+
+			case GraphicsCommandType::Invoke:
+			{
+				const uint32 functionIndex = read<uint32>(cursor);
+				if(context) m_functions[functionIndex](context);
+			}
+			break;
+
+			default:
+				THROW("GraphicsCommandBuffer: Unknown command type %i", (int)type);
+		}
+	}
+
+	if(outStatistics)
+	{
+		*outStatistics = statistics;
+	}
+}
+
+END_SAUCE_NAMESPACE
@@ -26,6 +26,9 @@ GraphicsContext* GraphicsContext::s_this = nullptr;
 GraphicsContext::GraphicsContext()
 	: m_context(nullptr)
 	, m_window(nullptr)
+	, m_batchPrimitiveType(PrimitiveType::Triangles)
+	, m_batchVertexCount(0)
+	, m_scratchVertexArrayCount(0)
 {
 	assert(s_this == nullptr);
 	s_this = this;
@@ -34,7 +37,6 @@ GraphicsContext::GraphicsContext()
 	VertexFormat::s_vtc.set(VertexAttribute::Position, 3, Datatype::Float);
 	VertexFormat::s_vtc.set(VertexAttribute::TexCoord, 2, Datatype::Float);
 	VertexFormat::s_vtc.set(VertexAttribute::Color, 4, Datatype::Uint8);
-	m_tempVertices = VertexFormat::s_vtc.createVertices(1);
 
 	// Add initial rendering state
 	State state;
@@ -42,8 +44,26 @@ GraphicsContext::GraphicsContext()
 	m_currentState = &m_stateStack.top();
 }
 
+GraphicsContext::GraphicsContext(GraphicsContext* wrappedContext)
+	: m_context(wrappedContext->m_context)
+	, m_window(wrappedContext->m_window)
+	, m_stateStack(wrappedContext->m_stateStack)
+	, m_batchPrimitiveType(PrimitiveType::Triangles)
+	, m_batchVertexCount(0)
+	, m_scratchVertexArrayCount(0)
+{
+	assert(s_this == wrappedContext);
+	s_this = this;
+
+	m_currentState = &m_stateStack.top();
+}
+
 GraphicsContext::~GraphicsContext()
 {
+	if(s_this == this)
+	{
+		s_this = nullptr;
+	}
 }
 
 GraphicsContext* GraphicsContext::GetContext()
@@ -53,6 +73,8 @@ GraphicsContext* GraphicsContext::GetContext()
 
 void GraphicsContext::pushRenderTarget(RenderTarget2DRef renderTarget)
 {
+	flushBatch();
+
 	// Unbind previous render target
 	if(m_currentState->renderTarget)
 	{
@@ -77,6 +99,8 @@ void GraphicsContext::pushRenderTarget(RenderTarget2DRef renderTarget)
 
 void GraphicsContext::popRenderTarget()
 {
+	flushBatch();
+
 	// Unbind previous render target
 	if(m_currentState->renderTarget)
 	{
@@ -99,7 +123,7 @@ void GraphicsContext::popRenderTarget()
 		setProjectionMatrix(createOrtographicMatrix(0, targetTexture->getWidth(), targetTexture->getHeight(), 0)); // TODO: Maybe this shouldn't be here?
 		setSize(targetTexture->getWidth(), targetTexture->getHeight());
 	}
-	else
+	else if(m_window)
 	{
 		setSize(m_window->getWidth(), m_window->getHeight());
 	}
@@ -113,6 +137,7 @@ void GraphicsContext::pushState()
 
 void GraphicsContext::popState()
 {
+	flushBatch();
 	m_stateStack.pop();
 	if(m_stateStack.empty()) THROW("GraphicsContext: State stack should not be empty.");
 	m_currentState = &m_stateStack.top();
@@ -120,6 +145,7 @@ void GraphicsContext::popState()
 
 void GraphicsContext::pushMatrix(const Matrix4 &mat)
 {
+	flushBatch();
 	m_currentState->transformationMatrixStack.push(m_currentState->transformationMatrixStack.top() * mat);
 }
 
@@ -127,6 +153,7 @@ bool GraphicsContext::popMatrix()
 {
 	if(m_currentState->transformationMatrixStack.size() > 1)
 	{
+		flushBatch();
 		m_currentState->transformationMatrixStack.pop();
 		return true;
 	}
@@ -146,6 +173,10 @@ void GraphicsContext::clearMatrixStack()
 
 void GraphicsContext::setTexture(Texture2DRef texture)
 {
+	if(m_currentState->texture != texture)
+	{
+		flushBatch();
+	}
 	m_currentState->texture = texture;
 }
 
@@ -156,6 +187,10 @@ Texture2DRef GraphicsContext::getTexture() const
 
 void GraphicsContext::setShader(ShaderRef shader)
 {
+	if(m_currentState->shader != shader)
+	{
+		flushBatch();
+	}
 	m_currentState->shader = shader;
 }
 
@@ -166,6 +201,7 @@ ShaderRef GraphicsContext::getShader() const
 
 void GraphicsContext::setBlendState(const BlendState &blendState)
 {
+	flushBatch();
 	m_currentState->blendState = blendState;
 }
 
@@ -177,6 +213,8 @@ BlendState GraphicsContext::getBlendState()
 // Orthographic projection
 void GraphicsContext::setSize(const uint w, const uint h)
 {
+	flushBatch();
+
 	// Set size
 	m_currentState->width = w;
 	m_currentState->height = h;
@@ -187,29 +225,21 @@ void GraphicsContext::setSize(const uint w, const uint h)
 
 void GraphicsContext::setProjectionMatrix(const Matrix4 matrix)
 {
+	flushBatch();
 	m_currentState->projectionMatrix = matrix;
 }
 
 void GraphicsContext::drawRectangle(const float x, const float y, const float width, const float height, const Color &color, const TextureRegion &textureRegion)
 {
-	VertexArray& tmpVerexArray = getTempVertexArray(4);
-
-	tmpVerexArray[0].set2f(VertexAttribute::Position, x, y);
-	tmpVerexArray[1].set2f(VertexAttribute::Position, x, y + height);
-	tmpVerexArray[2].set2f(VertexAttribute::Position, x + width, y);
-	tmpVerexArray[3].set2f(VertexAttribute::Position, x + width, y + height);
+	VertexPosColorUV* vertices = appendToBatch(PrimitiveType::Triangles, 6);
 
-	tmpVerexArray[0].set4ub(VertexAttribute::Color, color.getR(), color.getG(), color.getB(), color.getA());
-	tmpVerexArray[1].set4ub(VertexAttribute::Color, color.getR(), color.getG(), color.getB(), color.getA());
-	tmpVerexArray[2].set4ub(VertexAttribute::Color, color.getR(), color.getG(), color.getB(), color.getA());
-	tmpVerexArray[3].set4ub(VertexAttribute::Color, color.getR(), color.getG(), color.getB(), color.getA());
+	vertices[0] = { Vector3F(x, y, 0.0f), color, Vector2F(textureRegion.uv0.x, textureRegion.uv0.y) };
+	vertices[1] = { Vector3F(x, y + height, 0.0f), color, Vector2F(textureRegion.uv0.x, textureRegion.uv1.y) };
+	vertices[2] = { Vector3F(x + width, y, 0.0f), color, Vector2F(textureRegion.uv1.x, textureRegion.uv0.y) };
 
-	tmpVerexArray[0].set2f(VertexAttribute::TexCoord, textureRegion.uv0.x, textureRegion.uv0.y);
-	tmpVerexArray[1].set2f(VertexAttribute::TexCoord, textureRegion.uv0.x, textureRegion.uv1.y);
-	tmpVerexArray[2].set2f(VertexAttribute::TexCoord, textureRegion.uv1.x, textureRegion.uv0.y);
-	tmpVerexArray[3].set2f(VertexAttribute::TexCoord, textureRegion.uv1.x, textureRegion.uv1.y);
-
-	drawPrimitives(PrimitiveType::TriangleStrip, tmpVerexArray, 4);
+	vertices[3] = vertices[2];
+	vertices[4] = vertices[1];
+	vertices[5] = { Vector3F(x + width, y + height, 0.0f), color, Vector2F(textureRegion.uv1.x, textureRegion.uv1.y) };
 }
 
 void GraphicsContext::drawRectangle(const Vector2F &pos, const Vector2F &size, const Color &color, const TextureRegion &textureRegion)
@@ -224,27 +254,19 @@ void GraphicsContext::drawRectangle(const Rect<float> &rect, const Color &color,
 
 void GraphicsContext::drawRectangleOutline(const float x, const float y, const float width, const float height, const Color &color, const TextureRegion &textureRegion)
 {
-	VertexArray& tmpVerexArray = getTempVertexArray(8);
-
-	tmpVerexArray[0].set2f(VertexAttribute::Position, x, y);
-	tmpVerexArray[1].set2f(VertexAttribute::Position, x, y + height);
+	VertexPosColorUV* vertices = appendToBatch(PrimitiveType::Lines, 8);
 
-	tmpVerexArray[2].set2f(VertexAttribute::Position, x, y + height);
-	tmpVerexArray[3].set2f(VertexAttribute::Position, x + width, y + height);
-	
-	tmpVerexArray[4].set2f(VertexAttribute::Position, x + width, y + height);
-	tmpVerexArray[5].set2f(VertexAttribute::Position, x + width, y);
+	vertices[0] = { Vector3F(x, y, 0.0f), color, Vector2F(0.0f, 0.0f) };
+	vertices[1] = { Vector3F(x, y + height, 0.0f), color, Vector2F(0.0f, 0.0f) };
 
-	tmpVerexArray[6].set2f(VertexAttribute::Position, x + width, y);
-	tmpVerexArray[7].set2f(VertexAttribute::Position, x, y);
+	vertices[2] = vertices[1];
+	vertices[3] = { Vector3F(x + width, y + height, 0.0f), color, Vector2F(0.0f, 0.0f) };
 
-	for(int i = 0; i < 8; i++)
-	{
-		tmpVerexArray[i].set4ub(VertexAttribute::Color, color.getR(), color.getG(), color.getB(), color.getA());
-		tmpVerexArray[i].set2f(VertexAttribute::TexCoord, 0.0f, 0.0f);
-	}
+	vertices[4] = vertices[3];
+	vertices[5] = { Vector3F(x + width, y, 0.0f), color, Vector2F(0.0f, 0.0f) };
 
-	drawPrimitives(PrimitiveType::Lines, tmpVerexArray, 8);
+	vertices[6] = vertices[5];
+	vertices[7] = vertices[0];
 }
 
 void GraphicsContext::drawRectangleOutline(const Vector2F &pos, const Vector2F &size, const Color &color, const TextureRegion &textureRegion)
@@ -259,21 +281,21 @@ void GraphicsContext::drawRectangleOutline(const Rect<float> &rect, const Color
 
 void GraphicsContext::drawCircleGradient(const float x, const float y, const float radius, const uint segments, const Color &center, const Color &outer)
 {
-	VertexArray& tmpVerexArray = getTempVertexArray(segments + 2);
+	if(segments == 0) return;
 
-	tmpVerexArray[0].set2f(VertexAttribute::Position, x, y);
-	tmpVerexArray[0].set4ub(VertexAttribute::Color, center.getR(), center.getG(), center.getB(), center.getA());
-	tmpVerexArray[0].set2f(VertexAttribute::TexCoord, 0.5f, 0.5f);
+	const Vector2F* unitCircle = getUnitCircle(segments);
+	VertexPosColorUV* vertices = appendToBatch(PrimitiveType::Triangles, segments * 3);
 
-	for(uint i = 1; i < segments + 2; ++i)
+	const VertexPosColorUV centerVertex = { Vector3F(x, y, 0.0f), center, Vector2F(0.5f, 0.5f) };
+	VertexPosColorUV prevVertex = { Vector3F(x + unitCircle[0].x * radius, y + unitCircle[0].y * radius, 0.0f), outer, (Vector2F(1.0f) + unitCircle[0]) / 2.0f };
+	for(uint i = 1; i <= segments; ++i)
 	{
-		float r = (2.0f * PI * i) / segments;
-		tmpVerexArray[i].set2f(VertexAttribute::Position, x + cos(r) * radius, y + sin(r) * radius);
-		tmpVerexArray[i].set4ub(VertexAttribute::Color, outer.getR(), outer.getG(), outer.getB(), outer.getA());
-		tmpVerexArray[i].set2f(VertexAttribute::TexCoord, (1.0f + cos(r)) / 2.0f, (1.0f + sin(r)) / 2.0f);
+		const VertexPosColorUV vertex = { Vector3F(x + unitCircle[i].x * radius, y + unitCircle[i].y * radius, 0.0f), outer, (Vector2F(1.0f) + unitCircle[i]) / 2.0f };
+		*vertices++ = centerVertex;
+		*vertices++ = prevVertex;
+		*vertices++ = vertex;
+		prevVertex = vertex;
 	}
-
-	drawPrimitives(PrimitiveType::TriangleFan, tmpVerexArray, segments + 2);
 }
 
 void GraphicsContext::drawCircleGradient(const Vector2F &pos, const float radius, const uint segments, const Color &center, const Color &outer)
@@ -293,11 +315,6 @@ void GraphicsContext::drawCircle(const Vector2F &pos, const float radius, const
 
 void GraphicsContext::drawArrow(const float x0, const float y0, const float x1, const float y1, const float arrowHeadSize, const Color &color)
 {
-	VertexArray& tmpVerexArray = getTempVertexArray(6);
-
-	tmpVerexArray[0].set2f(VertexAttribute::Position, x0, y0); tmpVerexArray[0].set4ub(VertexAttribute::Color, color.x, color.y, color.z, color.w); tmpVerexArray[0].set2f(VertexAttribute::TexCoord, 0.f, 0.f);
-	tmpVerexArray[1].set2f(VertexAttribute::Position, x1, y1); tmpVerexArray[1].set4ub(VertexAttribute::Color, color.x, color.y, color.z, color.w); tmpVerexArray[1].set2f(VertexAttribute::TexCoord, 0.f, 0.f);
-
 	Vector2F p0 = (Vector2F(x0, y0) - Vector2F(x1, y1)).normalized() * arrowHeadSize;
 	Vector2F p1 = p0;
 	const float angle = math::degToRad(30.f);
@@ -307,23 +324,228 @@ void GraphicsContext::drawArrow(const float x0, const float y0, const float x1,
 	p0 += Vector2F(x1, y1);
 	p1 += Vector2F(x1, y1);
 
-	tmpVerexArray[2].set2f(VertexAttribute::Position, x1, y1); tmpVerexArray[2].set4ub(VertexAttribute::Color, color.x, color.y, color.z, color.w); tmpVerexArray[2].set2f(VertexAttribute::TexCoord, 0.f, 0.f);
-	tmpVerexArray[3].set2f(VertexAttribute::Position, p0.x, p0.y); tmpVerexArray[3].set4ub(VertexAttribute::Color, color.x, color.y, color.z, color.w); tmpVerexArray[3].set2f(VertexAttribute::TexCoord, 0.f, 0.f);
+	VertexPosColorUV* vertices = appendToBatch(PrimitiveType::Lines, 6);
+
+	vertices[0] = { Vector3F(x0, y0, 0.0f), color, Vector2F(0.0f, 0.0f) };
+	vertices[1] = { Vector3F(x1, y1, 0.0f), color, Vector2F(0.0f, 0.0f) };
 
-	tmpVerexArray[4].set2f(VertexAttribute::Position, x1, y1); tmpVerexArray[4].set4ub(VertexAttribute::Color, color.x, color.y, color.z, color.w); tmpVerexArray[4].set2f(VertexAttribute::TexCoord, 0.f, 0.f);
-	tmpVerexArray[5].set2f(VertexAttribute::Position, p1.x, p1.y); tmpVerexArray[5].set4ub(VertexAttribute::Color, color.x, color.y, color.z, color.w); tmpVerexArray[5].set2f(VertexAttribute::TexCoord, 0.f, 0.f);
+	vertices[2] = vertices[1];
+	vertices[3] = { Vector3F(p0.x, p0.y, 0.0f), color, Vector2F(0.0f, 0.0f) };
 
-	drawPrimitives(PrimitiveType::Lines, tmpVerexArray, 6);
+	vertices[4] = vertices[1];
+	vertices[5] = { Vector3F(p1.x, p1.y, 0.0f), color, Vector2F(0.0f, 0.0f) };
 }
 
 VertexArray& GraphicsContext::getTempVertexArray(const uint32 vertexCount)
 {
-	// Make sure we have enough vertices
-	if (m_tempVertices.getVertexCount() < vertexCount)
+	return allocateScratchVertices(vertexCount);
+}
+
+void GraphicsContext::flushBatch()
+{
+	if (m_batchVertexCount == 0)
 	{
-		m_tempVertices.resize(vertexCount);
+		return;
 	}
-	return m_tempVertices;
+
+	const uint32 vertexCount = m_batchVertexCount;
+	m_batchVertexCount = 0;
+	drawPrimitivesImpl(m_batchPrimitiveType, m_batchVertices, vertexCount);
+}
+
+VertexPosColorUV* GraphicsContext::appendToBatch(const PrimitiveType type, const uint32 vertexCount)
+{
+	if (m_batchVertexCount > 0 && (type != m_batchPrimitiveType || m_batchVertexCount + vertexCount > MaxBatchVertexCount))
+	{
+		flushBatch();
+	}
+
+	if (m_batchVertices.getVertexCount() < m_batchVertexCount + vertexCount)
+	{
+		m_batchVertices.resize(m_batchVertexCount + vertexCount);
+	}
+
+	m_batchPrimitiveType = type;
+	VertexPosColorUV* vertices = m_batchVertices.getVertices() + m_batchVertexCount;
+	m_batchVertexCount += vertexCount;
+	return vertices;
+}
+
+const Vector2F* GraphicsContext::getUnitCircle(const uint segments)
+{
+	vector<Vector2F>& unitCircle = m_unitCircles[segments];
+	if (unitCircle.empty())
+	{
+		unitCircle.resize(segments + 1);
+		for (uint i = 0; i <= segments; ++i)
+		{
+			const float r = (2.0f * PI * i) / segments;
+			unitCircle[i] = Vector2F(cos(r), sin(r));
+		}
+	}
+	return unitCircle.data();
+}
+
+VertexArray& GraphicsContext::allocateScratchVertices(const uint32 vertexCount, const VertexFormat& vertexFormat)
+{
+	if (m_scratchVertexArrayCount == m_scratchVertices.size())
+	{
+		m_scratchVertices.emplace_back(new VertexArray(0, vertexFormat));
+	}
+
+	// Reuse the storage of the array handed out at this point last frame
+	VertexArray& vertices = *m_scratchVertices[m_scratchVertexArrayCount++];
+	vertices.clear();
+	if (!(vertices.getVertexFormat() == vertexFormat))
+	{
+		vertices.setVertexFormat(vertexFormat);
+	}
+	vertices.resize(vertexCount);
+	return vertices;
+}
+
+void GraphicsContext::resetScratchVertices()
+{
+	m_scratchVertexArrayCount = 0;
+}
+
+// Commands flush the primitive batch before they reach the backend
+void GraphicsContext::enable(const Capability cap)
+{
+	flushBatch();
+	enableImpl(cap);
+}
+
+void GraphicsContext::disable(const Capability cap)
+{
+	flushBatch();
+	disableImpl(cap);
+}
+
+void GraphicsContext::enableScissor(const int x, const int y, const int w, const int h)
+{
+	flushBatch();
+	enableScissorImpl(x, y, w, h);
+}
+
+void GraphicsContext::disableScissor()
+{
+	flushBatch();
+	disableScissorImpl();
+}
+
+void GraphicsContext::setPointSize(const float pointSize)
+{
+	flushBatch();
+	setPointSizeImpl(pointSize);
+}
+
+void GraphicsContext::setLineWidth(const float lineWidth)
+{
+	flushBatch();
+	setLineWidthImpl(lineWidth);
+}
+
+void GraphicsContext::setViewportSize(const uint w, const uint h)
+{
+	flushBatch();
+	setViewportSizeImpl(w, h);
+}
+
+void GraphicsContext::clear(const uint32 clearMask, const Color& clearColor, const double clearDepth, const int32 clearStencil)
+{
+	flushBatch();
+	clearImpl(clearMask, clearColor, clearDepth, clearStencil);
+}
+
+void GraphicsContext::saveScreenshot(string path)
+{
+	flushBatch();
+	saveScreenshotImpl(path);
+}
+
+void GraphicsContext::drawIndexedPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount)
+{
+	flushBatch();
+	drawIndexedPrimitivesImpl(type, vertices, vertexCount, indices, indexCount);
+}
+
+void GraphicsContext::drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer)
+{
+	flushBatch();
+	drawIndexedPrimitivesImpl(type, vertexBuffer, indexBuffer);
+}
+
+void GraphicsContext::drawIndexedPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex)
+{
+	flushBatch();
+	drawIndexedPrimitivesImpl(type, vertexBuffer, indexBuffer, firstIndex, indexCount, baseVertex);
+}
+
+void GraphicsContext::drawPrimitives(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount)
+{
+	flushBatch();
+	drawPrimitivesImpl(type, vertices, vertexCount);
+}
+
+void GraphicsContext::drawPrimitives(const PrimitiveType type, const VertexBufferRef vertexBuffer)
+{
+	flushBatch();
+	drawPrimitivesImpl(type, vertexBuffer);
+}
+
+void GraphicsContext::swapBuffers()
+{
+	flushBatch();
+	swapBuffersImpl();
+}
+
+void GraphicsContext::texture2D_copyToGPU(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData)
+{
+	flushBatch();
+	texture2D_copyToGPUImpl(textureDeviceObject, pixelFormat, width, height, textureData);
+}
+
+void GraphicsContext::texture2D_copyToCPUReadable(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData)
+{
+	flushBatch();
+	texture2D_copyToCPUReadableImpl(textureDeviceObject, outTextureData);
+}
+
+void GraphicsContext::texture2D_updateSubregion(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData)
+{
+	flushBatch();
+	texture2D_updateSubregionImpl(textureDeviceObject, x, y, subRegionWidth, subRegionHeight, textureData);
+}
+
+void GraphicsContext::texture2D_updateFiltering(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering)
+{
+	flushBatch();
+	texture2D_updateFilteringImpl(textureDeviceObject, filtering);
+}
+
+void GraphicsContext::texture2D_updateWrapping(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping)
+{
+	flushBatch();
+	texture2D_updateWrappingImpl(textureDeviceObject, wrapping);
+}
+
+void GraphicsContext::texture2D_clearTexture(Texture2DDeviceObject* textureDeviceObject)
+{
+	flushBatch();
+	texture2D_clearTextureImpl(textureDeviceObject);
+}
+
+void GraphicsContext::shader_setUniform(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data)
+{
+	flushBatch();
+	shader_setUniformImpl(shaderDeviceObject, uniformName, datatype, numComponentsPerElement, numElements, data);
+}
+
+void GraphicsContext::shader_setSampler2D(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture)
+{
+	flushBatch();
+	shader_setSampler2DImpl(shaderDeviceObject, uniformName, texture);
 }
 
 void GraphicsContext::texture2D_getDeviceObject(Texture2DRef texture, Texture2DDeviceObject*& outTextureDeviceObject)
@@ -0,0 +1,449 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+#include <Sauce/Graphics.h>
+#include <Sauce/Graphics/Null/NullGraphicsContext.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+/**************************************************
+ * Device object definitions                      *
+ **************************************************/
+struct NullTexture2DDeviceObject : public Texture2DDeviceObject
+{
+	vector<uint8> pixels;
+};
+
+struct NullShaderDeviceObject : public ShaderDeviceObject
+{
+	unordered_map<string, uint32> uniformDataSizes;
+};
+
+struct NullRenderTarget2DDeviceObject : public RenderTarget2DDeviceObject
+{
+};
+
+struct NullVertexBufferDeviceObject : public VertexBufferDeviceObject
+{
+};
+
+struct NullIndexBufferDeviceObject : public IndexBufferDeviceObject
+{
+};
+
+NullGraphicsContext::NullGraphicsContext(const uint width, const uint height)
+	: m_enabledCapabilities(0)
+	, m_frameCount(0)
+	, m_drawCallCount(0)
+	, m_vertexCount(0)
+	, m_deviceObjectCount(0)
+{
+	setSize(width, height);
+	setProjectionMatrix(createOrtographicMatrix(0, width, 0, height));
+}
+
+NullGraphicsContext::~NullGraphicsContext()
+{
+	if(m_deviceObjectCount > 0)
+	{
+		LOG("NullGraphicsContext: %i device objects were not destroyed", m_deviceObjectCount);
+	}
+}
+
+Window *NullGraphicsContext::createWindow(const string &title, const int x, const int y, const int w, const int h, const Uint32 flags)
+{
+	// A plain window without a rendering surface, mostly useful for input
+	m_window = new Window(this, title, x, y, w, h, flags);
+
+	Vector2I size;
+	m_window->getSize(&size.x, &size.y);
+	setSize(size.x, size.y);
+	setProjectionMatrix(createOrtographicMatrix(0, size.x, 0, size.y));
+	return m_window;
+}
+
+/**************************************************
+ * Rendering                                      *
+ **************************************************/
+void NullGraphicsContext::enableImpl(const Capability cap)
+{
+	m_enabledCapabilities |= 1 << (uint32)cap;
+}
+
+void NullGraphicsContext::disableImpl(const Capability cap)
+{
+	m_enabledCapabilities &= ~(1 << (uint32)cap);
+}
+
+bool NullGraphicsContext::isEnabled(const Capability cap)
+{
+	return (m_enabledCapabilities & (1 << (uint32)cap)) != 0;
+}
+
+void NullGraphicsContext::enableScissorImpl(const int x, const int y, const int w, const int h)
+{
+}
+
+void NullGraphicsContext::disableScissorImpl()
+{
+}
+
+void NullGraphicsContext::setPointSizeImpl(const float pointSize)
+{
+}
+
+void NullGraphicsContext::setLineWidthImpl(const float lineWidth)
+{
+}
+
+void NullGraphicsContext::setViewportSizeImpl(const uint w, const uint h)
+{
+}
+
+void NullGraphicsContext::clearImpl(const uint32 clearMask, const Color &clearColor, const double clearDepth, const int32 clearStencil)
+{
+}
+
+void NullGraphicsContext::saveScreenshotImpl(string filePath)
+{
+	LOG("NullGraphicsContext: Cannot save screenshot \"%s\", nothing is rendered", filePath.c_str());
+}
+
+Matrix4 NullGraphicsContext::createOrtographicMatrix(const float l, const float r, const float t, const float b, const float n, const float f) const
+{
+	// Same conventions as the OpenGL backend so that game code sees the same matrices
+	Matrix4 mat(
+		2.0f / (r - l), 0.0f,            0.0f,           -((r + l) / (r - l)),
+		0.0f,           2.0f / (t - b),  0.0f,           -((t + b) / (t - b)),
+		0.0f,           0.0f,           -2.0f / (f - n), -((f + n) / (f - n)),
+		0.0f,           0.0f,            0.0f,            1.0f);
+	return mat;
+}
+
+Matrix4 NullGraphicsContext::createPerspectiveMatrix(const float fov, const float aspectRatio, const float zNear, const float zFar) const
+{
+	const float s = tanf(math::degToRad(fov / 2.0f));
+	Matrix4 mat(
+		1.0f / (s * aspectRatio),    0.0f,      0.0f,                             0.0f,
+		0.0f,                        1.0f / s,  0.0f,                             0.0f,
+		0.0f,                        0.0f,     -(zFar + zNear) / (zFar - zNear), -(2 * zFar * zNear) / (zFar - zNear) ,
+		0.0f,                        0.0f,     -1.0f,                             0.0f);
+	return mat;
+}
+
+Matrix4 NullGraphicsContext::createLookAtMatrix(const Vector3F &position, const Vector3F &fwd) const
+{
+	const Vector3F worldUp(0.0f, 1.0f, 0.0f);
+	const Vector3F right = math::normalize(math::cross(worldUp, fwd));
+	const Vector3F up = math::cross(fwd, right);
+	Matrix4 cameraMatrix(
+		right.x, right.y, right.z, 0.0f,
+		up.x, up.y, up.z, 0.0f,
+		fwd.x, fwd.y, fwd.z, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f);
+	Matrix4 cameraTranslate(
+		1, 0, 0, -position.x,
+		0, 1, 0, -position.y,
+		0, 0, 1, -position.z,
+		0.0f, 0.0f, 0.0f, 1.0f);
+	return cameraMatrix * cameraTranslate;
+}
+
+void NullGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount)
+{
+	m_drawCallCount++;
+	m_vertexCount += indexCount;
+}
+
+void NullGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer)
+{
+	m_drawCallCount++;
+	m_vertexCount += indexBuffer->getIndexCount();
+}
+
+void NullGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex)
+{
+	assert(firstIndex + indexCount <= indexBuffer->getIndexCount());
+	m_drawCallCount++;
+	m_vertexCount += indexCount;
+}
+
+void NullGraphicsContext::drawPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount)
+{
+	m_drawCallCount++;
+	m_vertexCount += vertexCount;
+}
+
+void NullGraphicsContext::drawPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer)
+{
+	m_drawCallCount++;
+	m_vertexCount += vertexBuffer->getVertexCount();
+}
+
+void NullGraphicsContext::swapBuffersImpl()
+{
+	m_frameCount++;
+}
+
+void NullGraphicsContext::setSwapInterval(const int interval)
+{
+}
+
+/**************************************************
+ * Texture2D internal API implementation          *
+ **************************************************/
+void NullGraphicsContext::texture2D_createDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject, const string& deviceObjectName)
+{
+	outTextureDeviceObject = new NullTexture2DDeviceObject();
+	m_deviceObjectCount++;
+}
+
+void NullGraphicsContext::texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject)
+{
+	assert(dynamic_cast<NullTexture2DDeviceObject*>(outTextureDeviceObject));
+	delete outTextureDeviceObject;
+	outTextureDeviceObject = nullptr;
+	m_deviceObjectCount--;
+}
+
+void NullGraphicsContext::texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObjectBase, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData)
+{
+	NullTexture2DDeviceObject* textureDeviceObject = dynamic_cast<NullTexture2DDeviceObject*>(textureDeviceObjectBase);
+	assert(textureDeviceObject);
+
+	// Keep the pixels so that they can be read back. Textures created
+	// without data are zeroed, like the OpenGL backend does.
+	const size_t dataSize = (size_t)width * height * pixelFormat.getPixelSizeInBytes();
+	if(textureData)
+	{
+		textureDeviceObject->pixels.assign(textureData, textureData + dataSize);
+	}
+	else
+	{
+		textureDeviceObject->pixels.assign(dataSize, 0);
+	}
+
+	// Update device object settings
+	textureDeviceObject->width = width;
+	textureDeviceObject->height = height;
+	textureDeviceObject->pixelFormat = pixelFormat;
+}
+
+void NullGraphicsContext::texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObjectBase, uint8** outTextureData)
+{
+	NullTexture2DDeviceObject* textureDeviceObject = dynamic_cast<NullTexture2DDeviceObject*>(textureDeviceObjectBase);
+	assert(textureDeviceObject);
+
+	*outTextureData = new uint8[textureDeviceObject->pixels.size()];
+	if(!textureDeviceObject->pixels.empty())
+	{
+		memcpy(*outTextureData, textureDeviceObject->pixels.data(), textureDeviceObject->pixels.size());
+	}
+}
+
+void NullGraphicsContext::texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObjectBase, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData)
+{
+	NullTexture2DDeviceObject* textureDeviceObject = dynamic_cast<NullTexture2DDeviceObject*>(textureDeviceObjectBase);
+	assert(textureDeviceObject);
+	assert(x + subRegionWidth <= textureDeviceObject->width && y + subRegionHeight <= textureDeviceObject->height);
+
+	// Copy the region row by row
+	const uint32 pixelSize = textureDeviceObject->pixelFormat.getPixelSizeInBytes();
+	const size_t rowSize = (size_t)subRegionWidth * pixelSize;
+	for(uint32 row = 0; row < subRegionHeight; ++row)
+	{
+		uint8* dst = textureDeviceObject->pixels.data() + ((size_t)(y + row) * textureDeviceObject->width + x) * pixelSize;
+		memcpy(dst, textureData + row * rowSize, rowSize);
+	}
+}
+
+void NullGraphicsContext::texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering)
+{
+	textureDeviceObject->filtering = filtering;
+}
+
+void NullGraphicsContext::texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping)
+{
+	textureDeviceObject->wrapping = wrapping;
+}
+
+void NullGraphicsContext::texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObjectBase)
+{
+	NullTexture2DDeviceObject* textureDeviceObject = dynamic_cast<NullTexture2DDeviceObject*>(textureDeviceObjectBase);
+	assert(textureDeviceObject);
+	fill(textureDeviceObject->pixels.begin(), textureDeviceObject->pixels.end(), 0);
+}
+
+/**************************************************
+ * Shader internal API implementation             *
+ **************************************************/
+void NullGraphicsContext::shader_createDeviceObject(ShaderDeviceObject*& outShaderDeviceObject, const string& deviceObjectName)
+{
+	outShaderDeviceObject = new NullShaderDeviceObject();
+	m_deviceObjectCount++;
+}
+
+void NullGraphicsContext::shader_destroyDeviceObject(ShaderDeviceObject*& outShaderDeviceObject)
+{
+	assert(dynamic_cast<NullShaderDeviceObject*>(outShaderDeviceObject));
+	delete outShaderDeviceObject;
+	outShaderDeviceObject = nullptr;
+	m_deviceObjectCount--;
+}
+
+void NullGraphicsContext::shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource)
+{
+	// Nothing is compiled, so uniforms are only known once they are set
+}
+
+void NullGraphicsContext::shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObjectBase, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data)
+{
+	NullShaderDeviceObject* shaderDeviceObject = dynamic_cast<NullShaderDeviceObject*>(shaderDeviceObjectBase);
+	if(!shaderDeviceObject)
+	{
+		return;
+	}
+
+	// Struct layouts come from shader reflection, which we do not have
+	switch(datatype)
+	{
+		case Datatype::Struct: break;
+		case Datatype::Matrix4: shaderDeviceObject->uniformDataSizes[uniformName] = util::GetDatatypeSize(datatype) * numElements; break;
+		default: shaderDeviceObject->uniformDataSizes[uniformName] = util::GetDatatypeSize(datatype) * numComponentsPerElement * numElements; break;
+	}
+}
+
+void NullGraphicsContext::shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture)
+{
+}
+
+uint32 NullGraphicsContext::shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObjectBase, const string& uniformName)
+{
+	NullShaderDeviceObject* shaderDeviceObject = dynamic_cast<NullShaderDeviceObject*>(shaderDeviceObjectBase);
+	if(!shaderDeviceObject)
+	{
+		return 0;
+	}
+
+	unordered_map<string, uint32>::const_iterator itr = shaderDeviceObject->uniformDataSizes.find(uniformName);
+	return itr != shaderDeviceObject->uniformDataSizes.end() ? itr->second : 0;
+}
+
+/**************************************************
+ * RenderTarget2D internal API implementation     *
+ **************************************************/
+void NullGraphicsContext::renderTarget2D_createDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject, const string& deviceObjectName)
+{
+	outRenderTargetDeviceObject = new NullRenderTarget2DDeviceObject();
+	m_deviceObjectCount++;
+}
+
+void NullGraphicsContext::renderTarget2D_destroyDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject)
+{
+	assert(dynamic_cast<NullRenderTarget2DDeviceObject*>(outRenderTargetDeviceObject));
+	delete[] outRenderTargetDeviceObject->targetTextures;
+	delete outRenderTargetDeviceObject;
+	outRenderTargetDeviceObject = nullptr;
+	m_deviceObjectCount--;
+}
+
+void NullGraphicsContext::renderTarget2D_initializeRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject, const Texture2DRef* targetTextures, const uint32 targetCount)
+{
+	// Copy target texture references
+	assert(targetCount > 0);
+	Texture2DRef* targetTexturesCopy = new Texture2DRef[targetCount];
+	for(uint32 i = 0; i < targetCount; ++i)
+	{
+		targetTexturesCopy[i] = targetTextures[i];
+	}
+
+	delete[] renderTargetDeviceObject->targetTextures;
+	renderTargetDeviceObject->targetCount = targetCount;
+	renderTargetDeviceObject->targetTextures = targetTexturesCopy;
+}
+
+void NullGraphicsContext::renderTarget2D_bindRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject)
+{
+}
+
+/**************************************************
+ * VertexBuffer internal API implementation       *
+ **************************************************/
+void NullGraphicsContext::vertexBuffer_createDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject, const string& deviceObjectName)
+{
+	outVertexBufferDeviceObject = new NullVertexBufferDeviceObject();
+	m_deviceObjectCount++;
+}
+
+void NullGraphicsContext::vertexBuffer_destroyDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject)
+{
+	assert(dynamic_cast<NullVertexBufferDeviceObject*>(outVertexBufferDeviceObject));
+	delete outVertexBufferDeviceObject;
+	outVertexBufferDeviceObject = nullptr;
+	m_deviceObjectCount--;
+}
+
+void NullGraphicsContext::vertexBuffer_initializeVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const BufferUsage bufferUsage, const VertexArray& vertices, const uint32 vertexCount)
+{
+	assert(vertexCount > 0);
+	vertexBufferDeviceObject->bufferUsage = bufferUsage;
+	vertexBufferDeviceObject->vertexCount = vertexCount;
+	vertexBufferDeviceObject->vertexFormat = vertices.getVertexFormat();
+}
+
+void NullGraphicsContext::vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const uint32 startIndex, const VertexArray& vertices, const uint32 vertexCount)
+{
+	assert(vertexCount > 0);
+	assert(vertexBufferDeviceObject->vertexFormat == vertices.getVertexFormat());
+	assert(startIndex + vertexCount <= vertexBufferDeviceObject->vertexCount);
+}
+
+void NullGraphicsContext::vertexBuffer_bindVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject)
+{
+}
+
+/**************************************************
+ * IndexBuffer internal API implementation        *
+ **************************************************/
+void NullGraphicsContext::indexBuffer_createDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject, const string& deviceObjectName)
+{
+	outIndexBufferDeviceObject = new NullIndexBufferDeviceObject();
+	m_deviceObjectCount++;
+}
+
+void NullGraphicsContext::indexBuffer_destroyDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject)
+{
+	assert(dynamic_cast<NullIndexBufferDeviceObject*>(outIndexBufferDeviceObject));
+	delete outIndexBufferDeviceObject;
+	outIndexBufferDeviceObject = nullptr;
+	m_deviceObjectCount--;
+}
+
+void NullGraphicsContext::indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const BufferUsage bufferUsage, const uint32* indices, const uint32 indexCount)
+{
+	assert(indexCount > 0);
+	indexBufferDeviceObject->bufferUsage = bufferUsage;
+	indexBufferDeviceObject->indexCount = indexCount;
+}
+
+void NullGraphicsContext::indexBuffer_modifyIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const uint32 startIndex, const uint32* indices, const uint32 indexCount)
+{
+	assert(indexCount > 0);
+	assert(startIndex + indexCount <= indexBufferDeviceObject->indexCount);
+}
+
+void NullGraphicsContext::indexBuffer_bindIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject)
+{
+}
+
+END_SAUCE_NAMESPACE
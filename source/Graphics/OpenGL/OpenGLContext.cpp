@@ -369,19 +369,28 @@ extern void checkOpenGLError(const string& info);
 
 OpenGLContext::OpenGLContext(const int major, const int minor) :
 	m_majorVersion(major),
-	m_minorVersion(minor)
+	m_minorVersion(minor),
+	m_profileFrameIndex(0),
+	m_timerQueriesSupported(false)
 {
 }
 
 OpenGLContext::~OpenGLContext()
 {
+	for(ProfileFrame& profileFrame : m_profileFrames)
+	{
+		if(!profileFrame.queryPool.empty())
+		{
+			GL_CALL(glDeleteQueries((GLsizei)profileFrame.queryPool.size(), profileFrame.queryPool.data()));
+		}
+	}
 	GL_CALL(glDeleteBuffers(1, &g_vbo));
 	GL_CALL(glDeleteVertexArrays(1, &g_vao));
 	delete g_zeroedTextureDataArray;
 	SDL_GL_DeleteContext(m_context);
 }
 
-void OpenGLContext::enable(const Capability cap)
+void OpenGLContext::enableImpl(const Capability cap)
 {
 	switch(cap)
 	{
@@ -403,7 +412,7 @@ void OpenGLContext::enable(const Capability cap)
 	}
 }
 
-void OpenGLContext::disable(const Capability cap)
+void OpenGLContext::disableImpl(const Capability cap)
 {
 	switch(cap)
 	{
@@ -431,17 +440,17 @@ bool OpenGLContext::isEnabled(const Capability cap)
 	return enabled;
 }
 
-void OpenGLContext::setPointSize(const float pointSize)
+void OpenGLContext::setPointSizeImpl(const float pointSize)
 {
 	GL_CALL(glPointSize(pointSize));
 }
 
-void OpenGLContext::setLineWidth(const float lineWidth)
+void OpenGLContext::setLineWidthImpl(const float lineWidth)
 {
 	GL_CALL(glLineWidth(lineWidth));
 }
 
-void OpenGLContext::clear(const uint32 clearMask, const Color& clearColor, const double clearDepth, const int32 clearStencil)
+void OpenGLContext::clearImpl(const uint32 clearMask, const Color& clearColor, const double clearDepth, const int32 clearStencil)
 {
 	uint32 glClearMask = 0x0;
 	if (clearMask & BufferMask::Color)
@@ -465,18 +474,18 @@ void OpenGLContext::clear(const uint32 clearMask, const Color& clearColor, const
 	GL_CALL(glClear(glClearMask));
 }
 
-void OpenGLContext::enableScissor(const int x, const int y, const int w, const int h)
+void OpenGLContext::enableScissorImpl(const int x, const int y, const int w, const int h)
 {
 	GL_CALL(glEnable(GL_SCISSOR_TEST));
 	GL_CALL(glScissor(x, y, w, h));
 }
 
-void OpenGLContext::disableScissor()
+void OpenGLContext::disableScissorImpl()
 {
 	GL_CALL(glDisable(GL_SCISSOR_TEST));
 }
 
-void OpenGLContext::saveScreenshot(string path)
+void OpenGLContext::saveScreenshotImpl(string path)
 {
 	// Get frame buffer data
 	uchar *data = new uchar[m_currentState->width * m_currentState->height * 4];
@@ -493,7 +502,7 @@ void OpenGLContext::saveScreenshot(string path)
 }
 
 // Orthographic projection
-void OpenGLContext::setViewportSize(const uint w, const uint h)
+void OpenGLContext::setViewportSizeImpl(const uint w, const uint h)
 {
 	// Set viewport
 	GL_CALL(glViewport(0, 0, w, h));
@@ -622,6 +631,10 @@ Window *OpenGLContext::createWindow(const string &title, const int x, const int
 	GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
 
 	GL_CALL(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &g_maxTextureSize));
+
+	// Timestamp queries are core in OpenGL 3.3 (ARB_timer_query)
+	m_timerQueriesSupported = glQueryCounter != nullptr && glGetQueryObjectui64v != nullptr && glGetInteger64v != nullptr;
+	beginProfileFrame();
 	g_zeroedTextureDataArray = new GLubyte[g_maxTextureSize * g_maxTextureSize * 4];
 	memset(g_zeroedTextureDataArray, 0, g_maxTextureSize * g_maxTextureSize * 4);
 
@@ -700,30 +713,32 @@ void OpenGLContext::setupContext()
 		shader = s_defaultShader;
 	}
 
+	ShaderDeviceObject* shaderDeviceObjectBase;
+	shader_getDeviceObject(shader, shaderDeviceObjectBase);
+	OpenGLShaderDeviceObject* shaderDeviceObject = dynamic_cast<OpenGLShaderDeviceObject*>(shaderDeviceObjectBase);
+	assert(shaderDeviceObject);
+
+	// Set uniforms directly on this context, as the shader may have been
+	// created through a context that forwards its calls to us
 	if (m_currentState->texture)
 	{
-		shader->setSampler2D("u_Texture", m_currentState->texture);
+		shader_setSampler2D(shaderDeviceObject, "u_Texture", m_currentState->texture);
 	}
 	else if (!m_currentState->shader)
 	{
-		shader->setSampler2D("u_Texture", s_defaultTexture);
+		shader_setSampler2D(shaderDeviceObject, "u_Texture", s_defaultTexture);
 	}
 
 	{
 		// TODO: Check if all samplers are bound on the shader
 	}
 
-	ShaderDeviceObject* shaderDeviceObjectBase;
-	shader_getDeviceObject(shader, shaderDeviceObjectBase);
-	OpenGLShaderDeviceObject* shaderDeviceObject = dynamic_cast<OpenGLShaderDeviceObject*>(shaderDeviceObjectBase);
-	assert(shaderDeviceObject);
-
 	// Enable shader
 	GL_CALL(glUseProgram(shaderDeviceObject->id));
 
 	// Set projection matrix
 	Matrix4 modelViewProjection = m_currentState->projectionMatrix * m_currentState->transformationMatrixStack.top();
-	shader->setUniformMatrix4f("u_ModelViewProj", modelViewProjection.get());
+	shader_setUniform(shaderDeviceObject, "u_ModelViewProj", Datatype::Matrix4, 16, 1, modelViewProjection.get());
 
 	// Set all uniforms
 	int32 currentTextureTarget = 0;
@@ -854,7 +869,7 @@ void OpenGLContext::setupVertexAttributePointers(const VertexFormat& fmt)
 	}
 }
 
-void OpenGLContext::drawIndexedPrimitives(const PrimitiveType primitiveType, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount)
+void OpenGLContext::drawIndexedPrimitivesImpl(const PrimitiveType primitiveType, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount)
 {
 	// If there are no vertices to draw, do nothing
 	if(vertexCount == 0 || indexCount == 0) return;
@@ -878,7 +893,7 @@ void OpenGLContext::drawIndexedPrimitives(const PrimitiveType primitiveType, con
 	GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
 
-void OpenGLContext::drawIndexedPrimitives(const PrimitiveType primitiveType, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer)
+void OpenGLContext::drawIndexedPrimitivesImpl(const PrimitiveType primitiveType, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer)
 {
 	// If one of the buffers are empty, do nothing
 	if (vertexBuffer->getVertexCount() == 0 || indexBuffer->getIndexCount() == 0)
@@ -917,7 +932,45 @@ void OpenGLContext::drawIndexedPrimitives(const PrimitiveType primitiveType, con
 	GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
 
-void OpenGLContext::drawPrimitives(const PrimitiveType primitiveType, const VertexArray& vertices, const uint vertexCount)
+void OpenGLContext::drawIndexedPrimitivesImpl(const PrimitiveType primitiveType, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex)
+{
+	// If there is nothing to draw, do nothing
+	if (vertexBuffer->getVertexCount() == 0 || indexCount == 0)
+	{
+		return;
+	}
+	assert(firstIndex + indexCount <= indexBuffer->getIndexCount());
+
+	setupContext();
+
+	// Bind vertex buffer object
+	VertexFormat vertexFormat;
+	{
+		VertexBufferDeviceObject* vertexBufferDeviceObject;
+		vertexBuffer_getDeviceObject(vertexBuffer, vertexBufferDeviceObject);
+		vertexBuffer_bindVertexBuffer(vertexBufferDeviceObject);
+		vertexFormat = vertexBufferDeviceObject->vertexFormat;
+	}
+
+	// Bind index buffer object
+	{
+		IndexBufferDeviceObject* indexBufferDeviceObject;
+		indexBuffer_getDeviceObject(indexBuffer, indexBufferDeviceObject);
+		indexBuffer_bindIndexBuffer(indexBufferDeviceObject);
+	}
+
+	// Setup vertex attribute pointers
+	setupVertexAttributePointers(vertexFormat);
+
+	// Draw the index range
+	GL_CALL(glDrawElementsBaseVertex(toPrimitiveType(primitiveType), indexCount, GL_UNSIGNED_INT, (void*)(uint64)(firstIndex * sizeof(uint32)), baseVertex));
+
+	// Reset vbo buffers
+	GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+	GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+}
+
+void OpenGLContext::drawPrimitivesImpl(const PrimitiveType primitiveType, const VertexArray& vertices, const uint vertexCount)
 {
 	// If there are no vertices to draw, do nothing
 	if(vertexCount == 0) return;
@@ -938,7 +991,7 @@ void OpenGLContext::drawPrimitives(const PrimitiveType primitiveType, const Vert
 	GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
 
-void OpenGLContext::drawPrimitives(const PrimitiveType primitiveType, const VertexBufferRef vertexBuffer)
+void OpenGLContext::drawPrimitivesImpl(const PrimitiveType primitiveType, const VertexBufferRef vertexBuffer)
 {
 	// If the buffer is empty, do nothing
 	if (vertexBuffer->getVertexCount() == 0)
@@ -969,6 +1022,130 @@ void OpenGLContext::drawPrimitives(const PrimitiveType primitiveType, const Vert
 	GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
 
+void OpenGLContext::beginProfileScope(const char* name)
+{
+	if(!m_timerQueriesSupported)
+	{
+		return;
+	}
+
+	// Take a pair of queries from the frame's pool
+	ProfileFrame& profileFrame = m_profileFrames[m_profileFrameIndex];
+	if(profileFrame.usedQueryCount + 2 > profileFrame.queryPool.size())
+	{
+		const size_t prevPoolSize = profileFrame.queryPool.size();
+		profileFrame.queryPool.resize(max<size_t>(prevPoolSize * 2, 32));
+		GL_CALL(glGenQueries((GLsizei)(profileFrame.queryPool.size() - prevPoolSize), profileFrame.queryPool.data() + prevPoolSize));
+	}
+
+	ProfileQuery profileQuery;
+	profileQuery.name = name;
+	profileQuery.beginQuery = profileFrame.queryPool[profileFrame.usedQueryCount++];
+	profileQuery.endQuery = profileFrame.queryPool[profileFrame.usedQueryCount++];
+	profileQuery.depth = (uint32)m_openProfileScopes.size();
+
+	// Timestamps rather than GL_TIME_ELAPSED so that scopes can nest
+	GL_CALL(glQueryCounter(profileQuery.beginQuery, GL_TIMESTAMP));
+	m_openProfileScopes.push_back((uint32)profileFrame.queries.size());
+	profileFrame.queries.push_back(profileQuery);
+}
+
+void OpenGLContext::endProfileScope()
+{
+	if(m_openProfileScopes.empty())
+	{
+		return;
+	}
+
+	const ProfileFrame& profileFrame = m_profileFrames[m_profileFrameIndex];
+	GL_CALL(glQueryCounter(profileFrame.queries[m_openProfileScopes.back()].endQuery, GL_TIMESTAMP));
+	m_openProfileScopes.pop_back();
+}
+
+void OpenGLContext::resolveProfileScopes()
+{
+	if(!m_timerQueriesSupported)
+	{
+		return;
+	}
+
+	// Close scopes that were left open
+	while(!m_openProfileScopes.empty())
+	{
+		endProfileScope();
+	}
+
+	// Move on to the oldest frame in the ring and read back its results
+	m_profileFrameIndex = (m_profileFrameIndex + 1) % ProfileFrameCount;
+	ProfileFrame& profileFrame = m_profileFrames[m_profileFrameIndex];
+	if(!profileFrame.queries.empty())
+	{
+		// If the last query of the frame is available, all of them are. Results
+		// that are still not ready are dropped rather than stalling the pipeline.
+		GLint available = 0;
+		GL_CALL(glGetQueryObjectiv(profileFrame.queries.back().endQuery, GL_QUERY_RESULT_AVAILABLE, &available));
+		if(available)
+		{
+			vector<ProfilerEvent> profilerEvents;
+			profilerEvents.reserve(profileFrame.queries.size());
+			for(const ProfileQuery& profileQuery : profileFrame.queries)
+			{
+				GLuint64 beginTimestamp = 0, endTimestamp = 0;
+				GL_CALL(glGetQueryObjectui64v(profileQuery.beginQuery, GL_QUERY_RESULT, &beginTimestamp));
+				GL_CALL(glGetQueryObjectui64v(profileQuery.endQuery, GL_QUERY_RESULT, &endTimestamp));
+
+				ProfilerEvent profilerEvent;
+				profilerEvent.name = profileQuery.name;
+				profilerEvent.startTicks = beginTimestamp + profileFrame.gpuToCpuTicks;
+				profilerEvent.endTicks = endTimestamp + profileFrame.gpuToCpuTicks;
+				profilerEvent.depth = profileQuery.depth;
+				profilerEvents.push_back(profilerEvent);
+			}
+			Profiler::SubmitGPUEvents(profilerEvents);
+		}
+	}
+
+	beginProfileFrame();
+}
+
+void OpenGLContext::swapBuffersImpl()
+{
+	SDL_GL_SwapWindow(m_window->getSDLHandle());
+}
+
+void OpenGLContext::setSwapInterval(const int interval)
+{
+	SDL_GL_MakeCurrent(m_window->getSDLHandle(), m_context);
+	SDL_GL_SetSwapInterval(interval);
+}
+
+void OpenGLContext::makeCurrent()
+{
+	SDL_GL_MakeCurrent(m_window->getSDLHandle(), m_context);
+}
+
+void OpenGLContext::doneCurrent()
+{
+	SDL_GL_MakeCurrent(m_window->getSDLHandle(), nullptr);
+}
+
+void OpenGLContext::beginProfileFrame()
+{
+	if(!m_timerQueriesSupported)
+	{
+		return;
+	}
+
+	ProfileFrame& profileFrame = m_profileFrames[m_profileFrameIndex];
+	profileFrame.queries.clear();
+	profileFrame.usedQueryCount = 0;
+
+	// GL timestamps are in nanoseconds, like Clock ticks, but from a different origin
+	GLint64 gpuTimestamp = 0;
+	GL_CALL(glGetInteger64v(GL_TIMESTAMP, &gpuTimestamp));
+	profileFrame.gpuToCpuTicks = (int64)Clock::GetTicks() - gpuTimestamp;
+}
+
 string OpenGLContext::getGLSLVersion() const
 {
 	switch(m_majorVersion)
@@ -1040,7 +1217,7 @@ void OpenGLContext::texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTex
 	outTextureDeviceObject = nullptr;
 }
 
-void OpenGLContext::texture2D_copyToGPU(Texture2DDeviceObject* textureDeviceObjectBase, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData)
+void OpenGLContext::texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObjectBase, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData)
 {
 	OpenGLTexture2DDeviceObject* textureDeviceObject = dynamic_cast<OpenGLTexture2DDeviceObject*>(textureDeviceObjectBase);
 	assert(textureDeviceObject);
@@ -1070,7 +1247,7 @@ void OpenGLContext::texture2D_copyToGPU(Texture2DDeviceObject* textureDeviceObje
 	textureDeviceObject->pixelFormat = pixelFormat;
 }
 
-void OpenGLContext::texture2D_copyToCPUReadable(Texture2DDeviceObject* textureDeviceObjectBase, uint8** outTextureData)
+void OpenGLContext::texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObjectBase, uint8** outTextureData)
 {
 	OpenGLTexture2DDeviceObject* textureDeviceObject = dynamic_cast<OpenGLTexture2DDeviceObject*>(textureDeviceObjectBase);
 	assert(textureDeviceObject);
@@ -1092,7 +1269,7 @@ void OpenGLContext::texture2D_copyToCPUReadable(Texture2DDeviceObject* textureDe
 	GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
 }
 
-void OpenGLContext::texture2D_updateSubregion(Texture2DDeviceObject* textureDeviceObjectBase, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData)
+void OpenGLContext::texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObjectBase, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData)
 {
 	OpenGLTexture2DDeviceObject* textureDeviceObject = dynamic_cast<OpenGLTexture2DDeviceObject*>(textureDeviceObjectBase);
 	assert(textureDeviceObject);
@@ -1116,7 +1293,7 @@ void OpenGLContext::texture2D_updateSubregion(Texture2DDeviceObject* textureDevi
 	GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
 }
 
-void OpenGLContext::texture2D_updateFiltering(Texture2DDeviceObject* textureDeviceObjectBase, const TextureFiltering filtering)
+void OpenGLContext::texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObjectBase, const TextureFiltering filtering)
 {
 	OpenGLTexture2DDeviceObject* textureDeviceObject = dynamic_cast<OpenGLTexture2DDeviceObject*>(textureDeviceObjectBase);
 	assert(textureDeviceObject);
@@ -1131,7 +1308,7 @@ void OpenGLContext::texture2D_updateFiltering(Texture2DDeviceObject* textureDevi
 	textureDeviceObject->filtering = filtering;
 }
 
-void OpenGLContext::texture2D_updateWrapping(Texture2DDeviceObject* textureDeviceObjectBase, const TextureWrapping wrapping)
+void OpenGLContext::texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObjectBase, const TextureWrapping wrapping)
 {
 	OpenGLTexture2DDeviceObject* textureDeviceObject = dynamic_cast<OpenGLTexture2DDeviceObject*>(textureDeviceObjectBase);
 	assert(textureDeviceObject);
@@ -1146,7 +1323,7 @@ void OpenGLContext::texture2D_updateWrapping(Texture2DDeviceObject* textureDevic
 	textureDeviceObject->wrapping = wrapping;
 }
 
-void OpenGLContext::texture2D_clearTexture(Texture2DDeviceObject* textureDeviceObjectBase)
+void OpenGLContext::texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObjectBase)
 {
 	OpenGLTexture2DDeviceObject* textureDeviceObject = dynamic_cast<OpenGLTexture2DDeviceObject*>(textureDeviceObjectBase);
 	assert(textureDeviceObject);
@@ -1746,7 +1923,7 @@ void OpenGLContext::shader_compileShader(ShaderDeviceObject* shaderDeviceObjectB
 	}
 }
 
-void OpenGLContext::shader_setUniform(ShaderDeviceObject* shaderDeviceObjectBase, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data)
+void OpenGLContext::shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObjectBase, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data)
 {
 	OpenGLShaderDeviceObject* shaderDeviceObject = dynamic_cast<OpenGLShaderDeviceObject*>(shaderDeviceObjectBase);
 	assert(shaderDeviceObject);
@@ -1855,7 +2032,7 @@ void OpenGLContext::shader_setUniform(ShaderDeviceObject* shaderDeviceObjectBase
 	}
 }
 
-void OpenGLContext::shader_setSampler2D(ShaderDeviceObject* shaderDeviceObjectBase, const string& uniformName, Texture2DRef texture)
+void OpenGLContext::shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObjectBase, const string& uniformName, Texture2DRef texture)
 {
 	OpenGLShaderDeviceObject* shaderDeviceObject = dynamic_cast<OpenGLShaderDeviceObject*>(shaderDeviceObjectBase);
 	assert(shaderDeviceObject);
@@ -1883,6 +2060,15 @@ void OpenGLContext::shader_setSampler2D(ShaderDeviceObject* shaderDeviceObjectBa
 	}
 }
 
+uint32 OpenGLContext::shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObjectBase, const string& uniformName)
+{
+	OpenGLShaderDeviceObject* shaderDeviceObject = dynamic_cast<OpenGLShaderDeviceObject*>(shaderDeviceObjectBase);
+	assert(shaderDeviceObject);
+
+	unordered_map<string, ShaderUniform*>::iterator itr = shaderDeviceObject->uniforms.find(uniformName);
+	return itr != shaderDeviceObject->uniforms.end() ? itr->second->dataSize : 0;
+}
+
 /**************************************************
  * RenderTarget2D API implementation              *
  **************************************************/
@@ -2037,7 +2223,7 @@ void OpenGLContext::vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* ve
 	const VertexFormat vertexFormat = vertices.getVertexFormat();
 	assert(vertexBufferDeviceObject->vertexFormat == vertexFormat);
 	GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vertexBufferDeviceObject->id));
-	GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, startIndex * vertexFormat.getVertexSizeInBytes(), vertices.getVertexDataSize(), vertices.getVertexData()));
+	GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, startIndex * vertexFormat.getVertexSizeInBytes(), min(vertexCount, vertices.getVertexCount()) * vertexFormat.getVertexSizeInBytes(), vertices.getVertexData()));
 	GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
 
@@ -2091,7 +2277,6 @@ void OpenGLContext::indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* i
 	assert(indexBufferDeviceObject);
 
 	assert(indexCount > 0);
-	assert(indices == nullptr);
 
 	// Upload index data to index buffer object
 	GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferDeviceObject->id));
@@ -114,8 +114,13 @@ Pixmap::~Pixmap()
 	delete[] m_data;
 }
 
-Pixmap &Pixmap::operator=(Pixmap &other)
+Pixmap &Pixmap::operator=(const Pixmap &other)
 {
+	if (this == &other)
+	{
+		return *this;
+	}
+
 	m_width = other.m_width;
 	m_height = other.m_height;
 	m_format = other.m_format;
@@ -139,6 +144,26 @@ Pixmap &Pixmap::operator=(Pixmap &other)
 	return *this;
 }
 
+Pixmap &Pixmap::operator=(Pixmap &&other) noexcept
+{
+	if (this != &other)
+	{
+		// Take ownership of other's data
+		delete[] m_data;
+		m_width = other.m_width;
+		m_height = other.m_height;
+		m_format = other.m_format;
+		m_data = other.m_data;
+
+		// Invalidate other
+		other.m_data = nullptr;
+		other.m_width = 0;
+		other.m_height = 0;
+		other.m_format = PixelFormat();
+	}
+	return *this;
+}
+
 const uchar *Pixmap::getData() const
 {
 	return m_data;
@@ -187,6 +212,23 @@ void Pixmap::setPixel(const uint x, const uint y, const void *data)
 	}
 }
 
+void Pixmap::setPixels(const uint x, const uint y, const Pixmap &pixmap)
+{
+	if (pixmap.m_format.getPixelSizeInBytes() != m_format.getPixelSizeInBytes() ||
+		x + pixmap.m_width > m_width || y + pixmap.m_height > m_height)
+	{
+		LOG("Pixmap::setPixels(): Source pixmap does not fit in the destination");
+		return;
+	}
+
+	// Copy row by row
+	const uint pixelSize = m_format.getPixelSizeInBytes();
+	for (uint row = 0; row < pixmap.m_height; ++row)
+	{
+		memcpy(m_data + (x + (y + row) * m_width) * pixelSize, pixmap.m_data + row * pixmap.m_width * pixelSize, pixmap.m_width * pixelSize);
+	}
+}
+
 void Pixmap::flipY()
 {
 	uchar *pixel0 = new uchar[m_format.getPixelSizeInBytes()];
@@ -247,15 +289,25 @@ Pixmap Pixmap::loadFromFile(const string& imageFile)
 {
 	Pixmap newPixmap;
 
+	// If the image is stored in a mounted pack file, decode it straight from the mapped memory
+	FIMEMORY* imageMemory = nullptr;
+	util::FileSpan fileSpan;
+	if (util::findInPackFiles(imageFile, fileSpan))
+	{
+		imageMemory = FreeImage_OpenMemory((BYTE*)fileSpan.data, (DWORD)fileSpan.size);
+	}
+	const string imageFilePath = util::getAbsoluteFilePath(imageFile);
+
 	// Check the file signature and deduce its format
-	FREE_IMAGE_FORMAT fif = FreeImage_GetFileType(imageFile.c_str(), 0);
+	FREE_IMAGE_FORMAT fif = imageMemory ? FreeImage_GetFileTypeFromMemory(imageMemory, 0) : FreeImage_GetFileType(imageFilePath.c_str(), 0);
 	if (fif == FIF_UNKNOWN)
 	{
 		// Guess the file format from the file extension
-		fif = FreeImage_GetFIFFromFilename(imageFile.c_str());
+		fif = FreeImage_GetFIFFromFilename(imageFilePath.c_str());
 		if (fif == FIF_UNKNOWN)
 		{
 			LOG("Unable to determine format of image file \"%s\"", imageFile.c_str());
+			if (imageMemory) FreeImage_CloseMemory(imageMemory);
 			return newPixmap;
 		}
 	}
@@ -264,11 +316,16 @@ Pixmap Pixmap::loadFromFile(const string& imageFile)
 	if (!FreeImage_FIFSupportsReading(fif))
 	{
 		LOG("Format of image file \"%s\" was recognized as \"%s\" but is unsupported", imageFile.c_str(), FreeImage_GetFormatFromFIF(fif));
+		if (imageMemory) FreeImage_CloseMemory(imageMemory);
 		return newPixmap;
 	}
 
 	// Let's load the file
-	FIBITMAP* bitmap = FreeImage_Load(fif, imageFile.c_str(), 0);
+	FIBITMAP* bitmap = imageMemory ? FreeImage_LoadFromMemory(fif, imageMemory, 0) : FreeImage_Load(fif, imageFilePath.c_str(), 0);
+	if (imageMemory)
+	{
+		FreeImage_CloseMemory(imageMemory);
+	}
 	if (!bitmap)
 	{
 		LOG("Error occured when loading image file \"%s\"; bitmap was nullptr", imageFile.c_str());
@@ -312,30 +369,68 @@ ByteStreamOut& operator<<(ByteStreamOut& out, const Pixmap& pixmap)
 	out << (uint32)pixmap.m_format.getComponents();
 	out << (uint32)pixmap.m_format.getDataType();
 
-	vector<uint8> dataArray;
-	const int32 dataSize = pixmap.m_width * pixmap.m_height * pixmap.m_format.getPixelSizeInBytes();
-	dataArray.resize(dataSize);
-	memcpy(dataArray.data(), pixmap.m_data, dataSize);
-
-	out << dataArray;
+	// Pixels are written in one bulk call straight from the pixmap's storage
+	const uint64 dataSize = pixmap.m_data ? (uint64)pixmap.m_width * pixmap.m_height * pixmap.m_format.getPixelSizeInBytes() : 0;
+	out << dataSize;
+	out.write((const void*)pixmap.m_data, dataSize);
 	return out;
 }
 
-ByteStreamIn& operator>>(ByteStreamIn& in, Pixmap& pixmap)
+bool Pixmap::readView(ByteStreamIn& in, uint& outWidth, uint& outHeight, PixelFormat& outFormat, util::FileSpan& outPixels)
 {
-	in >> pixmap.m_width;
-	in >> pixmap.m_height;
-
-	uint32 components, datatype;
+	uint32 width, height, components, datatype;
+	in >> width;
+	in >> height;
 	in >> components;
 	in >> datatype;
-	pixmap.m_format = PixelFormat((PixelComponents)components, (PixelDatatype)datatype);
 
-	vector<uint8> dataArray;
-	in >> dataArray;
+	uint64 dataSize;
+	in >> dataSize;
+	if (!in)
+	{
+		return false;
+	}
+
+	const PixelFormat format((PixelComponents)components, (PixelDatatype)datatype);
+	if (dataSize != 0 && dataSize != (uint64)width * height * format.getPixelSizeInBytes())
+	{
+		LOG("Serialized pixmap has an unexpected data size");
+		in.close();
+		return false;
+	}
+
+	outPixels = in.readSpan(dataSize);
+	if (!in)
+	{
+		return false;
+	}
+
+	outWidth = width;
+	outHeight = height;
+	outFormat = format;
+	return true;
+}
+
+ByteStreamIn& operator>>(ByteStreamIn& in, Pixmap& pixmap)
+{
+	uint width, height;
+	PixelFormat format;
+	util::FileSpan pixels;
+	if (!Pixmap::readView(in, width, height, format, pixels))
+	{
+		return in;
+	}
+
+	// Copy the pixels from the mapped stream directly into the pixmap's storage
 	delete[] pixmap.m_data;
-	pixmap.m_data = new uint8[dataArray.size()];
-	memcpy(pixmap.m_data, dataArray.data(), dataArray.size());
+	pixmap.m_data = pixels.size > 0 ? new uint8[pixels.size] : nullptr;
+	if (pixmap.m_data)
+	{
+		memcpy(pixmap.m_data, pixels.data, pixels.size);
+	}
+	pixmap.m_width = width;
+	pixmap.m_height = height;
+	pixmap.m_format = format;
 
 	return in;
 }
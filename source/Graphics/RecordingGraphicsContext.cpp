@@ -0,0 +1,528 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+#include <Sauce/Graphics.h>
+#include <Sauce/Graphics/RecordingGraphicsContext.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+//--------------------------------------------------------------------
+// RecordingGraphicsContext
+//--------------------------------------------------------------------
+RecordingGraphicsContext::RecordingGraphicsContext(GraphicsContext* backend, const string& captureFilePath)
+	: GraphicsContext(backend)
+	, m_backend(backend)
+	, m_commandBuffer(true)
+	, m_frameCount(0)
+{
+	// The window now talks to us and releases us when it is destroyed
+	if(m_window)
+	{
+		m_window->m_graphicsContext = this;
+	}
+
+	m_fileStream.open(captureFilePath, ofstream::binary);
+	if(!m_fileStream)
+	{
+		LOG("Could not open graphics capture file \"%s\" for writing", captureFilePath.c_str());
+		return;
+	}
+
+	GraphicsCaptureHeader header;
+	header.magic = Magic;
+	header.version = Version;
+	m_fileStream.write((const char*)&header, sizeof(GraphicsCaptureHeader));
+	LOG("Recording graphics commands to \"%s\"", captureFilePath.c_str());
+}
+
+RecordingGraphicsContext::~RecordingGraphicsContext()
+{
+	// Keep whatever was recorded after the last swap
+	if(!m_commandBuffer.isEmpty())
+	{
+		writeFrame();
+	}
+	m_fileStream.close();
+
+	delete m_backend;
+}
+
+void RecordingGraphicsContext::writeFrame()
+{
+	if(m_fileStream.is_open())
+	{
+		GraphicsCaptureFrame frame;
+		frame.commandCount = m_commandBuffer.getCommandCount();
+		frame.reserved = 0;
+		frame.size = m_commandBuffer.getSize();
+		m_fileStream.write((const char*)&frame, sizeof(GraphicsCaptureFrame));
+		m_fileStream.write((const char*)m_commandBuffer.getData(), frame.size);
+		m_frameCount++;
+	}
+	m_commandBuffer.reset();
+}
+
+Window* RecordingGraphicsContext::createWindow(const string& title, const int x, const int y, const int w, const int h, const Uint32 flags)
+{
+	THROW("RecordingGraphicsContext: Windows must be created by the backend context");
+	return nullptr;
+}
+
+//--------------------------------------------------------------------
+// Rendering
+//--------------------------------------------------------------------
+void RecordingGraphicsContext::enableImpl(const Capability cap)
+{
+	m_commandBuffer.enable(cap);
+	m_backend->enable(cap);
+}
+
+void RecordingGraphicsContext::disableImpl(const Capability cap)
+{
+	m_commandBuffer.disable(cap);
+	m_backend->disable(cap);
+}
+
+bool RecordingGraphicsContext::isEnabled(const Capability cap)
+{
+	return m_backend->isEnabled(cap);
+}
+
+void RecordingGraphicsContext::enableScissorImpl(const int x, const int y, const int w, const int h)
+{
+	m_commandBuffer.enableScissor(x, y, w, h);
+	m_backend->enableScissor(x, y, w, h);
+}
+
+void RecordingGraphicsContext::disableScissorImpl()
+{
+	m_commandBuffer.disableScissor();
+	m_backend->disableScissor();
+}
+
+void RecordingGraphicsContext::setPointSizeImpl(const float pointSize)
+{
+	m_commandBuffer.setPointSize(pointSize);
+	m_backend->setPointSize(pointSize);
+}
+
+void RecordingGraphicsContext::setLineWidthImpl(const float lineWidth)
+{
+	m_commandBuffer.setLineWidth(lineWidth);
+	m_backend->setLineWidth(lineWidth);
+}
+
+void RecordingGraphicsContext::setViewportSizeImpl(const uint w, const uint h)
+{
+	m_commandBuffer.setViewportSize(w, h);
+	m_backend->setViewportSize(w, h);
+}
+
+void RecordingGraphicsContext::clearImpl(const uint32 clearMask, const Color& clearColor, const double clearDepth, const int32 clearStencil)
+{
+	m_commandBuffer.clear(clearMask, clearColor, clearDepth, clearStencil);
+	m_backend->clear(clearMask, clearColor, clearDepth, clearStencil);
+}
+
+void RecordingGraphicsContext::saveScreenshotImpl(string filePath)
+{
+	m_commandBuffer.setState(*m_currentState);
+	m_commandBuffer.saveScreenshot(filePath);
+	*m_backend->m_currentState = *m_currentState;
+	m_backend->saveScreenshot(filePath);
+}
+
+Matrix4 RecordingGraphicsContext::createOrtographicMatrix(const float left, const float right, const float top, const float bottom, const float n, const float f) const
+{
+	return m_backend->createOrtographicMatrix(left, right, top, bottom, n, f);
+}
+
+Matrix4 RecordingGraphicsContext::createPerspectiveMatrix(const float fov, const float aspectRatio, const float zNear, const float zFar) const
+{
+	return m_backend->createPerspectiveMatrix(fov, aspectRatio, zNear, zFar);
+}
+
+Matrix4 RecordingGraphicsContext::createLookAtMatrix(const Vector3F& position, const Vector3F& fwd) const
+{
+	return m_backend->createLookAtMatrix(position, fwd);
+}
+
+void RecordingGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount)
+{
+	m_commandBuffer.setState(*m_currentState);
+	m_commandBuffer.drawIndexedPrimitives(type, vertices, vertexCount, indices, indexCount);
+	*m_backend->m_currentState = *m_currentState;
+	m_backend->drawIndexedPrimitives(type, vertices, vertexCount, indices, indexCount);
+}
+
+void RecordingGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer)
+{
+	m_commandBuffer.setState(*m_currentState);
+	m_commandBuffer.drawIndexedPrimitives(type, vertexBuffer, indexBuffer);
+	*m_backend->m_currentState = *m_currentState;
+	m_backend->drawIndexedPrimitives(type, vertexBuffer, indexBuffer);
+}
+
+void RecordingGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex)
+{
+	m_commandBuffer.setState(*m_currentState);
+	m_commandBuffer.drawIndexedPrimitives(type, vertexBuffer, indexBuffer, firstIndex, indexCount, baseVertex);
+	*m_backend->m_currentState = *m_currentState;
+	m_backend->drawIndexedPrimitives(type, vertexBuffer, indexBuffer, firstIndex, indexCount, baseVertex);
+}
+
+void RecordingGraphicsContext::drawPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount)
+{
+	m_commandBuffer.setState(*m_currentState);
+	m_commandBuffer.drawPrimitives(type, vertices, vertexCount);
+	*m_backend->m_currentState = *m_currentState;
+	m_backend->drawPrimitives(type, vertices, vertexCount);
+}
+
+void RecordingGraphicsContext::drawPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer)
+{
+	m_commandBuffer.setState(*m_currentState);
+	m_commandBuffer.drawPrimitives(type, vertexBuffer);
+	*m_backend->m_currentState = *m_currentState;
+	m_backend->drawPrimitives(type, vertexBuffer);
+}
+
+void RecordingGraphicsContext::beginProfileScope(const char* name)
+{
+	m_commandBuffer.beginProfileScope(name);
+	m_backend->beginProfileScope(name);
+}
+
+void RecordingGraphicsContext::endProfileScope()
+{
+	m_commandBuffer.endProfileScope();
+	m_backend->endProfileScope();
+}
+
+void RecordingGraphicsContext::resolveProfileScopes()
+{
+	m_backend->resolveProfileScopes();
+}
+
+void RecordingGraphicsContext::swapBuffersImpl()
+{
+	m_commandBuffer.swapBuffers();
+	writeFrame();
+	m_backend->swapBuffers();
+}
+
+void RecordingGraphicsContext::setSwapInterval(const int interval)
+{
+	m_commandBuffer.setSwapInterval(interval);
+	m_backend->setSwapInterval(interval);
+}
+
+void RecordingGraphicsContext::makeCurrent()
+{
+	m_backend->makeCurrent();
+}
+
+void RecordingGraphicsContext::doneCurrent()
+{
+	m_backend->doneCurrent();
+}
+
+//--------------------------------------------------------------------
+// Texture2D
+//--------------------------------------------------------------------
+void RecordingGraphicsContext::texture2D_createDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject, const string& deviceObjectName)
+{
+	m_backend->texture2D_createDeviceObject(outTextureDeviceObject, deviceObjectName);
+	m_commandBuffer.texture2D_createDeviceObject(outTextureDeviceObject, deviceObjectName);
+}
+
+void RecordingGraphicsContext::texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject)
+{
+	m_commandBuffer.texture2D_destroyDeviceObject(outTextureDeviceObject);
+	m_backend->texture2D_destroyDeviceObject(outTextureDeviceObject);
+}
+
+void RecordingGraphicsContext::texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData)
+{
+	m_commandBuffer.texture2D_copyToGPU(textureDeviceObject, pixelFormat, width, height, textureData);
+	m_backend->texture2D_copyToGPU(textureDeviceObject, pixelFormat, width, height, textureData);
+}
+
+void RecordingGraphicsContext::texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData)
+{
+	// Readbacks do not change anything on the GPU and are not recorded
+	m_backend->texture2D_copyToCPUReadable(textureDeviceObject, outTextureData);
+}
+
+void RecordingGraphicsContext::texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData)
+{
+	m_commandBuffer.texture2D_updateSubregion(textureDeviceObject, x, y, subRegionWidth, subRegionHeight, textureDeviceObject->pixelFormat.getPixelSizeInBytes(), textureData);
+	m_backend->texture2D_updateSubregion(textureDeviceObject, x, y, subRegionWidth, subRegionHeight, textureData);
+}
+
+void RecordingGraphicsContext::texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering)
+{
+	m_commandBuffer.texture2D_updateFiltering(textureDeviceObject, filtering);
+	m_backend->texture2D_updateFiltering(textureDeviceObject, filtering);
+}
+
+void RecordingGraphicsContext::texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping)
+{
+	m_commandBuffer.texture2D_updateWrapping(textureDeviceObject, wrapping);
+	m_backend->texture2D_updateWrapping(textureDeviceObject, wrapping);
+}
+
+void RecordingGraphicsContext::texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObject)
+{
+	m_commandBuffer.texture2D_clearTexture(textureDeviceObject);
+	m_backend->texture2D_clearTexture(textureDeviceObject);
+}
+
+//--------------------------------------------------------------------
+// Shader
+//--------------------------------------------------------------------
+void RecordingGraphicsContext::shader_createDeviceObject(ShaderDeviceObject*& outShaderDeviceObject, const string& deviceObjectName)
+{
+	m_backend->shader_createDeviceObject(outShaderDeviceObject, deviceObjectName);
+	m_commandBuffer.shader_createDeviceObject(outShaderDeviceObject, deviceObjectName);
+}
+
+void RecordingGraphicsContext::shader_destroyDeviceObject(ShaderDeviceObject*& outShaderDeviceObject)
+{
+	m_commandBuffer.shader_destroyDeviceObject(outShaderDeviceObject);
+	m_backend->shader_destroyDeviceObject(outShaderDeviceObject);
+}
+
+void RecordingGraphicsContext::shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource)
+{
+	m_commandBuffer.shader_compileShader(shaderDeviceObject, vsSource, psSource, gsSource);
+	m_backend->shader_compileShader(shaderDeviceObject, vsSource, psSource, gsSource);
+}
+
+void RecordingGraphicsContext::shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data)
+{
+	uint32 dataSize;
+	switch(datatype)
+	{
+		case Datatype::Struct: dataSize = m_backend->shader_getUniformDataSize(shaderDeviceObject, uniformName); break;
+		case Datatype::Matrix4: dataSize = util::GetDatatypeSize(datatype) * numElements; break;
+		default: dataSize = util::GetDatatypeSize(datatype) * numComponentsPerElement * numElements; break;
+	}
+	m_commandBuffer.shader_setUniform(shaderDeviceObject, uniformName, datatype, numComponentsPerElement, numElements, data, dataSize);
+	m_backend->shader_setUniform(shaderDeviceObject, uniformName, datatype, numComponentsPerElement, numElements, data);
+}
+
+void RecordingGraphicsContext::shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture)
+{
+	m_commandBuffer.shader_setSampler2D(shaderDeviceObject, uniformName, texture);
+	m_backend->shader_setSampler2D(shaderDeviceObject, uniformName, texture);
+}
+
+uint32 RecordingGraphicsContext::shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObject, const string& uniformName)
+{
+	return m_backend->shader_getUniformDataSize(shaderDeviceObject, uniformName);
+}
+
+//--------------------------------------------------------------------
+// RenderTarget2D
+//--------------------------------------------------------------------
+void RecordingGraphicsContext::renderTarget2D_createDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject, const string& deviceObjectName)
+{
+	m_backend->renderTarget2D_createDeviceObject(outRenderTargetDeviceObject, deviceObjectName);
+	m_commandBuffer.renderTarget2D_createDeviceObject(outRenderTargetDeviceObject, deviceObjectName);
+}
+
+void RecordingGraphicsContext::renderTarget2D_destroyDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject)
+{
+	m_commandBuffer.renderTarget2D_destroyDeviceObject(outRenderTargetDeviceObject);
+	m_backend->renderTarget2D_destroyDeviceObject(outRenderTargetDeviceObject);
+}
+
+void RecordingGraphicsContext::renderTarget2D_initializeRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject, const Texture2DRef* targetTextures, const uint32 targetCount)
+{
+	m_commandBuffer.renderTarget2D_initializeRenderTarget(renderTargetDeviceObject, targetTextures, targetCount);
+	m_backend->renderTarget2D_initializeRenderTarget(renderTargetDeviceObject, targetTextures, targetCount);
+}
+
+void RecordingGraphicsContext::renderTarget2D_bindRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject)
+{
+	m_commandBuffer.renderTarget2D_bindRenderTarget(renderTargetDeviceObject);
+	m_backend->renderTarget2D_bindRenderTarget(renderTargetDeviceObject);
+}
+
+//--------------------------------------------------------------------
+// VertexBuffer
+//--------------------------------------------------------------------
+void RecordingGraphicsContext::vertexBuffer_createDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject, const string& deviceObjectName)
+{
+	m_backend->vertexBuffer_createDeviceObject(outVertexBufferDeviceObject, deviceObjectName);
+	m_commandBuffer.vertexBuffer_createDeviceObject(outVertexBufferDeviceObject, deviceObjectName);
+}
+
+void RecordingGraphicsContext::vertexBuffer_destroyDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject)
+{
+	m_commandBuffer.vertexBuffer_destroyDeviceObject(outVertexBufferDeviceObject);
+	m_backend->vertexBuffer_destroyDeviceObject(outVertexBufferDeviceObject);
+}
+
+void RecordingGraphicsContext::vertexBuffer_initializeVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const BufferUsage bufferUsage, const VertexArray& vertices, const uint32 vertexCount)
+{
+	m_commandBuffer.vertexBuffer_initializeVertexBuffer(vertexBufferDeviceObject, bufferUsage, vertices, vertexCount);
+	m_backend->vertexBuffer_initializeVertexBuffer(vertexBufferDeviceObject, bufferUsage, vertices, vertexCount);
+}
+
+void RecordingGraphicsContext::vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const uint32 startIndex, const VertexArray& vertices, const uint32 vertexCount)
+{
+	m_commandBuffer.vertexBuffer_modifyVertexBuffer(vertexBufferDeviceObject, startIndex, vertices, vertexCount);
+	m_backend->vertexBuffer_modifyVertexBuffer(vertexBufferDeviceObject, startIndex, vertices, vertexCount);
+}
+
+void RecordingGraphicsContext::vertexBuffer_bindVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject)
+{
+	// Binding is part of the draw calls that are recorded
+	m_backend->vertexBuffer_bindVertexBuffer(vertexBufferDeviceObject);
+}
+
+//--------------------------------------------------------------------
+// IndexBuffer
+//--------------------------------------------------------------------
+void RecordingGraphicsContext::indexBuffer_createDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject, const string& deviceObjectName)
+{
+	m_backend->indexBuffer_createDeviceObject(outIndexBufferDeviceObject, deviceObjectName);
+	m_commandBuffer.indexBuffer_createDeviceObject(outIndexBufferDeviceObject, deviceObjectName);
+}
+
+void RecordingGraphicsContext::indexBuffer_destroyDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject)
+{
+	m_commandBuffer.indexBuffer_destroyDeviceObject(outIndexBufferDeviceObject);
+	m_backend->indexBuffer_destroyDeviceObject(outIndexBufferDeviceObject);
+}
+
+void RecordingGraphicsContext::indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const BufferUsage bufferUsage, const uint32* indices, const uint32 indexCount)
+{
+	m_commandBuffer.indexBuffer_initializeIndexBuffer(indexBufferDeviceObject, bufferUsage, indices, indexCount);
+	m_backend->indexBuffer_initializeIndexBuffer(indexBufferDeviceObject, bufferUsage, indices, indexCount);
+}
+
+void RecordingGraphicsContext::indexBuffer_modifyIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const uint32 startIndex, const uint32* indices, const uint32 indexCount)
+{
+	m_commandBuffer.indexBuffer_modifyIndexBuffer(indexBufferDeviceObject, startIndex, indices, indexCount);
+	m_backend->indexBuffer_modifyIndexBuffer(indexBufferDeviceObject, startIndex, indices, indexCount);
+}
+
+void RecordingGraphicsContext::indexBuffer_bindIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject)
+{
+	m_backend->indexBuffer_bindIndexBuffer(indexBufferDeviceObject);
+}
+
+//--------------------------------------------------------------------
+// GraphicsCaptureReplayer
+//--------------------------------------------------------------------
+GraphicsCaptureReplayer::GraphicsCaptureReplayer()
+	: m_readOffset(0)
+	, m_frameIndex(0)
+{
+}
+
+GraphicsCaptureReplayer::~GraphicsCaptureReplayer()
+{
+	close();
+}
+
+bool GraphicsCaptureReplayer::open(const string& filePath)
+{
+	close();
+
+	if(!m_mappedFile.open(filePath))
+	{
+		LOG("Could not map graphics capture \"%s\" into memory", filePath.c_str());
+		return false;
+	}
+
+	const GraphicsCaptureHeader* header = (const GraphicsCaptureHeader*)m_mappedFile.getData();
+	if(m_mappedFile.getSize() < sizeof(GraphicsCaptureHeader) ||
+		header->magic != RecordingGraphicsContext::Magic ||
+		header->version != RecordingGraphicsContext::Version)
+	{
+		LOG("Graphics capture \"%s\" is invalid or has an unsupported version", filePath.c_str());
+		close();
+		return false;
+	}
+
+	// Objects and vertex formats are defined by earlier frames, so every
+	// capture starts with a fresh command buffer
+	m_commandBuffer.reset(new GraphicsCommandBuffer(true));
+	m_readOffset = sizeof(GraphicsCaptureHeader);
+	m_frameIndex = 0;
+	return true;
+}
+
+void GraphicsCaptureReplayer::close()
+{
+	// Releases the objects created by the replay
+	m_commandBuffer.reset();
+	m_mappedFile.close();
+	m_readOffset = 0;
+	m_frameIndex = 0;
+}
+
+bool GraphicsCaptureReplayer::replayFrame(GraphicsContext* context, GraphicsCommandStatistics* outStatistics)
+{
+	if(!isOpen() || isAtEnd())
+	{
+		return false;
+	}
+
+	const uint64 fileSize = m_mappedFile.getSize();
+	if(m_readOffset + sizeof(GraphicsCaptureFrame) > fileSize)
+	{
+		LOG("Graphics capture is truncated at frame %i", m_frameIndex);
+		return false;
+	}
+
+	GraphicsCaptureFrame frame;
+	memcpy(&frame, m_mappedFile.getData() + m_readOffset, sizeof(GraphicsCaptureFrame));
+	m_readOffset += sizeof(GraphicsCaptureFrame);
+	if(m_readOffset + frame.size > fileSize)
+	{
+		LOG("Graphics capture is truncated at frame %i", m_frameIndex);
+		m_readOffset = fileSize;
+		return false;
+	}
+
+	m_commandBuffer->setData(m_mappedFile.getData() + m_readOffset, frame.size, frame.commandCount);
+	m_commandBuffer->execute(context, outStatistics);
+	m_readOffset += frame.size;
+	m_frameIndex++;
+	return true;
+}
+
+bool GraphicsCaptureReplayer::replay(GraphicsContext* context, vector<GraphicsCommandStatistics>* outFrameStatistics)
+{
+	while(!isAtEnd())
+	{
+		GraphicsCommandStatistics statistics;
+		if(!replayFrame(context, &statistics))
+		{
+			return false;
+		}
+
+		if(outFrameStatistics)
+		{
+			outFrameStatistics->push_back(statistics);
+		}
+	}
+	return true;
+}
+
+END_SAUCE_NAMESPACE
@@ -23,7 +23,10 @@ RenderTarget2D::RenderTarget2D()
 
 RenderTarget2D::~RenderTarget2D()
 {
-	m_graphicsContext->renderTarget2D_destroyDeviceObject(m_deviceObject);
+	if(m_deviceObject)
+	{
+		m_graphicsContext->renderTarget2D_destroyDeviceObject(m_deviceObject);
+	}
 }
 
 bool RenderTarget2D::initialize(RenderTarget2DDesc renderTargetDesc)
@@ -24,7 +24,10 @@ Shader::Shader()
 
 Shader::~Shader()
 {
-	m_graphicsContext->shader_destroyDeviceObject(m_deviceObject);
+	if(m_deviceObject)
+	{
+		m_graphicsContext->shader_destroyDeviceObject(m_deviceObject);
+	}
 }
 
 bool Shader::initialize(ShaderDesc shaderDesc)
@@ -33,11 +36,10 @@ bool Shader::initialize(ShaderDesc shaderDesc)
 	stringstream vsSource;
 	bool hasVertexShader = true;
 	{
-		if (!shaderDesc.shaderFileVS.empty() && util::fileExists(shaderDesc.shaderFileVS))
+		string fileContent;
+		if (!shaderDesc.shaderFileVS.empty() && util::readFile(shaderDesc.shaderFileVS, fileContent))
 		{
-			ifstream fileReader(util::getAbsoluteFilePath(shaderDesc.shaderFileVS));
-			vsSource << fileReader.rdbuf();
-			fileReader.close();
+			vsSource << fileContent;
 		}
 		else if (!shaderDesc.shaderSourceVS.empty())
 		{
@@ -53,11 +55,10 @@ bool Shader::initialize(ShaderDesc shaderDesc)
 	stringstream psSource;
 	bool hasPixelShader = true;
 	{
-		if (!shaderDesc.shaderFilePS.empty() && util::fileExists(shaderDesc.shaderFilePS))
+		string fileContent;
+		if (!shaderDesc.shaderFilePS.empty() && util::readFile(shaderDesc.shaderFilePS, fileContent))
 		{
-			ifstream fileReader(util::getAbsoluteFilePath(shaderDesc.shaderFilePS));
-			psSource << fileReader.rdbuf();
-			fileReader.close();
+			psSource << fileContent;
 		}
 		else if (!shaderDesc.shaderSourcePS.empty())
 		{
@@ -73,11 +74,10 @@ bool Shader::initialize(ShaderDesc shaderDesc)
 	stringstream gsSource;
 	bool hasGeometryShader = true;
 	{
-		if (!shaderDesc.shaderFileGS.empty() && util::fileExists(shaderDesc.shaderFileGS))
+		string fileContent;
+		if (!shaderDesc.shaderFileGS.empty() && util::readFile(shaderDesc.shaderFileGS, fileContent))
 		{
-			ifstream fileReader(util::getAbsoluteFilePath(shaderDesc.shaderFileGS));
-			gsSource << fileReader.rdbuf();
-			fileReader.close();
+			gsSource << fileContent;
 		}
 		else if (!shaderDesc.shaderSourceGS.empty())
 		{
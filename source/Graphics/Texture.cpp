@@ -18,6 +18,7 @@ BEGIN_SAUCE_NAMESPACE
 Texture2D::Texture2D()
 	: m_graphicsContext(nullptr)
 	, m_deviceObject(nullptr)
+	, m_retainPixmap(false)
 {
 }
 
@@ -45,6 +46,8 @@ bool Texture2D::initialize(Texture2DDesc textureDesc)
 		anonymousTexureCount++;
 	}
 
+	m_retainPixmap = textureDesc.retainPixmap;
+
 	// Create texture device object
 	m_graphicsContext->texture2D_createDeviceObject(m_deviceObject, textureDesc.debugName);
 
@@ -67,6 +70,12 @@ bool Texture2D::initialize(Texture2DDesc textureDesc)
 
 Pixmap Texture2D::getPixmap() const
 {
+	// Avoid the GPU readback if we kept a copy of the pixels
+	if (m_retainedPixmap.isValid())
+	{
+		return m_retainedPixmap;
+	}
+
 	// Get texture data
 	uchar* textureData;
 	m_graphicsContext->texture2D_copyToCPUReadable(m_deviceObject, &textureData);
@@ -77,17 +86,27 @@ Pixmap Texture2D::getPixmap() const
 	return pixmap;
 }
 
-void Texture2D::updatePixmap(const Pixmap& pixmap)
+void Texture2D::uploadPixels(const PixelFormat& format, const uint32 width, const uint32 height, const uint8* data)
 {
 	m_graphicsContext->texture2D_copyToGPU(
 		m_deviceObject,
-		pixmap.getFormat(),
-		pixmap.getWidth(),
-		pixmap.getHeight(),
-		(uint8*)pixmap.getData()
+		format,
+		width,
+		height,
+		(uint8*)data
 	);
 }
 
+void Texture2D::updatePixmap(const Pixmap& pixmap)
+{
+	uploadPixels(pixmap.getFormat(), pixmap.getWidth(), pixmap.getHeight(), pixmap.getData());
+
+	if (m_retainPixmap)
+	{
+		m_retainedPixmap = pixmap;
+	}
+}
+
 void Texture2D::updatePixmap(const uint32 x, const uint32 y, const Pixmap& pixmap)
 {
 	if (x + pixmap.getWidth() >= m_deviceObject->width || y + pixmap.getHeight() >= m_deviceObject->height)
@@ -104,11 +123,21 @@ void Texture2D::updatePixmap(const uint32 x, const uint32 y, const Pixmap& pixma
 		pixmap.getHeight(),
 		(uint8*)pixmap.getData()
 	);
+
+	if (m_retainedPixmap.isValid())
+	{
+		m_retainedPixmap.setPixels(x, y, pixmap);
+	}
 }
 
 void Texture2D::clear()
 {
 	m_graphicsContext->texture2D_clearTexture(m_deviceObject);
+
+	if (m_retainedPixmap.isValid())
+	{
+		m_retainedPixmap.clear();
+	}
 }
 
 //void Texture2D::enableMipmaps()
@@ -173,8 +202,15 @@ ByteStreamOut& operator<<(ByteStreamOut& out, const Texture2DRef& texture)
 	out << isNull;
 	if (!isNull)
 	{
-		Pixmap pixmap = texture->getPixmap();
-		out << pixmap;
+		// Serialize the retained pixels directly, otherwise read them back from the GPU
+		if (texture->m_retainedPixmap.isValid())
+		{
+			out << texture->m_retainedPixmap;
+		}
+		else
+		{
+			out << texture->getPixmap();
+		}
 		out << (uint32)texture->m_deviceObject->filtering;
 		out << (uint32)texture->m_deviceObject->wrapping;
 	}
@@ -191,13 +227,24 @@ ByteStreamIn& operator>>(ByteStreamIn& in, Texture2DRef& texture)
 	{
 		Texture2DDesc textureDesc;
 
-		Pixmap pixmap;
-		in >> pixmap;
-		textureDesc.pixmap = &pixmap;
+		// Upload the pixels straight from the stream's mapped memory
+		uint width, height;
+		PixelFormat format;
+		util::FileSpan pixels;
+		if (!Pixmap::readView(in, width, height, format, pixels))
+		{
+			return in;
+		}
 
 		in >> *(uint32*)&textureDesc.filtering;
 		in >> *(uint32*)&textureDesc.wrapping;
+		if (!in)
+		{
+			return in;
+		}
+
 		texture = CreateNew<Texture2D>(textureDesc);
+		texture->uploadPixels(format, width, height, pixels.data);
 	}
 	return in;
 }
@@ -0,0 +1,550 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+#include <Sauce/Graphics.h>
+#include <Sauce/Graphics/ThreadedGraphicsContext.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+// Set on the render thread so that calls made while replaying commands
+// (e.g. resources released by the replay) go straight to the backend
+static thread_local bool g_isRenderThread = false;
+
+ThreadedGraphicsContext::ThreadedGraphicsContext(GraphicsContext* backend)
+	: GraphicsContext(backend)
+	, m_backend(backend)
+	, m_enabledCapabilities(0)
+	, m_recordIndex(0)
+	, m_running(false)
+	, m_submittedBuffer(nullptr)
+	, m_submittedPresent(false)
+	, m_quit(false)
+{
+	// The window now talks to us and releases us when it is destroyed
+	if(m_window)
+	{
+		m_window->m_graphicsContext = this;
+	}
+
+	// Hand the backend over to the render thread
+	m_backend->doneCurrent();
+	m_running = true;
+	m_thread = thread(&ThreadedGraphicsContext::run, this);
+}
+
+ThreadedGraphicsContext::~ThreadedGraphicsContext()
+{
+	if(m_running)
+	{
+		synchronize();
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_condition.notify_all();
+		m_thread.join();
+		m_running = false;
+		m_backend->makeCurrent();
+	}
+
+	// Resources released here are destroyed on the backend directly
+	m_commandBuffers[0].reset();
+	m_commandBuffers[1].reset();
+
+	delete m_backend;
+}
+
+bool ThreadedGraphicsContext::isImmediate() const
+{
+	return g_isRenderThread || !m_running;
+}
+
+void ThreadedGraphicsContext::run()
+{
+	g_isRenderThread = true;
+	Profiler::SetThreadName("Render");
+	m_backend->makeCurrent();
+
+	while(true)
+	{
+		GraphicsCommandBuffer* commandBuffer;
+		bool present;
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_submittedBuffer || m_quit; });
+			if(!m_submittedBuffer)
+			{
+				break;
+			}
+			commandBuffer = m_submittedBuffer;
+			present = m_submittedPresent;
+		}
+
+		{
+			PROFILE_SCOPE("Execute");
+			commandBuffer->execute(m_backend);
+		}
+
+		if(present)
+		{
+			{
+				PROFILE_SCOPE("Swap");
+				m_backend->swapBuffers();
+			}
+			m_backend->resolveProfileScopes();
+		}
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_submittedBuffer = nullptr;
+		}
+		m_condition.notify_all();
+	}
+
+	m_backend->doneCurrent();
+}
+
+void ThreadedGraphicsContext::submit(const bool present)
+{
+	// Wait for the render thread to finish the previous buffer. This bounds
+	// the game thread to one frame ahead of the render thread.
+	{
+		unique_lock<mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return m_submittedBuffer == nullptr; });
+		m_submittedBuffer = &m_commandBuffers[m_recordIndex];
+		m_submittedPresent = present;
+	}
+	m_condition.notify_all();
+
+	// The other buffer has been executed and can be recorded into again
+	m_recordIndex ^= 1;
+	m_commandBuffers[m_recordIndex].reset();
+}
+
+void ThreadedGraphicsContext::synchronize()
+{
+	if(isImmediate())
+	{
+		return;
+	}
+
+	submit(false);
+
+	unique_lock<mutex> lock(m_mutex);
+	m_condition.wait(lock, [this]() { return m_submittedBuffer == nullptr; });
+}
+
+void ThreadedGraphicsContext::invokeAndWait(function<void(GraphicsContext*)> func)
+{
+	if(isImmediate())
+	{
+		func(m_backend);
+		return;
+	}
+
+	m_commandBuffers[m_recordIndex].invoke(move(func));
+	synchronize();
+}
+
+Window* ThreadedGraphicsContext::createWindow(const string& title, const int x, const int y, const int w, const int h, const Uint32 flags)
+{
+	THROW("ThreadedGraphicsContext: Windows must be created by the backend context");
+	return nullptr;
+}
+
+//--------------------------------------------------------------------
+// Rendering
+//--------------------------------------------------------------------
+void ThreadedGraphicsContext::enableImpl(const Capability cap)
+{
+	m_enabledCapabilities |= 1 << (uint32)cap;
+	if(isImmediate()) { m_backend->enable(cap); return; }
+	m_commandBuffers[m_recordIndex].enable(cap);
+}
+
+void ThreadedGraphicsContext::disableImpl(const Capability cap)
+{
+	m_enabledCapabilities &= ~(1 << (uint32)cap);
+	if(isImmediate()) { m_backend->disable(cap); return; }
+	m_commandBuffers[m_recordIndex].disable(cap);
+}
+
+bool ThreadedGraphicsContext::isEnabled(const Capability cap)
+{
+	return (m_enabledCapabilities & (1 << (uint32)cap)) != 0;
+}
+
+void ThreadedGraphicsContext::enableScissorImpl(const int x, const int y, const int w, const int h)
+{
+	if(isImmediate()) { m_backend->enableScissor(x, y, w, h); return; }
+	m_commandBuffers[m_recordIndex].enableScissor(x, y, w, h);
+}
+
+void ThreadedGraphicsContext::disableScissorImpl()
+{
+	if(isImmediate()) { m_backend->disableScissor(); return; }
+	m_commandBuffers[m_recordIndex].disableScissor();
+}
+
+void ThreadedGraphicsContext::setPointSizeImpl(const float pointSize)
+{
+	if(isImmediate()) { m_backend->setPointSize(pointSize); return; }
+	m_commandBuffers[m_recordIndex].setPointSize(pointSize);
+}
+
+void ThreadedGraphicsContext::setLineWidthImpl(const float lineWidth)
+{
+	if(isImmediate()) { m_backend->setLineWidth(lineWidth); return; }
+	m_commandBuffers[m_recordIndex].setLineWidth(lineWidth);
+}
+
+void ThreadedGraphicsContext::setViewportSizeImpl(const uint w, const uint h)
+{
+	if(isImmediate()) { m_backend->setViewportSize(w, h); return; }
+	m_commandBuffers[m_recordIndex].setViewportSize(w, h);
+}
+
+void ThreadedGraphicsContext::clearImpl(const uint32 clearMask, const Color& clearColor, const double clearDepth, const int32 clearStencil)
+{
+	if(isImmediate()) { m_backend->clear(clearMask, clearColor, clearDepth, clearStencil); return; }
+	m_commandBuffers[m_recordIndex].clear(clearMask, clearColor, clearDepth, clearStencil);
+}
+
+void ThreadedGraphicsContext::saveScreenshotImpl(string filePath)
+{
+	if(isImmediate())
+	{
+		*m_backend->m_currentState = *m_currentState;
+		m_backend->saveScreenshot(filePath);
+		return;
+	}
+
+	m_commandBuffers[m_recordIndex].setState(*m_currentState);
+	m_commandBuffers[m_recordIndex].saveScreenshot(filePath);
+}
+
+Matrix4 ThreadedGraphicsContext::createOrtographicMatrix(const float left, const float right, const float top, const float bottom, const float n, const float f) const
+{
+	return m_backend->createOrtographicMatrix(left, right, top, bottom, n, f);
+}
+
+Matrix4 ThreadedGraphicsContext::createPerspectiveMatrix(const float fov, const float aspectRatio, const float zNear, const float zFar) const
+{
+	return m_backend->createPerspectiveMatrix(fov, aspectRatio, zNear, zFar);
+}
+
+Matrix4 ThreadedGraphicsContext::createLookAtMatrix(const Vector3F& position, const Vector3F& fwd) const
+{
+	return m_backend->createLookAtMatrix(position, fwd);
+}
+
+void ThreadedGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount, const uint* indices, const uint indexCount)
+{
+	if(isImmediate())
+	{
+		*m_backend->m_currentState = *m_currentState;
+		m_backend->drawIndexedPrimitives(type, vertices, vertexCount, indices, indexCount);
+		return;
+	}
+
+	GraphicsCommandBuffer& commandBuffer = m_commandBuffers[m_recordIndex];
+	commandBuffer.setState(*m_currentState);
+	commandBuffer.drawIndexedPrimitives(type, vertices, vertexCount, indices, indexCount);
+}
+
+void ThreadedGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer)
+{
+	if(isImmediate())
+	{
+		*m_backend->m_currentState = *m_currentState;
+		m_backend->drawIndexedPrimitives(type, vertexBuffer, indexBuffer);
+		return;
+	}
+
+	GraphicsCommandBuffer& commandBuffer = m_commandBuffers[m_recordIndex];
+	commandBuffer.setState(*m_currentState);
+	commandBuffer.drawIndexedPrimitives(type, vertexBuffer, indexBuffer);
+}
+
+void ThreadedGraphicsContext::drawIndexedPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer, const IndexBufferRef indexBuffer, const uint32 firstIndex, const uint32 indexCount, const int32 baseVertex)
+{
+	if(isImmediate())
+	{
+		*m_backend->m_currentState = *m_currentState;
+		m_backend->drawIndexedPrimitives(type, vertexBuffer, indexBuffer, firstIndex, indexCount, baseVertex);
+		return;
+	}
+
+	GraphicsCommandBuffer& commandBuffer = m_commandBuffers[m_recordIndex];
+	commandBuffer.setState(*m_currentState);
+	commandBuffer.drawIndexedPrimitives(type, vertexBuffer, indexBuffer, firstIndex, indexCount, baseVertex);
+}
+
+void ThreadedGraphicsContext::drawPrimitivesImpl(const PrimitiveType type, const VertexArray& vertices, const uint vertexCount)
+{
+	if(isImmediate())
+	{
+		*m_backend->m_currentState = *m_currentState;
+		m_backend->drawPrimitives(type, vertices, vertexCount);
+		return;
+	}
+
+	GraphicsCommandBuffer& commandBuffer = m_commandBuffers[m_recordIndex];
+	commandBuffer.setState(*m_currentState);
+	commandBuffer.drawPrimitives(type, vertices, vertexCount);
+}
+
+void ThreadedGraphicsContext::drawPrimitivesImpl(const PrimitiveType type, const VertexBufferRef vertexBuffer)
+{
+	if(isImmediate())
+	{
+		*m_backend->m_currentState = *m_currentState;
+		m_backend->drawPrimitives(type, vertexBuffer);
+		return;
+	}
+
+	GraphicsCommandBuffer& commandBuffer = m_commandBuffers[m_recordIndex];
+	commandBuffer.setState(*m_currentState);
+	commandBuffer.drawPrimitives(type, vertexBuffer);
+}
+
+void ThreadedGraphicsContext::beginProfileScope(const char* name)
+{
+	if(isImmediate()) { m_backend->beginProfileScope(name); return; }
+	m_commandBuffers[m_recordIndex].beginProfileScope(name);
+}
+
+void ThreadedGraphicsContext::endProfileScope()
+{
+	if(isImmediate()) { m_backend->endProfileScope(); return; }
+	m_commandBuffers[m_recordIndex].endProfileScope();
+}
+
+void ThreadedGraphicsContext::resolveProfileScopes()
+{
+	// The render thread resolves the scopes after presenting each frame
+	if(isImmediate())
+	{
+		m_backend->resolveProfileScopes();
+	}
+}
+
+void ThreadedGraphicsContext::swapBuffersImpl()
+{
+	if(isImmediate()) { m_backend->swapBuffers(); return; }
+	submit(true);
+}
+
+void ThreadedGraphicsContext::setSwapInterval(const int interval)
+{
+	if(isImmediate()) { m_backend->setSwapInterval(interval); return; }
+	m_commandBuffers[m_recordIndex].setSwapInterval(interval);
+}
+
+//--------------------------------------------------------------------
+// Texture2D
+//--------------------------------------------------------------------
+void ThreadedGraphicsContext::texture2D_createDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject, const string& deviceObjectName)
+{
+	invokeAndWait([&](GraphicsContext* backend) { backend->texture2D_createDeviceObject(outTextureDeviceObject, deviceObjectName); });
+}
+
+void ThreadedGraphicsContext::texture2D_destroyDeviceObject(Texture2DDeviceObject*& outTextureDeviceObject)
+{
+	if(isImmediate()) { m_backend->texture2D_destroyDeviceObject(outTextureDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].texture2D_destroyDeviceObject(outTextureDeviceObject);
+	outTextureDeviceObject = nullptr;
+}
+
+void ThreadedGraphicsContext::texture2D_copyToGPUImpl(Texture2DDeviceObject* textureDeviceObject, const PixelFormat pixelFormat, const uint32 width, const uint32 height, uint8* textureData)
+{
+	if(isImmediate()) { m_backend->texture2D_copyToGPU(textureDeviceObject, pixelFormat, width, height, textureData); return; }
+
+	// Keep the texture's size and format readable on this thread
+	textureDeviceObject->width = width;
+	textureDeviceObject->height = height;
+	textureDeviceObject->pixelFormat = pixelFormat;
+	m_commandBuffers[m_recordIndex].texture2D_copyToGPU(textureDeviceObject, pixelFormat, width, height, textureData);
+}
+
+void ThreadedGraphicsContext::texture2D_copyToCPUReadableImpl(Texture2DDeviceObject* textureDeviceObject, uint8** outTextureData)
+{
+	invokeAndWait([&](GraphicsContext* backend) { backend->texture2D_copyToCPUReadable(textureDeviceObject, outTextureData); });
+}
+
+void ThreadedGraphicsContext::texture2D_updateSubregionImpl(Texture2DDeviceObject* textureDeviceObject, const uint32 x, const uint32 y, const uint32 subRegionWidth, const uint32 subRegionHeight, uint8* textureData)
+{
+	if(isImmediate()) { m_backend->texture2D_updateSubregion(textureDeviceObject, x, y, subRegionWidth, subRegionHeight, textureData); return; }
+	m_commandBuffers[m_recordIndex].texture2D_updateSubregion(textureDeviceObject, x, y, subRegionWidth, subRegionHeight, textureDeviceObject->pixelFormat.getPixelSizeInBytes(), textureData);
+}
+
+void ThreadedGraphicsContext::texture2D_updateFilteringImpl(Texture2DDeviceObject* textureDeviceObject, const TextureFiltering filtering)
+{
+	if(isImmediate()) { m_backend->texture2D_updateFiltering(textureDeviceObject, filtering); return; }
+	textureDeviceObject->filtering = filtering;
+	m_commandBuffers[m_recordIndex].texture2D_updateFiltering(textureDeviceObject, filtering);
+}
+
+void ThreadedGraphicsContext::texture2D_updateWrappingImpl(Texture2DDeviceObject* textureDeviceObject, const TextureWrapping wrapping)
+{
+	if(isImmediate()) { m_backend->texture2D_updateWrapping(textureDeviceObject, wrapping); return; }
+	textureDeviceObject->wrapping = wrapping;
+	m_commandBuffers[m_recordIndex].texture2D_updateWrapping(textureDeviceObject, wrapping);
+}
+
+void ThreadedGraphicsContext::texture2D_clearTextureImpl(Texture2DDeviceObject* textureDeviceObject)
+{
+	if(isImmediate()) { m_backend->texture2D_clearTexture(textureDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].texture2D_clearTexture(textureDeviceObject);
+}
+
+//--------------------------------------------------------------------
+// Shader
+//--------------------------------------------------------------------
+void ThreadedGraphicsContext::shader_createDeviceObject(ShaderDeviceObject*& outShaderDeviceObject, const string& deviceObjectName)
+{
+	invokeAndWait([&](GraphicsContext* backend) { backend->shader_createDeviceObject(outShaderDeviceObject, deviceObjectName); });
+}
+
+void ThreadedGraphicsContext::shader_destroyDeviceObject(ShaderDeviceObject*& outShaderDeviceObject)
+{
+	if(isImmediate()) { m_backend->shader_destroyDeviceObject(outShaderDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].shader_destroyDeviceObject(outShaderDeviceObject);
+	outShaderDeviceObject = nullptr;
+}
+
+void ThreadedGraphicsContext::shader_compileShader(ShaderDeviceObject* shaderDeviceObject, const string& vsSource, const string& psSource, const string& gsSource)
+{
+	invokeAndWait([&](GraphicsContext* backend) { backend->shader_compileShader(shaderDeviceObject, vsSource, psSource, gsSource); });
+}
+
+void ThreadedGraphicsContext::shader_setUniformImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, const Datatype datatype, const uint32 numComponentsPerElement, const uint32 numElements, const void* data)
+{
+	if(isImmediate()) { m_backend->shader_setUniform(shaderDeviceObject, uniformName, datatype, numComponentsPerElement, numElements, data); return; }
+
+	// Work out how many bytes to copy. The uniform tables are only written
+	// when compiling, so struct sizes can be read from here.
+	uint32 dataSize;
+	switch(datatype)
+	{
+		case Datatype::Struct: dataSize = m_backend->shader_getUniformDataSize(shaderDeviceObject, uniformName); break;
+		case Datatype::Matrix4: dataSize = util::GetDatatypeSize(datatype) * numElements; break;
+		default: dataSize = util::GetDatatypeSize(datatype) * numComponentsPerElement * numElements; break;
+	}
+	m_commandBuffers[m_recordIndex].shader_setUniform(shaderDeviceObject, uniformName, datatype, numComponentsPerElement, numElements, data, dataSize);
+}
+
+void ThreadedGraphicsContext::shader_setSampler2DImpl(ShaderDeviceObject* shaderDeviceObject, const string& uniformName, Texture2DRef texture)
+{
+	if(isImmediate()) { m_backend->shader_setSampler2D(shaderDeviceObject, uniformName, texture); return; }
+	m_commandBuffers[m_recordIndex].shader_setSampler2D(shaderDeviceObject, uniformName, texture);
+}
+
+uint32 ThreadedGraphicsContext::shader_getUniformDataSize(ShaderDeviceObject* shaderDeviceObject, const string& uniformName)
+{
+	return m_backend->shader_getUniformDataSize(shaderDeviceObject, uniformName);
+}
+
+//--------------------------------------------------------------------
+// RenderTarget2D
+//--------------------------------------------------------------------
+void ThreadedGraphicsContext::renderTarget2D_createDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject, const string& deviceObjectName)
+{
+	invokeAndWait([&](GraphicsContext* backend) { backend->renderTarget2D_createDeviceObject(outRenderTargetDeviceObject, deviceObjectName); });
+}
+
+void ThreadedGraphicsContext::renderTarget2D_destroyDeviceObject(RenderTarget2DDeviceObject*& outRenderTargetDeviceObject)
+{
+	if(isImmediate()) { m_backend->renderTarget2D_destroyDeviceObject(outRenderTargetDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].renderTarget2D_destroyDeviceObject(outRenderTargetDeviceObject);
+	outRenderTargetDeviceObject = nullptr;
+}
+
+void ThreadedGraphicsContext::renderTarget2D_initializeRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject, const Texture2DRef* targetTextures, const uint32 targetCount)
+{
+	// The backend allocates the target texture list, so wait for it
+	invokeAndWait([&](GraphicsContext* backend) { backend->renderTarget2D_initializeRenderTarget(renderTargetDeviceObject, targetTextures, targetCount); });
+}
+
+void ThreadedGraphicsContext::renderTarget2D_bindRenderTarget(RenderTarget2DDeviceObject* renderTargetDeviceObject)
+{
+	if(isImmediate()) { m_backend->renderTarget2D_bindRenderTarget(renderTargetDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].renderTarget2D_bindRenderTarget(renderTargetDeviceObject);
+}
+
+//--------------------------------------------------------------------
+// VertexBuffer
+//--------------------------------------------------------------------
+void ThreadedGraphicsContext::vertexBuffer_createDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject, const string& deviceObjectName)
+{
+	invokeAndWait([&](GraphicsContext* backend) { backend->vertexBuffer_createDeviceObject(outVertexBufferDeviceObject, deviceObjectName); });
+}
+
+void ThreadedGraphicsContext::vertexBuffer_destroyDeviceObject(VertexBufferDeviceObject*& outVertexBufferDeviceObject)
+{
+	if(isImmediate()) { m_backend->vertexBuffer_destroyDeviceObject(outVertexBufferDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].vertexBuffer_destroyDeviceObject(outVertexBufferDeviceObject);
+	outVertexBufferDeviceObject = nullptr;
+}
+
+void ThreadedGraphicsContext::vertexBuffer_initializeVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const BufferUsage bufferUsage, const VertexArray& vertices, const uint32 vertexCount)
+{
+	// The backend fills in the vertex format and count, so wait for it
+	invokeAndWait([&](GraphicsContext* backend) { backend->vertexBuffer_initializeVertexBuffer(vertexBufferDeviceObject, bufferUsage, vertices, vertexCount); });
+}
+
+void ThreadedGraphicsContext::vertexBuffer_modifyVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject, const uint32 startIndex, const VertexArray& vertices, const uint32 vertexCount)
+{
+	if(isImmediate()) { m_backend->vertexBuffer_modifyVertexBuffer(vertexBufferDeviceObject, startIndex, vertices, vertexCount); return; }
+	m_commandBuffers[m_recordIndex].vertexBuffer_modifyVertexBuffer(vertexBufferDeviceObject, startIndex, vertices, vertexCount);
+}
+
+void ThreadedGraphicsContext::vertexBuffer_bindVertexBuffer(VertexBufferDeviceObject* vertexBufferDeviceObject)
+{
+	if(isImmediate()) { m_backend->vertexBuffer_bindVertexBuffer(vertexBufferDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].invoke([vertexBufferDeviceObject](GraphicsContext* backend) { backend->vertexBuffer_bindVertexBuffer(vertexBufferDeviceObject); });
+}
+
+//--------------------------------------------------------------------
+// IndexBuffer
+//--------------------------------------------------------------------
+void ThreadedGraphicsContext::indexBuffer_createDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject, const string& deviceObjectName)
+{
+	invokeAndWait([&](GraphicsContext* backend) { backend->indexBuffer_createDeviceObject(outIndexBufferDeviceObject, deviceObjectName); });
+}
+
+void ThreadedGraphicsContext::indexBuffer_destroyDeviceObject(IndexBufferDeviceObject*& outIndexBufferDeviceObject)
+{
+	if(isImmediate()) { m_backend->indexBuffer_destroyDeviceObject(outIndexBufferDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].indexBuffer_destroyDeviceObject(outIndexBufferDeviceObject);
+	outIndexBufferDeviceObject = nullptr;
+}
+
+void ThreadedGraphicsContext::indexBuffer_initializeIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const BufferUsage bufferUsage, const uint32* indices, const uint32 indexCount)
+{
+	invokeAndWait([&](GraphicsContext* backend) { backend->indexBuffer_initializeIndexBuffer(indexBufferDeviceObject, bufferUsage, indices, indexCount); });
+}
+
+void ThreadedGraphicsContext::indexBuffer_modifyIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject, const uint32 startIndex, const uint32* indices, const uint32 indexCount)
+{
+	if(isImmediate()) { m_backend->indexBuffer_modifyIndexBuffer(indexBufferDeviceObject, startIndex, indices, indexCount); return; }
+	m_commandBuffers[m_recordIndex].indexBuffer_modifyIndexBuffer(indexBufferDeviceObject, startIndex, indices, indexCount);
+}
+
+void ThreadedGraphicsContext::indexBuffer_bindIndexBuffer(IndexBufferDeviceObject* indexBufferDeviceObject)
+{
+	if(isImmediate()) { m_backend->indexBuffer_bindIndexBuffer(indexBufferDeviceObject); return; }
+	m_commandBuffers[m_recordIndex].invoke([indexBufferDeviceObject](GraphicsContext* backend) { backend->indexBuffer_bindIndexBuffer(indexBufferDeviceObject); });
+}
+
+END_SAUCE_NAMESPACE
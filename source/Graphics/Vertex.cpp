@@ -102,6 +102,19 @@ VertexArray VertexFormat::createVertices(const uint32 count) const
 	return move(VertexArray(count, *this));
 }
 
+void VertexFormat::validateElements(initializer_list<VertexElement> elements, const uint vertexSize) const
+{
+	// Vertices are copied as raw bytes, so a mismatch would corrupt every draw
+	for(const VertexElement &element : elements)
+	{
+		THROW_IF(element.offset != getAttributeOffset(element.attribute),
+			"VertexFormat::FromElements(): Vertex member at offset %i does not match the vertex format (expected offset %i).", element.offset, getAttributeOffset(element.attribute));
+	}
+
+	THROW_IF(vertexSize != m_vertexByteSize,
+		"VertexFormat::FromElements(): Vertex type is %i bytes but the vertex format is %i bytes.", vertexSize, m_vertexByteSize);
+}
+
 VertexFormat &VertexFormat::operator=(const VertexFormat &other)
 {
 	for(int i = 0; i < (uint32)VertexAttribute::Max; i++)
@@ -128,15 +141,21 @@ bool VertexFormat::operator==(const VertexFormat &other)
 
 Vertex::Vertex()
 	: m_vertexData(nullptr)
-	, m_vertexFormat()
+	, m_vertexFormat(nullptr)
+{
+}
+
+Vertex::Vertex(uint8 *vertexData, const VertexFormat *vertexFormat)
+	: m_vertexData(vertexData)
+	, m_vertexFormat(vertexFormat)
 {
 }
 
 void Vertex::set1f(const VertexAttribute attrib, const float v0)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 1)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 1)
 	{
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
 	}
 	else
 	{
@@ -146,9 +165,9 @@ void Vertex::set1f(const VertexAttribute attrib, const float v0)
 
 void Vertex::set1ui(const VertexAttribute attrib, const uint v0)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 1)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 1)
 	{
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
 	}
 	else
 	{
@@ -158,9 +177,9 @@ void Vertex::set1ui(const VertexAttribute attrib, const uint v0)
 
 void Vertex::set1i(const VertexAttribute attrib, const int v0)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 1)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 1)
 	{
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
 	}
 	else
 	{
@@ -170,9 +189,9 @@ void Vertex::set1i(const VertexAttribute attrib, const int v0)
 
 void Vertex::set1us(const VertexAttribute attrib, const ushort v0)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 1)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 1)
 	{
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
 	}
 	else
 	{
@@ -182,9 +201,9 @@ void Vertex::set1us(const VertexAttribute attrib, const ushort v0)
 
 void Vertex::set1s(const VertexAttribute attrib, const short v0)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 1)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 1)
 	{
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
 	}
 	else
 	{
@@ -194,9 +213,9 @@ void Vertex::set1s(const VertexAttribute attrib, const short v0)
 
 void Vertex::set1ub(const VertexAttribute attrib, const uchar v0)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 1)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 1)
 	{
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
 	}
 	else
 	{
@@ -206,9 +225,9 @@ void Vertex::set1ub(const VertexAttribute attrib, const uchar v0)
 
 void Vertex::set1b(const VertexAttribute attrib, const char v0)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 1)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 1)
 	{
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
 	}
 	else
 	{
@@ -218,10 +237,10 @@ void Vertex::set1b(const VertexAttribute attrib, const char v0)
 
 void Vertex::set2f(const VertexAttribute attrib, const float v0, const float v1)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 2)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 2)
 	{
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
 	}
 	else
 	{
@@ -231,10 +250,10 @@ void Vertex::set2f(const VertexAttribute attrib, const float v0, const float v1)
 
 void Vertex::set2ui(const VertexAttribute attrib, const uint v0, const uint v1)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 2)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 2)
 	{
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
 	}
 	else
 	{
@@ -244,10 +263,10 @@ void Vertex::set2ui(const VertexAttribute attrib, const uint v0, const uint v1)
 
 void Vertex::set2i(const VertexAttribute attrib, const int v0, const int v1)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 2)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 2)
 	{
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
 	}
 	else
 	{
@@ -257,10 +276,10 @@ void Vertex::set2i(const VertexAttribute attrib, const int v0, const int v1)
 
 void Vertex::set2us(const VertexAttribute attrib, const ushort v0, const ushort v1)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 2)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 2)
 	{
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
 	}
 	else
 	{
@@ -270,10 +289,10 @@ void Vertex::set2us(const VertexAttribute attrib, const ushort v0, const ushort
 
 void Vertex::set2s(const VertexAttribute attrib, const short v0, const short v1)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 2)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 2)
 	{
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
 	}
 	else
 	{
@@ -283,10 +302,10 @@ void Vertex::set2s(const VertexAttribute attrib, const short v0, const short v1)
 
 void Vertex::set2ub(const VertexAttribute attrib, const uchar v0, const uchar v1)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 2)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 2)
 	{
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
 	}
 	else
 	{
@@ -296,10 +315,10 @@ void Vertex::set2ub(const VertexAttribute attrib, const uchar v0, const uchar v1
 
 void Vertex::set2b(const VertexAttribute attrib, const char v0, const char v1)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 2)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 2)
 	{
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
 	}
 	else
 	{
@@ -309,11 +328,11 @@ void Vertex::set2b(const VertexAttribute attrib, const char v0, const char v1)
 
 void Vertex::set3f(const VertexAttribute attrib, const float v0, const float v1, const float v2)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 3)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 3)
 	{
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
 	}
 	else
 	{
@@ -323,11 +342,11 @@ void Vertex::set3f(const VertexAttribute attrib, const float v0, const float v1,
 
 void Vertex::set3ui(const VertexAttribute attrib, const uint v0, const uint v1, const uint v2)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 3)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 3)
 	{
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
 	}
 	else
 	{
@@ -337,11 +356,11 @@ void Vertex::set3ui(const VertexAttribute attrib, const uint v0, const uint v1,
 
 void Vertex::set3i(const VertexAttribute attrib, const int v0, const int v1, const int v2)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 3)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 3)
 	{
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
 	}
 	else
 	{
@@ -351,11 +370,11 @@ void Vertex::set3i(const VertexAttribute attrib, const int v0, const int v1, con
 
 void Vertex::set3us(const VertexAttribute attrib, const ushort v0, const ushort v1, const ushort v2)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 3)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 3)
 	{
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
 	}
 	else
 	{
@@ -365,11 +384,11 @@ void Vertex::set3us(const VertexAttribute attrib, const ushort v0, const ushort
 
 void Vertex::set3s(const VertexAttribute attrib, const short v0, const short v1, const short v2)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 3)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 3)
 	{
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
 	}
 	else
 	{
@@ -379,11 +398,11 @@ void Vertex::set3s(const VertexAttribute attrib, const short v0, const short v1,
 
 void Vertex::set3ub(const VertexAttribute attrib, const uchar v0, const uchar v1, const uchar v2)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 3)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 3)
 	{
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
 	}
 	else
 	{
@@ -393,11 +412,11 @@ void Vertex::set3ub(const VertexAttribute attrib, const uchar v0, const uchar v1
 
 void Vertex::set3b(const VertexAttribute attrib, const char v0, const char v1, const char v2)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 3)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 3)
 	{
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
 	}
 	else
 	{
@@ -407,12 +426,12 @@ void Vertex::set3b(const VertexAttribute attrib, const char v0, const char v1, c
 
 void Vertex::set4f(const VertexAttribute attrib, const float v0, const float v1, const float v2, const float v3)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 4)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 4)
 	{
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
-		((float*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[3] = v3;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
+		((float*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[3] = v3;
 	}
 	else
 	{
@@ -422,12 +441,12 @@ void Vertex::set4f(const VertexAttribute attrib, const float v0, const float v1,
 
 void Vertex::set4ui(const VertexAttribute attrib, const uint v0, const uint v1, const uint v2, const uint v3)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 4)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 4)
 	{
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
-		((uint*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[3] = v3;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
+		((uint*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[3] = v3;
 	}
 	else
 	{
@@ -437,12 +456,12 @@ void Vertex::set4ui(const VertexAttribute attrib, const uint v0, const uint v1,
 
 void Vertex::set4i(const VertexAttribute attrib, const int v0, const int v1, const int v2, const int v3)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 4)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 4)
 	{
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
-		((int*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[3] = v3;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
+		((int*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[3] = v3;
 	}
 	else
 	{
@@ -452,12 +471,12 @@ void Vertex::set4i(const VertexAttribute attrib, const int v0, const int v1, con
 
 void Vertex::set4us(const VertexAttribute attrib, const ushort v0, const ushort v1, const ushort v2, const ushort v3)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 4)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 4)
 	{
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
-		((ushort*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[3] = v3;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
+		((ushort*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[3] = v3;
 	}
 	else
 	{
@@ -467,12 +486,12 @@ void Vertex::set4us(const VertexAttribute attrib, const ushort v0, const ushort
 
 void Vertex::set4s(const VertexAttribute attrib, const short v0, const short v1, const short v2, const short v3)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 4)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 4)
 	{
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
-		((short*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[3] = v3;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
+		((short*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[3] = v3;
 	}
 	else
 	{
@@ -482,12 +501,12 @@ void Vertex::set4s(const VertexAttribute attrib, const short v0, const short v1,
 
 void Vertex::set4ub(const VertexAttribute attrib, const uchar v0, const uchar v1, const uchar v2, const uchar v3)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 4)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 4)
 	{
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
-		((uchar*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[3] = v3;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
+		((uchar*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[3] = v3;
 	}
 	else
 	{
@@ -497,12 +516,12 @@ void Vertex::set4ub(const VertexAttribute attrib, const uchar v0, const uchar v1
 
 void Vertex::set4b(const VertexAttribute attrib, const char v0, const char v1, const char v2, const char v3)
 {
-	if(m_vertexFormat.isAttributeEnabled(attrib) || m_vertexFormat.getElementCount(attrib) != 4)
+	if(m_vertexFormat->isAttributeEnabled(attrib) || m_vertexFormat->getElementCount(attrib) != 4)
 	{
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[0] = v0;
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[1] = v1;
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[2] = v2;
-		((char*) (m_vertexData + m_vertexFormat.getAttributeOffset(attrib)))[3] = v3;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[0] = v0;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[1] = v1;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[2] = v2;
+		((char*) (m_vertexData + m_vertexFormat->getAttributeOffset(attrib)))[3] = v3;
 	}
 	else
 	{
@@ -517,7 +536,7 @@ string Vertex::toString() const
 	for (int32 vertexAttributeIndex = 0; vertexAttributeIndex < (uint32)VertexAttribute::Max; ++vertexAttributeIndex)
 	{
 		VertexAttribute attrib = VertexAttribute(vertexAttributeIndex);
-		if(m_vertexFormat.isAttributeEnabled(attrib))
+		if(m_vertexFormat->isAttributeEnabled(attrib))
 		{
 			switch(attrib)
 			{
@@ -527,9 +546,9 @@ string Vertex::toString() const
 				case VertexAttribute::Normal:   ss << "\tNormal "; break;
 			}
 
-			const int32 elementCount = m_vertexFormat.getElementCount(attrib);
+			const int32 elementCount = m_vertexFormat->getElementCount(attrib);
 
-			switch (m_vertexFormat.getDatatype(attrib))
+			switch (m_vertexFormat->getDatatype(attrib))
 			{
 				case Datatype::Float:  ss << "(float)"; break;
 				case Datatype::Uint32: ss << "(uint32)"; break;
@@ -543,8 +562,8 @@ string Vertex::toString() const
 			ss << ": [";
 			for(int elementIndex = 0; elementIndex < elementCount; ++elementIndex)
 			{
-				const uint8 *const dataPtr = (m_vertexData + m_vertexFormat.getAttributeOffset(attrib));
-				switch(m_vertexFormat.getDatatype(attrib))
+				const uint8 *const dataPtr = (m_vertexData + m_vertexFormat->getAttributeOffset(attrib));
+				switch(m_vertexFormat->getDatatype(attrib))
 				{
 				case Datatype::Float:  ss << ((float*)dataPtr)[elementIndex]; break;
 				case Datatype::Uint32: ss << ((uint32*)dataPtr)[elementIndex]; break;
@@ -571,7 +590,6 @@ VertexArray::VertexArray()
 	, m_vertexCapacity(0)
 	, m_vertexFormat(VertexFormat::s_vtc)
 	, m_vertexArrayData(nullptr)
-	, m_vertexHandlesCache(nullptr)
 {
 }
 
@@ -580,7 +598,6 @@ VertexArray::VertexArray(const uint32 vertexCount)
 	, m_vertexCapacity(0)
 	, m_vertexFormat(VertexFormat::s_vtc)
 	, m_vertexArrayData(nullptr)
-	, m_vertexHandlesCache(nullptr)
 {
 	resize(vertexCount);
 }
@@ -590,7 +607,6 @@ VertexArray::VertexArray(const uint32 vertexCount, const VertexFormat& vertexFor
 	, m_vertexCapacity(0)
 	, m_vertexFormat(vertexFormat)
 	, m_vertexArrayData(nullptr)
-	, m_vertexHandlesCache(nullptr)
 {
 	resize(vertexCount);
 }
@@ -601,40 +617,34 @@ VertexArray::VertexArray(VertexArray&& other) noexcept
 	m_vertexCapacity = other.m_vertexCapacity;
 	m_vertexFormat = other.m_vertexFormat;
 	m_vertexArrayData = other.m_vertexArrayData;
-	m_vertexHandlesCache = other.m_vertexHandlesCache;
 	other.m_vertexCount = 0;
 	other.m_vertexCapacity = 0;
 	other.m_vertexFormat = VertexFormat();
 	other.m_vertexArrayData = nullptr;
-	other.m_vertexHandlesCache = nullptr;
 }
 
 VertexArray::~VertexArray()
 {
 	delete[] m_vertexArrayData;
-	delete[] m_vertexHandlesCache;
 }
 
 VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
 {
 	delete[] m_vertexArrayData;
-	delete[] m_vertexHandlesCache;
 	m_vertexCount = other.m_vertexCount;
 	m_vertexCapacity = other.m_vertexCapacity;
 	m_vertexFormat = other.m_vertexFormat;
 	m_vertexArrayData = other.m_vertexArrayData;
-	m_vertexHandlesCache = other.m_vertexHandlesCache;
 	other.m_vertexCount = 0;
 	other.m_vertexCapacity = 0;
 	other.m_vertexFormat = VertexFormat();
 	other.m_vertexArrayData = nullptr;
-	other.m_vertexHandlesCache = nullptr;
 	return *this;
 }
 
-Vertex& VertexArray::operator[](const uint32 index)
+Vertex VertexArray::operator[](const uint32 index)
 {
-	if (index > m_vertexCount)
+	if (index >= m_vertexCount)
 	{
 		LOG("Attempting to access a vertex outside the vertex array");
 		static vector<uint8> zeroedData;
@@ -642,12 +652,9 @@ Vertex& VertexArray::operator[](const uint32 index)
 		{
 			zeroedData.resize(m_vertexFormat.getVertexSizeInBytes());
 		}
-		static Vertex tmpVertex;
-		tmpVertex.m_vertexData = zeroedData.data();
-		tmpVertex.m_vertexFormat = m_vertexFormat;
-		return tmpVertex;
+		return Vertex(zeroedData.data(), &m_vertexFormat);
 	}
-	return m_vertexHandlesCache[index];
+	return Vertex(m_vertexArrayData + index * m_vertexFormat.getVertexSizeInBytes(), &m_vertexFormat);
 }
 
 uint32 VertexArray::getVertexCount() const
@@ -655,6 +662,11 @@ uint32 VertexArray::getVertexCount() const
 	return m_vertexCount;
 }
 
+uint32 VertexArray::getVertexCapacity() const
+{
+	return m_vertexCapacity;
+}
+
 VertexFormat VertexArray::getVertexFormat() const
 {
 	return m_vertexFormat;
@@ -674,43 +686,58 @@ void VertexArray::resize(const uint32 newVertexCount)
 {
 	if (m_vertexCapacity < newVertexCount)
 	{
-		// Temporarily store pointer to previous data
-		const uint32 prevVertexDataSize = getVertexDataSize();
-		const uint8* prevVertexArrayData = m_vertexArrayData;
-
 		// Capacity needs to increase
-		m_vertexCapacity = m_vertexCount = newVertexCount;
-		const uint32 newVertexDataSize = getVertexDataSize();
-		m_vertexArrayData = new uint8[newVertexDataSize];
-		memset(m_vertexArrayData, 0, newVertexDataSize);
-
-		// Copy previous vertex data
-		memcpy(m_vertexArrayData, prevVertexArrayData, prevVertexDataSize);
+		reserve(max(newVertexCount, m_vertexCapacity * 2));
+	}
+	m_vertexCount = newVertexCount;
+}
 
-		// Clear previous data
-		delete[] prevVertexArrayData;
+void VertexArray::reserve(const uint32 vertexCapacity)
+{
+	if (m_vertexCapacity >= vertexCapacity)
+	{
+		return;
+	}
 
-		// Update vertex cache
-		delete[] m_vertexHandlesCache;
-		m_vertexHandlesCache = new Vertex[m_vertexCount];
-		for (uint32 vertexIndex = 0; vertexIndex < m_vertexCount; ++vertexIndex)
-		{
-			m_vertexHandlesCache[vertexIndex].m_vertexData = m_vertexArrayData + (vertexIndex * m_vertexFormat.getVertexSizeInBytes());
-			m_vertexHandlesCache[vertexIndex].m_vertexFormat = m_vertexFormat;
-		}
+	// Copy the vertices in use and zero the rest
+	const uint32 vertexSize = m_vertexFormat.getVertexSizeInBytes();
+	const uint32 prevVertexDataSize = getVertexDataSize();
+	uint8* vertexArrayData = new uint8[vertexCapacity * vertexSize];
+	if (prevVertexDataSize > 0)
+	{
+		memcpy(vertexArrayData, m_vertexArrayData, prevVertexDataSize);
 	}
-	else
+	memset(vertexArrayData + prevVertexDataSize, 0, vertexCapacity * vertexSize - prevVertexDataSize);
+
+	delete[] m_vertexArrayData;
+	m_vertexArrayData = vertexArrayData;
+	m_vertexCapacity = vertexCapacity;
+}
+
+void VertexArray::clear()
+{
+	m_vertexCount = 0;
+}
+
+void VertexArray::setVertexFormat(const VertexFormat& vertexFormat)
+{
+	if (m_vertexCount > 0)
 	{
-		// We already have the capacity, change vertex count only
-		m_vertexCount = newVertexCount;
+		LOG("VertexArray::setVertexFormat(): Vertex array must be cleared before changing its format");
+		return;
 	}
+
+	// Keep the storage, measured in vertices of the new format
+	const uint32 capacityInBytes = m_vertexCapacity * m_vertexFormat.getVertexSizeInBytes();
+	m_vertexFormat = vertexFormat;
+	m_vertexCapacity = m_vertexFormat.getVertexSizeInBytes() > 0 ? capacityInBytes / m_vertexFormat.getVertexSizeInBytes() : 0;
 }
 
 VertexArray VertexArray::makeCopy() const
 {
 	VertexArray newVertexArray;
 	newVertexArray.m_vertexFormat = m_vertexFormat;
-	newVertexArray.resize(m_vertexCapacity);
+	newVertexArray.reserve(m_vertexCapacity);
 	newVertexArray.m_vertexCount = m_vertexCount;
 	memcpy(newVertexArray.m_vertexArrayData, m_vertexArrayData, getVertexDataSize());
 	return move(newVertexArray);
@@ -722,7 +749,7 @@ string VertexArray::toString() const
 	for (uint32 vertexIndex = 0; vertexIndex < m_vertexCount; ++vertexIndex)
 	{
 		ss << "Vertex[" << vertexIndex << "]:" << endl;
-		ss << m_vertexHandlesCache[vertexIndex].toString();
+		ss << Vertex(m_vertexArrayData + vertexIndex * m_vertexFormat.getVertexSizeInBytes(), &m_vertexFormat).toString();
 		ss << endl;
 	}
 	return ss.str();
@@ -27,7 +27,10 @@ VertexBuffer::VertexBuffer()
 
 VertexBuffer::~VertexBuffer()
 {
-	m_graphicsContext->vertexBuffer_destroyDeviceObject(m_deviceObject);
+	if(m_deviceObject)
+	{
+		m_graphicsContext->vertexBuffer_destroyDeviceObject(m_deviceObject);
+	}
 }
 
 bool VertexBuffer::initialize(VertexBufferDesc vertexBufferDesc)
@@ -132,6 +135,17 @@ bool IndexBuffer::initialize(IndexBufferDesc indexBufferDesc)
 	return true;
 }
 
+void IndexBuffer::modifyData(const uint32 startIndex, const uint32* indices, const uint32 indexCount)
+{
+	if (m_deviceObject->bufferUsage == BufferUsage::Static)
+	{
+		LOG("IndexBuffer::modifyData(): Cannot modify a static index buffer");
+		return;
+	}
+
+	m_graphicsContext->indexBuffer_modifyIndexBuffer(m_deviceObject, startIndex, indices, indexCount);
+}
+
 uint32 IndexBuffer::getIndexCount() const
 {
 	return m_deviceObject->indexCount;
@@ -18,11 +18,19 @@ BEGIN_SAUCE_NAMESPACE
 
 ShaderRef g_ImGuiShader;
 Texture2DRef g_FontTexture;
+VertexBufferRef g_VertexBuffer;
+IndexBufferRef g_IndexBuffer;
+VertexArray g_Vertices;
+vector<uint32> g_Indices;
 static ImGuiMouseCursor g_LastMouseCursor = ImGuiMouseCursor_COUNT;
 static SDL_Cursor* g_ImGuiToSDLCursor[ImGuiMouseCursor_COUNT];
 
 bool createShaders();
 bool createFontsTexture();
+void uploadDrawData(const ImDrawData* imDrawData);
+
+static_assert(sizeof(ImDrawIdx) == sizeof(uint32), "ImGuiSystem uploads ImGui indices as 32-bit indices");
+static_assert(sizeof(ImDrawVert) == 20 && offsetof(ImDrawVert, col) == 8 && offsetof(ImDrawVert, uv) == 12, "ImDrawVert must match the ImGui vertex format");
 
 void ImGuiSystem::initialize(void* hwnd)
 {
@@ -95,10 +103,57 @@ void ImGuiSystem::initialize(void* hwnd)
 //#endif
     }
 
+    // Vertex format matching ImDrawVert
+    {
+        VertexFormat fmt;
+        fmt.set(VertexAttribute::Position, 2, Datatype::Float);
+        fmt.set(VertexAttribute::Color, 4, Datatype::Uint8);
+        fmt.set(VertexAttribute::TexCoord, 2, Datatype::Float);
+        g_Vertices = fmt.createVertices(0);
+    }
+
     createShaders();
 }
 
-void ImGuiSystem::processInputs(const float deltaTime, const char textInputChar)
+void ImGuiSystem::processEvent(const SDL_Event& event)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    switch (event.type)
+    {
+        case SDL_KEYDOWN: case SDL_KEYUP:
+        {
+            // io.KeysDown[] is indexed by scancode, see io.KeyMap
+            const int32 scancode = event.key.keysym.scancode;
+            if (scancode >= 0 && scancode < IM_ARRAYSIZE(io.KeysDown))
+            {
+                io.KeysDown[scancode] = event.type == SDL_KEYDOWN;
+            }
+
+            // Take the modifiers from the event so replayed input scripts get them right
+            const Uint16 modifiers = event.key.keysym.mod;
+            io.KeyCtrl = (modifiers & KMOD_CTRL) != 0;
+            io.KeyShift = (modifiers & KMOD_SHIFT) != 0;
+            io.KeyAlt = (modifiers & KMOD_ALT) != 0;
+            io.KeySuper = false;
+        }
+        break;
+
+        case SDL_TEXTINPUT:
+        {
+            io.AddInputCharactersUTF8(event.text.text);
+        }
+        break;
+
+        case SDL_MOUSEWHEEL:
+        {
+            io.MouseWheelH += (float)event.wheel.x;
+            io.MouseWheel += (float)event.wheel.y;
+        }
+        break;
+    }
+}
+
+void ImGuiSystem::processInputs(const float deltaTime)
 {
     ImGuiIO& io = ImGui::GetIO();
     IM_ASSERT(io.Fonts->IsBuilt() && "Font atlas not built! It is generally built by the renderer back-end. Missing call to renderer _NewFrame() function? e.g. ImGui_ImplOpenGL3_NewFrame().");
@@ -112,22 +167,7 @@ void ImGuiSystem::processInputs(const float deltaTime, const char textInputChar)
     // Set delta time
     io.DeltaTime = deltaTime;
 
-    // Read keyboard modifiers inputs
-    io.KeyCtrl = input->getButtonState(SAUCE_KEY_LCTRL) || input->getButtonState(SAUCE_KEY_RCTRL);
-    io.KeyShift = input->getButtonState(SAUCE_KEY_LSHIFT) || input->getButtonState(SAUCE_KEY_RSHIFT);
-    io.KeyAlt = input->getButtonState(SAUCE_KEY_LALT) || input->getButtonState(SAUCE_KEY_RALT);
-    io.KeySuper = false;
-
-
-    // Update key states
-    {
-        for (int32 scancode = 0; scancode < 512; ++scancode)
-        {
-            const int32 keycode = SDL_GetKeyFromScancode((SDL_Scancode)scancode);
-            io.KeysDown[scancode] = input->getButtonState((Keycode)keycode);
-        }
-        io.AddInputCharacter(textInputChar);
-    }
+    // Keyboard and text input is fed by processEvent() as it arrives
 
     // Update mouse state
     {
@@ -136,9 +176,6 @@ void ImGuiSystem::processInputs(const float deltaTime, const char textInputChar)
         io.MouseDown[2] = input->getButtonState(MouseButton::SAUCE_MOUSE_BUTTON_MIDDLE);
         io.MouseDown[3] = input->getButtonState(MouseButton::SAUCE_MOUSE_BUTTON_X1);
         io.MouseDown[4] = input->getButtonState(MouseButton::SAUCE_MOUSE_BUTTON_X2);
-
-        // TODO:
-        //io.MouseWheel += input->getAxisValue()
     }
 
     // Update mouse pos
@@ -197,120 +234,153 @@ void ImGuiSystem::render()
 {
     ImGui::Render();
 
+    ImDrawData* imDrawData = ImGui::GetDrawData();
+    if (imDrawData->TotalVtxCount == 0 || imDrawData->TotalIdxCount == 0)
+    {
+        return;
+    }
+
+    // Scissor rectangles are in framebuffer pixels
+    const int32 fbWidth = (int32)(imDrawData->DisplaySize.x * imDrawData->FramebufferScale.x);
+    const int32 fbHeight = (int32)(imDrawData->DisplaySize.y * imDrawData->FramebufferScale.y);
+    if (fbWidth <= 0 || fbHeight <= 0)
+    {
+        return;
+    }
+
     GraphicsContext* graphicsContext = Game::Get()->getWindow()->getGraphicsContext();
 
-    graphicsContext->setShader(g_ImGuiShader);
+    // Upload every draw list of the frame at once
+    uploadDrawData(imDrawData);
 
-    ImDrawData* imDrawData = ImGui::GetDrawData();
+    // Setup render state. Triangles from ImGui have no consistent winding.
+    const bool faceCulling = graphicsContext->isEnabled(Capability::FaceCulling);
+    if (faceCulling)
     {
-        VertexFormat fmt;
-        fmt.set(VertexAttribute::Position, 2, Datatype::Float);
-        fmt.set(VertexAttribute::Color, 4, Datatype::Uint8);
-        fmt.set(VertexAttribute::TexCoord, 2, Datatype::Float);
-
-        // Setup desired GL state
-        // Recreate the VAO every time (this is to easily allow multiple GL contexts to be rendered to. VAO are not shared among GL contexts)
-        // The renderer would actually work without any VAO bound, but then our VertexAttrib calls would overwrite the default one currently bound.
-//        GLuint vertex_array_object = 0;
-//#ifndef IMGUI_IMPL_OPENGL_ES2
-//        glGenVertexArrays(1, &vertex_array_object);
-//#endif
-//        ImGui_ImplOpenGL3_SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
+        graphicsContext->disable(Capability::FaceCulling);
+    }
+    graphicsContext->setShader(g_ImGuiShader);
 
-        // Will project scissor/clipping rectangles into framebuffer space
-        ImVec2 clip_off = imDrawData->DisplayPos;         // (0,0) unless using multi-viewports
-        ImVec2 clip_scale = imDrawData->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
+    // Will project scissor/clipping rectangles into framebuffer space
+    const ImVec2 clip_off = imDrawData->DisplayPos;         // (0,0) unless using multi-viewports
+    const ImVec2 clip_scale = imDrawData->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
-        // Render command lists
-        for (int n = 0; n < imDrawData->CmdListsCount; n++)
+    // Render command lists. Each list starts where the previous one ended in
+    // the shared buffers, the commands index relative to their list.
+    ImTextureID currentTexture = NULL;
+    uint32 listVertexOffset = 0, listIndexOffset = 0;
+    for (int n = 0; n < imDrawData->CmdListsCount; n++)
+    {
+        const ImDrawList* imDrawList = imDrawData->CmdLists[n];
+        for (int cmd_i = 0; cmd_i < imDrawList->CmdBuffer.Size; cmd_i++)
         {
-            const ImDrawList* imDrawList = imDrawData->CmdLists[n];
-
-            // Convert ImGui vertex buffer to Sauce vertex buffer
-            VertexArray vertices;
-            uint32 vertexCount;
+            const ImDrawCmd* pcmd = &imDrawList->CmdBuffer[cmd_i];
+            if (pcmd->UserCallback != NULL)
             {
-                const ImVector<ImDrawVert>& imVbo = imDrawList->VtxBuffer;
-                vertexCount = imVbo.Size;
-                vertices = fmt.createVertices(vertexCount);
-                for (uint32 i = 0; i < vertexCount; ++i)
+                // User callback, registered via ImDrawList::AddCallback()
+                // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
+                if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
                 {
-                    const uint8* col = (const uint8*)&imVbo[i].col;
-                    vertices[i].set2f(VertexAttribute::Position, imVbo[i].pos.x, imVbo[i].pos.y);
-                    vertices[i].set4ub(VertexAttribute::Color, col[0], col[1], col[2], col[3]);
-                    vertices[i].set2f(VertexAttribute::TexCoord, imVbo[i].uv.x, imVbo[i].uv.y);
+                    graphicsContext->setShader(g_ImGuiShader);
+                    currentTexture = NULL;
                 }
-            }
-
-            // Convert ImGui index buffer to Sauce index buffer
-            uint32* indices;
-            uint32 indexCount;
-            {
-                const ImVector<ImDrawIdx>& imIbo = imDrawList->IdxBuffer;
-                assert(imIbo.Size % 3 == 0);
-                indexCount = imIbo.Size;
-                indices = new uint32[indexCount];
-                for (uint32 i = 0; i < indexCount / 3; ++i)
+                else
                 {
-                    indices[i * 3 + 0] = imIbo[i * 3 + 0];
-                    indices[i * 3 + 1] = imIbo[i * 3 + 2];
-                    indices[i * 3 + 2] = imIbo[i * 3 + 1];
+                    pcmd->UserCallback(imDrawList, pcmd);
                 }
+                continue;
             }
 
-            for (int cmd_i = 0; cmd_i < imDrawList->CmdBuffer.Size; cmd_i++)
+            // Project scissor/clipping rectangles into framebuffer space
+            ImVec4 clip_rect;
+            clip_rect.x = (pcmd->ClipRect.x - clip_off.x) * clip_scale.x;
+            clip_rect.y = (pcmd->ClipRect.y - clip_off.y) * clip_scale.y;
+            clip_rect.z = (pcmd->ClipRect.z - clip_off.x) * clip_scale.x;
+            clip_rect.w = (pcmd->ClipRect.w - clip_off.y) * clip_scale.y;
+            if (clip_rect.x >= fbWidth || clip_rect.y >= fbHeight || clip_rect.z < 0.0f || clip_rect.w < 0.0f)
             {
-                const ImDrawCmd* pcmd = &imDrawList->CmdBuffer[cmd_i];
-                if (pcmd->UserCallback != NULL)
-                {
-                    // User callback, registered via ImDrawList::AddCallback()
-                    // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
-                    // TODO: add callback
-                    if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
-                        assert(0);//ImGui_ImplOpenGL3_SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
-                    else
-                        pcmd->UserCallback(imDrawList, pcmd);
-                }
-                else
-                {
-                    // Project scissor/clipping rectangles into framebuffer space
-                    ImVec4 clip_rect;
-                    clip_rect.x = (pcmd->ClipRect.x - clip_off.x) * clip_scale.x;
-                    clip_rect.y = (pcmd->ClipRect.y - clip_off.y) * clip_scale.y;
-                    clip_rect.z = (pcmd->ClipRect.z - clip_off.x) * clip_scale.x;
-                    clip_rect.w = (pcmd->ClipRect.w - clip_off.y) * clip_scale.y;
-
-                    // TODO: Fix clipping
-//                    if (clip_rect.x < fb_width && clip_rect.y < fb_height && clip_rect.z >= 0.0f && clip_rect.w >= 0.0f)
-//                    {
-//                        // Apply scissor/clipping rectangle
-//                        if (clip_origin_lower_left)
-//                            glScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
-//                        else
-//                            glScissor((int)clip_rect.x, (int)clip_rect.y, (int)clip_rect.z, (int)clip_rect.w); // Support for GL 4.5 rarely used glClipControl(GL_UPPER_LEFT)
-//
-//                        // Bind texture, Draw
-//                        glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
-//#if IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
-//                        if (g_GlVersion >= 3200)
-//                            glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset);
-//                        else
-//#endif
-//                            glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)));
-//                    }
-
-                    g_ImGuiShader->setSampler2D("u_Texture", *(Texture2DRef*)pcmd->TextureId);
-                    graphicsContext->drawIndexedPrimitives(PrimitiveType::Triangles, vertices, vertexCount, indices, indexCount);
-                }
+                continue;
             }
 
-            delete[] indices;
+            // Apply scissor/clipping rectangle. The scissor origin is the lower left corner.
+            graphicsContext->enableScissor((int)clip_rect.x, (int)(fbHeight - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
+
+            // Bind texture, draw
+            if (pcmd->TextureId != currentTexture)
+            {
+                g_ImGuiShader->setSampler2D("u_Texture", *(Texture2DRef*)pcmd->TextureId);
+                currentTexture = pcmd->TextureId;
+            }
+            graphicsContext->drawIndexedPrimitives(PrimitiveType::Triangles, g_VertexBuffer, g_IndexBuffer, listIndexOffset + pcmd->IdxOffset, pcmd->ElemCount, (int32)(listVertexOffset + pcmd->VtxOffset));
         }
+        listVertexOffset += imDrawList->VtxBuffer.Size;
+        listIndexOffset += imDrawList->IdxBuffer.Size;
     }
 
+    // Restore render state
+    graphicsContext->disableScissor();
+    if (faceCulling)
+    {
+        graphicsContext->enable(Capability::FaceCulling);
+    }
     graphicsContext->setShader(nullptr);
 }
 
+void uploadDrawData(const ImDrawData* imDrawData)
+{
+    const uint32 vertexCount = (uint32)imDrawData->TotalVtxCount;
+    const uint32 indexCount = (uint32)imDrawData->TotalIdxCount;
+
+    // The buffers grow to fit the largest frame so far and are reused after that
+    const uint32 vertexCapacity = g_VertexBuffer ? g_VertexBuffer->getVertexCount() : 0;
+    const uint32 indexCapacity = g_IndexBuffer ? g_IndexBuffer->getIndexCount() : 0;
+    const bool growVertexBuffer = vertexCount > vertexCapacity;
+    const bool growIndexBuffer = indexCount > indexCapacity;
+    g_Vertices.resize(growVertexBuffer ? max(vertexCount, vertexCapacity * 2) : vertexCapacity);
+    g_Indices.resize(growIndexBuffer ? max(indexCount, indexCapacity * 2) : indexCapacity);
+
+    // ImDrawVert and ImDrawIdx are laid out like g_Vertices and g_Indices
+    // (see imconfig.h), so every draw list is copied as is
+    uint8* vertexData = g_Vertices.getVertexData();
+    uint32* indexData = g_Indices.data();
+    for (int n = 0; n < imDrawData->CmdListsCount; n++)
+    {
+        const ImDrawList* imDrawList = imDrawData->CmdLists[n];
+        memcpy(vertexData, imDrawList->VtxBuffer.Data, imDrawList->VtxBuffer.Size * sizeof(ImDrawVert));
+        memcpy(indexData, imDrawList->IdxBuffer.Data, imDrawList->IdxBuffer.Size * sizeof(ImDrawIdx));
+        vertexData += imDrawList->VtxBuffer.Size * sizeof(ImDrawVert);
+        indexData += imDrawList->IdxBuffer.Size;
+    }
+
+    if (growVertexBuffer)
+    {
+        VertexBufferDesc vertexBufferDesc;
+        vertexBufferDesc.bufferUsage = BufferUsage::Dynamic;
+        vertexBufferDesc.vertices = &g_Vertices;
+        vertexBufferDesc.vertexCount = g_Vertices.getVertexCount();
+        vertexBufferDesc.debugName = "ImGuiVertexBuffer";
+        g_VertexBuffer = CreateNew<VertexBuffer>(vertexBufferDesc);
+    }
+    else
+    {
+        g_VertexBuffer->modifyData(0, g_Vertices, vertexCount);
+    }
+
+    if (growIndexBuffer)
+    {
+        IndexBufferDesc indexBufferDesc;
+        indexBufferDesc.bufferUsage = BufferUsage::Dynamic;
+        indexBufferDesc.indices = g_Indices.data();
+        indexBufferDesc.indexCount = (uint32)g_Indices.size();
+        indexBufferDesc.debugName = "ImGuiIndexBuffer";
+        g_IndexBuffer = CreateNew<IndexBuffer>(indexBufferDesc);
+    }
+    else
+    {
+        g_IndexBuffer->modifyData(0, g_Indices.data(), indexCount);
+    }
+}
+
 bool createShaders()
 {
     const string vertexShader =
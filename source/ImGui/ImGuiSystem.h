@@ -14,7 +14,8 @@ class ImGuiSystem
 {
 public:
 	static void initialize(void* hwnd);
-	static void processInputs(const float deltaTime, const char textInputChar);
+	static void processEvent(const SDL_Event& event);
+	static void processInputs(const float deltaTime);
 	static void newFrame();
 	static void render();
 };
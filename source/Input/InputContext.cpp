@@ -23,51 +23,54 @@ void InputContext::addKeybind(const string &name, Keybind *keybind)
 {
 	if(!name.empty() && keybind)
 	{
-		m_keybinds[name] = keybind;
+		const uint actionID = m_inputManager->getActionID(name);
+		if(actionID >= m_keybinds.size())
+		{
+			m_keybinds.resize(actionID + 1, 0);
+		}
+		m_keybinds[actionID] = keybind;
+		keybind->m_inputManager = m_inputManager;
+		m_inputManager->invalidateKeybinds();
 	}
 }
 
+Keybind *InputContext::getKeybind(const string &name)
+{
+	uint actionID;
+	return m_inputManager->findActionID(name, actionID) ? getKeybind(actionID) : 0;
+}
+
 void InputContext::removeKeybind(Keybind *keybind)
 {
-	for(map<string, Keybind*>::iterator itr = m_keybinds.begin(); itr != m_keybinds.end(); itr++)
+	vector<Keybind*>::iterator itr = find(m_keybinds.begin(), m_keybinds.end(), keybind);
+	if(keybind && itr != m_keybinds.end())
 	{
-		if(itr->second == keybind)
-		{
-			m_keybinds.erase(itr);
-			break;
-		}
+		*itr = 0;
+		m_inputManager->invalidateKeybinds();
 	}
 }
 
 void InputContext::removeKeybind(const string &name)
 {
-	map<string, Keybind*>::iterator itr;
-	if((itr = m_keybinds.find(name)) != m_keybinds.end())
+	uint actionID;
+	if(m_inputManager->findActionID(name, actionID) && actionID < m_keybinds.size() && m_keybinds[actionID])
 	{
-		m_keybinds.erase(itr);
+		m_keybinds[actionID] = 0;
+		m_inputManager->invalidateKeybinds();
 	}
 }
 
-bool InputContext::getKeyState(string name) const
+bool InputContext::getKeyState(const string &name) const
 {
-	map<string, Keybind*>::const_iterator itr;
-	if((itr = m_keybinds.find(name)) == m_keybinds.end())
-	{
-		return false;
-	}
-	return m_inputManager->getKeyState(itr->second->getInputButton());
+	// Names that were never bound are unbound, don't intern them
+	uint actionID;
+	return m_inputManager->findActionID(name, actionID) && getKeyState(actionID);
 }
 
-void InputContext::updateKeybinds(InputEvent *e)
+bool InputContext::getKeyState(const uint actionID) const
 {
-	for(map<string, Keybind*>::iterator itr = m_keybinds.begin(); itr != m_keybinds.end(); ++itr)
-	{
-		Keybind* kb = itr->second;
-		if(kb->getInputButton() == e->getInputButton() && kb->getFunction())
-		{
-			kb->getFunction()(e);
-		}
-	}
+	Keybind *keybind = getKeybind(actionID);
+	return keybind && m_inputManager->getKeyState(keybind->getInputButton());
 }
 
 END_SAUCE_NAMESPACE
@@ -17,14 +17,22 @@
 BEGIN_SAUCE_NAMESPACE
 
 InputManager::InputManager(string contextFile) :
-	m_context(0),
+	m_mouseButtonStates(0),
+	m_recording(nullptr),
 	m_x(0),
 	m_y(0),
+	m_context(0),
+	m_keybindTableDirty(true),
 	m_defaultController(0),
+	m_defaultControllerID(-1),
 	m_leftTrigger(false),
 	m_rightTrigger(false),
 	m_triggerThreshold(0.7)
 {
+	memset(m_keyStates, 0, sizeof(m_keyStates));
+	memset(m_controllerButtonStates, 0, sizeof(m_controllerButtonStates));
+	memset(m_controllerAxisValues, 0, sizeof(m_controllerAxisValues));
+
 	// Set all str to key mappings
 	m_strToKey["space"] = SAUCE_SCANCODE_SPACE;
 	m_strToKey["quote"] = m_strToKey["apostrophe"] = SAUCE_SCANCODE_APOSTROPHE;
@@ -174,11 +182,11 @@ InputManager::InputManager(string contextFile) :
 	m_strToKey["controller_axis_trigger_right"] = SAUCE_CONTROLLER_AXIS_TRIGGER_RIGHT;
 
 	// Load input config file
-	if(util::fileExists(contextFile))
+	string contextFileContent;
+	if(util::readFile(contextFile, contextFileContent))
 	{
 		tinyxml2::XMLDocument doc;
-		util::toAbsoluteFilePath(contextFile);
-		doc.LoadFile(contextFile.c_str());
+		doc.Parse(contextFileContent.c_str(), contextFileContent.size());
 
 		// Get root node
 		tinyxml2::XMLNode *contextNode = doc.FirstChildElement();
@@ -225,6 +233,8 @@ InputManager::InputManager(string contextFile) :
 
 InputManager::~InputManager()
 {
+	stopRecording();
+
 	for(Keybind *kb : m_contextKeybinds)
 	{
 		delete kb;
@@ -256,7 +266,7 @@ Sint32 InputManager::getY() const
 InputButton InputManager::toInputButton(string name) const
 {
 	transform(name.begin(), name.end(), name.begin(), ::tolower);
-	map<string, InputButton>::const_iterator itr;
+	unordered_map<string, InputButton>::const_iterator itr;
 	if((itr = m_strToKey.find(name)) != m_strToKey.end())
 	{
 		return itr->second;
@@ -264,9 +274,29 @@ InputButton InputManager::toInputButton(string name) const
 	return SAUCE_SCANCODE_UNKNOWN;
 }
 
+uint InputManager::getActionID(const string &name)
+{
+	return m_actionIDs.insert(make_pair(name, (uint)m_actionIDs.size())).first->second;
+}
+
+bool InputManager::findActionID(const string &name, uint &actionID) const
+{
+	unordered_map<string, uint>::const_iterator itr = m_actionIDs.find(name);
+	if(itr == m_actionIDs.end())
+	{
+		return false;
+	}
+	actionID = itr->second;
+	return true;
+}
+
 void InputManager::setContext(InputContext *inputContext)
 {
-	m_context = inputContext;
+	if(inputContext != m_context)
+	{
+		m_context = inputContext;
+		invalidateKeybinds();
+	}
 }
 
 InputContext *InputManager::getContextByName(const string &name)
@@ -292,11 +322,14 @@ void InputManager::setClipboardString(const string str)
 void InputManager::addKeybind(Keybind *keybind)
 {
 	m_keybinds.push_back(keybind);
+	keybind->m_inputManager = this;
+	invalidateKeybinds();
 }
 
 void InputManager::removeKeybind(Keybind *keybind)
 {
 	m_keybinds.remove(keybind);
+	invalidateKeybinds();
 }
 
 void InputManager::addController(const uint id)
@@ -315,6 +348,7 @@ void InputManager::addController(const uint id)
 		if(!m_defaultController)
 		{
 			m_defaultController = controller;
+			setDefaultControllerID(joyId);
 		}
 	}
 }
@@ -331,29 +365,122 @@ void InputManager::removeController(const uint joyId)
 	if(controller == m_defaultController)
 	{
 		m_defaultController = m_controllers.empty() ? 0 : m_controllers.begin()->second;
+		setDefaultControllerID(m_controllers.empty() ? -1 : m_controllers.begin()->first);
 	}
 
 	// Close controller
 	SDL_GameControllerClose(controller);
 }
 
-void InputManager::updateKeybinds(InputEvent *e)
+void InputManager::setDefaultControllerID(const SDL_JoystickID joyId)
 {
-	//if(m_game->isEnabled(SAUCE_BLOCK_BACKGROUND_INPUT) && !m_game->getWindow()->checkFlags(SDL_WINDOW_INPUT_FOCUS)) return;
+	if(joyId == m_defaultControllerID) return;
+
+	// Buttons held on the previous pad should not stay pressed
+	m_defaultControllerID = joyId;
+	memset(m_controllerButtonStates, 0, sizeof(m_controllerButtonStates));
+	memset(m_controllerAxisValues, 0, sizeof(m_controllerAxisValues));
+}
 
-	// Update keybinds
-	for(Keybind *kb : m_keybinds)
+bool InputManager::isDefaultControllerEvent(const SDL_JoystickID joyId)
+{
+	// Without a connected pad, scripted input drives the states of the first pad it mentions
+	if(!m_defaultController && m_defaultControllerID < 0)
 	{
-		if(kb->getInputButton() == e->getInputButton() && kb->getFunction())
+		m_defaultControllerID = joyId;
+	}
+	return joyId == m_defaultControllerID;
+}
+
+// Keybind table slots: scancodes, then mouse buttons, controller buttons and controller axes
+static const int KEYBIND_SLOT_MOUSE = SDL_NUM_SCANCODES;
+static const int KEYBIND_SLOT_CONTROLLER_BUTTON = KEYBIND_SLOT_MOUSE + SAUCE_MOUSE_BUTTON_X2 + 1;
+static const int KEYBIND_SLOT_CONTROLLER_AXIS = KEYBIND_SLOT_CONTROLLER_BUTTON + SAUCE_CONTROLLER_BUTTON_RIGHT_TRIGGER + 1;
+static const int KEYBIND_SLOT_COUNT = KEYBIND_SLOT_CONTROLLER_AXIS + SAUCE_CONTROLLER_AXIS_MAX;
+
+int InputManager::getKeybindSlot(const InputButton inputButton)
+{
+	const uint code = inputButton.getCode();
+	switch(inputButton.getType())
+	{
+		case InputButtonType::Keyboard: return code < SDL_NUM_SCANCODES ? code : -1;
+		case InputButtonType::Mouse: return code <= SAUCE_MOUSE_BUTTON_X2 ? KEYBIND_SLOT_MOUSE + code : -1;
+		case InputButtonType::ControllerButton: return code <= SAUCE_CONTROLLER_BUTTON_RIGHT_TRIGGER ? KEYBIND_SLOT_CONTROLLER_BUTTON + code : -1;
+		case InputButtonType::ControllerAxis: return code < SAUCE_CONTROLLER_AXIS_MAX ? KEYBIND_SLOT_CONTROLLER_AXIS + code : -1;
+	}
+	return -1;
+}
+
+void InputManager::rebuildKeybindTable()
+{
+	// Manager keybinds are dispatched before the keybinds of the current context
+	vector<Keybind*> keybinds(m_keybinds.begin(), m_keybinds.end());
+	if(m_context)
+	{
+		for(Keybind *kb : m_context->m_keybinds)
 		{
-			kb->getFunction()(e);
+			if(kb)
+			{
+				keybinds.push_back(kb);
+			}
 		}
 	}
 
-	// Update keybinds of current context
-	if(m_context)
+	// Counting sort by slot, which keeps the dispatch order within a slot
+	m_keybindTableOffsets.assign(KEYBIND_SLOT_COUNT + 1, 0);
+	for(Keybind *kb : keybinds)
+	{
+		const int slot = getKeybindSlot(kb->getInputButton());
+		if(slot >= 0)
+		{
+			m_keybindTableOffsets[slot + 1]++;
+		}
+	}
+
+	for(int slot = 0; slot < KEYBIND_SLOT_COUNT; ++slot)
 	{
-		m_context->updateKeybinds(e);
+		m_keybindTableOffsets[slot + 1] += m_keybindTableOffsets[slot];
+	}
+
+	m_keybindTable.resize(m_keybindTableOffsets[KEYBIND_SLOT_COUNT]);
+	vector<uint> next(m_keybindTableOffsets.begin(), m_keybindTableOffsets.end() - 1);
+	for(Keybind *kb : keybinds)
+	{
+		const int slot = getKeybindSlot(kb->getInputButton());
+		if(slot >= 0)
+		{
+			m_keybindTable[next[slot]++] = kb;
+		}
+	}
+
+	m_keybindTableDirty = false;
+}
+
+void InputManager::updateKeybinds(InputEvent *e)
+{
+	//if(m_game->isEnabled(SAUCE_BLOCK_BACKGROUND_INPUT) && !m_game->getWindow()->checkFlags(SDL_WINDOW_INPUT_FOCUS)) return;
+
+	if(m_keybindTableDirty)
+	{
+		rebuildKeybindTable();
+	}
+
+	const int slot = getKeybindSlot(e->getInputButton());
+	if(slot < 0)
+	{
+		return;
+	}
+
+	// Keybind callbacks may change keybinds or the context. That only marks the
+	// table dirty, so the entries of this slot stay valid until we return.
+	const uint end = m_keybindTableOffsets[slot + 1];
+	for(uint i = m_keybindTableOffsets[slot]; i < end; ++i)
+	{
+		Keybind *kb = m_keybindTable[i];
+		if(kb->getFunction())
+		{
+			kb->getFunction()(e);
+		}
 	}
 }
 
@@ -362,13 +489,14 @@ bool InputManager::getKeyState(const InputButton inputButton, ControllerDevice *
 	//if(m_game->isEnabled(SAUCE_BLOCK_BACKGROUND_INPUT) && !m_game->getWindow()->checkFlags(SDL_WINDOW_INPUT_FOCUS)) return false;
 	switch(inputButton.getType())
 	{
-		case InputButtonType::Keyboard: return SDL_GetKeyboardState(NULL)[inputButton.getCode()];
-		case InputButtonType::Mouse: return (SDL_GetMouseState(NULL, NULL) & SDL_BUTTON(inputButton.getCode())) != 0;
+		case InputButtonType::Keyboard: return inputButton.getCode() < SDL_NUM_SCANCODES && m_keyStates[inputButton.getCode()];
+		case InputButtonType::Mouse: return (m_mouseButtonStates & SDL_BUTTON(inputButton.getCode())) != 0;
 		case InputButtonType::ControllerButton:
 		{
 			if(inputButton.getCode() == SAUCE_CONTROLLER_BUTTON_LEFT_TRIGGER) return m_leftTrigger/*[controller]*/;
 			else if(inputButton.getCode() == SAUCE_CONTROLLER_BUTTON_RIGHT_TRIGGER) return m_rightTrigger/*[controller]*/;
-			else return SDL_GameControllerGetButton(static_cast<SDL_GameController*>(controller ? controller : m_defaultController), (SDL_GameControllerButton)inputButton.getCode()) != 0;
+			else if(!controller) return inputButton.getCode() < SDL_CONTROLLER_BUTTON_MAX && m_controllerButtonStates[inputButton.getCode()];
+			else return SDL_GameControllerGetButton(static_cast<SDL_GameController*>(controller), (SDL_GameControllerButton)inputButton.getCode()) != 0;
 		}
 		case InputButtonType::ControllerAxis: return getAxisValue((const ControllerAxis)inputButton.getCode(), controller) > m_triggerThreshold;
 	}
@@ -382,19 +510,98 @@ bool InputManager::getButtonState(const InputButton inputButton, ControllerDevic
 
 float InputManager::getAxisValue(const ControllerAxis axis, ControllerDevice *controller) const
 {
-	return AXIS_VALUE_TO_FLOAT(SDL_GameControllerGetAxis(static_cast<SDL_GameController*>(controller ? controller : m_defaultController), (SDL_GameControllerAxis)axis));
+	if(!controller)
+	{
+		return (uint32)axis < SDL_CONTROLLER_AXIS_MAX ? AXIS_VALUE_TO_FLOAT(m_controllerAxisValues[axis]) : 0.0f;
+	}
+	return AXIS_VALUE_TO_FLOAT(SDL_GameControllerGetAxis(static_cast<SDL_GameController*>(controller), (SDL_GameControllerAxis)axis));
+}
+
+void InputManager::processEvent(const uint64 tick, const SDL_Event &event)
+{
+	switch(event.type)
+	{
+		case SDL_KEYDOWN: case SDL_KEYUP:
+		{
+			if(event.key.keysym.scancode < SDL_NUM_SCANCODES)
+			{
+				m_keyStates[event.key.keysym.scancode] = event.type == SDL_KEYDOWN;
+			}
+		}
+		break;
+
+		case SDL_MOUSEBUTTONDOWN: m_mouseButtonStates |= SDL_BUTTON(event.button.button); break;
+		case SDL_MOUSEBUTTONUP: m_mouseButtonStates &= ~SDL_BUTTON(event.button.button); break;
+
+		case SDL_CONTROLLERBUTTONDOWN: case SDL_CONTROLLERBUTTONUP:
+		{
+			if(event.cbutton.button < SDL_CONTROLLER_BUTTON_MAX && isDefaultControllerEvent(event.cbutton.which))
+			{
+				m_controllerButtonStates[event.cbutton.button] = event.type == SDL_CONTROLLERBUTTONDOWN;
+			}
+		}
+		break;
+
+		case SDL_CONTROLLERAXISMOTION:
+		{
+			if(event.caxis.axis < SDL_CONTROLLER_AXIS_MAX && isDefaultControllerEvent(event.caxis.which))
+			{
+				m_controllerAxisValues[event.caxis.axis] = event.caxis.value;
+			}
+		}
+		break;
+	}
+
+	if(m_recording)
+	{
+		m_recording->addEvent(tick, event);
+	}
+}
+
+void InputManager::startRecording(const string &filePath)
+{
+	stopRecording();
+	m_recording = new InputScript();
+	m_recordingFilePath = filePath;
+	LOG("Recording input to \"%s\"", filePath.c_str());
+}
+
+void InputManager::stopRecording()
+{
+	if(!m_recording)
+	{
+		return;
+	}
+
+	if(m_recording->save(m_recordingFilePath))
+	{
+		LOG("Saved %i recorded input events to \"%s\"", (int)m_recording->getEventCount(), m_recordingFilePath.c_str());
+	}
+	delete m_recording;
+	m_recording = nullptr;
 }
 
 Keybind::Keybind() :
 	m_inputButton(),
-	m_function()
+	m_function(),
+	m_inputManager(0)
 {
 }
 
 Keybind::Keybind(InputButton inputButton, function<void(InputEvent*)> func, const uint flags) :
 	m_inputButton(inputButton),
-	m_function(func)
+	m_function(func),
+	m_inputManager(0)
+{
+}
+
+void Keybind::setInputButton(const InputButton inputButton)
 {
+	m_inputButton = inputButton;
+	if(m_inputManager)
+	{
+		m_inputManager->invalidateKeybinds();
+	}
 }
 
 /*Keycode Keybind::getKeycode() const
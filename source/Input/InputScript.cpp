@@ -0,0 +1,403 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+#include <Sauce/Input.h>
+#include <Sauce/Utils.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+// Event types are stored as an index into this table
+static const Uint32 g_inputEventTypes[] =
+{
+	SDL_KEYDOWN,
+	SDL_KEYUP,
+	SDL_TEXTINPUT,
+	SDL_MOUSEMOTION,
+	SDL_MOUSEBUTTONDOWN,
+	SDL_MOUSEBUTTONUP,
+	SDL_MOUSEWHEEL,
+	SDL_CONTROLLERAXISMOTION,
+	SDL_CONTROLLERBUTTONDOWN,
+	SDL_CONTROLLERBUTTONUP
+};
+static const uint8 g_inputEventTypeCount = sizeof(g_inputEventTypes) / sizeof(Uint32);
+
+static uint8 GetInputEventTypeIndex(const Uint32 eventType)
+{
+	for(uint8 i = 0; i < g_inputEventTypeCount; ++i)
+	{
+		if(g_inputEventTypes[i] == eventType)
+		{
+			return i;
+		}
+	}
+	return g_inputEventTypeCount;
+}
+
+// LEB128 encoding. Signed values are zigzag encoded so that small negative numbers stay small.
+static void WriteVarint(vector<uint8>& buffer, uint64 value)
+{
+	while(value >= 0x80)
+	{
+		buffer.push_back((uint8)(value | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back((uint8)value);
+}
+
+static void WriteSignedVarint(vector<uint8>& buffer, const int64 value)
+{
+	WriteVarint(buffer, ((uint64)value << 1) ^ (uint64)(value >> 63));
+}
+
+static bool ReadVarint(const vector<uint8>& buffer, size_t& offset, uint64& outValue)
+{
+	outValue = 0;
+	for(uint32 shift = 0; shift < 64 && offset < buffer.size(); shift += 7)
+	{
+		const uint8 byte = buffer[offset++];
+		outValue |= (uint64)(byte & 0x7F) << shift;
+		if((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool ReadSignedVarint(const vector<uint8>& buffer, size_t& offset, int64& outValue)
+{
+	uint64 value;
+	if(!ReadVarint(buffer, offset, value))
+	{
+		return false;
+	}
+	outValue = (int64)(value >> 1) ^ -(int64)(value & 1);
+	return true;
+}
+
+InputScript::InputScript() :
+	m_nextEvent(0)
+{
+}
+
+bool InputScript::IsInputEvent(const Uint32 eventType)
+{
+	return GetInputEventTypeIndex(eventType) < g_inputEventTypeCount;
+}
+
+void InputScript::addEvent(const uint64 tick, const SDL_Event& event)
+{
+	if(!IsInputEvent(event.type))
+	{
+		return;
+	}
+
+	// Keep events sorted by tick, after any events already on the same tick
+	ScriptedEvent scriptedEvent;
+	scriptedEvent.tick = tick;
+	scriptedEvent.event = event;
+	const vector<ScriptedEvent>::iterator itr = upper_bound(m_events.begin(), m_events.end(), tick,
+		[](const uint64 tick, const ScriptedEvent& scriptedEvent) { return tick < scriptedEvent.tick; });
+	m_events.insert(itr, scriptedEvent);
+}
+
+void InputScript::addKey(const uint64 tick, const Scancode scancode, const bool pressed)
+{
+	SDL_Event event;
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = pressed ? SDL_KEYDOWN : SDL_KEYUP;
+	event.key.state = pressed ? SDL_PRESSED : SDL_RELEASED;
+	event.key.keysym.scancode = (SDL_Scancode)scancode;
+	event.key.keysym.sym = SDL_GetKeyFromScancode((SDL_Scancode)scancode);
+	addEvent(tick, event);
+}
+
+void InputScript::addMouseButton(const uint64 tick, const MouseButton button, const bool pressed, const int32 x, const int32 y)
+{
+	SDL_Event event;
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = pressed ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+	event.button.button = (Uint8)button;
+	event.button.state = pressed ? SDL_PRESSED : SDL_RELEASED;
+	event.button.clicks = 1;
+	event.button.x = x;
+	event.button.y = y;
+	addEvent(tick, event);
+}
+
+void InputScript::addMouseMove(const uint64 tick, const int32 x, const int32 y)
+{
+	SDL_Event event;
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = SDL_MOUSEMOTION;
+	event.motion.x = x;
+	event.motion.y = y;
+	addEvent(tick, event);
+}
+
+void InputScript::addMouseWheel(const uint64 tick, const int32 dx, const int32 dy)
+{
+	SDL_Event event;
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = SDL_MOUSEWHEEL;
+	event.wheel.x = dx;
+	event.wheel.y = dy;
+	addEvent(tick, event);
+}
+
+void InputScript::addText(const uint64 tick, const char character)
+{
+	SDL_Event event;
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = SDL_TEXTINPUT;
+	event.text.text[0] = character;
+	addEvent(tick, event);
+}
+
+void InputScript::pushEvents(const uint64 tick)
+{
+	for(; m_nextEvent < m_events.size() && m_events[m_nextEvent].tick <= tick; ++m_nextEvent)
+	{
+		SDL_Event event = m_events[m_nextEvent].event;
+		if(SDL_PushEvent(&event) < 0)
+		{
+			LOG("Failed to push scripted input event (%s)", SDL_GetError());
+		}
+	}
+}
+
+void InputScript::clear()
+{
+	m_events.clear();
+	m_nextEvent = 0;
+}
+
+bool InputScript::save(const string& filePath) const
+{
+	vector<uint8> buffer;
+	buffer.reserve(m_events.size() * 8);
+	uint64 prevTick = 0;
+	for(const ScriptedEvent& scriptedEvent : m_events)
+	{
+		const SDL_Event& event = scriptedEvent.event;
+		WriteVarint(buffer, scriptedEvent.tick - prevTick);
+		buffer.push_back(GetInputEventTypeIndex(event.type));
+		prevTick = scriptedEvent.tick;
+
+		switch(event.type)
+		{
+			case SDL_KEYDOWN: case SDL_KEYUP:
+			{
+				WriteVarint(buffer, event.key.keysym.scancode);
+				WriteVarint(buffer, event.key.keysym.mod);
+				buffer.push_back(event.key.repeat);
+			}
+			break;
+
+			case SDL_TEXTINPUT:
+			{
+				const uint8 length = (uint8)strnlen(event.text.text, SDL_TEXTINPUTEVENT_TEXT_SIZE - 1);
+				buffer.push_back(length);
+				buffer.insert(buffer.end(), event.text.text, event.text.text + length);
+			}
+			break;
+
+			case SDL_MOUSEMOTION:
+			{
+				WriteSignedVarint(buffer, event.motion.x);
+				WriteSignedVarint(buffer, event.motion.y);
+			}
+			break;
+
+			case SDL_MOUSEBUTTONDOWN: case SDL_MOUSEBUTTONUP:
+			{
+				buffer.push_back(event.button.button);
+				buffer.push_back(event.button.clicks);
+				WriteSignedVarint(buffer, event.button.x);
+				WriteSignedVarint(buffer, event.button.y);
+			}
+			break;
+
+			case SDL_MOUSEWHEEL:
+			{
+				WriteSignedVarint(buffer, event.wheel.x);
+				WriteSignedVarint(buffer, event.wheel.y);
+			}
+			break;
+
+			case SDL_CONTROLLERAXISMOTION:
+			{
+				buffer.push_back(event.caxis.axis);
+				WriteSignedVarint(buffer, event.caxis.value);
+			}
+			break;
+
+			case SDL_CONTROLLERBUTTONDOWN: case SDL_CONTROLLERBUTTONUP:
+			{
+				buffer.push_back(event.cbutton.button);
+			}
+			break;
+		}
+	}
+
+	ByteStreamOut fileStream(filePath, FileVersion);
+	if(!fileStream)
+	{
+		LOG("Could not open input script \"%s\" for writing", filePath.c_str());
+		return false;
+	}
+	fileStream << (uint64)m_events.size();
+	fileStream << buffer;
+	fileStream.close();
+	return true;
+}
+
+bool InputScript::load(const string& filePath)
+{
+	clear();
+
+	uint64 eventCount = 0;
+	vector<uint8> buffer;
+	{
+		ByteStreamIn fileStream(filePath, FileVersion);
+		fileStream >> eventCount;
+		fileStream >> buffer;
+		if(!fileStream)
+		{
+			LOG("Could not read input script \"%s\"", filePath.c_str());
+			return false;
+		}
+	}
+
+	m_events.reserve((size_t)eventCount);
+	size_t offset = 0;
+	uint64 tick = 0;
+	for(uint64 i = 0; i < eventCount; ++i)
+	{
+		uint64 tickDelta;
+		if(!ReadVarint(buffer, offset, tickDelta) || offset >= buffer.size() || buffer[offset] >= g_inputEventTypeCount)
+		{
+			break;
+		}
+		tick += tickDelta;
+
+		ScriptedEvent scriptedEvent;
+		scriptedEvent.tick = tick;
+		SDL_Event& event = scriptedEvent.event;
+		memset(&event, 0, sizeof(SDL_Event));
+		event.type = g_inputEventTypes[buffer[offset++]];
+
+		bool valid = true;
+		uint64 value0 = 0, value1 = 0;
+		int64 signed0 = 0, signed1 = 0;
+		switch(event.type)
+		{
+			case SDL_KEYDOWN: case SDL_KEYUP:
+			{
+				valid = ReadVarint(buffer, offset, value0) && ReadVarint(buffer, offset, value1) && offset < buffer.size();
+				if(valid)
+				{
+					event.key.state = event.type == SDL_KEYDOWN ? SDL_PRESSED : SDL_RELEASED;
+					event.key.keysym.scancode = (SDL_Scancode)value0;
+					event.key.keysym.sym = SDL_GetKeyFromScancode((SDL_Scancode)value0);
+					event.key.keysym.mod = (Uint16)value1;
+					event.key.repeat = buffer[offset++];
+				}
+			}
+			break;
+
+			case SDL_TEXTINPUT:
+			{
+				const uint8 length = offset < buffer.size() ? buffer[offset++] : 0;
+				valid = length < SDL_TEXTINPUTEVENT_TEXT_SIZE && offset + length <= buffer.size();
+				if(valid)
+				{
+					memcpy(event.text.text, buffer.data() + offset, length);
+					offset += length;
+				}
+			}
+			break;
+
+			case SDL_MOUSEMOTION:
+			{
+				valid = ReadSignedVarint(buffer, offset, signed0) && ReadSignedVarint(buffer, offset, signed1);
+				event.motion.x = (Sint32)signed0;
+				event.motion.y = (Sint32)signed1;
+			}
+			break;
+
+			case SDL_MOUSEBUTTONDOWN: case SDL_MOUSEBUTTONUP:
+			{
+				valid = offset + 2 <= buffer.size();
+				if(valid)
+				{
+					event.button.button = buffer[offset++];
+					event.button.clicks = buffer[offset++];
+					event.button.state = event.type == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+					valid = ReadSignedVarint(buffer, offset, signed0) && ReadSignedVarint(buffer, offset, signed1);
+					event.button.x = (Sint32)signed0;
+					event.button.y = (Sint32)signed1;
+				}
+			}
+			break;
+
+			case SDL_MOUSEWHEEL:
+			{
+				valid = ReadSignedVarint(buffer, offset, signed0) && ReadSignedVarint(buffer, offset, signed1);
+				event.wheel.x = (Sint32)signed0;
+				event.wheel.y = (Sint32)signed1;
+			}
+			break;
+
+			case SDL_CONTROLLERAXISMOTION:
+			{
+				valid = offset < buffer.size();
+				if(valid)
+				{
+					event.caxis.axis = buffer[offset++];
+					valid = ReadSignedVarint(buffer, offset, signed0);
+					event.caxis.value = (Sint16)signed0;
+				}
+			}
+			break;
+
+			case SDL_CONTROLLERBUTTONDOWN: case SDL_CONTROLLERBUTTONUP:
+			{
+				valid = offset < buffer.size();
+				if(valid)
+				{
+					event.cbutton.button = buffer[offset++];
+					event.cbutton.state = event.type == SDL_CONTROLLERBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+				}
+			}
+			break;
+		}
+
+		if(!valid)
+		{
+			break;
+		}
+		m_events.push_back(scriptedEvent);
+	}
+
+	if(m_events.size() != eventCount)
+	{
+		LOG("Input script \"%s\" is truncated (read %i of %i events)", filePath.c_str(), (int)m_events.size(), (int)eventCount);
+		clear();
+		return false;
+	}
+	return true;
+}
+
+END_SAUCE_NAMESPACE
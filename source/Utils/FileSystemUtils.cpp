@@ -22,6 +22,11 @@
 #include <direct.h>
 #else
 #include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include "..\..\include\Sauce\Utils\MiscUtils.h"
 #define MAX_PATH 1024
 #endif
@@ -69,10 +74,41 @@ namespace util
 
 	bool fileExists(string filePath)
 	{
-		ifstream s(getAbsoluteFilePath(filePath).c_str());
-		bool open = s.is_open();
-		s.close();
-		return open;
+		// Check mounted pack files before touching the file system
+		FileSpan fileSpan;
+		if (findInPackFiles(filePath, fileSpan))
+		{
+			return true;
+		}
+
+#ifdef SAUCE_COMPILE_WINDOWS
+		const DWORD attributes = GetFileAttributesA(getAbsoluteFilePath(filePath).c_str());
+		return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0;
+#else
+		struct stat fileStat;
+		return stat(getAbsoluteFilePath(filePath).c_str(), &fileStat) == 0 && !S_ISDIR(fileStat.st_mode);
+#endif
+	}
+
+	bool readFile(const string& assetPath, string& outContent)
+	{
+		FileSpan fileSpan;
+		if (findInPackFiles(assetPath, fileSpan))
+		{
+			outContent.assign((const char*)fileSpan.data, (size_t)fileSpan.size);
+			return true;
+		}
+
+		ifstream fileStream(getAbsoluteFilePath(assetPath), ifstream::binary);
+		if (!fileStream)
+		{
+			return false;
+		}
+
+		stringstream ss;
+		ss << fileStream.rdbuf();
+		outContent = ss.str();
+		return true;
 	}
 
 	std::string FileMD5(const std::string& fileName)
@@ -93,45 +129,314 @@ namespace util
 		return "INVALID_MD5";
 	}
 
+#ifdef SAUCE_COMPILE_WINDOWS
+	// Converts a FILETIME (100 ns intervals since 1601-01-01) to nanoseconds since the Unix epoch
+	static int64 fileTimeToUnixNanoseconds(const FILETIME& fileTime)
+	{
+		const int64 intervals = (int64)(((uint64)fileTime.dwHighDateTime << 32) | fileTime.dwLowDateTime);
+		return (intervals - 116444736000000000LL) * 100;
+	}
+#endif
+
+	bool getFileMetadata(const string& filePath, FileMetadata& outMetadata)
+	{
+		const string absoluteFilePath = getAbsoluteFilePath(filePath);
+#ifdef SAUCE_COMPILE_WINDOWS
+		const HANDLE fileHandle = CreateFileA(absoluteFilePath.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		BY_HANDLE_FILE_INFORMATION fileInfo;
+		const bool success = GetFileInformationByHandle(fileHandle, &fileInfo) != 0;
+		CloseHandle(fileHandle);
+		if (!success)
+		{
+			return false;
+		}
+
+		outMetadata.size = ((uint64)fileInfo.nFileSizeHigh << 32) | fileInfo.nFileSizeLow;
+		outMetadata.modifiedTime = fileTimeToUnixNanoseconds(fileInfo.ftLastWriteTime);
+		outMetadata.fileId = ((uint64)fileInfo.nFileIndexHigh << 32) | fileInfo.nFileIndexLow;
+#else
+		struct stat fileStat;
+		if (stat(absoluteFilePath.c_str(), &fileStat) != 0)
+		{
+			return false;
+		}
+
+		outMetadata.size = fileStat.st_size;
+		outMetadata.modifiedTime = (int64)fileStat.st_mtim.tv_sec * 1000000000LL + fileStat.st_mtim.tv_nsec;
+		outMetadata.fileId = fileStat.st_ino;
+#endif
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	// File hash cache
+	//--------------------------------------------------------------
+	FileHashCache::FileHashCache()
+		: m_dirty(false)
+	{
+	}
+
+	bool FileHashCache::load(const string& indexFilePath)
+	{
+		m_entries.clear();
+		m_dirty = false;
+
+		if (!fileExists(indexFilePath))
+		{
+			return false;
+		}
+
+		ByteStreamIn fileStream(indexFilePath, Version);
+		if (!fileStream)
+		{
+			return false;
+		}
+
+		uint64 entryCount = 0;
+		fileStream >> entryCount;
+		for (uint64 i = 0; i < entryCount && fileStream; ++i)
+		{
+			string filePath;
+			Entry entry;
+			fileStream >> filePath >> entry.metadata.size >> entry.metadata.modifiedTime >> entry.metadata.fileId >> entry.contentHash;
+			m_entries[filePath] = entry;
+		}
+
+		if (!fileStream)
+		{
+			LOG("File hash index \"%s\" is corrupt, discarding it", indexFilePath.c_str());
+			m_entries.clear();
+			return false;
+		}
+		return true;
+	}
+
+	bool FileHashCache::save(const string& indexFilePath)
+	{
+		ByteStreamOut fileStream(indexFilePath, Version);
+		if (!fileStream)
+		{
+			return false;
+		}
+
+		fileStream << (uint64)m_entries.size();
+		for (const pair<const string, Entry>& entry : m_entries)
+		{
+			fileStream << entry.first << entry.second.metadata.size << entry.second.metadata.modifiedTime << entry.second.metadata.fileId << entry.second.contentHash;
+		}
+		fileStream.close();
+
+		m_dirty = false;
+		return true;
+	}
+
+	bool FileHashCache::getContentHash(const string& filePath, uint64& outHash)
+	{
+		FileMetadata metadata;
+		if (!getFileMetadata(filePath, metadata))
+		{
+			return false;
+		}
+
+		// Unchanged files are answered from the cache without reading them
+		const unordered_map<string, Entry>::iterator itr = m_entries.find(filePath);
+		if (itr != m_entries.end() && itr->second.metadata == metadata)
+		{
+			outHash = itr->second.contentHash;
+			return true;
+		}
+
+		Entry entry;
+		entry.metadata = metadata;
+		if (metadata.size > 0)
+		{
+			MappedFile mappedFile;
+			if (!mappedFile.open(getAbsoluteFilePath(filePath)))
+			{
+				return false;
+			}
+			entry.contentHash = XXH64(mappedFile.getData(), mappedFile.getSize());
+		}
+		else
+		{
+			entry.contentHash = XXH64(nullptr, 0);
+		}
+
+		m_entries[filePath] = entry;
+		m_dirty = true;
+		outHash = entry.contentHash;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	// Memory-mapped file
+	//--------------------------------------------------------------
+	MappedFile::MappedFile()
+		: m_data(nullptr)
+		, m_size(0)
+#ifdef SAUCE_COMPILE_WINDOWS
+		, m_fileHandle(INVALID_HANDLE_VALUE)
+		, m_mappingHandle(nullptr)
+#endif
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const string& filePath)
+	{
+		close();
+
+#ifdef SAUCE_COMPILE_WINDOWS
+		m_fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(m_fileHandle, &fileSize) && fileSize.QuadPart > 0)
+		{
+			m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (m_mappingHandle)
+			{
+				m_data = (const uint8*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+				m_size = fileSize.QuadPart;
+			}
+		}
+#else
+		const int fd = ::open(filePath.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+		{
+			void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED)
+			{
+				m_data = (const uint8*)data;
+				m_size = fileStat.st_size;
+			}
+		}
+
+		// The mapping keeps its own reference to the file
+		::close(fd);
+#endif
+
+		if (!m_data)
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+#ifdef SAUCE_COMPILE_WINDOWS
+		if (m_data)
+		{
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mappingHandle)
+		{
+			CloseHandle(m_mappingHandle);
+			m_mappingHandle = nullptr;
+		}
+		if (m_fileHandle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(m_fileHandle);
+			m_fileHandle = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (m_data)
+		{
+			munmap((void*)m_data, m_size);
+		}
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
+
 	//--------------------------------------------------------------
 	// File system iterator
 	//--------------------------------------------------------------
+	bool matchFileMask(const char* mask, const char* name)
+	{
+#ifdef SAUCE_COMPILE_WINDOWS
+		const auto equals = [](const char a, const char b) { return tolower((uint8)a) == tolower((uint8)b); };
+#else
+		const auto equals = [](const char a, const char b) { return a == b; };
+#endif
+
+		// Greedy wildcard match, backtracking to the last '*' on mismatch
+		const char* starMask = nullptr;
+		const char* starName = nullptr;
+		while (*name)
+		{
+			if (*mask == '*')
+			{
+				starMask = ++mask;
+				starName = name;
+			}
+			else if (*mask == '?' || (*mask && equals(*mask, *name)))
+			{
+				++mask;
+				++name;
+			}
+			else if (starMask)
+			{
+				mask = starMask;
+				name = ++starName;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		while (*mask == '*')
+		{
+			++mask;
+		}
+		return *mask == '\0';
+	}
+
 	FileSystemIterator::FileSystemIterator(const string& searchPath, const string& mask, const uint32 flags)
 		: m_searchPath(searchPath)
-		, m_searchMask(mask)
+		, m_searchMask(mask.empty() ? "*" : mask)
 		, m_searchFlags(flags)
-		, m_hFind(nullptr)
-		, m_fdata()
 	{
 	}
 
 	FileSystemIterator::~FileSystemIterator()
 	{
-		if (m_hFind)
+		while (!m_directoryStack.empty())
 		{
-			FindClose(m_hFind);
+			popDirectory();
 		}
 	}
 
 	FileSystemIterator::iterator FileSystemIterator::begin()
 	{
-		// Fix up path
-		string searchPath = m_searchPath;
-		toAbsoluteFilePath(searchPath);
-		toDirectoryPath(searchPath);
-		searchPath += m_searchMask; // Add search mask
-
-		// Find first file
-		m_fdata = WIN32_FIND_DATA();
-
-		if (m_hFind)
+		// Restart the traversal from the search path
+		while (!m_directoryStack.empty())
 		{
-			FindClose(m_hFind);
+			popDirectory();
 		}
-		m_hFind = FindFirstFile(searchPath.c_str(), &m_fdata);
-		
-		const bool isEnd = m_hFind == INVALID_HANDLE_VALUE;
-		if (isEnd)
+
+		if (!pushDirectory(m_searchPath))
 		{
 			return end();
 		}
@@ -144,35 +449,179 @@ namespace util
 		return iterator(*this, true);
 	}
 
-	FileSystemIterator::iterator& FileSystemIterator::iterator::operator++()
+	bool FileSystemIterator::pushDirectory(const string& name)
 	{
-		// Repeat until we've found a file/directory or until reached the end of the search
-		m_directoryOrFile = nullptr;
-		do 
+		OpenDirectory directory;
+		if (m_directoryStack.empty())
 		{
-			if (FindNextFile(m_fsitr.m_hFind, &m_fsitr.m_fdata) != 0)
+			directory.path = name;
+			while (directory.path.size() > 1 && (directory.path.back() == '/' || directory.path.back() == '\\'))
 			{
-				wchar_t filename[MAX_PATH];
-				mbstowcs_s(0, filename, m_fsitr.m_fdata.cFileName, 1024);
-				if (wcscmp(filename, L".") != 0 && wcscmp(filename, L"..") != 0)
+				directory.path.pop_back();
+			}
+		}
+		else
+		{
+			directory.path = m_directoryStack.back().path + "/" + name;
+		}
+
+#ifdef SAUCE_COMPILE_WINDOWS
+		// Search for everything and filter by mask ourselves, otherwise
+		// subdirectories not matching the mask could not be recursed into
+		directory.absolutePath = m_directoryStack.empty() ? getAbsoluteFilePath(directory.path) : m_directoryStack.back().absolutePath + "/" + name;
+		directory.findData = WIN32_FIND_DATA();
+		directory.findHandle = FindFirstFile((directory.absolutePath + "/*").c_str(), &directory.findData);
+		if (directory.findHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		directory.hasPendingEntry = true;
+#else
+		// Open subdirectories relative to their parent so the kernel does
+		// not have to resolve the full path again for every level
+		DIR* dirHandle = nullptr;
+		if (m_directoryStack.empty())
+		{
+			dirHandle = opendir(getAbsoluteFilePath(directory.path).c_str());
+		}
+		else
+		{
+			const int fd = openat(dirfd((DIR*)m_directoryStack.back().dirHandle), name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+			if (fd >= 0)
+			{
+				dirHandle = fdopendir(fd);
+				if (!dirHandle)
 				{
-					if ((m_fsitr.m_fdata.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 &&
-						m_fsitr.m_searchFlags & FileSystemIteratorFlag::IncludeDirectories)
-					{
-						m_directoryOrFile = new DirectoryOrFile(m_fsitr.m_fdata.cFileName, m_fsitr.m_searchPath, true);
-					}
-					else if (m_fsitr.m_searchFlags & FileSystemIteratorFlag::IncludeFiles)
-					{
-						m_directoryOrFile = new DirectoryOrFile(m_fsitr.m_fdata.cFileName, m_fsitr.m_searchPath, false);
-					}
+					::close(fd);
 				}
 			}
-			else
+		}
+		if (!dirHandle)
+		{
+			return false;
+		}
+		directory.dirHandle = dirHandle;
+#endif
+
+		m_directoryStack.push_back(move(directory));
+		return true;
+	}
+
+	void FileSystemIterator::popDirectory()
+	{
+#ifdef SAUCE_COMPILE_WINDOWS
+		FindClose(m_directoryStack.back().findHandle);
+#else
+		closedir((DIR*)m_directoryStack.back().dirHandle);
+#endif
+		m_directoryStack.pop_back();
+	}
+
+	bool FileSystemIterator::next(DirectoryOrFile& outDirectoryOrFile)
+	{
+		const bool includeDirectories = (m_searchFlags & FileSystemIteratorFlag::IncludeDirectories) != 0;
+		const bool includeFiles = (m_searchFlags & FileSystemIteratorFlag::IncludeFiles) != 0;
+		const bool recursive = (m_searchFlags & FileSystemIteratorFlag::Recursive) != 0;
+
+		while (!m_directoryStack.empty())
+		{
+			OpenDirectory& directory = m_directoryStack.back();
+
+#ifdef SAUCE_COMPILE_WINDOWS
+			// FindFirstFile/FindNextFile return the metadata with each entry
+			if (!directory.hasPendingEntry && FindNextFile(directory.findHandle, &directory.findData) == 0)
+			{
+				popDirectory();
+				continue;
+			}
+			directory.hasPendingEntry = false;
+
+			const WIN32_FIND_DATA& findData = directory.findData;
+			const char* name = findData.cFileName;
+			if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+			{
+				continue;
+			}
+
+			const bool isDirectory = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+			const bool isLink = (findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+			const bool matches = (isDirectory ? includeDirectories : includeFiles) && matchFileMask(m_searchMask.c_str(), name);
+			if (matches)
+			{
+				outDirectoryOrFile = DirectoryOrFile(name, directory.path, isDirectory,
+					isDirectory ? 0 : ((uint64)findData.nFileSizeHigh << 32) | findData.nFileSizeLow,
+					fileTimeToUnixNanoseconds(findData.ftLastWriteTime));
+			}
+#else
+			errno = 0;
+			const dirent* entry = readdir((DIR*)directory.dirHandle);
+			if (!entry)
+			{
+				if (errno != 0)
+				{
+					LOG("Error reading directory \"%s\": %s", directory.path.c_str(), strerror(errno));
+				}
+				popDirectory();
+				continue;
+			}
+
+			const char* name = entry->d_name;
+			if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+			{
+				continue;
+			}
+
+			// The entry type comes with the directory listing on most file
+			// systems, so entries that are filtered out cost no extra syscall
+			bool isDirectory = entry->d_type == DT_DIR;
+			bool isLink = entry->d_type == DT_LNK;
+			struct stat fileStat;
+			bool hasStat = false;
+			if (entry->d_type == DT_UNKNOWN)
 			{
-				m_isEnd = true;
+				hasStat = fstatat(dirfd((DIR*)directory.dirHandle), name, &fileStat, AT_SYMLINK_NOFOLLOW) == 0;
+				isDirectory = hasStat && S_ISDIR(fileStat.st_mode);
+				isLink = hasStat && S_ISLNK(fileStat.st_mode);
+			}
+			if (isLink)
+			{
+				// Report symbolic links as what they point to
+				hasStat = fstatat(dirfd((DIR*)directory.dirHandle), name, &fileStat, 0) == 0;
+				isDirectory = hasStat && S_ISDIR(fileStat.st_mode);
 			}
-		} while (!m_directoryOrFile && !m_isEnd);
 
+			const bool matches = (isDirectory ? includeDirectories : includeFiles) && matchFileMask(m_searchMask.c_str(), name);
+			if (matches)
+			{
+				// Size and mtime of matching entries, resolved relative to the open directory
+				if (!hasStat)
+				{
+					hasStat = fstatat(dirfd((DIR*)directory.dirHandle), name, &fileStat, 0) == 0;
+				}
+				outDirectoryOrFile = DirectoryOrFile(name, directory.path, isDirectory,
+					hasStat && !isDirectory ? (uint64)fileStat.st_size : 0,
+					hasStat ? (int64)fileStat.st_mtim.tv_sec * 1000000000LL + fileStat.st_mtim.tv_nsec : 0);
+			}
+#endif
+
+			// Descend after the directory itself has been reported (pre-order).
+			// Symbolic links are not followed to avoid cycles.
+			if (recursive && isDirectory && !isLink)
+			{
+				pushDirectory(name);
+			}
+
+			if (matches)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	FileSystemIterator::iterator& FileSystemIterator::iterator::operator++()
+	{
+		m_isEnd = !m_fsitr.next(m_directoryOrFile);
 		return *this;
 	}
 
@@ -182,11 +631,152 @@ namespace util
 		this->operator++();
 		return retval;
 	}
+}
+
+//--------------------------------------------------------------
+// ByteStreamOut
+//--------------------------------------------------------------
+ByteStreamOut::ByteStreamOut(const string& filePath, const uint32 version)
+	: m_fileStream(filePath, ofstream::binary)
+	, m_buffer(new uint8[BufferCapacity])
+	, m_bufferSize(0)
+{
+	m_header.magic = util::toLittleEndian(ByteStreamHeader::Magic);
+	m_header.byteOrderMark = ByteStreamHeader::ByteOrderMark;
+	m_header.formatVersion = util::toLittleEndian(ByteStreamHeader::FormatVersion);
+	m_header.userVersion = util::toLittleEndian(version);
+	m_header.payloadSize = 0;
+	m_header.checksum = 0;
+	m_header.reserved = 0;
+
+	// Reserve space for the header; it is rewritten with the final size and checksum in close()
+	m_fileStream.write((const char*)&m_header, sizeof(ByteStreamHeader));
+}
+
+ByteStreamOut::~ByteStreamOut()
+{
+	close();
+	delete[] m_buffer;
+}
 
-	DirectoryOrFile FileSystemIterator::iterator::operator*() const
+void ByteStreamOut::close()
+{
+	if (!m_fileStream.is_open())
+	{
+		return;
+	}
+
+	flush();
+
+	const ByteStreamHeader header = {
+		m_header.magic,
+		m_header.byteOrderMark,
+		m_header.formatVersion,
+		m_header.userVersion,
+		util::toLittleEndian(m_header.payloadSize),
+		util::toLittleEndian(m_header.checksum),
+		0
+	};
+	m_fileStream.seekp(0, ios::beg);
+	m_fileStream.write((const char*)&header, sizeof(ByteStreamHeader));
+	m_fileStream.close();
+}
+
+void ByteStreamOut::writeUnbuffered(const void* data, const uint64 size)
+{
+	flush();
+	if (size < BufferCapacity)
 	{
-		return *m_directoryOrFile;
+		memcpy(m_buffer, data, (size_t)size);
+		m_bufferSize = (uint32)size;
 	}
+	else
+	{
+		// Large blocks bypass the buffer entirely
+		m_header.checksum = util::CRC32(data, size, m_header.checksum);
+		m_header.payloadSize += size;
+		m_fileStream.write((const char*)data, size);
+	}
+}
+
+void ByteStreamOut::flush()
+{
+	if (m_bufferSize > 0)
+	{
+		m_header.checksum = util::CRC32(m_buffer, m_bufferSize, m_header.checksum);
+		m_header.payloadSize += m_bufferSize;
+		m_fileStream.write((const char*)m_buffer, m_bufferSize);
+		m_bufferSize = 0;
+	}
+}
+
+//--------------------------------------------------------------
+// ByteStreamIn
+//--------------------------------------------------------------
+ByteStreamIn::ByteStreamIn(const string& filePath, const uint32 version)
+	: m_data(nullptr)
+	, m_size(0)
+	, m_offset(0)
+{
+	util::FileSpan span;
+	if (!util::findInPackFiles(filePath, span) && m_mappedFile.open(util::getAbsoluteFilePath(filePath)))
+	{
+		span = m_mappedFile.getSpan();
+	}
+
+	if (span.isValid() && !validate(span, version))
+	{
+		LOG("Byte stream \"%s\" is corrupt or has an unexpected version", filePath.c_str());
+	}
+}
+
+ByteStreamIn::ByteStreamIn(const util::FileSpan& span, const uint32 version)
+	: m_data(nullptr)
+	, m_size(0)
+	, m_offset(0)
+{
+	if (span.isValid())
+	{
+		validate(span, version);
+	}
+}
+
+void ByteStreamIn::close()
+{
+	m_data = nullptr;
+	m_size = 0;
+	m_offset = 0;
+	m_mappedFile.close();
+}
+
+bool ByteStreamIn::validate(const util::FileSpan& span, const uint32 version)
+{
+	if (span.size < sizeof(ByteStreamHeader))
+	{
+		close();
+		return false;
+	}
+
+	ByteStreamHeader header;
+	memcpy(&header, span.data, sizeof(ByteStreamHeader));
+	const uint8* payload = span.data + sizeof(ByteStreamHeader);
+	const uint64 payloadSize = util::toLittleEndian(header.payloadSize);
+
+	if (util::toLittleEndian(header.magic) != ByteStreamHeader::Magic ||
+		header.byteOrderMark != ByteStreamHeader::ByteOrderMark ||
+		util::toLittleEndian(header.formatVersion) != ByteStreamHeader::FormatVersion ||
+		util::toLittleEndian(header.userVersion) != version ||
+		payloadSize != span.size - sizeof(ByteStreamHeader) ||
+		util::CRC32(payload, payloadSize) != util::toLittleEndian(header.checksum))
+	{
+		close();
+		return false;
+	}
+
+	m_data = payload;
+	m_size = payloadSize;
+	m_offset = 0;
+	return true;
 }
 
 END_SAUCE_NAMESPACE
@@ -11,6 +11,7 @@
 // Distributed under the MIT license
 
 #include <Sauce/Utils/MiscUtils.h>
+#include <Sauce/Utils/FileSystemUtils.h>
 #include <sstream>
 #include <fstream>
 
@@ -317,6 +318,113 @@ std::string util::ByteArrayMD5(const std::string& str)
 	return md5(str);
 }
 
+uint32 util::CRC32(const void* data, const uint64 size, const uint32 crc)
+{
+	// Lookup table for the reflected 0xEDB88320 polynomial
+	static const vector<uint32> crcTable = []()
+	{
+		vector<uint32> table(256);
+		for(uint32 i = 0; i < 256; ++i)
+		{
+			uint32 value = i;
+			for(int j = 0; j < 8; ++j)
+			{
+				value = (value & 1) ? (value >> 1) ^ 0xEDB88320 : value >> 1;
+			}
+			table[i] = value;
+		}
+		return table;
+	}();
+
+	const uint8* bytes = (const uint8*)data;
+	uint32 value = ~crc;
+	for(uint64 i = 0; i < size; ++i)
+	{
+		value = crcTable[(value ^ bytes[i]) & 0xFF] ^ (value >> 8);
+	}
+	return ~value;
+}
+
+uint64 util::XXH64(const void* data, const uint64 size, const uint64 seed)
+{
+	static const uint64 prime1 = 11400714785074694791ULL;
+	static const uint64 prime2 = 14029467366897019727ULL;
+	static const uint64 prime3 = 1609587929392839161ULL;
+	static const uint64 prime4 = 9650029242287828579ULL;
+	static const uint64 prime5 = 2870177450012600261ULL;
+
+	const auto rotateLeft = [](const uint64 value, const int bits) { return (value << bits) | (value >> (64 - bits)); };
+	const auto read64 = [](const uint8* bytes) { uint64 value; memcpy(&value, bytes, sizeof(uint64)); return toLittleEndian(value); };
+	const auto read32 = [](const uint8* bytes) { uint32 value; memcpy(&value, bytes, sizeof(uint32)); return toLittleEndian(value); };
+	const auto round = [&](uint64 accumulator, const uint64 input)
+	{
+		accumulator += input * prime2;
+		return rotateLeft(accumulator, 31) * prime1;
+	};
+	const auto mergeRound = [&](uint64 accumulator, const uint64 value)
+	{
+		accumulator ^= round(0, value);
+		return accumulator * prime1 + prime4;
+	};
+
+	const uint8* bytes = (const uint8*)data;
+	const uint8* bytesEnd = bytes + size;
+	uint64 hash;
+
+	// Process 32 byte stripes with four independent accumulators
+	if (size >= 32)
+	{
+		uint64 v1 = seed + prime1 + prime2;
+		uint64 v2 = seed + prime2;
+		uint64 v3 = seed;
+		uint64 v4 = seed - prime1;
+		for (; bytes + 32 <= bytesEnd; bytes += 32)
+		{
+			v1 = round(v1, read64(bytes));
+			v2 = round(v2, read64(bytes + 8));
+			v3 = round(v3, read64(bytes + 16));
+			v4 = round(v4, read64(bytes + 24));
+		}
+
+		hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+		hash = mergeRound(hash, v1);
+		hash = mergeRound(hash, v2);
+		hash = mergeRound(hash, v3);
+		hash = mergeRound(hash, v4);
+	}
+	else
+	{
+		hash = seed + prime5;
+	}
+	hash += size;
+
+	// Process the remaining bytes
+	for (; bytes + 8 <= bytesEnd; bytes += 8)
+	{
+		hash ^= round(0, read64(bytes));
+		hash = rotateLeft(hash, 27) * prime1 + prime4;
+	}
+	if (bytes + 4 <= bytesEnd)
+	{
+		hash ^= (uint64)read32(bytes) * prime1;
+		hash = rotateLeft(hash, 23) * prime2 + prime3;
+		bytes += 4;
+	}
+	for (; bytes < bytesEnd; ++bytes)
+	{
+		hash ^= (*bytes) * prime5;
+		hash = rotateLeft(hash, 11) * prime1;
+	}
+
+	// Final avalanche
+	hash ^= hash >> 33;
+	hash *= prime2;
+	hash ^= hash >> 29;
+	hash *= prime3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
 uint32 util::GetDatatypeSize(const Datatype datatype)
 {
 	switch (datatype)
@@ -0,0 +1,310 @@
+//     _____                        ______             _            
+//    / ____|                      |  ____|           (_)           
+//   | (___   __ _ _   _  ___ ___  | |__   _ __   __ _ _ _ __   ___ 
+//    \___ \ / _` | | | |/ __/ _ \ |  __| | '_ \ / _` | | '_ \ / _ \
+//    ____) | (_| | |_| | (_|  __/ | |____| | | | (_| | | | | |  __/
+//   |_____/ \__,_|\__,_|\___\___| |______|_| |_|\__, |_|_| |_|\___|
+//                                                __/ |             
+//                                               |___/              
+// Copyright (C) 2011-2020
+// Made by Marcus "Bitsauce" Vergara
+// Distributed under the MIT license
+
+#include <Sauce/Common.h>
+#include <Sauce/Utils.h>
+
+BEGIN_SAUCE_NAMESPACE
+
+namespace util
+{
+	//--------------------------------------------------------------
+	// PackFile
+	//--------------------------------------------------------------
+	PackFile::PackFile()
+		: m_header(nullptr)
+		, m_entries(nullptr)
+		, m_stringTable(nullptr)
+	{
+	}
+
+	PackFile::~PackFile()
+	{
+		close();
+	}
+
+	bool PackFile::open(const string& filePath)
+	{
+		close();
+
+		// Map the whole archive into memory
+		const string absoluteFilePath = getAbsoluteFilePath(filePath);
+		if (!m_mappedFile.open(absoluteFilePath))
+		{
+			LOG("Could not map pack file \"%s\" into memory", absoluteFilePath.c_str());
+			return false;
+		}
+
+		// Validate header and table of contents. Offsets are checked against
+		// the size first so that the remaining checks can't overflow.
+		const uint64 mappedSize = m_mappedFile.getSize();
+		m_header = (const PackFileHeader*)m_mappedFile.getData();
+		if (mappedSize < sizeof(PackFileHeader) ||
+			m_header->magic != Magic ||
+			m_header->version != Version ||
+			m_header->tocOffset > mappedSize ||
+			m_header->stringTableOffset > mappedSize ||
+			m_header->entryCount > (mappedSize - m_header->tocOffset) / sizeof(PackFileEntry) ||
+			m_header->stringTableSize > mappedSize - m_header->stringTableOffset)
+		{
+			LOG("Pack file \"%s\" is invalid or has an unsupported version", absoluteFilePath.c_str());
+			close();
+			return false;
+		}
+
+		m_entries = (const PackFileEntry*)(m_mappedFile.getData() + m_header->tocOffset);
+		m_stringTable = (const char*)(m_mappedFile.getData() + m_header->stringTableOffset);
+		m_filePath = filePath;
+		return true;
+	}
+
+	void PackFile::close()
+	{
+		m_mappedFile.close();
+		m_header = nullptr;
+		m_entries = nullptr;
+		m_stringTable = nullptr;
+		m_filePath.clear();
+	}
+
+	bool PackFile::contains(const string& assetPath) const
+	{
+		const string normalizedPath = NormalizePath(assetPath);
+		return !normalizedPath.empty() && findEntry(normalizedPath) != nullptr;
+	}
+
+	bool PackFile::find(const string& assetPath, FileSpan& outSpan) const
+	{
+		const string normalizedPath = NormalizePath(assetPath);
+		if (normalizedPath.empty())
+		{
+			return false;
+		}
+
+		const PackFileEntry* entry = findEntry(normalizedPath);
+		if (!entry || entry->compression != (uint32)PackCompression::None)
+		{
+			return false;
+		}
+
+		outSpan.data = m_mappedFile.getData() + entry->dataOffset;
+		outSpan.size = entry->dataSize;
+		return true;
+	}
+
+	const PackFileEntry* PackFile::findEntry(const string& normalizedPath) const
+	{
+		if (!m_entries)
+		{
+			return nullptr;
+		}
+
+		// Binary search for the first entry with a matching hash
+		const uint64 pathHash = HashPath(normalizedPath);
+		const PackFileEntry* entriesEnd = m_entries + m_header->entryCount;
+		const PackFileEntry* entry = lower_bound(m_entries, entriesEnd, pathHash,
+			[](const PackFileEntry& entry, const uint64 hash) { return entry.pathHash < hash; });
+
+		// Compare paths in case of hash collisions
+		for (; entry != entriesEnd && entry->pathHash == pathHash; ++entry)
+		{
+			if (entry->pathOffset + (uint64)entry->pathLength <= m_header->stringTableSize &&
+				entry->pathLength == normalizedPath.size() &&
+				memcmp(m_stringTable + entry->pathOffset, normalizedPath.data(), entry->pathLength) == 0)
+			{
+				const uint64 mappedSize = m_mappedFile.getSize();
+				if (entry->dataOffset > mappedSize || entry->storedSize > mappedSize - entry->dataOffset ||
+					(entry->compression == (uint32)PackCompression::None && entry->dataSize > entry->storedSize))
+				{
+					LOG("Entry \"%s\" in pack file \"%s\" is out of bounds", normalizedPath.c_str(), m_filePath.c_str());
+					return nullptr;
+				}
+				return entry;
+			}
+		}
+		return nullptr;
+	}
+
+	string PackFile::NormalizePath(const string& assetPath)
+	{
+		// Only game asset paths can be packed
+		string path;
+		if (assetPath.compare(0, 2, ":/") == 0)
+		{
+			path = assetPath.substr(2);
+		}
+		else if (assetPath.find(":/") != string::npos)
+		{
+			return "";
+		}
+		else
+		{
+			path = assetPath;
+		}
+
+		replace(path.begin(), path.end(), '\\', '/');
+		while (path.compare(0, 2, "./") == 0)
+		{
+			path.erase(0, 2);
+		}
+		return path;
+	}
+
+	uint64 PackFile::HashPath(const string& normalizedPath)
+	{
+		// 64-bit FNV-1a
+		uint64 hash = 0xcbf29ce484222325ULL;
+		for (const char c : normalizedPath)
+		{
+			hash ^= (uint8)c;
+			hash *= 0x100000001b3ULL;
+		}
+		return hash;
+	}
+
+	//--------------------------------------------------------------
+	// PackFileWriter
+	//--------------------------------------------------------------
+	PackFileWriter::PackFileWriter(const uint32 alignment)
+		: m_alignment(max(alignment, 1u))
+	{
+	}
+
+	bool PackFileWriter::addFile(const string& assetPath, const string& diskFilePath)
+	{
+		ifstream fileStream(diskFilePath, ifstream::binary | ifstream::ate);
+		if (!fileStream)
+		{
+			LOG("Could not open file \"%s\" for packing", diskFilePath.c_str());
+			return false;
+		}
+
+		vector<uint8> data((size_t)fileStream.tellg());
+		fileStream.seekg(0, ios::beg);
+		fileStream.read((char*)data.data(), data.size());
+		return addData(assetPath, data.data(), data.size());
+	}
+
+	bool PackFileWriter::addData(const string& assetPath, const uint8* data, const uint64 size)
+	{
+		const string normalizedPath = PackFile::NormalizePath(assetPath);
+		if (normalizedPath.empty())
+		{
+			LOG("Asset path \"%s\" cannot be stored in a pack file", assetPath.c_str());
+			return false;
+		}
+		m_entries[normalizedPath].assign(data, data + size);
+		return true;
+	}
+
+	bool PackFileWriter::write(const string& packFilePath) const
+	{
+		ofstream fileStream(packFilePath, ofstream::binary);
+		if (!fileStream)
+		{
+			LOG("Could not open pack file \"%s\" for writing", packFilePath.c_str());
+			return false;
+		}
+
+		const auto alignUp = [this](const uint64 offset) { return (offset + m_alignment - 1) / m_alignment * m_alignment; };
+
+		// Lay out entry data and the string table
+		vector<PackFileEntry> entries;
+		entries.reserve(m_entries.size());
+		string stringTable;
+		uint64 dataOffset = alignUp(sizeof(PackFileHeader));
+		for (const pair<const string, vector<uint8>>& entry : m_entries)
+		{
+			PackFileEntry fileEntry;
+			fileEntry.pathHash = PackFile::HashPath(entry.first);
+			fileEntry.dataOffset = dataOffset;
+			fileEntry.dataSize = entry.second.size();
+			fileEntry.storedSize = entry.second.size();
+			fileEntry.pathOffset = (uint32)stringTable.size();
+			fileEntry.pathLength = (uint32)entry.first.size();
+			fileEntry.compression = (uint32)PackCompression::None;
+			fileEntry.reserved = 0;
+			entries.push_back(fileEntry);
+
+			stringTable += entry.first;
+			dataOffset = alignUp(dataOffset + fileEntry.storedSize);
+		}
+
+		PackFileHeader header;
+		header.magic = PackFile::Magic;
+		header.version = PackFile::Version;
+		header.entryCount = (uint32)entries.size();
+		header.alignment = m_alignment;
+		header.tocOffset = dataOffset;
+		header.stringTableOffset = header.tocOffset + entries.size() * sizeof(PackFileEntry);
+		header.stringTableSize = stringTable.size();
+
+		// Write header and entry data in path order, padding between entries
+		const vector<char> padding(m_alignment, 0);
+		fileStream.write((const char*)&header, sizeof(PackFileHeader));
+		uint64 writeOffset = sizeof(PackFileHeader);
+		uint32 entryIndex = 0;
+		for (const pair<const string, vector<uint8>>& entry : m_entries)
+		{
+			const PackFileEntry& fileEntry = entries[entryIndex++];
+			fileStream.write(padding.data(), fileEntry.dataOffset - writeOffset);
+			fileStream.write((const char*)entry.second.data(), entry.second.size());
+			writeOffset = fileEntry.dataOffset + fileEntry.storedSize;
+		}
+		fileStream.write(padding.data(), header.tocOffset - writeOffset);
+
+		// Write the table of contents sorted by hash
+		stable_sort(entries.begin(), entries.end(),
+			[](const PackFileEntry& a, const PackFileEntry& b) { return a.pathHash < b.pathHash; });
+		fileStream.write((const char*)entries.data(), entries.size() * sizeof(PackFileEntry));
+		fileStream.write(stringTable.data(), stringTable.size());
+
+		return (bool)fileStream;
+	}
+
+	//--------------------------------------------------------------
+	// Mounted pack files
+	//--------------------------------------------------------------
+	vector<unique_ptr<PackFile>> g_mountedPackFiles;
+
+	bool mountPackFile(const string& packFilePath)
+	{
+		unique_ptr<PackFile> packFile(new PackFile());
+		if (!packFile->open(packFilePath))
+		{
+			return false;
+		}
+		LOG("Mounted pack file \"%s\" (%i entries)", packFilePath.c_str(), packFile->getEntryCount());
+		g_mountedPackFiles.push_back(move(packFile));
+		return true;
+	}
+
+	void unmountPackFiles()
+	{
+		g_mountedPackFiles.clear();
+	}
+
+	bool findInPackFiles(const string& assetPath, FileSpan& outSpan)
+	{
+		// Packs mounted last take precedence so that patches can override assets
+		for (vector<unique_ptr<PackFile>>::reverse_iterator itr = g_mountedPackFiles.rbegin(); itr != g_mountedPackFiles.rend(); ++itr)
+		{
+			if ((*itr)->find(assetPath, outSpan))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+END_SAUCE_NAMESPACE
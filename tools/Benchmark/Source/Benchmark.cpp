@@ -0,0 +1,137 @@
+#include "Benchmark.h"
+
+const void* volatile g_benchmarkSink = nullptr;
+
+BenchmarkRunner::BenchmarkRunner(const string& filter, const double minSampleSeconds, const uint32 sampleCount)
+	: m_filter(filter)
+	, m_minSampleSeconds(minSampleSeconds)
+	, m_sampleCount(max(sampleCount, 1u))
+{
+}
+
+bool BenchmarkRunner::isSelected(const string& name) const
+{
+	return m_filter.empty() || name.find(m_filter) != string::npos;
+}
+
+void BenchmarkRunner::run(const string& name, const function<void(const uint64 iterations)>& body, const double itemsPerIteration)
+{
+	if(!isSelected(name))
+	{
+		return;
+	}
+
+	// Double the iteration count until one sample takes long enough to time reliably
+	const uint64 minSampleTicks = Clock::SecondsToTicks(m_minSampleSeconds);
+	uint64 iterations = 1;
+	while(true)
+	{
+		const uint64 startTicks = Clock::GetTicks();
+		body(iterations);
+		const uint64 elapsedTicks = Clock::GetTicks() - startTicks;
+		if(elapsedTicks >= minSampleTicks || iterations >= (1ULL << 40))
+		{
+			break;
+		}
+
+		// Jump close to the target once we have a usable measurement
+		if(elapsedTicks > minSampleTicks / 100)
+		{
+			iterations = max(iterations + 1, uint64(iterations * 1.2 * minSampleTicks / elapsedTicks));
+		}
+		else
+		{
+			iterations *= 2;
+		}
+	}
+
+	vector<double> samplesNs;
+	samplesNs.reserve(m_sampleCount);
+	for(uint32 i = 0; i < m_sampleCount; ++i)
+	{
+		const uint64 startTicks = Clock::GetTicks();
+		body(iterations);
+		const uint64 elapsedTicks = Clock::GetTicks() - startTicks;
+		samplesNs.push_back(double(elapsedTicks) / double(iterations));
+	}
+
+	BenchmarkResult result;
+	result.name = name;
+	result.iterations = iterations;
+	result.itemsPerIteration = itemsPerIteration;
+	ComputeStatistics(samplesNs, result);
+	addResult(result);
+}
+
+void BenchmarkRunner::addResult(const BenchmarkResult& result)
+{
+	m_results.push_back(result);
+	printResult(result);
+}
+
+void BenchmarkRunner::ComputeStatistics(vector<double> samplesNs, BenchmarkResult& result)
+{
+	result.sampleCount = (uint32)samplesNs.size();
+	if(samplesNs.empty())
+	{
+		return;
+	}
+
+	sort(samplesNs.begin(), samplesNs.end());
+	const size_t middle = samplesNs.size() / 2;
+	result.minNs = samplesNs.front();
+	result.maxNs = samplesNs.back();
+	result.medianNs = samplesNs.size() % 2 == 0 ? (samplesNs[middle - 1] + samplesNs[middle]) * 0.5 : samplesNs[middle];
+
+	double sumNs = 0.0;
+	for(const double sampleNs : samplesNs)
+	{
+		sumNs += sampleNs;
+	}
+	result.meanNs = sumNs / samplesNs.size();
+}
+
+void BenchmarkRunner::printResult(const BenchmarkResult& result) const
+{
+	printf("%-40s %14.1f ns/%-5s (min %.1f, max %.1f)", result.name.c_str(), result.medianNs, result.unit.c_str(), result.minNs, result.maxNs);
+	if(result.itemsPerIteration > 0.0 && result.medianNs > 0.0)
+	{
+		printf(" %10.2f M items/s", result.itemsPerIteration * 1.0e3 / result.medianNs);
+	}
+	printf("\n");
+}
+
+bool BenchmarkRunner::writeJSON(const string& filePath) const
+{
+	FILE* file = fopen(filePath.c_str(), "w");
+	if(!file)
+	{
+		LOG("Could not open benchmark output file \"%s\"", filePath.c_str());
+		return false;
+	}
+
+	// Benchmark names are plain identifiers, so they are written without escaping
+	fprintf(file, "{\n\t\"version\": 1,\n\t\"benchmarks\": [\n");
+	for(size_t i = 0; i < m_results.size(); ++i)
+	{
+		const BenchmarkResult& result = m_results[i];
+		fprintf(file, "\t\t{\n");
+		fprintf(file, "\t\t\t\"name\": \"%s\",\n", result.name.c_str());
+		fprintf(file, "\t\t\t\"unit\": \"%s\",\n", result.unit.c_str());
+		fprintf(file, "\t\t\t\"iterations\": %llu,\n", (unsigned long long)result.iterations);
+		fprintf(file, "\t\t\t\"samples\": %u,\n", result.sampleCount);
+		fprintf(file, "\t\t\t\"min_ns\": %.3f,\n", result.minNs);
+		fprintf(file, "\t\t\t\"median_ns\": %.3f,\n", result.medianNs);
+		fprintf(file, "\t\t\t\"mean_ns\": %.3f,\n", result.meanNs);
+		fprintf(file, "\t\t\t\"max_ns\": %.3f,\n", result.maxNs);
+		fprintf(file, "\t\t\t\"items_per_iteration\": %.3f", result.itemsPerIteration);
+		for(const pair<const string, double>& counter : result.counters)
+		{
+			fprintf(file, ",\n\t\t\t\"%s\": %.3f", counter.first.c_str(), counter.second);
+		}
+		fprintf(file, "\n\t\t}%s\n", i + 1 < m_results.size() ? "," : "");
+	}
+	fprintf(file, "\t]\n}\n");
+	fclose(file);
+	return true;
+}
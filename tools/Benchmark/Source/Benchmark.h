@@ -0,0 +1,90 @@
+#pragma once
+
+/* Include the SauceEngine framework */
+#include <Sauce/Sauce.h>
+#include <functional>
+
+using namespace sauce;
+
+extern const void* volatile g_benchmarkSink;
+
+/**
+ * Prevents the compiler from optimizing away the computation of \p value.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+	g_benchmarkSink = &value;
+#else
+	asm volatile("" : : "m"(value) : "memory");
+#endif
+}
+
+/**
+ * Timing of a single benchmark. All times are per iteration in nanoseconds.
+ */
+struct BenchmarkResult
+{
+	string name;
+	string unit               = "op";  ///< What one iteration is ("op" or "frame")
+	uint64 iterations         = 0;     ///< Iterations per sample
+	uint32 sampleCount        = 0;
+	double minNs              = 0.0;
+	double medianNs           = 0.0;
+	double meanNs             = 0.0;
+	double maxNs              = 0.0;
+	double itemsPerIteration  = 0.0;   ///< Work items processed per iteration, used to report throughput (0 = none)
+	map<string, double> counters;      ///< Extra per-iteration counters (e.g. draw calls per frame)
+};
+
+/**
+ * Runs micro-benchmarks and collects their results.
+ *
+ * A benchmark body is called with an iteration count and runs its workload
+ * that many times. The count is calibrated so that each sample takes at
+ * least the configured sample time, then a fixed number of samples is taken.
+ */
+class BenchmarkRunner
+{
+public:
+	BenchmarkRunner(const string& filter, const double minSampleSeconds, const uint32 sampleCount);
+
+	/** True if \p name matches the filter given on the command line. */
+	bool isSelected(const string& name) const;
+
+	void run(const string& name, const function<void(const uint64 iterations)>& body, const double itemsPerIteration = 0.0);
+
+	/** Adds a result that was measured elsewhere (e.g. frame times from a macro-benchmark). */
+	void addResult(const BenchmarkResult& result);
+
+	/** Fills in min/median/mean/max of \p result from per-iteration samples in nanoseconds. */
+	static void ComputeStatistics(vector<double> samplesNs, BenchmarkResult& result);
+
+	const vector<BenchmarkResult>& getResults() const { return m_results; }
+
+	bool writeJSON(const string& filePath) const;
+
+private:
+	void printResult(const BenchmarkResult& result) const;
+
+	string m_filter;
+	double m_minSampleSeconds;
+	uint32 m_sampleCount;
+	vector<BenchmarkResult> m_results;
+};
+
+/**
+ * Benchmark suites
+ */
+void RunMicroBenchmarks(BenchmarkRunner& runner);
+
+struct MacroBenchmarkDesc
+{
+	GraphicsBackend graphicsBackend = GraphicsBackend::Null; ///< Null runs headless
+	string          graphicsCaptureFile;                     ///< Record the draw traffic through a RecordingGraphicsContext
+	string          fontFilePath;                            ///< Text benchmarks are skipped without a font
+	uint32          warmupFrames = 30;
+	uint32          measuredFrames = 300;
+};
+void RunMacroBenchmarks(BenchmarkRunner& runner, const MacroBenchmarkDesc& desc);
@@ -0,0 +1,335 @@
+#include "Benchmark.h"
+
+/**
+ * A workload that is ticked and drawn every frame
+ */
+class MacroScenario
+{
+public:
+	virtual ~MacroScenario() { }
+	virtual void tick() { }
+	virtual void draw(GraphicsContext* context) = 0;
+};
+
+/**
+ * N moving sprites drawn with a single SpriteBatch
+ */
+class SpriteScenario : public MacroScenario
+{
+public:
+	SpriteScenario(const uint32 spriteCount)
+		: m_spriteBatch(spriteCount)
+	{
+		Pixmap pixmap(16, 16, PixelFormat(PixelComponents::Rgba, PixelDatatype::Uint8));
+		const uint8 white[4] = { 255, 255, 255, 255 };
+		pixmap.fill(white);
+		Texture2DDesc textureDesc;
+		textureDesc.pixmap = &pixmap;
+		m_texture = CreateNew<Texture2D>(textureDesc);
+
+		Random random(3);
+		m_sprites.reserve(spriteCount);
+		m_velocities.reserve(spriteCount);
+		for(uint32 i = 0; i < spriteCount; ++i)
+		{
+			m_sprites.emplace_back(m_texture, Rect<float>(random.nextDouble(0.0, 1264.0), random.nextDouble(0.0, 704.0), 16.0f, 16.0f));
+			m_velocities.emplace_back(random.nextDouble(-4.0, 4.0), random.nextDouble(-4.0, 4.0));
+		}
+	}
+
+	void tick()
+	{
+		for(size_t i = 0; i < m_sprites.size(); ++i)
+		{
+			Vector2F position = m_sprites[i].getPosition() + m_velocities[i];
+			if(position.x < 0.0f || position.x > 1264.0f) m_velocities[i].x = -m_velocities[i].x;
+			if(position.y < 0.0f || position.y > 704.0f) m_velocities[i].y = -m_velocities[i].y;
+			m_sprites[i].setPosition(position);
+		}
+	}
+
+	void draw(GraphicsContext* context)
+	{
+		m_spriteBatch.begin(context);
+		for(const Sprite& sprite : m_sprites)
+		{
+			m_spriteBatch.drawSprite(sprite);
+		}
+		m_spriteBatch.end();
+	}
+
+private:
+	Texture2DRef m_texture;
+	SpriteBatch m_spriteBatch;
+	vector<Sprite> m_sprites;
+	vector<Vector2F> m_velocities;
+};
+
+/**
+ * N lines of text drawn with the SDF font renderer
+ */
+class TextScenario : public MacroScenario
+{
+public:
+	TextScenario(const string& fontFilePath, const uint32 textCount)
+		: m_textCount(textCount)
+	{
+		FontRendererDesc fontDesc;
+		fontDesc.fontFilePath = fontFilePath;
+		m_fontRenderer = CreateNew<FontRenderer>(fontDesc);
+		m_drawArgs.text = "The quick brown fox jumps over the lazy dog";
+		m_drawArgs.scale = 0.125f;
+	}
+
+	void draw(GraphicsContext* context)
+	{
+		for(uint32 i = 0; i < m_textCount; ++i)
+		{
+			m_drawArgs.position.set(float(i % 4) * 320.0f, float(i / 4) * 12.0f);
+			m_fontRenderer->drawText(context, m_drawArgs);
+		}
+	}
+
+private:
+	FontRendererRef m_fontRenderer;
+	FontRendererDrawTextArgs m_drawArgs;
+	const uint32 m_textCount;
+};
+
+/**
+ * N debug shapes drawn with the GraphicsContext draw helpers
+ */
+class DebugDrawScenario : public MacroScenario
+{
+public:
+	DebugDrawScenario(const uint32 shapeCount)
+		: m_shapeCount(shapeCount)
+	{
+	}
+
+	void draw(GraphicsContext* context)
+	{
+		// Filled shapes first, then outlines. Switching between triangles and
+		// lines ends the current batch, so interleaving them costs a draw each.
+		for(uint32 i = 0; i < m_shapeCount / 2; ++i)
+		{
+			const Vector2F position = getPosition(i);
+			if(i % 2 == 0) context->drawRectangle(position, Vector2F(10.0f, 6.0f), Color::Red);
+			else context->drawCircle(position, 4.0f, 16, Color::Blue);
+		}
+
+		for(uint32 i = m_shapeCount / 2; i < m_shapeCount; ++i)
+		{
+			const Vector2F position = getPosition(i);
+			if(i % 2 == 0) context->drawRectangleOutline(position, Vector2F(10.0f, 6.0f), Color::Green);
+			else context->drawArrow(position, position + Vector2F(10.0f, 4.0f), 3.0f, Color::Yellow);
+		}
+		context->flushBatch();
+	}
+
+private:
+	static Vector2F getPosition(const uint32 i)
+	{
+		return Vector2F(float(i % 100) * 12.0f, float(i / 100) * 7.0f);
+	}
+
+	const uint32 m_shapeCount;
+};
+
+/**
+ * Runs every selected scenario for a fixed number of frames and reports
+ * the time from the start to the end of each frame.
+ */
+class BenchmarkGame : public Game
+{
+	struct ScenarioDesc
+	{
+		string name;
+		function<MacroScenario*()> create;
+	};
+
+public:
+	BenchmarkGame(BenchmarkRunner& runner, const MacroBenchmarkDesc& desc)
+		: m_runner(runner)
+		, m_desc(desc)
+		, m_scenarioIndex(0)
+		, m_frameIndex(0)
+		, m_frameStartTicks(0)
+		, m_graphicsContext(nullptr)
+		, m_drawCallCount(0)
+		, m_vertexCount(0)
+	{
+	}
+
+	void onStart(GameEvent* e)
+	{
+		const uint32 spriteCounts[] = { 1000, 10000 };
+		for(const uint32 spriteCount : spriteCounts)
+		{
+			m_scenarios.push_back({ "frame/sprites_" + util::intToStr(spriteCount), [spriteCount]() { return new SpriteScenario(spriteCount); } });
+		}
+
+		m_scenarios.push_back({ "frame/debug_draw_10000", []() { return new DebugDrawScenario(10000); } });
+
+		if(!m_desc.fontFilePath.empty())
+		{
+			const uint32 textCounts[] = { 100, 1000 };
+			const string fontFilePath = m_desc.fontFilePath;
+			for(const uint32 textCount : textCounts)
+			{
+				m_scenarios.push_back({ "frame/text_" + util::intToStr(textCount), [fontFilePath, textCount]() { return new TextScenario(fontFilePath, textCount); } });
+			}
+		}
+		else
+		{
+			printf("No font given, skipping text benchmarks\n");
+		}
+
+		m_scenarios.erase(remove_if(m_scenarios.begin(), m_scenarios.end(),
+			[this](const ScenarioDesc& scenario) { return !m_runner.isSelected(scenario.name); }), m_scenarios.end());
+
+		startScenario();
+		Game::onStart(e);
+	}
+
+	void onTick(TickEvent* e)
+	{
+		if(m_scenario)
+		{
+			m_scenario->tick();
+		}
+		Game::onTick(e);
+	}
+
+	void onDraw(DrawEvent* e)
+	{
+		m_graphicsContext = e->getGraphicsContext();
+		if(m_scenario)
+		{
+			m_scenario->draw(m_graphicsContext);
+		}
+		Game::onDraw(e);
+	}
+
+	void onStepBegin(StepEvent* e)
+	{
+		m_frameStartTicks = Clock::GetTicks();
+		Game::onStepBegin(e);
+	}
+
+	void onStepEnd(StepEvent* e)
+	{
+		Game::onStepEnd(e);
+		if(!m_scenario)
+		{
+			return;
+		}
+
+		const uint64 frameTicks = Clock::GetTicks() - m_frameStartTicks;
+		if(m_frameIndex++ >= m_desc.warmupFrames)
+		{
+			m_frameTimesNs.push_back((double)frameTicks);
+		}
+
+		if(m_frameIndex >= m_desc.warmupFrames + m_desc.measuredFrames)
+		{
+			finishScenario();
+			++m_scenarioIndex;
+			startScenario();
+		}
+	}
+
+private:
+	void startScenario()
+	{
+		m_scenario.reset();
+		if(m_scenarioIndex >= m_scenarios.size())
+		{
+			end();
+			return;
+		}
+
+		m_scenario.reset(m_scenarios[m_scenarioIndex].create());
+		m_frameIndex = 0;
+		m_frameTimesNs.clear();
+
+		// Draw traffic is only counted by the null backend
+		if(NullGraphicsContext* nullContext = getNullBackend())
+		{
+			m_drawCallCount = nullContext->getDrawCallCount();
+			m_vertexCount = nullContext->getVertexCount();
+		}
+	}
+
+	void finishScenario()
+	{
+		BenchmarkResult result;
+		result.name = m_scenarios[m_scenarioIndex].name;
+		result.unit = "frame";
+		result.iterations = 1;
+		BenchmarkRunner::ComputeStatistics(m_frameTimesNs, result);
+
+		if(NullGraphicsContext* nullContext = getNullBackend())
+		{
+			const double frameCount = m_desc.warmupFrames + m_desc.measuredFrames;
+			result.counters["draw_calls"] = (nullContext->getDrawCallCount() - m_drawCallCount) / frameCount;
+			result.counters["vertices"] = (nullContext->getVertexCount() - m_vertexCount) / frameCount;
+		}
+		m_runner.addResult(result);
+	}
+
+	/**
+	 * Gets the null backend behind the capture and render thread wrappers,
+	 * or null if another backend is used. Waits for the render thread so
+	 * that its counters include every frame submitted so far.
+	 */
+	NullGraphicsContext* getNullBackend() const
+	{
+		GraphicsContext* context = m_graphicsContext;
+		while(context)
+		{
+			if(RecordingGraphicsContext* recordingContext = dynamic_cast<RecordingGraphicsContext*>(context))
+			{
+				context = recordingContext->getBackend();
+			}
+			else if(ThreadedGraphicsContext* threadedContext = dynamic_cast<ThreadedGraphicsContext*>(context))
+			{
+				threadedContext->synchronize();
+				context = threadedContext->getBackend();
+			}
+			else
+			{
+				break;
+			}
+		}
+		return dynamic_cast<NullGraphicsContext*>(context);
+	}
+
+	BenchmarkRunner& m_runner;
+	const MacroBenchmarkDesc m_desc;
+	vector<ScenarioDesc> m_scenarios;
+	uint32 m_scenarioIndex;
+	unique_ptr<MacroScenario> m_scenario;
+	uint32 m_frameIndex;
+	uint64 m_frameStartTicks;
+	vector<double> m_frameTimesNs;
+	GraphicsContext* m_graphicsContext;
+	uint64 m_drawCallCount;
+	uint64 m_vertexCount;
+};
+
+void RunMacroBenchmarks(BenchmarkRunner& runner, const MacroBenchmarkDesc& desc)
+{
+	GameDesc gameDesc;
+	gameDesc.name = "Sauce3D Benchmark";
+	gameDesc.graphicsBackend = desc.graphicsBackend;
+	gameDesc.graphicsCaptureFile = desc.graphicsCaptureFile;
+	gameDesc.flags = (uint32)EngineFlag::RunInBackground;
+	if(desc.graphicsBackend == GraphicsBackend::Null)
+	{
+		gameDesc.flags |= (uint32)EngineFlag::Headless;
+	}
+
+	BenchmarkGame game(runner, desc);
+	game.run(gameDesc);
+}
@@ -0,0 +1,84 @@
+#include "Benchmark.h"
+
+/**
+ * Benchmark:
+ * Times engine hot paths and writes the results as JSON so that runs of
+ * different engine versions can be compared.
+ *
+ * Micro-benchmarks time isolated engine functions. Macro-benchmarks run a
+ * game for a fixed number of frames and time whole frames. They run
+ * headless on the null graphics backend unless --backend gl is given, which
+ * needs a display (e.g. Xvfb with llvmpipe for reproducible numbers).
+ *
+ * Usage: saucebench [options]
+ *   --json <file>          Write results to <file>
+ *   --filter <text>        Only run benchmarks whose name contains <text>
+ *   --micro | --macro      Only run one kind of benchmark
+ *   --backend <null|gl>    Graphics backend for macro-benchmarks (default: null)
+ *   --capture <file>       Record the macro-benchmark draw traffic to <file>
+ *   --font <file>          Font used by the text macro-benchmarks
+ *   --frames <count>       Measured frames per macro-benchmark (default: 300)
+ *   --samples <count>      Samples per micro-benchmark (default: 10)
+ *   --sample-time <sec>    Minimum duration of one micro-benchmark sample (default: 0.05)
+ */
+int main(int argc, char *argv[])
+{
+	string jsonFile;
+	string filter;
+	bool runMicro = true, runMacro = true;
+	uint32 sampleCount = 10;
+	double minSampleSeconds = 0.05;
+	MacroBenchmarkDesc macroDesc;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if(arg == "--micro") runMacro = false;
+		else if(arg == "--macro") runMicro = false;
+		else if(arg == "--json" && hasValue) jsonFile = argv[++i];
+		else if(arg == "--filter" && hasValue) filter = argv[++i];
+		else if(arg == "--capture" && hasValue) macroDesc.graphicsCaptureFile = argv[++i];
+		else if(arg == "--font" && hasValue) macroDesc.fontFilePath = argv[++i];
+		else if(arg == "--frames" && hasValue) macroDesc.measuredFrames = (uint32)util::strToInt(argv[++i]);
+		else if(arg == "--samples" && hasValue) sampleCount = (uint32)util::strToInt(argv[++i]);
+		else if(arg == "--sample-time" && hasValue) minSampleSeconds = atof(argv[++i]);
+		else if(arg == "--backend" && hasValue)
+		{
+			const string backend = argv[++i];
+			if(backend == "null") macroDesc.graphicsBackend = GraphicsBackend::Null;
+			else if(backend == "gl") macroDesc.graphicsBackend = GraphicsBackend::OpenGL4;
+			else
+			{
+				printf("Unknown graphics backend \"%s\"\n", backend.c_str());
+				return 1;
+			}
+		}
+		else
+		{
+			printf("Usage: %s [--json <file>] [--filter <text>] [--micro | --macro] [--backend <null|gl>] [--capture <file>] [--font <file>] [--frames <count>] [--samples <count>] [--sample-time <seconds>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	BenchmarkRunner runner(filter, minSampleSeconds, sampleCount);
+	if(runMicro)
+	{
+		RunMicroBenchmarks(runner);
+	}
+	if(runMacro)
+	{
+		RunMacroBenchmarks(runner, macroDesc);
+	}
+
+	if(!jsonFile.empty())
+	{
+		if(!runner.writeJSON(jsonFile))
+		{
+			printf("Failed to write benchmark results to \"%s\"\n", jsonFile.c_str());
+			return 1;
+		}
+		printf("Wrote %u benchmark results to \"%s\"\n", (uint32)runner.getResults().size(), jsonFile.c_str());
+	}
+	return 0;
+}
@@ -0,0 +1,589 @@
+#include "Benchmark.h"
+
+/**
+ * Math
+ */
+static void BenchmarkMath(BenchmarkRunner& runner)
+{
+	const uint32 count = 1024;
+	Random random(1);
+	vector<Vector2F> points(count);
+	vector<Vector4F> points4(count);
+	for(uint32 i = 0; i < count; ++i)
+	{
+		points[i].set(random.nextDouble(-100.0, 100.0), random.nextDouble(-100.0, 100.0));
+		points4[i].set(points[i].x, points[i].y, random.nextDouble(-100.0, 100.0), 1.0f);
+	}
+
+	runner.run("math/vector2_normalize_dot", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			float sum = 0.0f;
+			for(uint32 j = 0; j < count; ++j)
+			{
+				sum += points[j].normalized().dot(points[(j + 1) % count]);
+			}
+			DoNotOptimize(sum);
+		}
+	}, count);
+
+	Matrix4 transform;
+	transform.translate(10.0f, 20.0f, 30.0f);
+	transform.rotateZ(45.0f);
+	transform.scale(2.0f);
+
+	runner.run("math/matrix4_multiply", [&](const uint64 iterations)
+	{
+		Matrix4 result;
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			result = transform * result;
+			DoNotOptimize(result);
+		}
+	});
+
+	runner.run("math/matrix4_transform_vector4", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			Vector4F sum;
+			for(uint32 j = 0; j < count; ++j)
+			{
+				sum += transform * points4[j];
+			}
+			DoNotOptimize(sum);
+		}
+	}, count);
+
+	runner.run("math/matrix4_invert", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			Matrix4 inverse = transform;
+			inverse.invert();
+			DoNotOptimize(inverse);
+		}
+	});
+}
+
+/**
+ * VertexArray
+ */
+static void BenchmarkVertexArray(BenchmarkRunner& runner)
+{
+	const uint32 count = 4096;
+	VertexFormat vertexFormat;
+	vertexFormat.set(VertexAttribute::Position, 2, Datatype::Float);
+	vertexFormat.set(VertexAttribute::Color, 4, Datatype::Uint8);
+	vertexFormat.set(VertexAttribute::TexCoord, 2, Datatype::Float);
+	VertexArray vertices = vertexFormat.createVertices(count);
+
+	runner.run("vertex_array/write_vtc", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			for(uint32 j = 0; j < count; ++j)
+			{
+				vertices[j].set2f(VertexAttribute::Position, float(j), float(i));
+				vertices[j].set4ub(VertexAttribute::Color, 255, 128, 64, 255);
+				vertices[j].set2f(VertexAttribute::TexCoord, 0.5f, 0.5f);
+			}
+			DoNotOptimize(*vertices.getVertexData());
+		}
+	}, count);
+
+	VertexArrayT<VertexPos2DColorUV> typedVertices(count);
+	runner.run("vertex_array/write_typed_vtc", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			for(uint32 j = 0; j < count; ++j)
+			{
+				typedVertices[j] = { Vector2F(float(j), float(i)), Color(255, 128, 64, 255), Vector2F(0.5f, 0.5f) };
+			}
+			DoNotOptimize(*typedVertices.getVertices());
+		}
+	}, count);
+
+	runner.run("vertex_array/resize", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			VertexArray scratch(0, vertexFormat);
+			for(uint32 size = 64; size <= count; size *= 2)
+			{
+				scratch.resize(size);
+			}
+			DoNotOptimize(*scratch.getVertexData());
+		}
+	});
+
+	VertexArray reused(0, vertexFormat);
+	runner.run("vertex_array/clear_resize_reuse", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			reused.clear();
+			for(uint32 size = 64; size <= count; size *= 2)
+			{
+				reused.resize(size);
+			}
+			DoNotOptimize(*reused.getVertexData());
+		}
+	});
+}
+
+/**
+ * Pixmap
+ */
+static void BenchmarkPixmap(BenchmarkRunner& runner)
+{
+	const uint32 size = 512;
+	const PixelFormat format(PixelComponents::Rgba, PixelDatatype::Uint8);
+	Pixmap pixmap(size, size, format);
+	Pixmap tile(64, 64, format);
+	const uint8 color[4] = { 255, 128, 64, 255 };
+	tile.fill(color);
+
+	runner.run("pixmap/set_pixel_rgba8", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			for(uint32 y = 0; y < size; ++y)
+			{
+				for(uint32 x = 0; x < size; ++x)
+				{
+					pixmap.setPixel(x, y, color);
+				}
+			}
+			DoNotOptimize(*pixmap.getData());
+		}
+	}, size * size);
+
+	runner.run("pixmap/get_pixel_rgba8", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			uint32 sum = 0;
+			for(uint32 y = 0; y < size; ++y)
+			{
+				for(uint32 x = 0; x < size; ++x)
+				{
+					uint8 pixel[4];
+					pixmap.getPixel(x, y, pixel);
+					sum += pixel[0];
+				}
+			}
+			DoNotOptimize(sum);
+		}
+	}, size * size);
+
+	runner.run("pixmap/blit_64x64", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			for(uint32 y = 0; y < size; y += 64)
+			{
+				for(uint32 x = 0; x < size; x += 64)
+				{
+					pixmap.setPixels(x, y, tile);
+				}
+			}
+			DoNotOptimize(*pixmap.getData());
+		}
+	}, size * size);
+
+	runner.run("pixmap/flip_y", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			pixmap.flipY();
+			DoNotOptimize(*pixmap.getData());
+		}
+	}, size * size);
+
+	runner.run("pixmap/copy", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			Pixmap copy(pixmap);
+			DoNotOptimize(*copy.getData());
+		}
+	}, size * size);
+}
+
+/**
+ * RectanglePacker
+ */
+static void BenchmarkRectanglePacker(BenchmarkRunner& runner)
+{
+	const uint32 count = 256;
+	vector<Vector2I> sizes(count);
+	vector<string> keys(count);
+	Random random(2);
+	for(uint32 i = 0; i < count; ++i)
+	{
+		sizes[i].set(random.nextInt(8, 64), random.nextInt(8, 64));
+		keys[i] = util::intToStr(i);
+	}
+
+	runner.run("rectangle_packer/pack_256", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			RectanglePacker packer;
+			packer.setMaxWidth(1024);
+			for(uint32 j = 0; j < count; ++j)
+			{
+				packer.addRectangle(keys[j], sizes[j].x, sizes[j].y);
+			}
+			const RectanglePacker::Result result = packer.pack();
+			DoNotOptimize(result.area);
+		}
+	}, count);
+}
+
+/**
+ * SDF generation
+ */
+static void BenchmarkSDF(BenchmarkRunner& runner)
+{
+	// Rings of filled circles approximate a glyph atlas
+	const uint32 size = 256;
+	vector<uint8> mask(size * size, 0);
+	for(uint32 cy = 32; cy < size; cy += 64)
+	{
+		for(uint32 cx = 32; cx < size; cx += 64)
+		{
+			for(uint32 y = cy - 24; y < cy + 24; ++y)
+			{
+				for(uint32 x = cx - 24; x < cx + 24; ++x)
+				{
+					const int32 dx = int32(x) - int32(cx), dy = int32(y) - int32(cy);
+					const int32 distanceSq = dx * dx + dy * dy;
+					if(distanceSq < 24 * 24 && distanceSq > 12 * 12)
+					{
+						mask[x + y * size] = 255;
+					}
+				}
+			}
+		}
+	}
+
+	runner.run("font/generate_sdf_256", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			Pixmap sdf;
+			FontRenderingSystem::GenerateSDF(mask.data(), size, size, 20, 4, sdf);
+			DoNotOptimize(*sdf.getData());
+		}
+	}, (size / 4) * (size / 4));
+}
+
+/**
+ * Scene event propagation
+ */
+class CountingSceneObject : public SceneObject
+{
+public:
+	CountingSceneObject() : m_tickCount(0) { }
+
+	void onTick(TickEvent *e)
+	{
+		++m_tickCount;
+		SceneObject::onTick(e);
+	}
+
+	uint64 m_tickCount;
+};
+
+static void BenchmarkScene(BenchmarkRunner& runner)
+{
+	// Balanced tree with 4 children per node, 1365 nodes in total
+	const uint32 fanOut = 4, depth = 5;
+	vector<unique_ptr<CountingSceneObject>> objects;
+	objects.emplace_back(new CountingSceneObject());
+	size_t levelBegin = 0;
+	for(uint32 level = 1; level < depth + 1; ++level)
+	{
+		const size_t levelEnd = objects.size();
+		for(size_t parent = levelBegin; parent < levelEnd; ++parent)
+		{
+			for(uint32 i = 0; i < fanOut; ++i)
+			{
+				objects.emplace_back(new CountingSceneObject());
+				objects[parent]->addChildLast(objects.back().get());
+			}
+		}
+		levelBegin = levelEnd;
+	}
+
+	runner.run("scene/tick_propagation_1365", [&](const uint64 iterations)
+	{
+		TickEvent e(1.0f / 30.0f);
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			objects[0]->onEvent(&e);
+		}
+		DoNotOptimize(objects[0]->m_tickCount);
+	}, (double)objects.size());
+
+	// A frame of high-rate mouse input. The moves between two clicks are
+	// coalesced, so the scene only sees a few of them.
+	EventQueue eventQueue;
+	runner.run("scene/queued_mouse_input_1000", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			for(int32 j = 0; j < 1000; ++j)
+			{
+				if(j % 250 == 0)
+				{
+					eventQueue.push<MouseEvent>(MouseEventType::Down, nullptr, j, j, SAUCE_MOUSE_BUTTON_LEFT, 0, 0);
+				}
+				eventQueue.pushCoalesced<MouseEvent>(1, MouseEventType::Move, nullptr, j, j, SAUCE_MOUSE_BUTTON_NONE, 0, 0);
+			}
+			eventQueue.dispatch([&](Event *e) { objects[0]->onEvent(e); });
+		}
+		DoNotOptimize(eventQueue.getCoalescedCount());
+	}, 1000.0);
+}
+
+/**
+ * Transform hierarchy
+ */
+static void BenchmarkTransforms(BenchmarkRunner& runner)
+{
+	// Same shape as the scene benchmark: 4 children per node, 1365 transforms
+	const uint32 fanOut = 4, depth = 5;
+	TransformHierarchy hierarchy;
+	vector<TransformID> transforms;
+	transforms.push_back(hierarchy.create());
+	size_t levelBegin = 0;
+	for(uint32 level = 1; level < depth + 1; ++level)
+	{
+		const size_t levelEnd = transforms.size();
+		for(size_t parent = levelBegin; parent < levelEnd; ++parent)
+		{
+			for(uint32 i = 0; i < fanOut; ++i)
+			{
+				transforms.push_back(hierarchy.create(transforms[parent]));
+				Matrix4 localMatrix;
+				localMatrix.translate(1.0f, 2.0f, 0.0f);
+				localMatrix.rotateZ(10.0f);
+				hierarchy.setLocalMatrix(transforms.back(), localMatrix);
+			}
+		}
+		levelBegin = levelEnd;
+	}
+	hierarchy.update();
+
+	runner.run("transform/update_static_1365", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			hierarchy.update();
+		}
+		DoNotOptimize(hierarchy.getWorldMatrix(transforms.back()));
+	}, (double)transforms.size());
+
+	Matrix4 rootMatrix;
+	runner.run("transform/update_moved_root_1365", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			rootMatrix.translate(0.1f, 0.0f, 0.0f);
+			hierarchy.setLocalMatrix(transforms[0], rootMatrix);
+			hierarchy.update();
+		}
+		DoNotOptimize(hierarchy.getWorldMatrix(transforms.back()));
+	}, (double)transforms.size());
+}
+
+/**
+ * Spatial index
+ */
+static void BenchmarkSpatialIndex(BenchmarkRunner& runner)
+{
+	// 10000 sprites spread over a level 16 screens large
+	const uint32 count = 10000;
+	Random random(5);
+	SpatialIndex2D index(8.0f);
+	vector<BoundingBox2D> boxes(count);
+	vector<uint32> proxies(count);
+	for(uint32 i = 0; i < count; ++i)
+	{
+		boxes[i] = ToBoundingBox(Rect<float>(random.nextDouble(0.0, 5120.0), random.nextDouble(0.0, 2880.0), 16.0f, 16.0f));
+		proxies[i] = index.insert(boxes[i], 0);
+	}
+
+	const BoundingBox2D view = ToBoundingBox(Rect<float>(1280.0f, 720.0f, 1280.0f, 720.0f));
+	runner.run("spatial/query_view_10000", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			uint32 visibleCount = 0;
+			index.query(view, [&](const uint32) { ++visibleCount; return true; });
+			DoNotOptimize(visibleCount);
+		}
+	});
+
+	runner.run("spatial/move_10000", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			const float dx = (i & 1) ? 1.0f : -1.0f;
+			for(uint32 j = 0; j < count; ++j)
+			{
+				boxes[j].min[0] += dx;
+				boxes[j].max[0] += dx;
+				index.move(proxies[j], boxes[j]);
+			}
+		}
+		DoNotOptimize(index.getHeight());
+	}, count);
+}
+
+/**
+ * Entity component iteration
+ */
+struct BenchmarkPosition
+{
+	BenchmarkPosition(const float x = 0.0f, const float y = 0.0f) : x(x), y(y) { }
+	float x, y;
+};
+
+struct BenchmarkVelocity
+{
+	BenchmarkVelocity(const float x = 0.0f, const float y = 0.0f) : x(x), y(y) { }
+	float x, y;
+};
+
+static void BenchmarkEntities(BenchmarkRunner& runner)
+{
+	const uint32 count = 50000;
+	EntityWorld world;
+	Random random(4);
+	for(uint32 i = 0; i < count; ++i)
+	{
+		const Entity entity = world.createEntity();
+		world.addComponent<BenchmarkPosition>(entity, random.nextDouble(0.0, 1280.0), random.nextDouble(0.0, 720.0));
+		world.addComponent<BenchmarkVelocity>(entity, random.nextDouble(-4.0, 4.0), random.nextDouble(-4.0, 4.0));
+	}
+
+	runner.run("entity/each_50000", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			world.each<BenchmarkVelocity, BenchmarkPosition>([](const Entity, BenchmarkVelocity& velocity, BenchmarkPosition& position)
+			{
+				position.x += velocity.x;
+				position.y += velocity.y;
+			});
+		}
+		DoNotOptimize(*world.getPool<BenchmarkPosition>().getComponents());
+	}, count);
+
+	runner.run("entity/each_parallel_50000", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			world.eachParallel<BenchmarkVelocity, BenchmarkPosition>([](const Entity, BenchmarkVelocity& velocity, BenchmarkPosition& position)
+			{
+				position.x += velocity.x;
+				position.y += velocity.y;
+			});
+		}
+		DoNotOptimize(*world.getPool<BenchmarkPosition>().getComponents());
+	}, count);
+}
+
+/**
+ * ByteStream
+ */
+static void BenchmarkByteStream(BenchmarkRunner& runner)
+{
+	const string valuesFilePath = "BenchmarkValues.bin";
+	const string vectorFilePath = "BenchmarkVector.bin";
+	const uint32 count = 1 << 16;
+	vector<float> values(count);
+	for(uint32 i = 0; i < count; ++i)
+	{
+		values[i] = float(i) * 0.5f;
+	}
+
+	// Write the files up front so that the read benchmarks can be run on their own
+	{
+		ByteStreamOut valuesOut(valuesFilePath);
+		valuesOut.write(values.data(), count);
+		ByteStreamOut vectorOut(vectorFilePath);
+		vectorOut << values;
+	}
+
+	runner.run("byte_stream/write_floats_64k", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			ByteStreamOut out(valuesFilePath);
+			for(uint32 j = 0; j < count; ++j)
+			{
+				out << values[j];
+			}
+		}
+	}, count);
+
+	runner.run("byte_stream/read_floats_64k", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			ByteStreamIn in(valuesFilePath);
+			float sum = 0.0f;
+			for(uint32 j = 0; j < count; ++j)
+			{
+				float value;
+				in >> value;
+				sum += value;
+			}
+			DoNotOptimize(sum);
+		}
+	}, count);
+
+	runner.run("byte_stream/write_vector_64k", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			ByteStreamOut out(vectorFilePath);
+			out << values;
+		}
+	}, count);
+
+	runner.run("byte_stream/read_vector_64k", [&](const uint64 iterations)
+	{
+		for(uint64 i = 0; i < iterations; ++i)
+		{
+			ByteStreamIn in(vectorFilePath);
+			vector<float> readValues;
+			in >> readValues;
+			DoNotOptimize(readValues);
+		}
+	}, count);
+
+	remove(valuesFilePath.c_str());
+	remove(vectorFilePath.c_str());
+}
+
+void RunMicroBenchmarks(BenchmarkRunner& runner)
+{
+	BenchmarkMath(runner);
+	BenchmarkVertexArray(runner);
+	BenchmarkPixmap(runner);
+	BenchmarkRectanglePacker(runner);
+	BenchmarkSDF(runner);
+	BenchmarkScene(runner);
+	BenchmarkTransforms(runner);
+	BenchmarkSpatialIndex(runner);
+	BenchmarkEntities(runner);
+	BenchmarkByteStream(runner);
+}
@@ -0,0 +1,58 @@
+/* Include the SauceEngine framework */
+#include <Sauce/Sauce.h>
+#include <filesystem>
+
+using namespace sauce;
+
+/**
+ * PackTool:
+ * Packs every file under a directory into a single pack file which can be
+ * mounted through GameDesc::packFiles. Files are stored under their path
+ * relative to the input directory, so "Assets/Sprites/Player.png" packed
+ * from "Assets" is loaded by the game as ":/Sprites/Player.png".
+ *
+ * Usage: saucepack <input directory> <output pack file> [alignment]
+ */
+int main(int argc, char *argv[])
+{
+	if(argc < 3)
+	{
+		printf("Usage: %s <input directory> <output pack file> [alignment]\n", argv[0]);
+		return 1;
+	}
+
+	const filesystem::path inputDirectory = argv[1];
+	const string outputFile = argv[2];
+	const uint32 alignment = argc > 3 ? (uint32)util::strToInt(argv[3]) : 16;
+
+	if(!filesystem::is_directory(inputDirectory))
+	{
+		printf("Input directory \"%s\" does not exist\n", argv[1]);
+		return 1;
+	}
+
+	util::PackFileWriter packFileWriter(alignment);
+	for(const filesystem::directory_entry &entry : filesystem::recursive_directory_iterator(inputDirectory))
+	{
+		if(!entry.is_regular_file())
+		{
+			continue;
+		}
+
+		const string assetPath = filesystem::relative(entry.path(), inputDirectory).generic_string();
+		if(!packFileWriter.addFile(assetPath, entry.path().string()))
+		{
+			printf("Failed to add \"%s\"\n", entry.path().string().c_str());
+			return 1;
+		}
+	}
+
+	if(!packFileWriter.write(outputFile))
+	{
+		printf("Failed to write pack file \"%s\"\n", outputFile.c_str());
+		return 1;
+	}
+
+	printf("Packed %u files into \"%s\"\n", packFileWriter.getEntryCount(), outputFile.c_str());
+	return 0;
+}
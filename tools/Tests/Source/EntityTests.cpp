@@ -0,0 +1,99 @@
+#include "Tests.h"
+
+struct TestHealth
+{
+	int value;
+};
+
+/**
+ * A component removed and added again inside each() is kept with the new value
+ */
+static void TestRemoveThenAddDuringIteration()
+{
+	EntityWorld world;
+	const Entity entity = world.createEntity();
+	world.addComponent<TestHealth>(entity, TestHealth{ 1 });
+
+	world.each<TestHealth>([&](const Entity e, TestHealth&)
+	{
+		world.removeComponent<TestHealth>(e);
+		world.addComponent<TestHealth>(e, TestHealth{ 2 });
+	});
+
+	CHECK(world.hasComponent<TestHealth>(entity));
+	CHECK(world.getComponent<TestHealth>(entity) && world.getComponent<TestHealth>(entity)->value == 2);
+}
+
+/**
+ * A component added and then removed inside each() is gone afterwards
+ */
+static void TestAddThenRemoveDuringIteration()
+{
+	EntityWorld world;
+	const Entity entity = world.createEntity();
+	world.addComponent<TestHealth>(entity, TestHealth{ 1 });
+
+	world.each<TestHealth>([&](const Entity e, TestHealth&)
+	{
+		world.addComponent<TestHealth>(e, TestHealth{ 2 });
+		world.removeComponent<TestHealth>(e);
+	});
+
+	CHECK(!world.hasComponent<TestHealth>(entity));
+}
+
+/**
+ * Handles of destroyed entities stay invalid while their slot is reused
+ */
+static void TestStaleHandles()
+{
+	EntityWorld world;
+	const Entity first = world.createEntity();
+	Entity entity = first;
+	for(uint32 i = 0; i < 1000; ++i)
+	{
+		world.destroyEntity(entity);
+		entity = world.createEntity();
+		CHECK(entity != first);
+	}
+	CHECK(!world.isAlive(first));
+	CHECK(world.isAlive(entity));
+	CHECK(world.getEntityCount() == 1);
+}
+
+/**
+ * Adding a component through a stale handle throws and leaves the entity
+ * reusing its slot untouched
+ */
+static void TestAddComponentToStaleHandle()
+{
+	EntityWorld world;
+	const Entity stale = world.createEntity();
+	world.destroyEntity(stale);
+	const Entity entity = world.createEntity();
+	world.addComponent<TestHealth>(entity, TestHealth{ 1 });
+
+	bool thrown = false;
+	try
+	{
+		world.addComponent<TestHealth>(stale, TestHealth{ 2 });
+	}
+	catch(Exception&)
+	{
+		thrown = true;
+	}
+
+	CHECK(thrown);
+	CHECK(world.getPool<TestHealth>().size() == 1);
+	CHECK(world.getComponent<TestHealth>(entity) && world.getComponent<TestHealth>(entity)->value == 1);
+	world.removeComponent<TestHealth>(entity);
+	CHECK(!world.hasComponent<TestHealth>(entity));
+}
+
+void RunEntityTests()
+{
+	TestRemoveThenAddDuringIteration();
+	TestAddThenRemoveDuringIteration();
+	TestStaleHandles();
+	TestAddComponentToStaleHandle();
+}
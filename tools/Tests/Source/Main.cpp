@@ -0,0 +1,25 @@
+#include "Tests.h"
+
+uint32 g_failedCheckCount = 0;
+
+/**
+ * Tests:
+ * Checks engine behavior that is easy to get wrong and does not need a
+ * window or graphics context. Exits with 1 if any check failed.
+ *
+ * Usage: saucetest
+ */
+int main(int argc, char *argv[])
+{
+	RunEntityTests();
+	RunSceneObjectTests();
+	RunSpatialGroupTests();
+
+	if(g_failedCheckCount > 0)
+	{
+		printf("%u check(s) failed\n", g_failedCheckCount);
+		return 1;
+	}
+	printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,93 @@
+#include "Tests.h"
+
+/**
+ * Counts the ticks it receives and optionally deletes itself on the first one
+ */
+class TickCounter : public SceneObject
+{
+public:
+	TickCounter(uint32 *tickCount, const bool removeFirst, const bool deleteOnTick) :
+		m_tickCount(tickCount),
+		m_removeFirst(removeFirst),
+		m_deleteOnTick(deleteOnTick)
+	{
+	}
+
+	void onTick(TickEvent *e)
+	{
+		(*m_tickCount)++;
+		if(m_deleteOnTick)
+		{
+			if(m_removeFirst)
+			{
+				getParent()->removeChild(this);
+			}
+			delete this;
+		}
+	}
+
+private:
+	uint32 *m_tickCount;
+	const bool m_removeFirst;
+	const bool m_deleteOnTick;
+};
+
+/**
+ * A child removed and deleted by its own handler is forgotten, and its siblings still get the event
+ */
+static void TestDeleteChildDuringPropagation(const bool removeFirst)
+{
+	uint32 tickCount = 0;
+	SceneObject parent;
+	parent.addChildLast(new TickCounter(&tickCount, removeFirst, true));
+	TickCounter sibling(&tickCount, false, false);
+	parent.addChildLast(&sibling);
+
+	TickEvent e(1.0f);
+	parent.onEvent(&e);
+	CHECK(tickCount == 2);
+	CHECK(parent.getChildren().size() == 1);
+	CHECK(parent.getChildren().front() == &sibling);
+
+	parent.onEvent(&e);
+	CHECK(tickCount == 3);
+	parent.removeChild(&sibling);
+}
+
+/**
+ * A spatial group forgets the bounds of a child deleted during propagation
+ */
+static void TestDeleteSpatialChildDuringPropagation()
+{
+	uint32 tickCount = 0;
+	SpatialGroup group;
+	TickCounter *child = new TickCounter(&tickCount, true, true);
+	group.addChildLast(child);
+	group.setChildBounds(child, Rect<float>(0.0f, 0.0f, 10.0f, 10.0f));
+
+	TickEvent e(1.0f);
+	group.onEvent(&e);
+	CHECK(tickCount == 1);
+	CHECK(group.getChildren().empty());
+	CHECK(group.pick(Vector2F(5.0f, 5.0f)) == 0);
+}
+
+/**
+ * Children of a deleted object are left without a parent
+ */
+static void TestDeleteParent()
+{
+	SceneObject child;
+	SceneObject *parent = new SceneObject();
+	parent->addChildLast(&child);
+	delete parent;
+	CHECK(child.getParent() == 0);
+}
+
+void RunSceneObjectTests()
+{
+	TestDeleteChildDuringPropagation(true);
+	TestDeleteChildDuringPropagation(false);
+	TestDeleteSpatialChildDuringPropagation();
+	TestDeleteParent();
+}
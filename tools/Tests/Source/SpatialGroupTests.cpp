@@ -0,0 +1,69 @@
+#include "Tests.h"
+
+/**
+ * Exposes event propagation, so child changes can be deferred like during an event
+ */
+class TestSpatialGroup : public SpatialGroup
+{
+public:
+	void removeChildDeferred(SceneObject *child)
+	{
+		beginPropagation();
+		removeChild(child);
+		CHECK(pick(Vector2F(5.0f, 5.0f)) == child);
+		endPropagation();
+	}
+};
+
+/**
+ * A removed child is no longer queried or picked, even after it was deleted
+ */
+static void TestRemovedChildIsForgotten()
+{
+	SpatialGroup group;
+	SceneObject *child = new SceneObject();
+	group.addChildLast(child);
+	group.setChildBounds(child, Rect<float>(0.0f, 0.0f, 10.0f, 10.0f));
+	CHECK(group.pick(Vector2F(5.0f, 5.0f)) == child);
+
+	group.removeChild(child);
+	delete child;
+
+	vector<SceneObject*> children;
+	group.queryRect(Rect<float>(0.0f, 0.0f, 10.0f, 10.0f), children);
+	CHECK(children.empty());
+	CHECK(group.pick(Vector2F(5.0f, 5.0f)) == 0);
+	CHECK(group.getIndex().getProxyCount() == 0);
+}
+
+/**
+ * A child removed while an event is passed down keeps its bounds until the removal is applied
+ */
+static void TestDeferredRemoval()
+{
+	TestSpatialGroup group;
+	SceneObject child;
+	group.addChildLast(&child);
+	group.setChildBounds(&child, Rect<float>(0.0f, 0.0f, 10.0f, 10.0f));
+
+	group.removeChildDeferred(&child);
+	CHECK(group.pick(Vector2F(5.0f, 5.0f)) == 0);
+}
+
+/**
+ * Bounds can only be set for children of the group
+ */
+static void TestBoundsOfNonChild()
+{
+	SpatialGroup group;
+	SceneObject object;
+	group.setChildBounds(&object, Rect<float>(0.0f, 0.0f, 10.0f, 10.0f));
+	CHECK(group.pick(Vector2F(5.0f, 5.0f)) == 0);
+}
+
+void RunSpatialGroupTests()
+{
+	TestRemovedChildIsForgotten();
+	TestDeferredRemoval();
+	TestBoundsOfNonChild();
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+/* Include the SauceEngine framework */
+#include <Sauce/Sauce.h>
+
+using namespace sauce;
+
+/**
+ * Number of failed checks. A test run fails if any check failed.
+ */
+extern uint32 g_failedCheckCount;
+
+#define CHECK(condition) \
+	do { \
+		if(!(condition)) \
+		{ \
+			printf("%s:%i: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			g_failedCheckCount++; \
+		} \
+	} while(false)
+
+void RunEntityTests();
+void RunSceneObjectTests();
+void RunSpatialGroupTests();